@@ -0,0 +1,220 @@
+/*
+ * File: Button.c
+ * Author: Roger Berry
+ * Comments: Debounced hall call and car call buttons on the GPIO inputs
+ *           The buttons close to 0 V against the GPIO pull ups. All the
+ *           button pins are sampled together in the Timer6 interrupt every
+ *           250 us and debounced with a 2 bit vertical counter, one counter
+ *           bit per pin in each of two bytes, so a pin changes state after 4
+ *           samples, 1 ms, that all differ from its debounced state. Any
+ *           bounce resets the count. GPIO_7 is on PORTD which has no
+ *           interrupt on change, so the pins are sampled by the timer rather
+ *           than woken by edges. GPIO_8 is the LED display chip select.
+ *           Each change of debounced state is put in an event ring by the
+ *           interrupt and taken out by ButtonService, which turns presses
+ *           into lift calls through the pin map. Each side only writes its
+ *           own index so no lock is needed.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Lift.h"
+#include "Button.h"
+#include "Scheduler.h"
+
+//define the calls made by each pin at start up
+//the middle floor has no hall buttons, there are not enough pins
+const BUTTON_MAP DefaultButtonMap[BUTTON_PINS] =
+{
+    {0, LIFT_CALL_CAR},                     //GPIO_1, car floor 1
+    {1, LIFT_CALL_CAR},                     //GPIO_2, car floor 2
+    {2, LIFT_CALL_CAR},                     //GPIO_3, car floor 3
+    {0, LIFT_CALL_UP},                      //GPIO_4, hall floor 1 up
+    {BUTTON_UNUSED, 0},                     //GPIO_5, bottom endstop
+    {BUTTON_UNUSED, 0},                     //GPIO_6, top endstop
+    {2, LIFT_CALL_DOWN},                    //GPIO_7, hall floor 3 down
+    {BUTTON_UNUSED, 0}                      //GPIO_8, LED display chip select
+};
+
+//define variables used in this file
+BUTTON_MAP ButtonMap[BUTTON_PINS];
+volatile unsigned char ButtonState = 0;             //debounced, bit set while pressed
+unsigned char ButtonCount0 = 0;                     //low bit of each pin's counter
+unsigned char ButtonCount1 = 0;                     //high bit of each pin's counter
+volatile unsigned char ButtonEvents[BUTTON_EVENT_COUNT];
+volatile unsigned char EventHead = 0;               //written by the interrupt
+volatile unsigned char EventTail = 0;               //written by the main loop
+volatile unsigned int ButtonOverflowCount = 0;      //events lost with the ring full
+
+
+
+//***************************************************************
+//Read the button pins, a bit is set for each pin held at 0 V
+
+static unsigned char    ReadButtons(void)
+{
+    unsigned char Pressed;
+
+    Pressed = 0;
+    if(GPIO_1_READ_PORT == 0)
+    {
+        Pressed |= 0x01;
+    }
+    if(GPIO_2_READ_PORT == 0)
+    {
+        Pressed |= 0x02;
+    }
+    if(GPIO_3_READ_PORT == 0)
+    {
+        Pressed |= 0x04;
+    }
+    if(GPIO_4_READ_PORT == 0)
+    {
+        Pressed |= 0x08;
+    }
+    if(GPIO_7_READ_PORT == 0)
+    {
+        Pressed |= 0x40;
+    }
+    return Pressed & BUTTON_PIN_MASK;
+}
+
+
+
+//***************************************************************
+//Load the default pin map, call after InitialisePorts
+//a button held at start up is not reported until it is released
+
+void    InitialiseButtons(void)
+{
+    unsigned char Pin;
+
+    for(Pin = 0; Pin < BUTTON_PINS; Pin++)
+    {
+        ButtonMap[Pin] = DefaultButtonMap[Pin];
+    }
+    ButtonState = ReadButtons();
+    ButtonCount0 = 0;
+    ButtonCount1 = 0;
+    EventHead = 0;
+    EventTail = 0;
+    ButtonOverflowCount = 0;
+}
+
+
+
+//***************************************************************
+//Sample and debounce the buttons, called from HIGH_ISR every 250 us
+
+void    ButtonInterrupt(void)
+{
+    unsigned char Delta;
+    unsigned char Toggle;
+    unsigned char Pin;
+    unsigned char Mask;
+    unsigned char Event;
+
+    //count pins that differ from their debounced state, reset the rest
+    Delta = ReadButtons() ^ ButtonState;
+    ButtonCount1 = (ButtonCount1 ^ ButtonCount0) & Delta;
+    ButtonCount0 = (unsigned char)~ButtonCount0 & Delta;
+    //a counter that has wrapped to 0 has seen 4 samples
+    Toggle = Delta & (unsigned char)~(ButtonCount0 | ButtonCount1);
+    if(Toggle == 0)
+    {
+        return;
+    }
+    ButtonState ^= Toggle;
+
+    Mask = 0x01;
+    for(Pin = 0; Pin < BUTTON_PINS; Pin++)
+    {
+        if(Toggle & Mask)
+        {
+            Event = Pin;
+            if(ButtonState & Mask)
+            {
+                Event |= BUTTON_PRESSED;
+            }
+            if((unsigned char)(EventHead - EventTail) < BUTTON_EVENT_COUNT)
+            {
+                ButtonEvents[EventHead & BUTTON_EVENT_MASK] = Event;
+                EventHead++;
+                SchedulerInterruptSignal(EVENT_BUTTON);
+            }
+            else
+            {
+                ButtonOverflowCount++;
+            }
+        }
+        Mask = (unsigned char)(Mask << 1);
+    }
+}
+
+
+
+//***************************************************************
+//Pass the button presses to the lift, called on every pass of the
+//main loop
+
+void    ButtonService(void)
+{
+    unsigned char Event;
+    unsigned char Pin;
+
+    while(EventTail != EventHead)
+    {
+        Event = ButtonEvents[EventTail & BUTTON_EVENT_MASK];
+        EventTail++;
+        if(Event & BUTTON_PRESSED)
+        {
+            Pin = Event & BUTTON_PIN_BITS;
+            if(ButtonMap[Pin].Floor != BUTTON_UNUSED)
+            {
+                LiftCall(ButtonMap[Pin].Floor, ButtonMap[Pin].Call);
+            }
+        }
+    }
+}
+
+
+
+//***************************************************************
+//Set the call made when a pin is pressed, Pin is from 0 for GPIO_1
+//Floor BUTTON_UNUSED makes no call. The endstop pins cannot be used
+//returns LIFT_OK or LIFT_INVALID_CALL
+
+unsigned int    ButtonSetMap(unsigned int Pin, unsigned int Floor, unsigned int Call)
+{
+    if(Pin >= BUTTON_PINS || (BUTTON_PIN_MASK & (1 << Pin)) == 0)
+    {
+        return LIFT_INVALID_CALL;
+    }
+    if(Floor != BUTTON_UNUSED && (Floor >= LIFT_FLOORS || Call >= LIFT_CALL_TYPES))
+    {
+        return LIFT_INVALID_CALL;
+    }
+    ButtonMap[Pin].Floor = (unsigned char)Floor;
+    ButtonMap[Pin].Call = (unsigned char)Call;
+    return LIFT_OK;
+}
+
+
+
+//***************************************************************
+//Get the debounced buttons, bit n is set while GPIO_(n + 1) is pressed
+
+unsigned int    ButtonGetState(void)
+{
+    return ButtonState;
+}
+
+
+
+//***************************************************************
+//Get the number of events lost because the ring was full
+
+unsigned int    ButtonGetOverflowCount(void)
+{
+    return ButtonOverflowCount;
+}
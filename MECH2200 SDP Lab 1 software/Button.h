@@ -0,0 +1,44 @@
+/*
+ * File: Button.h
+ * Author: Roger Berry
+ * Comments: Debounced hall call and car call buttons on the GPIO inputs
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef BUTTON_H
+#define	BUTTON_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define button constants, pin n is GPIO_(n + 1)
+#define BUTTON_PINS                 8
+#define BUTTON_PIN_MASK             0x4F        //GPIO_5 and GPIO_6 are the endstops, GPIO_8 the display select
+#define BUTTON_UNUSED               0xFF        //floor of a pin with no call
+
+//define event queue
+#define BUTTON_EVENT_COUNT          8           //power of 2
+#define BUTTON_EVENT_MASK           (BUTTON_EVENT_COUNT - 1)
+#define BUTTON_PRESSED              0x80        //set in an event for a press, clear for a release
+#define BUTTON_PIN_BITS             0x07        //pin number in an event
+
+//the call made when a pin is pressed
+typedef struct
+{
+    unsigned char Floor;                    //from 0, BUTTON_UNUSED for none
+    unsigned char Call;                     //LIFT_CALL_UP, LIFT_CALL_DOWN or LIFT_CALL_CAR
+} BUTTON_MAP;
+
+//declare functions
+void    InitialiseButtons(void);
+void    ButtonInterrupt(void);
+void    ButtonService(void);
+unsigned int    ButtonSetMap(unsigned int, unsigned int, unsigned int);
+unsigned int    ButtonGetState(void);
+unsigned int    ButtonGetOverflowCount(void);
+
+
+
+#endif	/* BUTTON_H */
+
@@ -0,0 +1,183 @@
+/*
+ * File: Calibration.c
+ * Author: Roger Berry
+ * Comments: Lift calibration record kept in high endurance flash
+ *           The floor positions, the travel and the move settings are
+ *           saved as one record with a version and a CRC-8. Each save
+ *           goes to the next of the 4 HEF rows with the sequence number
+ *           one higher, so the rows wear evenly and the last good record
+ *           is never erased while the new one is written. A record whose
+ *           write was cut short fails its CRC and the one before it is
+ *           used. At start up the newest valid record is loaded.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stddef.h>
+#include "Init.h"
+#include "Motion.h"
+#include "Protocol.h"
+#include "Flash.h"
+#include "Calibration.h"
+
+//define external global variables
+extern  volatile unsigned int GLOBAL_StepperMotorSpeed;
+extern  volatile signed long GLOBAL_Floor1Position;
+extern  volatile signed long GLOBAL_Floor2Position;
+extern  volatile signed long GLOBAL_Floor3Position;
+extern  volatile signed long GLOBAL_MaxPosition;
+
+//define variables used in this file
+CALIBRATION_RECORD CalibrationRecord;
+unsigned char CalibrationRow = HEF_ROW_COUNT - 1;   //row of the newest record, the next save uses the row after
+unsigned char CalibrationSequence = 0;              //sequence of the newest record
+unsigned char CalibrationLoaded = 0;                //set once a valid record has been loaded
+
+
+
+//***************************************************************
+//Work out the CRC-8 of every byte of the record before the CRC
+
+static unsigned char    RecordCrc(CALIBRATION_RECORD *Record)
+{
+    unsigned char *Byte;
+    unsigned char Crc;
+    unsigned int Index;
+
+    Byte = (unsigned char *)Record;
+    Crc = 0;
+    for(Index = 0; Index < offsetof(CALIBRATION_RECORD, Crc); Index++)
+    {
+        Crc = ProtocolCrc8(Crc, Byte[Index]);
+    }
+    return Crc;
+}
+
+
+
+//***************************************************************
+//Read the record in the passed row, returns 1 if it is valid
+
+static unsigned int    ReadRecord(unsigned char Row, CALIBRATION_RECORD *Record)
+{
+    FlashReadRow(HEF_START + (unsigned int)Row * HEF_ROW_SIZE, (unsigned char *)Record, sizeof(CALIBRATION_RECORD));
+    if(Record->Version != CALIBRATION_VERSION)
+    {
+        return 0;
+    }
+    return Record->Crc == RecordCrc(Record);
+}
+
+
+
+//***************************************************************
+//Load the newest valid record into the floor positions and move settings
+//returns CALIBRATION_OK or CALIBRATION_NONE
+
+unsigned int    CalibrationLoad(void)
+{
+    unsigned char Row;
+    unsigned char Found;
+    unsigned char Options;
+
+    //the sequence wraps, newer is less than 128 ahead
+    Found = 0;
+    for(Row = 0; Row < HEF_ROW_COUNT; Row++)
+    {
+        if(ReadRecord(Row, &CalibrationRecord) != 0)
+        {
+            if(Found == 0 || (signed char)(CalibrationRecord.Sequence - CalibrationSequence) > 0)
+            {
+                Found = 1;
+                CalibrationRow = Row;
+                CalibrationSequence = CalibrationRecord.Sequence;
+            }
+        }
+    }
+    if(Found == 0)
+    {
+        return CALIBRATION_NONE;
+    }
+
+    ReadRecord(CalibrationRow, &CalibrationRecord);
+    GLOBAL_Floor1Position = CalibrationRecord.FloorPosition[0];
+    GLOBAL_Floor2Position = CalibrationRecord.FloorPosition[1];
+    GLOBAL_Floor3Position = CalibrationRecord.FloorPosition[2];
+    GLOBAL_MaxPosition = CalibrationRecord.MaxPosition;
+    GLOBAL_StepperMotorSpeed = CalibrationRecord.StepDelay;
+    MotionSetProfile(CalibrationRecord.Acceleration, CalibrationRecord.Deceleration);
+    Options = CalibrationRecord.Options;
+    if(Options & CALIBRATION_OPTION_SCURVE)
+    {
+        MotionSetShape(MOTION_SHAPE_SCURVE);
+    }
+    else
+    {
+        MotionSetShape(MOTION_SHAPE_TRAPEZOID);
+    }
+    MotionSetHardwareCruise((Options & CALIBRATION_OPTION_HARDWARE) != 0);
+    MotionSetModeSwitch((Options & CALIBRATION_OPTION_MODE) != 0);
+    CalibrationLoaded = 1;
+    return CALIBRATION_OK;
+}
+
+
+
+//***************************************************************
+//Save the floor positions and move settings to the next row
+//the CPU stalls while the row is written so the motor must be stopped
+//returns CALIBRATION_OK, CALIBRATION_BUSY or CALIBRATION_WRITE_ERROR
+
+unsigned int    CalibrationSave(void)
+{
+    unsigned char Row;
+
+    if(MotionBusy() != 0 || MotionBlocksActive() != 0)
+    {
+        return CALIBRATION_BUSY;
+    }
+
+    CalibrationRecord.Version = CALIBRATION_VERSION;
+    CalibrationRecord.Sequence = CalibrationSequence + 1;
+    CalibrationRecord.FloorPosition[0] = GLOBAL_Floor1Position;
+    CalibrationRecord.FloorPosition[1] = GLOBAL_Floor2Position;
+    CalibrationRecord.FloorPosition[2] = GLOBAL_Floor3Position;
+    CalibrationRecord.MaxPosition = GLOBAL_MaxPosition;
+    CalibrationRecord.StepDelay = GLOBAL_StepperMotorSpeed;
+    CalibrationRecord.Acceleration = MotionGetAcceleration();
+    CalibrationRecord.Deceleration = MotionGetDeceleration();
+    CalibrationRecord.Options = 0;
+    if(MotionGetShape() == MOTION_SHAPE_SCURVE)
+    {
+        CalibrationRecord.Options |= CALIBRATION_OPTION_SCURVE;
+    }
+    if(MotionGetHardwareCruise() != 0)
+    {
+        CalibrationRecord.Options |= CALIBRATION_OPTION_HARDWARE;
+    }
+    if(MotionGetModeSwitch() != 0)
+    {
+        CalibrationRecord.Options |= CALIBRATION_OPTION_MODE;
+    }
+    CalibrationRecord.Crc = RecordCrc(&CalibrationRecord);
+
+    //the newest record stays in its row until the new one has been checked
+    Row = (CalibrationRow + 1) & HEF_ROW_MASK;
+    if(FlashWriteRow(HEF_START + (unsigned int)Row * HEF_ROW_SIZE, (unsigned char *)&CalibrationRecord, sizeof(CALIBRATION_RECORD)) != FLASH_OK)
+    {
+        return CALIBRATION_WRITE_ERROR;
+    }
+    CalibrationRow = Row;
+    CalibrationSequence = CalibrationRecord.Sequence;
+    CalibrationLoaded = 1;
+    return CALIBRATION_OK;
+}
+
+
+
+//***************************************************************
+//Test for a saved record having been loaded or written, returns 1 if so
+
+unsigned int    CalibrationIsLoaded(void)
+{
+    return CalibrationLoaded;
+}
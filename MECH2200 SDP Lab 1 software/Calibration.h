@@ -0,0 +1,52 @@
+/*
+ * File: Calibration.h
+ * Author: Roger Berry
+ * Comments: Lift calibration record kept in high endurance flash
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef CALIBRATION_H
+#define	CALIBRATION_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define record constants
+#define CALIBRATION_VERSION         1           //change when the record layout changes
+#define CALIBRATION_FLOORS          3
+
+//define option bits saved with the move settings
+#define CALIBRATION_OPTION_SCURVE   0x01
+#define CALIBRATION_OPTION_HARDWARE 0x02        //hardware cruise
+#define CALIBRATION_OPTION_MODE     0x04        //step mode switching
+
+//define calibration status
+#define CALIBRATION_OK              0x0000
+#define CALIBRATION_NONE            0x0001  //no row holds a valid record
+#define CALIBRATION_WRITE_ERROR     0x0002
+#define CALIBRATION_BUSY            0xFFFF  //the motor is moving, same as MOTION_BUSY
+
+//the record fits in one HEF row, the CRC is the last byte
+typedef struct
+{
+    unsigned char Version;
+    unsigned char Sequence;                 //one more than the last record written
+    signed long FloorPosition[CALIBRATION_FLOORS];  //steps above the bottom endstop edge
+    signed long MaxPosition;                //travel between the endstop edges
+    unsigned int StepDelay;                 //cruise interval in us
+    unsigned int Acceleration;              //steps/s/s
+    unsigned int Deceleration;
+    unsigned char Options;
+    unsigned char Crc;                      //CRC-8 of every byte before it
+} CALIBRATION_RECORD;
+
+//declare functions
+unsigned int    CalibrationLoad(void);
+unsigned int    CalibrationSave(void);
+unsigned int    CalibrationIsLoaded(void);
+
+
+
+#endif	/* CALIBRATION_H */
+
@@ -7,8 +7,17 @@
 
 #include "Init.h"
 #include "Comms.h"
+#include "Format.h"
 #include "PWM.h"
 #include "Timer.h"
+#include "Protocol.h"
+#include "SPI.h"
+#include "Motion.h"
+#include "Home.h"
+#include "Button.h"
+#include "Door.h"
+#include "SoftTimer.h"
+#include "Scheduler.h"
 
 //define external global variables
 extern volatile unsigned int GLOBAL_CalibrationStatus;
@@ -21,12 +30,28 @@ extern  volatile unsigned int GLOBAL_PWM1_PulseTime;
 extern  volatile unsigned int GLOBAL_PWM2_PulseTime;
 extern  volatile unsigned int GLOBAL_PWM3_PulseTime;
 extern  volatile unsigned int GLOBAL_PWM4_PulseTime;
-extern  volatile unsigned int GLOBAL_StepperMotorSpeed;
+
+//define strings
+const unsigned char BackspaceMessage[] = "\b \b";     //erase the last character on the terminal
 
 //define variables used in this file
-volatile unsigned char UART_RxBufferPointerType[BUFFER_SIZE];
-volatile unsigned char *OldRxPointer = UART_RxBufferPointerType;
-volatile unsigned char *NewRxPointer = UART_RxBufferPointerType;
+//receive and transmit buffer indexes are free running and masked on access
+//so the difference between them is the number of characters held
+volatile unsigned char UART_RxBuffer[RX_BUFFER_SIZE];
+volatile unsigned char RxHeadIndex = 0;     //next free location, written by the interrupt
+volatile unsigned char RxTailIndex = 0;     //next character to read, written by the main code
+volatile unsigned int RxDroppedCount = 0;   //characters lost because the buffer was full
+volatile unsigned int RxOverrunCount = 0;   //UART receiver overrun errors
+volatile unsigned int RxFrameErrorCount = 0;//UART framing errors
+unsigned long BaudRate = DEFAULT_BAUD_RATE;
+unsigned long PreviousBaudRate = DEFAULT_BAUD_RATE;   //restored if a change is not confirmed
+unsigned long NewBaudRate = DEFAULT_BAUD_RATE;
+unsigned char BaudChangeState = BAUD_CHANGE_IDLE;
+volatile unsigned char UART_TxBuffer[TX_BUFFER_SIZE];
+volatile unsigned char TxHeadIndex = 0;     //next free location, written by the main code
+volatile unsigned char TxTailIndex = 0;     //next character to send, written by the interrupt
+volatile unsigned char TxHighWaterMark = 0; //greatest number of characters waiting to be sent
+unsigned int TxWaitCount = 0;               //times a send had to wait for room in the buffer
 
 
 
@@ -36,10 +61,7 @@ volatile unsigned char *NewRxPointer = UART_RxBufferPointerType;
 void    InitialiseComms (void)
 {
     //initialise UART for 9600/8/N/1
-    BAUD1CONbits.BRG16 = 0;     //use 8 bit baud rate generator
-    TX1STAbits.BRGH = 0;        //Low speed UART
-    SPBRGH = 0;                 //set SPBRG word to 51 for 9600 baud
-    SPBRGL = 51;                //32MHz oscillator
+    SetBaudRate(DEFAULT_BAUD_RATE);
     
     //enable serial port
     TX1STAbits.SYNC = 0;         //set for asynchronous mode
@@ -47,70 +69,208 @@ void    InitialiseComms (void)
     RC1STAbits.CREN = 1;         //enable receiver
     RC1STAbits.SPEN = 1;         //enable serial port
     PIE1bits.RCIE = 1;          //enable RX interrupts
+    //TX interrupts are only enabled while the transmit buffer holds data
+    UART_INTERRUPT_TX_ENABLE = INTERRUPT_DISABLED;
+    
+    //initialise receiver buffer
+    RxHeadIndex = 0;
+    RxTailIndex = 0;
+    
+    //initialise transmitter buffer
+    TxHeadIndex = 0;
+    TxTailIndex = 0;
     
-    //initialise receiver arrays 
-    OldRxPointer = UART_RxBufferPointerType;
-    NewRxPointer = UART_RxBufferPointerType;
+    //clear error counters and high water mark
+    ClearCommsCounters();
 
 }
 
 
 
 //***************************************************************
-//Convert the passed integer value into a decimal string
-//leading zeros may be added by specifying the length
-//This is primarily used for fraction decimal places
+//Calculate the baud rate generator value for the passed baud rate
+//the 16 bit generator is used in high speed mode so that
+//baud rate = FOSC / (4 * (SPBRG + 1))
+//the result is rounded to the nearest divisor
+//returns BAUD_DIVISOR_INVALID if the rate is outside the generator range
 
-void    DecimalToResultString(unsigned int Value, volatile unsigned char *ResultString, unsigned int Length)
+unsigned int    GetBaudDivisor(unsigned long Rate)
 {
-    unsigned int Status = 0;
+    unsigned long Divisor;
     
-    //null the string
-    *ResultString = (unsigned char)NULL;
+    //test for invalid value
+    if(Rate == 0)
+    {
+        return BAUD_DIVISOR_INVALID;
+    }
+    Divisor = (INSTRUCTION_FREQUENCY + (Rate / 2)) / Rate;
+    //test for rate outside the generator range
+    if(Divisor == 0 || Divisor > BAUD_DIVISOR_INVALID)
+    {
+        return BAUD_DIVISOR_INVALID;
+    }
+    return (unsigned int)(Divisor - 1);
+}
+
+
+
+//***************************************************************
+//Calculate the error between the actual and requested baud rate
+//the result is in 0.01% units i.e. 64 = +0.64%
+//returns BAUD_ERROR_INVALID if the rate cannot be generated
+
+signed int      GetBaudError(unsigned long Rate)
+{
+    unsigned int Divisor;
+    unsigned long Actual;
+    signed long Error;
     
-    //convert from a digital value into an ASCII string
-    if(Value >= 10000 || Length == 5)
+    //test for invalid value
+    Divisor = GetBaudDivisor(Rate);
+    if(Divisor == BAUD_DIVISOR_INVALID)
     {
-        *ResultString = (unsigned char)((Value / 10000) + ASCII_NUMBER_OFFSET);
-        Value = Value % 10000;
-        //conversion performed set status bit
-        Status = 1; 
-        //increment pointer
-        ResultString++;
+        return BAUD_ERROR_INVALID;
     }
-    if(Status == 1 || Value >= 1000 || Length == 4)
+    //actual rate produced by the generator
+    Actual = INSTRUCTION_FREQUENCY / ((unsigned long)Divisor + 1);
+    //difference scaled to 0.01% units
+    //the rate is divided rather than the difference multiplied to stay within 32 bits
+    Error = (signed long)Actual - (signed long)Rate;
+    Error = (Error * 100) / (signed long)(Rate / 100);
+    
+    return (signed int)Error;
+}
+
+
+
+//***************************************************************
+//Set the UART baud rate
+//returns BAUD_RATE_INVALID and leaves the UART unchanged if the
+//error would be greater than the limit
+
+unsigned int    SetBaudRate(unsigned long Rate)
+{
+    unsigned int Divisor;
+    signed int Error;
+    
+    //test the rate can be generated accurately enough
+    Error = GetBaudError(Rate);
+    if(Error > BAUD_RATE_ERROR_LIMIT || Error < -BAUD_RATE_ERROR_LIMIT)
     {
-        *ResultString = (unsigned char)((Value / 1000) + ASCII_NUMBER_OFFSET);
-        Value = Value % 1000;
-        //conversion performed set status bit
-        Status = 1;
-        //increment pointer
-        ResultString++;
+        return BAUD_RATE_INVALID;
     }
-    if(Status == 1 || Value >= 100 || Length == 3)
+    Divisor = GetBaudDivisor(Rate);
+    
+    UART_BAUD_16BIT = 1;            //use 16 bit baud rate generator
+    UART_BAUD_HIGH_SPEED = 1;       //high speed UART
+    SPBRGH = (unsigned char)(Divisor >> 8);
+    SPBRGL = (unsigned char)Divisor;
+    BaudRate = Rate;
+    
+    return STRING_OK;
+}
+
+
+
+//***************************************************************
+//return the present baud rate
+
+unsigned long   GetBaudRate(void)
+{
+    return BaudRate;
+}
+
+
+
+//***************************************************************
+//Start a baud rate change with a handshake
+//any waiting characters are sent at the present rate, then the UART is
+//switched and the host must send the confirm character at the new rate
+//within the confirm time. BaudChangeService runs each step without waiting
+
+unsigned int    ChangeBaudRate(unsigned long Rate)
+{
+    signed int Error;
+    
+    //test for valid rate before changing anything
+    Error = GetBaudError(Rate);
+    if(Error > BAUD_RATE_ERROR_LIMIT || Error < -BAUD_RATE_ERROR_LIMIT)
     {
-        *ResultString = (unsigned char)((Value / 100) + ASCII_NUMBER_OFFSET);
-        Value = Value % 100;
-        //conversion performed set status bit
-        Status = 1;
-        //increment pointer
-        ResultString++;
+        return BAUD_RATE_INVALID;
     }
-    if(Status == 1 || Value >= 10 || Length == 2)
+    PreviousBaudRate = BaudRate;
+    NewBaudRate = Rate;
+    BaudChangeState = BAUD_CHANGE_SENDING;
+    return STRING_OK;
+}
+
+
+
+//***************************************************************
+//Run the baud rate change started by ChangeBaudRate, call until it
+//returns something other than LINE_PENDING
+//returns STRING_OK when the host confirms the new rate or
+//BAUD_RATE_NOT_CONFIRMED when the previous rate has been restored
+
+unsigned int    BaudChangeService(void)
+{
+    unsigned int RxChar;
+    
+    switch(BaudChangeState)
     {
-        *ResultString = (unsigned char)((Value / 10) + ASCII_NUMBER_OFFSET);
-        Value = Value % 10;
-        //conversion performed set status bit
-        Status = 1;
-        //increment pointer
-        ResultString++;
+        case BAUD_CHANGE_SENDING:
+            //wait for the last character to leave the shift register
+            if(TxTailIndex != TxHeadIndex || TX_BUFFER_STATUS == 0)
+            {
+                return LINE_PENDING;
+            }
+            SetBaudRate(NewBaudRate);
+            //discard anything received while switching
+            while(GetChar() != 0xFFFF);
+            SoftTimerStart(SOFT_TIMER_BAUD_CONFIRM, BAUD_CONFIRM_TIME, 0, NULL);
+            BaudChangeState = BAUD_CHANGE_CONFIRM;
+            return LINE_PENDING;
+            
+        case BAUD_CHANGE_CONFIRM:
+            //binary frames are still handled while waiting, each when there
+            //is room for its reply
+            while(GetTxSpace() >= LINE_ECHO_SPACE)
+            {
+                RxChar = GetChar();
+                if(RxChar == 0xFFFF)
+                {
+                    break;
+                }
+                if(ProtocolReceiveByte((unsigned char)RxChar) == 0 && RxChar == BAUD_CONFIRM_CHARACTER)
+                {
+                    SoftTimerStop(SOFT_TIMER_BAUD_CONFIRM);
+                    BaudChangeState = BAUD_CHANGE_IDLE;
+                    return STRING_OK;
+                }
+            }
+            if(SoftTimerExpired(SOFT_TIMER_BAUD_CONFIRM) == 0)
+            {
+                return LINE_PENDING;
+            }
+            //no handshake, restore the previous rate
+            SetBaudRate(PreviousBaudRate);
+            BaudChangeState = BAUD_CHANGE_IDLE;
+            return BAUD_RATE_NOT_CONFIRMED;
     }
-    //get units
-    *ResultString = (unsigned char)(Value + ASCII_NUMBER_OFFSET);
-    //increment pointer
-    ResultString++;
-    //null the string
-    *ResultString = (unsigned char)NULL;
+    //no change in progress
+    return STRING_OK;
+}
+
+
+
+//***************************************************************
+//Convert the passed integer value into a decimal string
+//leading zeros may be added by specifying the length
+//This is primarily used for fraction decimal places
+
+void    DecimalToResultString(unsigned int Value, volatile unsigned char *ResultString, unsigned int Length)
+{
+    FormatUnsigned16(Value, Length, ResultString);
 }
 
 
@@ -118,24 +278,160 @@ void    DecimalToResultString(unsigned int Value, volatile unsigned char *Result
 
 //***************************************************************
 //Convert the passed string into an integer and return the result
+//values above 65535 return 65535 so range checks still reject them,
+//empty and invalid strings return 0
 
 unsigned int    StringToInteger(volatile unsigned char *StringPointer)
 {
-    unsigned int CharValue;
     unsigned int Result = 0;
     
+    switch(StringToUnsigned(StringPointer, &Result))
+    {
+        case STRING_OK:
+            break;
+        case VALUE_TOO_LARGE:
+            Result = 0xFFFF;
+            break;
+        default:    //NO_DATA or INVALID_STRING
+            Result = 0;
+            break;
+    }
+    
+    return Result;
+}
+
+
+
+//***************************************************************
+//Convert the passed string of digits into an unsigned integer
+//returns STRING_OK, NO_DATA, INVALID_STRING or VALUE_TOO_LARGE
+//the result is only written if the string is valid
+
+unsigned int    StringToUnsigned(volatile unsigned char *StringPointer, unsigned int *Result)
+{
+    unsigned int CharValue;
+    unsigned int Value = 0;
+    
+    //test for empty string
+    if(*StringPointer == (unsigned char)NULL)
+    {
+        return NO_DATA;
+    }
+    
     while(*StringPointer != (unsigned char)NULL)
     {
+        //test for a character that is not a digit
+        if(*StringPointer < '0' || *StringPointer > '9')
+        {
+            return INVALID_STRING;
+        }
         //convert string from ASCII character to decimal 
-        //note that string should only contain ASCII characters
-        CharValue = (unsigned int)*StringPointer - 0x30; //cast is used to stop warning from compiler since number should never go negative
+        CharValue = (unsigned int)*StringPointer - ASCII_NUMBER_OFFSET;
+        //test for the next digit taking the value past 65535
+        if(Value > 0xFFFF / 10 || (Value == 0xFFFF / 10 && CharValue > 0xFFFF % 10))
+        {
+            return VALUE_TOO_LARGE;
+        }
         //multiply and add
-        Result = (Result * 10) + CharValue;
+        Value = (Value * 10) + CharValue;
         //increment the pointer
         StringPointer++;
     }
     
-    return Result;
+    *Result = Value;
+    return STRING_OK;
+}
+
+
+
+//***************************************************************
+//Convert the passed decimal string into a scaled integer
+//the result is the value multiplied by 10 to the power Decimals
+//e.g. "12.5" with 2 decimals gives 1250, "-0.05" gives -5
+//more fraction digits than Decimals is an invalid string
+//returns STRING_OK, NO_DATA, INVALID_STRING or VALUE_TOO_LARGE
+//the result is only written if the string is valid
+
+unsigned int    StringToFixed(volatile unsigned char *StringPointer, unsigned int Decimals, signed long *Result)
+{
+    unsigned long Value = 0;
+    unsigned int Negative = 0;
+    unsigned int DecimalPoint = 0;
+    unsigned int Digits = 0;
+    unsigned int FractionDigits = 0;
+    unsigned int CharValue;
+    
+    //test for minus sign
+    if(*StringPointer == '-')
+    {
+        Negative = 1;
+        StringPointer++;
+    }
+    
+    //read digits then add zeros for any fraction digits not entered
+    while(*StringPointer != (unsigned char)NULL || FractionDigits < Decimals)
+    {
+        if(*StringPointer == (unsigned char)NULL)
+        {
+            //pad the fraction
+            CharValue = 0;
+            FractionDigits++;
+        }
+        else if(*StringPointer == '.')
+        {
+            //test for more than one decimal point
+            if(DecimalPoint != 0)
+            {
+                return INVALID_STRING;
+            }
+            DecimalPoint = 1;
+            StringPointer++;
+            continue;
+        }
+        else if(*StringPointer >= '0' && *StringPointer <= '9')
+        {
+            CharValue = (unsigned int)*StringPointer - ASCII_NUMBER_OFFSET;
+            Digits++;
+            if(DecimalPoint != 0)
+            {
+                //test for more resolution than the result holds
+                if(FractionDigits >= Decimals)
+                {
+                    return INVALID_STRING;
+                }
+                FractionDigits++;
+            }
+            StringPointer++;
+        }
+        else
+        {
+            return INVALID_STRING;
+        }
+        
+        //test for the next digit overflowing, negative values may be one larger
+        if(Value > FIXED_MAXIMUM / 10 || (Value == FIXED_MAXIMUM / 10 && CharValue > (FIXED_MAXIMUM % 10) + Negative))
+        {
+            return VALUE_TOO_LARGE;
+        }
+        //multiply and add
+        Value = (Value * 10) + CharValue;
+    }
+    
+    //test for no digits entered
+    if(Digits == 0)
+    {
+        return NO_DATA;
+    }
+    
+    if(Negative != 0)
+    {
+        *Result = (signed long)(0 - Value);
+    }
+    else
+    {
+        *Result = (signed long)Value;
+    }
+    return STRING_OK;
 }
 
 
@@ -145,10 +441,10 @@ unsigned int    StringToInteger(volatile unsigned char *StringPointer)
 
 void    BinaryToResultString(unsigned int ByteLength, volatile unsigned char *ResultString, unsigned int Value)
 {
-    unsigned int Index = 0;
     unsigned int Loop;
     unsigned int LoopLength;
     unsigned int Mask;
+    unsigned int GroupCount;
 
     //terminate string
     *ResultString = (unsigned char)NULL;
@@ -173,6 +469,7 @@ void    BinaryToResultString(unsigned int ByteLength, volatile unsigned char *Re
         LoopLength = 16;
     }
     //loop for all 16 bits of integer
+    GroupCount = 4;
     for(Loop = 0; Loop < LoopLength; Loop++)
     {
         //test status of highest bit
@@ -186,19 +483,19 @@ void    BinaryToResultString(unsigned int ByteLength, volatile unsigned char *Re
             //bit is a 1
             *ResultString = '1';
         }
+        //increment pointer
+        ResultString++;
         //insert a space every 4 bits
-        //correct for zero start point
-        if((Loop + 1) %4 == 0)
+        GroupCount--;
+        if(GroupCount == 0)
         {
-            //increment index
-            ResultString++;
             //add a space to the string
             *ResultString = ' ';
+            ResultString++;
+            GroupCount = 4;
         }
         //shift left to get next highest bit
         Value = Value << 1;
-        //increment index
-        ResultString++;
     }
     //terminate the string
     *ResultString = (unsigned char)NULL;
@@ -217,17 +514,12 @@ unsigned int GetChar()
     unsigned int ReturnValue = 0xFFFF;
     
     //test for any characters in the receiver buffer
-    if (OldRxPointer != NewRxPointer)
+    if (RxTailIndex != RxHeadIndex)
     {
         //character in the buffer, return the value
-        ReturnValue = *OldRxPointer;
-        //increment the Rd pointer
-        OldRxPointer++;
-        //test for wrap around
-        if(OldRxPointer == (UART_RxBufferPointerType + BUFFER_SIZE - 1))
-        {
-            OldRxPointer = UART_RxBufferPointerType;
-        }
+        ReturnValue = UART_RxBuffer[RxTailIndex & RX_BUFFER_MASK];
+        //move the tail on, wrap around is handled by the mask
+        RxTailIndex++;
     }
     
     return ReturnValue;
@@ -238,184 +530,336 @@ unsigned int GetChar()
 
 
 //***************************************************************
-//GetString gets the entered data from the comms ending in a CR and returns an integer
-//Return error codes as necessary
-//Length of the string is passed along with string array pointer
+//StartLine prepares a line reader to collect a new string
+//Length is the maximum number of characters, Mode selects whether a
+//decimal point is accepted
 
-unsigned int    GetString(unsigned int Length, volatile unsigned char *RxString)
+void    StartLine(LINE_READER *Line, volatile unsigned char *RxString, unsigned int Length, unsigned int Mode)
 {
-    //declare variables
-    unsigned int RxChar;
-    unsigned int CharCounter = 0;
-    unsigned int ReturnValue = STRING_OK;
+    Line->String = RxString;
+    Line->MaxLength = (unsigned char)Length;
+    Line->Mode = (unsigned char)Mode;
+    Line->Count = 0;
+    Line->Excess = 0;
+    Line->DecimalPoints = 0;
     
     //null the receiver string
     *RxString = (unsigned char)NULL;
+}
+
+
+
+//***************************************************************
+//ReadLine takes any characters waiting in the comms buffer and adds them
+//to the line. It never waits for a character, and leaves characters in
+//the receive buffer while the transmit buffer has no room for their echo.
+//Returns LINE_PENDING until a CR is received then the string status
+//i.e. STRING_OK or the error code as necessary
+//Backspace or delete removes the last character
+
+unsigned int    ReadLine(LINE_READER *Line)
+{
+    //declare variables
+    unsigned int RxChar;
+    unsigned int ReturnValue = LINE_PENDING;
     
-    //get the string but test for master time out
-    while(GLOBAL_MasterTimeOutFlag == 0)
+    //process characters until the buffer is empty or the line is finished
+    while(ReturnValue == LINE_PENDING)
     {
+        //test for overriding timeout
+        if(GLOBAL_MasterTimeOutFlag == 1)
+        {
+            ReturnValue = TIME_OUT;
+            break;
+        }
+        
+        //leave the characters received until their echo can be sent
+        if(GetTxSpace() < LINE_ECHO_SPACE)
+        {
+            break;
+        }
+        
         //check comms buffer for character
         RxChar = GetChar();
+        if(RxChar == 0xFFFF)
+        {
+            //no more characters yet
+            break;
+        }
         
-        if(RxChar != 0xFFFF)
+        //binary frames are recognised by their sync byte and handled here
+        if(ProtocolReceiveByte((unsigned char)RxChar) == 0)
         {
-            //character received 
             //test for termination character
             if((unsigned char)RxChar == '\r')
             {
-                break;
+                ReturnValue = STRING_OK;
+                //test for string too long
+                if(Line->Excess != 0)
+                {
+                    ReturnValue = TOO_LONG;
+                }
+                //test for no data entered
+                if(Line->Count == 0 && Line->Excess == 0)
+                {
+                    ReturnValue = NO_DATA;
+                }
+                //test for too many decimal points
+                if(Line->DecimalPoints > 1)
+                {
+                    ReturnValue = INVALID_STRING;
+                }
             }
-            else
+            else if((unsigned char)RxChar == '\b' || (unsigned char)RxChar == 0x7F)
             {
-                if(RxChar >= '0' && RxChar <= '9')
+                //backspace, remove the rejected characters first
+                if(Line->Excess != 0)
                 {
-                    //set return value to signify one or more characters
-                    ReturnValue = 0;
-                    //test for string less than length
-                    if(CharCounter < Length)
+                    Line->Excess--;
+                    SendMessage(BackspaceMessage);
+                }
+                else if(Line->Count != 0)
+                {
+                    Line->Count--;
+                    if(Line->String[Line->Count] == '.')
                     {
-                        //echo character
-                        SendChar(RxChar);
-                        //save the character in the array
-                        *RxString = (unsigned char)RxChar;
-                        //increment the pointer to the array
-                        RxString++;
-                        //null the end of the string
-                        *RxString = (unsigned char)NULL;
-                        //increment the character counter
-                        CharCounter++;
+                        Line->DecimalPoints--;
                     }
-                    else
+                    //null the end of the string
+                    Line->String[Line->Count] = (unsigned char)NULL;
+                    SendMessage(BackspaceMessage);
+                }
+            }
+            else if((RxChar >= '0' && RxChar <= '9') || (RxChar == '.' && Line->Mode == LINE_DECIMAL) ||
+                    (RxChar == '-' && Line->Mode == LINE_DECIMAL && Line->Count == 0))
+            {
+                //test for string less than length
+                if(Line->Count < Line->MaxLength && Line->Excess == 0)
+                {
+                    //test for multiple decimal places
+                    if(RxChar == '.')
                     {
-                        //string too long
-                        //echo 'X'character
-                        SendChar('X');
-                        //set status to 'too long'
-                        ReturnValue = TOO_LONG;
+                        Line->DecimalPoints++;
                     }
+                    //echo character
+                    SendChar(RxChar);
+                    //save the character in the array and null the end of the string
+                    Line->String[Line->Count] = (unsigned char)RxChar;
+                    Line->Count++;
+                    Line->String[Line->Count] = (unsigned char)NULL;
+                }
+                else
+                {
+                    //string too long
+                    //echo 'X'character
+                    SendChar('X');
+                    Line->Excess++;
                 }
             }
-        } 
+            //all other characters are ignored
+        }
     }
-    //test for no data entered
-    if(CharCounter == 0)
+    
+    //return line status
+    return ReturnValue;
+}
+
+
+
+//***************************************************************
+//places a single character in the transmit buffer
+//returns TX_QUEUE_FULL without waiting if there is no room
+
+unsigned int    QueueChar(unsigned char Value)
+{
+    unsigned char Used;
+    
+    //get the number of characters waiting to be sent
+    Used = (unsigned char)(TxHeadIndex - TxTailIndex);
+    if(Used >= TX_BUFFER_SIZE)
     {
-        ReturnValue = NO_DATA;
+        return TX_QUEUE_FULL;
     }
-    //test for overriding timeout
-    if(GLOBAL_MasterTimeOutFlag == 1)
+    //save the character and move the head on
+    UART_TxBuffer[TxHeadIndex & TX_BUFFER_MASK] = Value;
+    TxHeadIndex++;
+    //record the buffer high water mark
+    Used++;
+    if(Used > TxHighWaterMark)
     {
-        ReturnValue = TIME_OUT;
+        TxHighWaterMark = Used;
     }
-    //return error value
-    return ReturnValue;
+    //the interrupt routine sends the character
+    UART_INTERRUPT_TX_ENABLE = INTERRUPT_ENABLED;
+    
+    return TX_QUEUE_OK;
 }
 
 
+
 //***************************************************************
-//GetFloatString gets the entered data from the comms ending in a CR
-//Return error codes as necessary
-//Length of the maximum string is passed along with the pointer to the string array
+//places the passed array string from code memory in the transmit buffer
+//the whole string is queued or, if it does not fit, none of it
 
-unsigned int    GetFloatString(unsigned int Length, volatile unsigned char *RxString)
+unsigned int    QueueMessage(const unsigned char *StringPointer)
 {
-    //declare variables
-    unsigned int RxChar;
-    unsigned int CharCounter = 0;
-    unsigned int ReturnValue = STRING_OK;
-    unsigned int DecimalPointCounter = 0;
+    const unsigned char *EndPointer = StringPointer;
     
-    //null the receiver string
-    *RxString = (unsigned char)NULL;
+    //find the string length
+    while(*EndPointer != (unsigned char)NULL)
+    {
+        EndPointer++;
+    }
+    //test for room in the buffer
+    if((unsigned int)(EndPointer - StringPointer) > (TX_BUFFER_SIZE - (unsigned char)(TxHeadIndex - TxTailIndex)))
+    {
+        return TX_QUEUE_FULL;
+    }
+    //queue the string
+    while(StringPointer != EndPointer)
+    {
+        QueueChar(*StringPointer);
+        StringPointer++;
+    }
+    
+    return TX_QUEUE_OK;
+}
+
+
+
+//***************************************************************
+//places the passed array string from ram in the transmit buffer
+//the whole string is queued or, if it does not fit, none of it
+
+unsigned int    QueueString(volatile unsigned char *StringPointer)
+{
+    volatile unsigned char *EndPointer = StringPointer;
     
-    //get the string but test for master time out
-    while(GLOBAL_MasterTimeOutFlag == 0)
+    //find the string length
+    while(*EndPointer != (unsigned char)NULL)
     {
-        //check comms buffer for character
-        RxChar = GetChar();
-        if(RxChar != 0xFFFF)
-        {
-            //character received 
-            //test for termination character
-            if((unsigned char)RxChar == '\r')
-            {
-                break;
-            }
-            else
-            {
-                if((RxChar >= '0' && RxChar <= '9') || RxChar == '.')
-                {
-                    //test for multiple decimal places
-                    if(RxChar == '.')
-                    {
-                        //increment decimal point counter
-                        DecimalPointCounter++;
-                    }
-                    //set return value to signify one or more characters
-                    ReturnValue = 0;
-                    //test for string less than length
-                    if(CharCounter < Length)
-                    {
-                        //echo character
-                        SendChar(RxChar);
-                        //save the character in the array
-                        *RxString = (unsigned char)RxChar;
-                        //increment the pointer to the array
-                        RxString++;
-                        //null the end of the string
-                        *RxString = (unsigned char)NULL;
-                        //increment the character counter
-                        CharCounter++;
-                    }
-                    else
-                    {
-                        //string too long
-                        //echo 'X'character
-                        SendChar('X');
-                        //set status to 'too long'
-                        ReturnValue = TOO_LONG;
-                    }
-                }
-            }
-        } 
+        EndPointer++;
     }
-    //test for no data entered
-    if(CharCounter == 0)
+    //test for room in the buffer
+    if((unsigned int)(EndPointer - StringPointer) > (TX_BUFFER_SIZE - (unsigned char)(TxHeadIndex - TxTailIndex)))
     {
-        ReturnValue = NO_DATA;
+        return TX_QUEUE_FULL;
     }
-    //test for too many decimal points
-    if(DecimalPointCounter > 1)
+    //queue the string
+    while(StringPointer != EndPointer)
     {
-        ReturnValue = INVALID_STRING;
+        QueueChar(*StringPointer);
+        StringPointer++;
     }
-    //test for overriding timeout
-    if(GLOBAL_MasterTimeOutFlag == 1)
+    
+    return TX_QUEUE_OK;
+}
+
+
+
+//***************************************************************
+//return the number of characters that can be queued without waiting
+
+unsigned int    GetTxSpace(void)
+{
+    return TX_BUFFER_SIZE - (unsigned char)(TxHeadIndex - TxTailIndex);
+}
+
+
+
+//***************************************************************
+//return the greatest number of characters held in the transmit buffer
+
+unsigned int    GetTxHighWaterMark(void)
+{
+    return TxHighWaterMark;
+}
+
+//return the number of sends that found the transmit buffer full and
+//waited, the menus check for room first so this stays at 0
+unsigned int    GetTxWaitCount(void)
+{
+    return TxWaitCount;
+}
+
+
+
+//***************************************************************
+//receiver error counters
+
+unsigned int    GetRxDroppedCount(void)
+{
+    return RxDroppedCount;
+}
+
+unsigned int    GetRxOverrunCount(void)
+{
+    return RxOverrunCount;
+}
+
+unsigned int    GetRxFrameErrorCount(void)
+{
+    return RxFrameErrorCount;
+}
+
+
+
+//***************************************************************
+//clear the receiver error counters and transmit high water mark
+
+void    ClearCommsCounters(void)
+{
+    //counters are written by the interrupt so disable it while clearing
+    PIE1bits.RCIE = 0;
+    RxDroppedCount = 0;
+    RxOverrunCount = 0;
+    RxFrameErrorCount = 0;
+    TxHighWaterMark = 0;
+    TxWaitCount = 0;
+    PIE1bits.RCIE = 1;
+}
+
+
+
+//***************************************************************
+//wait for room in the transmit buffer
+//if interrupts are not yet enabled the buffer is emptied here instead
+
+static void    WaitForTxSpace(void)
+{
+    if((unsigned char)(TxHeadIndex - TxTailIndex) >= TX_BUFFER_SIZE && TxWaitCount != 0xFFFF)
     {
-        ReturnValue = TIME_OUT;
+        TxWaitCount++;
+    }
+    while((unsigned char)(TxHeadIndex - TxTailIndex) >= TX_BUFFER_SIZE)
+    {
+        if(INTCONbits.GIE == 0 && TX_BUFFER_STATUS != 0)
+        {
+            TXREG = UART_TxBuffer[TxTailIndex & TX_BUFFER_MASK];
+            TxTailIndex++;
+        }
     }
-    //return error value
-    return ReturnValue;
 }
 
 
 
 //***************************************************************
 //writes the single character to the UART
+//only waits if the transmit buffer is full
 
 void    SendChar(unsigned int Value)
 {
-    //wait for TX buffer to be clear
-    while(TX_BUFFER_STATUS == 0);
-    //transmit character
-    TXREG = (unsigned char)Value;    //note that TXREG is byte width
+    //wait for room in the TX buffer
+    WaitForTxSpace();
+    //queue character
+    QueueChar((unsigned char)Value);    //note that TXREG is byte width
 }
 
 
 
 //***************************************************************
 //writes the passed array string from code memory to the UART
+//only waits if the transmit buffer is full
 
 void    SendMessage(const unsigned char *StringPointer)
 {
@@ -423,30 +867,27 @@ void    SendMessage(const unsigned char *StringPointer)
     //test for end of string
     while(*StringPointer != (unsigned char)NULL)
     {
-        //can a character be loaded
-        if(TX_BUFFER_STATUS != 0)
-        {
-            TXREG = *StringPointer;
-            StringPointer++;
-        }
+        //wait for room in the TX buffer
+        WaitForTxSpace();
+        QueueChar(*StringPointer);
+        StringPointer++;
     }
 }
 
 
 //***************************************************************
 //writes the passed array string from ram to the UART
+//only waits if the transmit buffer is full
 
 void    SendString(volatile unsigned char *StringPointer)
 {
     //test for end of string
     while(*StringPointer != (unsigned char)NULL)
     {
-        //can a character be loaded
-        if(TX_BUFFER_STATUS != 0)
-        {
-            TXREG = *StringPointer;
-            StringPointer++;
-        }
+        //wait for room in the TX buffer
+        WaitForTxSpace();
+        QueueChar(*StringPointer);
+        StringPointer++;
     }
 }
 
@@ -458,22 +899,68 @@ void    SendString(volatile unsigned char *StringPointer)
 void __interrupt () HIGH_ISR(void)
 {
     //declare variables
+    unsigned char RxChar;
     
     //test for UART receiver interrupt source
-    if(UART_INTERRUPT_RX_FLAG)
+    //the receiver FIFO is two characters deep so empty it completely
+    //the flag is cleared by reading RCREG
+    while(UART_INTERRUPT_RX_FLAG)
     {
-        //save character in buffer using pointers
-        *NewRxPointer = RCREG;
-        //increment pointer
-        NewRxPointer++;
-        //test for wrap around
-        if(NewRxPointer == (UART_RxBufferPointerType + BUFFER_SIZE - 1))
+        //test for framing error, this belongs to the character about to be read
+        if(UART_FRAME_ERROR)
+        {
+            //discard the character
+            RxChar = RCREG;
+            RxFrameErrorCount++;
+        }
+        else
+        {
+            RxChar = RCREG;
+            //test for room in the buffer
+            if((unsigned char)(RxHeadIndex - RxTailIndex) < RX_BUFFER_SIZE)
+            {
+                //save character in buffer
+                UART_RxBuffer[RxHeadIndex & RX_BUFFER_MASK] = RxChar;
+                RxHeadIndex++;
+                SchedulerInterruptSignal(EVENT_RX);
+            }
+            else
+            {
+                //buffer full, unread characters are kept
+                RxDroppedCount++;
+            }
+        }
+    }
+    //test for overrun, the receiver stops until it is reset
+    if(UART_OVERRUN_ERROR)
+    {
+        RC1STAbits.CREN = 0;
+        RC1STAbits.CREN = 1;
+        RxOverrunCount++;
+    }
+    
+    //test for UART transmitter ready for the next character
+    //TXIF is always set when TXREG is empty so only act on it when enabled
+    if(UART_INTERRUPT_TX_ENABLE && UART_INTERRUPT_TX_FLAG)
+    {
+        if(TxTailIndex != TxHeadIndex)
+        {
+            //load next character, this clears the interrupt flag
+            TXREG = UART_TxBuffer[TxTailIndex & TX_BUFFER_MASK];
+            TxTailIndex++;
+        }
+        else
         {
-            //re-initialise the array pointer
-            NewRxPointer = UART_RxBufferPointerType;
+            //buffer empty, stop transmitter interrupts
+            UART_INTERRUPT_TX_ENABLE = INTERRUPT_DISABLED;
         }
-        //clear interrupt flag
-        UART_INTERRUPT_RX_FLAG = 0;
+    }
+    
+
+    //test for SPI byte exchanged, only acted on while the queue is running
+    if(SPI_INTERRUPT_ENABLE && SPI_INTERRUPT_FLAG)
+    {
+        SPI_InterruptService();
     }
     
 
@@ -490,20 +977,32 @@ void __interrupt () HIGH_ISR(void)
     
 
     //test for updating stepper motor speed and stepping motor
-    if(TIMER_3_INTERRUPT_FLAG)
+    //the interval of each step comes from the acceleration profile
+    if(TIMER_3_INTERRUPT_ENABLE && TIMER_3_INTERRUPT_FLAG)
     {
-        TIMER_3_INTERRUPT_FLAG = CLEAR_FLAG;
-        //load new PWM pulse time value
-        TIMER_3_TIME = -GLOBAL_StepperMotorSpeed;
-        //toggle DRV8711 step signal
-        if(DRV8711_STEP_READ_LATCH == 0)
-        {
-           DRV8711_STEP_WRITE = 1; 
-        }
-        else
-        {
-           DRV8711_STEP_WRITE = 0;
-        }
+        MotionStepInterrupt();
+    }
+    
+    //test for the end of a block of cruise steps made by PWM11 or
+    //for the pulse after a stop request
+    if((TIMER_5_INTERRUPT_ENABLE && TIMER_5_INTERRUPT_FLAG) || (STEP_PWM_PHASE_INTERRUPT_ENABLE && STEP_PWM_PHASE_INTERRUPT_FLAG))
+    {
+        MotionCruiseInterrupt();
+    }
+    
+    //test for an endstop switch closing, the position is latched here
+    if(IOC_INTERRUPT_ENABLE && IOC_INTERRUPT_FLAG)
+    {
+        EndstopInterrupt();
+    }
+    
+    //test for the input sample period, the buttons are debounced here
+    //and every 4th sample is the 1 ms tick
+    if(TIMER_6_INTERRUPT_ENABLE && TIMER_6_INTERRUPT_FLAG)
+    {
+        TIMER_6_INTERRUPT_FLAG = CLEAR_FLAG;
+        ButtonInterrupt();
+        SoftTimerInterrupt();
     }
     
     
@@ -513,6 +1012,8 @@ void __interrupt () HIGH_ISR(void)
     {
         PERIPHERAL_PWM5_INTERRUPT_FLAG = CLEAR_FLAG;
         PWM5_INTERRUPT_FLAG = 0b0;
+        //move the doors on, this also sets the PWM6 pulse time
+        DoorInterrupt();
         //load new PWM pulse time value
         PWM5DC = GLOBAL_PWM3_PulseTime;
         //load new data 
@@ -17,10 +17,18 @@
 #define UART_FRAME_ERROR            RCSTAbits.FERR
 #define UART_OVERRUN_ERROR          RCSTAbits.OERR
 #define UART_INTERRUPT_RX_FLAG      PIR1bits.RCIF
+#define UART_INTERRUPT_TX_FLAG      PIR1bits.TXIF
+#define UART_INTERRUPT_TX_ENABLE    PIE1bits.TXIE
 #define TX_BUFFER_STATUS            TXSTAbits.TRMT
+#define UART_BAUD_16BIT             BAUD1CONbits.BRG16
+#define UART_BAUD_HIGH_SPEED        TX1STAbits.BRGH
 
 //define comms constants
-#define BUFFER_SIZE                 20      //cyclic buffer is 20 bytes long
+#define RX_BUFFER_SIZE              32      //receive cyclic buffer length, must be a power of 2
+#define RX_BUFFER_MASK              (RX_BUFFER_SIZE - 1)
+#define TX_BUFFER_SIZE              64      //transmit cyclic buffer length, must be a power of 2
+#define TX_BUFFER_MASK              (TX_BUFFER_SIZE - 1)
+#define LINE_ECHO_SPACE             12      //most one received character can send, a protocol reply frame
 #define RX_STRING_LENGTH            30      //maximum rx string length
 #define RESULT_STRING_LENGTH        30      //maximum value convertion string length
 #define ASCII_NUMBER_OFFSET         0x0030
@@ -33,18 +41,73 @@
 #define VALUE_TOO_SMALL             0xFFFA  //below minimum value
 #define STRING_OK                   0x0000  //string ok
 #define NULL                        0       //null string terminator
+#define TX_QUEUE_OK                 0x0000  //data placed in the transmit buffer
+#define TX_QUEUE_FULL               0xFFF9  //not enough room in the transmit buffer
+#define BAUD_RATE_INVALID           0xFFF8  //baud rate cannot be generated within the error limit
+#define BAUD_RATE_NOT_CONFIRMED     0xFFF7  //no handshake received at the new baud rate
+#define LINE_PENDING                0xFFF6  //line not yet terminated
+#define OUT_OF_RANGE                0xFFF5  //value outside the permitted range
+
+//define line reader modes
+#define LINE_INTEGER                0       //digits only
+#define LINE_DECIMAL                1       //leading minus sign, digits and a decimal point
+
+//define fixed point constants
+#define FIXED_MAXIMUM               0x7FFFFFFFUL    //largest scaled value StringToFixed returns
+
+//define baud rate constants
+#define DEFAULT_BAUD_RATE           9600UL
+#define BAUD_RATE_ERROR_LIMIT       200     //maximum baud rate error in 0.01% units i.e. 2%
+#define BAUD_CONFIRM_CHARACTER      'Y'     //character the host sends at the new baud rate
+#define BAUD_CONFIRM_TIME           5000    //time allowed for the handshake in ms
+#define BAUD_DIVISOR_INVALID        0xFFFF  //rate outside the baud rate generator range
+#define BAUD_ERROR_INVALID          0x7FFF  //error value for a rate that cannot be generated
+
+//define baud rate change states
+#define BAUD_CHANGE_IDLE            0
+#define BAUD_CHANGE_SENDING         1       //sending the last characters at the present rate
+#define BAUD_CHANGE_CONFIRM         2       //waiting for the confirm character at the new rate
+
+//line reader, holds the state of a string being entered
+typedef struct
+{
+    volatile unsigned char *String;
+    unsigned char MaxLength;
+    unsigned char Mode;
+    unsigned char Count;            //characters saved in the string
+    unsigned char Excess;           //characters rejected because the string was full
+    unsigned char DecimalPoints;
+} LINE_READER;
 
 //declare functions
 void    InitialiseComms (void);
+unsigned int    GetBaudDivisor(unsigned long);
+signed int      GetBaudError(unsigned long);
+unsigned int    SetBaudRate(unsigned long);
+unsigned long   GetBaudRate(void);
+unsigned int    ChangeBaudRate(unsigned long);
+unsigned int    BaudChangeService(void);
 void    DecimalToResultString(unsigned int, volatile unsigned char *, unsigned int);
 void    BinaryToResultString(unsigned int, volatile unsigned char *, unsigned int);
 unsigned int    StringToInteger(volatile unsigned char *);
+unsigned int    StringToUnsigned(volatile unsigned char *, unsigned int *);
+unsigned int    StringToFixed(volatile unsigned char *, unsigned int, signed long *);
 unsigned int    GetChar(void);
-unsigned int    GetString(unsigned int, volatile unsigned char *);
-unsigned int    GetFloatString(unsigned int, volatile unsigned char *);
+void    StartLine(LINE_READER *, volatile unsigned char *, unsigned int, unsigned int);
+unsigned int    ReadLine(LINE_READER *);
 void    SendChar(unsigned int);
 void    SendMessage(const unsigned char *);
 void    SendString(volatile unsigned char *);
+unsigned int    QueueChar(unsigned char);
+unsigned int    QueueMessage(const unsigned char *);
+unsigned int    QueueString(volatile unsigned char *);
+unsigned int    GetTxSpace(void);
+unsigned int    GetTxHighWaterMark(void);
+unsigned int    GetTxWaitCount(void);
+unsigned int    GetRxDroppedCount(void);
+unsigned int    GetRxOverrunCount(void);
+unsigned int    GetRxFrameErrorCount(void);
+void    ClearCommsCounters(void);
 void __interrupt () HIGH_ISR(void);
 
 
@@ -0,0 +1,101 @@
+/*
+ * File: Display.c
+ * Author: Roger Berry
+ * Comments: Lift floor and direction on the serial LED display
+ *           The 4 digit display is on the SPI bus with GPIO_8 as its chip
+ *           select. Every DISPLAY_REFRESH ms the text is made up from the
+ *           lift floor and direction, and only if it has changed is it
+ *           queued for the bus. The write is never waited for, one still
+ *           on the bus holds the next until the look after.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "SPI.h"
+#include "SoftTimer.h"
+#include "Lift.h"
+#include "Display.h"
+
+//define variables used in this file
+SPI_TRANSACTION DisplayTransaction;
+unsigned char DisplayText[DISPLAY_DIGITS + 1];
+unsigned char DisplayShown[DISPLAY_DIGITS + 1];     //text last sent, empty until the first write
+
+
+
+//***************************************************************
+//Start the refresh timer, call after InitialiseSPI and InitialiseSoftTimers
+
+void    InitialiseDisplay(void)
+{
+    DisplayTransaction.Status = SPI_IDLE;
+    DisplayShown[0] = 0;
+    SoftTimerStart(SOFT_TIMER_DISPLAY, DISPLAY_REFRESH, DISPLAY_REFRESH, NULL);
+}
+
+
+
+//***************************************************************
+//Show the floor, - between floors, then U or d for the direction
+
+void    DisplayService(void)
+{
+    unsigned char Floor;
+    unsigned char Index;
+    unsigned char Changed;
+
+    if(SoftTimerExpired(SOFT_TIMER_DISPLAY) == 0)
+    {
+        return;
+    }
+    if(DisplayTransaction.Status == SPI_QUEUED || DisplayTransaction.Status == SPI_ACTIVE)
+    {
+        return;
+    }
+
+    DisplayText[0] = ' ';
+    Floor = (unsigned char)LiftGetFloor();
+    if(Floor == LIFT_NO_FLOOR)
+    {
+        DisplayText[1] = '-';
+    }
+    else
+    {
+        DisplayText[1] = '1' + Floor;
+    }
+    DisplayText[2] = ' ';
+    switch(LiftGetDirection())
+    {
+        case LIFT_DIRECTION_UP:
+            DisplayText[3] = 'U';
+            break;
+        case LIFT_DIRECTION_DOWN:
+            DisplayText[3] = 'd';
+            break;
+        default:
+            DisplayText[3] = ' ';
+            break;
+    }
+    DisplayText[DISPLAY_DIGITS] = 0;
+
+    Changed = 0;
+    for(Index = 0; Index < DISPLAY_DIGITS; Index++)
+    {
+        if(DisplayText[Index] != DisplayShown[Index])
+        {
+            Changed = 1;
+        }
+    }
+    if(Changed == 0)
+    {
+        return;
+    }
+    QueueLED_Display(&DisplayTransaction, LED_DISPLAY_CURSOR_CONTROL, DisplayText, 0);
+    if(QueueSPI(&DisplayTransaction) == SPI_QUEUE_OK)
+    {
+        for(Index = 0; Index <= DISPLAY_DIGITS; Index++)
+        {
+            DisplayShown[Index] = DisplayText[Index];
+        }
+    }
+}
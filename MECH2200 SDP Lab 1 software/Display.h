@@ -0,0 +1,26 @@
+/*
+ * File: Display.h
+ * Author: Roger Berry
+ * Comments: Lift floor and direction on the serial LED display
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef DISPLAY_H
+#define	DISPLAY_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define display constants
+#define DISPLAY_DIGITS              4
+#define DISPLAY_REFRESH             100         //ms between looks for a change
+
+//declare functions
+void    InitialiseDisplay(void);
+void    DisplayService(void);
+
+
+
+#endif	/* DISPLAY_H */
+
@@ -0,0 +1,180 @@
+/*
+ * File: Door.c
+ * Author: Roger Berry
+ * Comments: Lift doors moved by two servos on the 16 bit PWMs
+ *           The doors are two panels that part in the middle, each on a
+ *           servo driven from PWM5 and PWM6 with a 20 ms period. The servos
+ *           face each other so the PWM6 pulse width is the PWM5 one
+ *           mirrored about the middle of the travel. Rather than jump to the
+ *           new pulse width, which slams the doors, the PWM5 period
+ *           interrupt moves the pulse width a set amount towards the open
+ *           or closed width each period, so the doors open and close at a
+ *           steady speed. Closing is slower than opening as a default.
+ *           The main loop only writes the state, one byte, to start the
+ *           doors moving. The interrupt writes the state again once the
+ *           doors reach the end of their travel.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Door.h"
+
+//define external global variables
+extern  volatile unsigned int GLOBAL_PWM3_PulseTime;
+extern  volatile unsigned int GLOBAL_PWM4_PulseTime;
+
+//define variables used in this file
+volatile unsigned char DoorRunState = DOOR_CLOSED;
+unsigned int DoorOpenRate = DEFAULT_DOOR_OPEN_RATE;         //us per period
+unsigned int DoorCloseRate = DEFAULT_DOOR_CLOSE_RATE;
+unsigned int DoorDwell = DEFAULT_DOOR_DWELL;                //ms
+
+
+
+//***************************************************************
+//Set the doors closed, call after InitialisePWM_16Bit
+//the servos go straight to the closed position at start up
+
+void    InitialiseDoor(void)
+{
+    GLOBAL_PWM3_PulseTime = DOOR_CLOSED_PULSE;
+    GLOBAL_PWM4_PulseTime = DOOR_MIRROR_PULSE - DOOR_CLOSED_PULSE;
+    DoorRunState = DOOR_CLOSED;
+}
+
+
+
+//***************************************************************
+//Move the doors one step towards the end of their travel, called from
+//HIGH_ISR at the start of each PWM5 period before the pulse width is loaded
+
+void    DoorInterrupt(void)
+{
+    unsigned int Pulse;
+
+    Pulse = GLOBAL_PWM3_PulseTime;
+    if(DoorRunState == DOOR_OPENING)
+    {
+        if(DOOR_OPEN_PULSE - Pulse > DoorOpenRate)
+        {
+            Pulse = Pulse + DoorOpenRate;
+        }
+        else
+        {
+            Pulse = DOOR_OPEN_PULSE;
+            DoorRunState = DOOR_OPEN;
+        }
+    }
+    else if(DoorRunState == DOOR_CLOSING)
+    {
+        if(Pulse - DOOR_CLOSED_PULSE > DoorCloseRate)
+        {
+            Pulse = Pulse - DoorCloseRate;
+        }
+        else
+        {
+            Pulse = DOOR_CLOSED_PULSE;
+            DoorRunState = DOOR_CLOSED;
+        }
+    }
+    else
+    {
+        return;
+    }
+    GLOBAL_PWM3_PulseTime = Pulse;
+    GLOBAL_PWM4_PulseTime = DOOR_MIRROR_PULSE - Pulse;
+}
+
+
+
+//***************************************************************
+//Start the doors opening or closing, doors part way are turned round
+
+void    DoorOpen(void)
+{
+    if(DoorRunState != DOOR_OPEN)
+    {
+        DoorRunState = DOOR_OPENING;
+    }
+}
+
+void    DoorClose(void)
+{
+    if(DoorRunState != DOOR_CLOSED)
+    {
+        DoorRunState = DOOR_CLOSING;
+    }
+}
+
+
+
+//***************************************************************
+//Get the door state, DOOR_CLOSED, DOOR_OPENING, DOOR_OPEN or DOOR_CLOSING
+
+unsigned int    DoorState(void)
+{
+    return DoorRunState;
+}
+
+
+
+//***************************************************************
+//Test for the doors at the end of their travel, returns 1 if so
+
+unsigned int    DoorIsOpen(void)
+{
+    return DoorRunState == DOOR_OPEN;
+}
+
+unsigned int    DoorIsClosed(void)
+{
+    return DoorRunState == DOOR_CLOSED;
+}
+
+
+
+//***************************************************************
+//Set the open and close speeds in us of pulse width per 20 ms period
+//returns DOOR_OK or DOOR_INVALID_SETTING
+
+unsigned int    DoorSetSpeed(unsigned int OpenRate, unsigned int CloseRate)
+{
+    unsigned char InterruptEnable;
+
+    if(OpenRate == 0 || OpenRate > DOOR_MAX_RATE || CloseRate == 0 || CloseRate > DOOR_MAX_RATE)
+    {
+        return DOOR_INVALID_SETTING;
+    }
+    //the interrupt must not read a rate half written
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    DoorOpenRate = OpenRate;
+    DoorCloseRate = CloseRate;
+    INTCONbits.GIE = InterruptEnable;
+    return DOOR_OK;
+}
+
+unsigned int    DoorGetOpenRate(void)
+{
+    return DoorOpenRate;
+}
+
+unsigned int    DoorGetCloseRate(void)
+{
+    return DoorCloseRate;
+}
+
+
+
+//***************************************************************
+//Set the time in ms the doors are held open at a floor
+
+void    DoorSetDwell(unsigned int Dwell)
+{
+    DoorDwell = Dwell;
+}
+
+unsigned int    DoorGetDwell(void)
+{
+    return DoorDwell;
+}
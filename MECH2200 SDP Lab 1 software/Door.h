@@ -0,0 +1,54 @@
+/*
+ * File: Door.h
+ * Author: Roger Berry
+ * Comments: Lift doors moved by two servos on the 16 bit PWMs
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef DOOR_H
+#define	DOOR_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define servo pulse widths in us for the PWM5 door, PWM6 is mirrored
+#define DOOR_CLOSED_PULSE           1000
+#define DOOR_OPEN_PULSE             2000
+#define DOOR_MIRROR_PULSE           (DOOR_CLOSED_PULSE + DOOR_OPEN_PULSE)
+
+//define default door settings
+#define DOOR_PERIOD                 20          //ms between pulse width changes, the PWM5 period
+#define DEFAULT_DOOR_OPEN_RATE      20          //us per period, 1 s to open
+#define DEFAULT_DOOR_CLOSE_RATE     10          //us per period, 2 s to close
+#define DEFAULT_DOOR_DWELL          3000        //ms held open at a floor
+#define DOOR_MAX_RATE               (DOOR_OPEN_PULSE - DOOR_CLOSED_PULSE)
+
+//define door states
+#define DOOR_CLOSED                 0
+#define DOOR_OPENING                1
+#define DOOR_OPEN                   2
+#define DOOR_CLOSING                3
+
+//define door status
+#define DOOR_OK                     0x0000
+#define DOOR_INVALID_SETTING        0x0001  //rate of 0 or more than the full travel
+
+//declare functions
+void    InitialiseDoor(void);
+void    DoorInterrupt(void);
+void    DoorOpen(void);
+void    DoorClose(void);
+unsigned int    DoorState(void);
+unsigned int    DoorIsOpen(void);
+unsigned int    DoorIsClosed(void);
+unsigned int    DoorSetSpeed(unsigned int, unsigned int);
+unsigned int    DoorGetOpenRate(void);
+unsigned int    DoorGetCloseRate(void);
+void    DoorSetDwell(unsigned int);
+unsigned int    DoorGetDwell(void);
+
+
+
+#endif	/* DOOR_H */
+
@@ -0,0 +1,123 @@
+/*
+ * File: Flash.c
+ * Author: Roger Berry
+ * Comments: High endurance flash rows read and written a byte per word
+ *           The PIC16F1779 has 4 rows of 32 words at the top of program
+ *           memory rated for 100k erase cycles. Only the low byte of each
+ *           word is used. A row is erased and then all 32 write latches
+ *           are loaded and written at once. The CPU stalls for about 2 ms
+ *           during each erase and each write, no interrupt is serviced, so
+ *           rows must only be written with the motor stopped.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Flash.h"
+
+
+
+//***************************************************************
+//Send the unlock sequence and start the erase or write set up in PMCON1
+//the sequence must not be interrupted
+
+static void    FlashUnlock(void)
+{
+    unsigned char InterruptEnable;
+
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    PMCON2 = 0x55;
+    PMCON2 = 0xAA;
+    PMCON1bits.WR = 1;
+    NOP();
+    NOP();
+    INTCONbits.GIE = InterruptEnable;
+}
+
+
+
+//***************************************************************
+//Read the low byte of the program memory word at the passed address
+
+unsigned char   FlashReadByte(unsigned int Address)
+{
+    PMADRL = (unsigned char)Address;
+    PMADRH = (unsigned char)(Address >> 8);
+    PMCON1bits.CFGS = 0;
+    PMCON1bits.RD = 1;
+    NOP();
+    NOP();
+    return PMDATL;
+}
+
+
+
+//***************************************************************
+//Read Count bytes from consecutive words starting at the passed address
+
+void    FlashReadRow(unsigned int Address, unsigned char *Buffer, unsigned int Count)
+{
+    unsigned int Index;
+
+    for(Index = 0; Index < Count; Index++)
+    {
+        Buffer[Index] = FlashReadByte(Address + Index);
+    }
+}
+
+
+
+//***************************************************************
+//Erase the row at the passed address and write Count bytes to it
+//the rest of the row is left erased. The row is read back to check it
+//returns FLASH_OK, FLASH_INVALID_ROW or FLASH_WRITE_ERROR
+
+unsigned int    FlashWriteRow(unsigned int Address, const unsigned char *Buffer, unsigned int Count)
+{
+    unsigned int Index;
+
+    if((Address & (HEF_ROW_SIZE - 1)) != 0 || Address < HEF_START || Count > HEF_ROW_SIZE)
+    {
+        return FLASH_INVALID_ROW;
+    }
+
+    //erase the row
+    PMADRL = (unsigned char)Address;
+    PMADRH = (unsigned char)(Address >> 8);
+    PMCON1bits.CFGS = 0;
+    PMCON1bits.FREE = 1;
+    PMCON1bits.WREN = 1;
+    FlashUnlock();
+    PMCON1bits.FREE = 0;
+
+    //load the latches, the row is written with the last word
+    PMCON1bits.LWLO = 1;
+    for(Index = 0; Index < Count; Index++)
+    {
+        PMADRL = (unsigned char)(Address + Index);
+        PMDATL = Buffer[Index];
+        PMDATH = HEF_RETLW;
+        if(Index == Count - 1)
+        {
+            PMCON1bits.LWLO = 0;
+        }
+        FlashUnlock();
+    }
+    PMCON1bits.LWLO = 0;
+    PMCON1bits.WREN = 0;
+    if(PMCON1bits.WRERR)
+    {
+        PMCON1bits.WRERR = 0;
+        return FLASH_WRITE_ERROR;
+    }
+
+    //check the row
+    for(Index = 0; Index < Count; Index++)
+    {
+        if(FlashReadByte(Address + Index) != Buffer[Index])
+        {
+            return FLASH_WRITE_ERROR;
+        }
+    }
+    return FLASH_OK;
+}
@@ -0,0 +1,36 @@
+/*
+ * File: Flash.h
+ * Author: Roger Berry
+ * Comments: High endurance flash rows read and written a byte per word
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef FLASH_H
+#define	FLASH_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define high endurance flash, the last 128 words of program memory
+//the range is kept out of the linker with -mrom=default,-3f80-3fff
+#define HEF_START                   0x3F80
+#define HEF_ROW_SIZE                32          //words erased and written together
+#define HEF_ROW_COUNT               4           //power of 2
+#define HEF_ROW_MASK                (HEF_ROW_COUNT - 1)
+#define HEF_RETLW                   0x34        //high byte written, each word reads back as RETLW byte
+
+//define flash status
+#define FLASH_OK                    0x0000
+#define FLASH_WRITE_ERROR           0x0001  //WRERR set or the row did not read back
+#define FLASH_INVALID_ROW           0x0002
+
+//declare functions
+unsigned char   FlashReadByte(unsigned int);
+void    FlashReadRow(unsigned int, unsigned char *, unsigned int);
+unsigned int    FlashWriteRow(unsigned int, const unsigned char *, unsigned int);
+
+
+
+#endif	/* FLASH_H */
+
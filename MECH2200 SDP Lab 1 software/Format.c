@@ -0,0 +1,233 @@
+/*
+ * File: Format.c
+ * Author: Roger Berry
+ * Comments: Integer to string conversion without division
+ *           The PIC16 has no divide instruction so each / or % is a library
+ *           loop. Digits are found here by counting how many times each
+ *           power of ten can be subtracted, at most 9 subtractions a digit.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Comms.h"
+#include "Format.h"
+
+//define powers of ten for subtract and count conversion, units are not included
+#define POWERS_16_COUNT     4
+#define POWERS_32_COUNT     9
+
+const unsigned int PowersOfTen16[POWERS_16_COUNT] = {10000, 1000, 100, 10};
+const unsigned long PowersOfTen32[POWERS_32_COUNT] = {1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10};
+const unsigned char HexCharacters[] = "0123456789ABCDEF";
+
+
+
+//***************************************************************
+//Convert an 8 bit unsigned value into a decimal string
+
+unsigned int    FormatUnsigned8(unsigned char Value, unsigned int MinDigits, volatile unsigned char *Buffer)
+{
+    return FormatUnsigned16(Value, MinDigits, Buffer);
+}
+
+
+
+//***************************************************************
+//Convert a 16 bit unsigned value into a decimal string
+
+unsigned int    FormatUnsigned16(unsigned int Value, unsigned int MinDigits, volatile unsigned char *Buffer)
+{
+    unsigned int Length = 0;
+    unsigned int Index;
+    unsigned char Digit;
+
+    //padding beyond the largest value
+    while(MinDigits > POWERS_16_COUNT + 1)
+    {
+        Buffer[Length] = '0';
+        Length++;
+        MinDigits--;
+    }
+
+    for(Index = 0; Index < POWERS_16_COUNT; Index++)
+    {
+        //count the subtractions of this power of ten
+        Digit = 0;
+        while(Value >= PowersOfTen16[Index])
+        {
+            Value = Value - PowersOfTen16[Index];
+            Digit++;
+        }
+        //leading zeros are only added for padding
+        if(Digit != 0 || Length != 0 || MinDigits > POWERS_16_COUNT - Index)
+        {
+            Buffer[Length] = (unsigned char)(Digit + ASCII_NUMBER_OFFSET);
+            Length++;
+        }
+    }
+
+    //units are always added
+    Buffer[Length] = (unsigned char)(Value + ASCII_NUMBER_OFFSET);
+    Length++;
+    Buffer[Length] = (unsigned char)NULL;
+
+    return Length;
+}
+
+
+
+//***************************************************************
+//Convert a 32 bit unsigned value into a decimal string
+
+unsigned int    FormatUnsigned32(unsigned long Value, unsigned int MinDigits, volatile unsigned char *Buffer)
+{
+    unsigned int Length = 0;
+    unsigned int Index;
+    unsigned char Digit;
+
+    //16 bit subtraction is much quicker, use it when the value allows
+    if(Value <= 0xFFFF && MinDigits <= POWERS_16_COUNT + 1)
+    {
+        return FormatUnsigned16((unsigned int)Value, MinDigits, Buffer);
+    }
+
+    //padding beyond the largest value
+    while(MinDigits > POWERS_32_COUNT + 1)
+    {
+        Buffer[Length] = '0';
+        Length++;
+        MinDigits--;
+    }
+
+    for(Index = 0; Index < POWERS_32_COUNT; Index++)
+    {
+        //count the subtractions of this power of ten
+        Digit = 0;
+        while(Value >= PowersOfTen32[Index])
+        {
+            Value = Value - PowersOfTen32[Index];
+            Digit++;
+        }
+        //leading zeros are only added for padding
+        if(Digit != 0 || Length != 0 || MinDigits > POWERS_32_COUNT - Index)
+        {
+            Buffer[Length] = (unsigned char)(Digit + ASCII_NUMBER_OFFSET);
+            Length++;
+        }
+    }
+
+    //units are always added
+    Buffer[Length] = (unsigned char)(Value + ASCII_NUMBER_OFFSET);
+    Length++;
+    Buffer[Length] = (unsigned char)NULL;
+
+    return Length;
+}
+
+
+
+//***************************************************************
+//Convert signed values into a decimal string
+//the sign is not counted as a digit
+//the magnitude is negated as unsigned so the most negative value is correct
+
+unsigned int    FormatSigned8(signed char Value, unsigned int MinDigits, volatile unsigned char *Buffer)
+{
+    return FormatSigned16(Value, MinDigits, Buffer);
+}
+
+unsigned int    FormatSigned16(signed int Value, unsigned int MinDigits, volatile unsigned char *Buffer)
+{
+    if(Value < 0)
+    {
+        *Buffer = '-';
+        return FormatUnsigned16(0 - (unsigned int)Value, MinDigits, Buffer + 1) + 1;
+    }
+    return FormatUnsigned16((unsigned int)Value, MinDigits, Buffer);
+}
+
+unsigned int    FormatSigned32(signed long Value, unsigned int MinDigits, volatile unsigned char *Buffer)
+{
+    if(Value < 0)
+    {
+        *Buffer = '-';
+        return FormatUnsigned32(0 - (unsigned long)Value, MinDigits, Buffer + 1) + 1;
+    }
+    return FormatUnsigned32((unsigned long)Value, MinDigits, Buffer);
+}
+
+
+
+//***************************************************************
+//Convert a fixed point value into a decimal string
+//Value is the number scaled by 10 to the power Decimals
+//e.g. 12345 with 2 decimals gives 123.45, -5 with 2 decimals gives -0.05
+
+unsigned int    FormatFixed(signed long Value, unsigned int Decimals, volatile unsigned char *Buffer)
+{
+    unsigned int Length;
+    unsigned int Index;
+
+    if(Decimals > FORMAT_MAX_DECIMALS)
+    {
+        Decimals = FORMAT_MAX_DECIMALS;
+    }
+
+    //pad so there is at least one digit before the point
+    Length = FormatSigned32(Value, Decimals + 1, Buffer);
+    if(Decimals == 0)
+    {
+        return Length;
+    }
+
+    //move the fraction along one place and insert the point
+    for(Index = Length; Index > Length - Decimals; Index--)
+    {
+        Buffer[Index] = Buffer[Index - 1];
+    }
+    Buffer[Length - Decimals] = '.';
+    Length++;
+    Buffer[Length] = (unsigned char)NULL;
+
+    return Length;
+}
+
+
+
+//***************************************************************
+//Convert a value into an upper case hexadecimal string with no prefix
+//MinDigits pads with leading zeros up to 8 digits
+
+unsigned int    FormatHex(unsigned long Value, unsigned int MinDigits, volatile unsigned char *Buffer)
+{
+    unsigned int Length = 0;
+    unsigned int Index;
+    unsigned long Temp = Value;
+
+    //count the significant digits
+    do
+    {
+        Length++;
+        Temp = Temp >> 4;
+    }
+    while(Temp != 0);
+    if(MinDigits > 8)
+    {
+        MinDigits = 8;
+    }
+    if(Length < MinDigits)
+    {
+        Length = MinDigits;
+    }
+
+    //fill from the least significant digit
+    Buffer[Length] = (unsigned char)NULL;
+    for(Index = Length; Index > 0; Index--)
+    {
+        Buffer[Index - 1] = HexCharacters[(unsigned char)Value & 0x0F];
+        Value = Value >> 4;
+    }
+
+    return Length;
+}
+
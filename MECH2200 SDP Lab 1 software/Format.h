@@ -0,0 +1,37 @@
+/*
+ * File: Format.h
+ * Author: Roger Berry
+ * Comments: Integer to string conversion without division
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef FORMAT_H
+#define	FORMAT_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define format constants
+#define FORMAT_MAX_DIGITS           10      //digits in the largest 32 bit value
+#define FORMAT_MAX_DECIMALS         9       //fixed point decimals that fit in 32 bits
+
+//every function writes a null terminated string into the passed buffer and
+//returns its length. The buffer must hold the longest result plus the null,
+//12 characters covers every 32 bit value
+//MinDigits pads with leading zeros, 0 or 1 gives no padding
+
+//declare functions
+unsigned int    FormatUnsigned8(unsigned char, unsigned int, volatile unsigned char *);
+unsigned int    FormatUnsigned16(unsigned int, unsigned int, volatile unsigned char *);
+unsigned int    FormatUnsigned32(unsigned long, unsigned int, volatile unsigned char *);
+unsigned int    FormatSigned8(signed char, unsigned int, volatile unsigned char *);
+unsigned int    FormatSigned16(signed int, unsigned int, volatile unsigned char *);
+unsigned int    FormatSigned32(signed long, unsigned int, volatile unsigned char *);
+unsigned int    FormatFixed(signed long, unsigned int, volatile unsigned char *);
+unsigned int    FormatHex(unsigned long, unsigned int, volatile unsigned char *);
+
+
+
+#endif	/* FORMAT_H */
+
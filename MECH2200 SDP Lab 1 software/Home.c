@@ -0,0 +1,432 @@
+/*
+ * File: Home.c
+ * Author: Roger Berry
+ * Comments: Lift endstops on interrupt on change and the homing sequence
+ *           The bottom and top switches are on GPIO_5 and GPIO_6 and close
+ *           to 0 V. The falling edge interrupt latches the position the
+ *           moment a switch closes, so it does not depend on how often the
+ *           main loop runs. A move running into a closed switch is stopped
+ *           in the interrupt at any time, homed or not. Homing ramps down
+ *           past the switch and finds the edge again, any other move is
+ *           halted at once without a ramp, which would overrun the travel,
+ *           and the lift must be homed again before it moves.
+ *           Homing finds each switch twice, first fast to get near it, then
+ *           after backing off slowly so the edge is found at a speed that
+ *           repeats to a step. The bottom edge becomes position 0 and the
+ *           top edge gives the travel in steps. Each part of the sequence is
+ *           a single move started by HomeService, which is called on every
+ *           pass of the main loop and never waits for the motor.
+ *           With the travel loaded from flash only the bottom switch is
+ *           found again, to check the zero after a power cycle.
+ *           Floors and manual moves are kept HOME_LIMIT_MARGIN clear of the
+ *           switch edges so they never close a switch.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Timer.h"
+#include "SPI.h"
+#include "Motion.h"
+#include "Home.h"
+#include "Scheduler.h"
+
+//define external global variables
+extern  volatile unsigned int GLOBAL_StepperMotorSpeed;
+extern  volatile signed long GLOBAL_MaxPosition;
+
+//define variables used in this file
+volatile signed long EndstopPosition[ENDSTOP_COUNT];    //position latched when the switch closed
+volatile unsigned char EndstopArmed[ENDSTOP_COUNT];     //set to latch the next closing
+volatile unsigned char EndstopLatched[ENDSTOP_COUNT];   //set when a position has been latched
+volatile unsigned char HomeRunState = HOME_IDLE;   //set to HOME_FAILED by the interrupt at a limit
+unsigned char HomeEndstop;                          //switch being found
+unsigned char HomeAbortRequest = 0;
+unsigned char HomeBottomOnly = 0;                   //set to keep the saved travel
+volatile unsigned int HomeError = HOME_OK;
+signed long HomeTravel = 0;                         //steps from the bottom edge to the top edge
+unsigned int SavedStepDelay;                        //settings restored when homing finishes
+unsigned int SavedAcceleration;
+unsigned int SavedDeceleration;
+unsigned int SavedShape;
+
+
+
+//***************************************************************
+//Set up the falling edge interrupts, call after InitialisePorts
+
+void    InitialiseHome(void)
+{
+    unsigned char Endstop;
+
+    for(Endstop = 0; Endstop < ENDSTOP_COUNT; Endstop++)
+    {
+        EndstopArmed[Endstop] = 0;
+        EndstopLatched[Endstop] = 0;
+        EndstopPosition[Endstop] = 0;
+    }
+    HomeRunState = HOME_IDLE;
+    HomeAbortRequest = 0;
+    HomeError = HOME_OK;
+
+    ENDSTOP_BOTTOM_EDGE = ENABLED;
+    ENDSTOP_TOP_EDGE = ENABLED;
+    ENDSTOP_BOTTOM_FLAG = CLEAR_FLAG;
+    ENDSTOP_TOP_FLAG = CLEAR_FLAG;
+    IOC_INTERRUPT_ENABLE = INTERRUPT_ENABLED;
+}
+
+
+
+//***************************************************************
+//Act on a switch closing, Down is set for the bottom switch
+
+static void    EndstopReached(unsigned char Endstop, unsigned char Down)
+{
+    //contact bounce gives more edges, only the first after arming is latched
+    if(EndstopArmed[Endstop] != 0)
+    {
+        EndstopPosition[Endstop] = MotionGetPosition();
+        EndstopArmed[Endstop] = 0;
+        EndstopLatched[Endstop] = 1;
+    }
+
+    //stop a move towards the switch, the direction output is high going down
+    if(DRV8711_DIR_READ_LATCH != Down)
+    {
+        return;
+    }
+    if(HomeRunState >= HOME_SEEK_FAST && HomeRunState <= HOME_PARK)
+    {
+        //homing slows down past the switch and comes back to it
+        MotionStop();
+    }
+    else if(MotionBusy() != 0)
+    {
+        //the lift has overrun its travel, a ramp would run further on
+        MotionHalt();
+        HomeError = HOME_LIMIT;
+        HomeRunState = HOME_FAILED;
+    }
+}
+
+
+
+//***************************************************************
+//Interrupt on change, called from HIGH_ISR
+
+void    EndstopInterrupt(void)
+{
+    SchedulerInterruptSignal(EVENT_ENDSTOP);
+    if(ENDSTOP_BOTTOM_FLAG)
+    {
+        ENDSTOP_BOTTOM_FLAG = CLEAR_FLAG;
+        EndstopReached(ENDSTOP_BOTTOM, 1);
+    }
+    if(ENDSTOP_TOP_FLAG)
+    {
+        ENDSTOP_TOP_FLAG = CLEAR_FLAG;
+        EndstopReached(ENDSTOP_TOP, 0);
+    }
+}
+
+
+
+//***************************************************************
+//Test for a switch being closed now, returns 1 if closed
+
+unsigned int    EndstopClosed(unsigned int Endstop)
+{
+    if(Endstop == ENDSTOP_BOTTOM)
+    {
+        return ENDSTOP_BOTTOM_READ == ENDSTOP_CLOSED;
+    }
+    return ENDSTOP_TOP_READ == ENDSTOP_CLOSED;
+}
+
+
+
+//***************************************************************
+//Move towards the switch being found at the passed step interval
+//the move ends early when the interrupt stops it at the switch
+
+static void    SeekEndstop(unsigned int Delay, signed long Distance)
+{
+    GLOBAL_StepperMotorSpeed = Delay;
+    EndstopLatched[HomeEndstop] = 0;
+    EndstopArmed[HomeEndstop] = 1;
+    if(HomeEndstop == ENDSTOP_BOTTOM)
+    {
+        Distance = -Distance;
+    }
+    MotionMoveBy(Distance);
+}
+
+
+
+//***************************************************************
+//Start the fast seek for the switch being found
+
+static void    StartFastSeek(void)
+{
+    HomeRunState = HOME_SEEK_FAST;
+    if(EndstopClosed(HomeEndstop) != 0)
+    {
+        //already on the switch, back off from here
+        EndstopArmed[HomeEndstop] = 0;
+        EndstopPosition[HomeEndstop] = MotionGetPosition();
+        EndstopLatched[HomeEndstop] = 1;
+        return;
+    }
+    SeekEndstop(HOME_FAST_DELAY, HOME_MAX_TRAVEL);
+}
+
+
+
+//***************************************************************
+//Move the passed steps away from the last position latched at the
+//switch being found
+
+static void    MoveAwayFromEndstop(signed long Steps)
+{
+    GLOBAL_StepperMotorSpeed = HOME_FAST_DELAY;
+    if(HomeEndstop == ENDSTOP_TOP)
+    {
+        Steps = -Steps;
+    }
+    MotionMoveTo(EndstopPosition[HomeEndstop] + Steps);
+}
+
+
+
+//***************************************************************
+//Put back the move settings and end the sequence
+
+static void    FinishHome(unsigned int Error)
+{
+    EndstopArmed[ENDSTOP_BOTTOM] = 0;
+    EndstopArmed[ENDSTOP_TOP] = 0;
+    GLOBAL_StepperMotorSpeed = SavedStepDelay;
+    MotionSetProfile(SavedAcceleration, SavedDeceleration);
+    MotionSetShape(SavedShape);
+    HomeAbortRequest = 0;
+    HomeError = Error;
+    if(Error == HOME_OK)
+    {
+        GLOBAL_MaxPosition = HomeTravel;
+        HomeRunState = HOME_DONE;
+    }
+    else
+    {
+        HomeRunState = HOME_FAILED;
+    }
+}
+
+
+
+//***************************************************************
+//Save the move settings and start the fast seek for the bottom switch
+
+static unsigned int    BeginHome(unsigned char BottomOnly)
+{
+    if(MotionBusy() != 0 || MotionBlocksActive() != 0)
+    {
+        return MOTION_BUSY;
+    }
+    if(HomeRunState != HOME_IDLE && HomeRunState != HOME_DONE && HomeRunState != HOME_FAILED)
+    {
+        return MOTION_BUSY;
+    }
+
+    //the trapezoid stops in the fewest steps once a switch closes
+    SavedStepDelay = GLOBAL_StepperMotorSpeed;
+    SavedAcceleration = MotionGetAcceleration();
+    SavedDeceleration = MotionGetDeceleration();
+    SavedShape = MotionGetShape();
+    MotionSetProfile(HOME_ACCELERATION, HOME_DECELERATION);
+    MotionSetShape(MOTION_SHAPE_TRAPEZOID);
+    MotionClearHalt();
+    MotorOn();
+
+    HomeError = HOME_OK;
+    HomeAbortRequest = 0;
+    HomeBottomOnly = BottomOnly;
+    HomeEndstop = ENDSTOP_BOTTOM;
+    StartFastSeek();
+    return MOTION_OK;
+}
+
+
+
+//***************************************************************
+//Start homing, returns MOTION_BUSY if the motor is moving
+
+unsigned int    HomeStart(void)
+{
+    return BeginHome(0);
+}
+
+
+
+//***************************************************************
+//Find the bottom switch only and keep the travel in GLOBAL_MaxPosition
+//used at start up once a calibration record has been loaded
+//returns MOTION_BUSY if the motor is moving
+
+unsigned int    HomeVerify(void)
+{
+    return BeginHome(1);
+}
+
+
+
+//***************************************************************
+//Stop homing, the sequence ends once the motor has stopped
+
+void    HomeAbort(void)
+{
+    if(HomeRunState >= HOME_SEEK_FAST && HomeRunState <= HOME_PARK)
+    {
+        HomeAbortRequest = 1;
+        MotionStop();
+    }
+}
+
+
+
+//***************************************************************
+//Start the next part of the homing sequence once the last move has
+//finished, called on every pass of the main loop
+
+void    HomeService(void)
+{
+    if(HomeRunState < HOME_SEEK_FAST || HomeRunState > HOME_PARK)
+    {
+        return;
+    }
+    if(MotionBusy() != 0)
+    {
+        return;
+    }
+    if(HomeAbortRequest != 0)
+    {
+        FinishHome(HOME_ABORTED);
+        return;
+    }
+
+    switch(HomeRunState)
+    {
+        case HOME_SEEK_FAST:
+            if(EndstopLatched[HomeEndstop] == 0)
+            {
+                FinishHome(HOME_NOT_FOUND);
+                break;
+            }
+            HomeRunState = HOME_BACK_OFF_MOVE;
+            MoveAwayFromEndstop(HOME_BACK_OFF);
+            break;
+
+        case HOME_BACK_OFF_MOVE:
+            if(EndstopClosed(HomeEndstop) != 0)
+            {
+                FinishHome(HOME_STUCK);
+                break;
+            }
+            //the switch closes again within the back off distance
+            HomeRunState = HOME_SEEK_SLOW;
+            SeekEndstop(HOME_SLOW_DELAY, 2L * HOME_BACK_OFF);
+            break;
+
+        case HOME_SEEK_SLOW:
+            if(EndstopLatched[HomeEndstop] == 0)
+            {
+                FinishHome(HOME_NOT_FOUND);
+                break;
+            }
+            if(HomeEndstop == ENDSTOP_BOTTOM)
+            {
+                //the bottom edge is position 0
+                MotionSetPosition(MotionGetPosition() - EndstopPosition[ENDSTOP_BOTTOM]);
+                EndstopPosition[ENDSTOP_BOTTOM] = 0;
+                if(HomeBottomOnly != 0)
+                {
+                    //the travel is already known, park clear of the switch
+                    HomeTravel = GLOBAL_MaxPosition;
+                    HomeRunState = HOME_PARK;
+                    MoveAwayFromEndstop(HOME_BACK_OFF);
+                    break;
+                }
+                HomeEndstop = ENDSTOP_TOP;
+                StartFastSeek();
+                break;
+            }
+            //the top edge gives the travel, park clear of the switch
+            HomeTravel = EndstopPosition[ENDSTOP_TOP];
+            HomeRunState = HOME_PARK;
+            MoveAwayFromEndstop(HOME_BACK_OFF);
+            break;
+
+        case HOME_PARK:
+            FinishHome(HOME_OK);
+            break;
+    }
+}
+
+
+
+//***************************************************************
+//Get the homing state and the result of the last sequence
+
+unsigned int    HomeState(void)
+{
+    return HomeRunState;
+}
+
+unsigned int    HomeResult(void)
+{
+    return HomeError;
+}
+
+
+
+//***************************************************************
+//Test for zero and the travel being known, returns 1 once homed
+
+unsigned int    HomeIsDone(void)
+{
+    return HomeRunState == HOME_DONE;
+}
+
+
+
+//***************************************************************
+//Get the steps from the bottom switch edge to the top switch edge
+
+signed long     HomeGetTravel(void)
+{
+    return HomeTravel;
+}
+
+
+
+//***************************************************************
+//Limit a position to the travel less HOME_LIMIT_MARGIN at each end
+//a move to a switch edge closes the switch and halts the lift
+
+signed long     HomeLimitPosition(signed long Position)
+{
+    if(Position > GLOBAL_MaxPosition - HOME_LIMIT_MARGIN)
+    {
+        Position = GLOBAL_MaxPosition - HOME_LIMIT_MARGIN;
+    }
+    if(Position < HOME_LIMIT_MARGIN)
+    {
+        Position = HOME_LIMIT_MARGIN;
+    }
+    return Position;
+}
+
+//returns 1 if the position is HOME_LIMIT_MARGIN or more from both switch edges
+unsigned int    HomeInTravel(signed long Position)
+{
+    return HomeLimitPosition(Position) == Position;
+}
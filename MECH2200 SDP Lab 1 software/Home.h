@@ -0,0 +1,76 @@
+/*
+ * File: Home.h
+ * Author: Roger Berry
+ * Comments: Lift endstops on interrupt on change and the homing sequence
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef HOME_H
+#define	HOME_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define endstops, positive steps move the lift up
+#define ENDSTOP_BOTTOM              0
+#define ENDSTOP_TOP                 1
+#define ENDSTOP_COUNT               2
+
+//the switches close to 0 V against the GPIO pull ups
+#define ENDSTOP_BOTTOM_READ         GPIO_5_READ_PORT
+#define ENDSTOP_TOP_READ            GPIO_6_READ_PORT
+#define ENDSTOP_CLOSED              0b0
+
+//interrupt on change, a falling edge is the switch closing
+#define ENDSTOP_BOTTOM_EDGE         IOCBNbits.IOCBN5
+#define ENDSTOP_BOTTOM_FLAG         IOCBFbits.IOCBF5
+#define ENDSTOP_TOP_EDGE            IOCCNbits.IOCCN5
+#define ENDSTOP_TOP_FLAG            IOCCFbits.IOCCF5
+#define IOC_INTERRUPT_ENABLE        INTCONbits.IOCIE
+#define IOC_INTERRUPT_FLAG          INTCONbits.IOCIF
+
+//define homing constants, distances are in steps
+#define HOME_FAST_DELAY             500         //step interval in us looking for a switch
+#define HOME_SLOW_DELAY             4000        //step interval in us finding the switch edge
+#define HOME_ACCELERATION           2000        //steps/s/s
+#define HOME_DECELERATION           20000       //steps/s/s, stops within 100 steps of the switch at the fast speed
+#define HOME_BACK_OFF               400         //steps moved away before the slow seek
+#define HOME_MAX_TRAVEL             200000L     //longest fast seek before giving up
+#define HOME_LIMIT_MARGIN           HOME_BACK_OFF   //steps floors and manual moves keep clear of each switch edge
+
+//define homing states
+#define HOME_IDLE                   0       //never homed
+#define HOME_SEEK_FAST              1
+#define HOME_BACK_OFF_MOVE          2
+#define HOME_SEEK_SLOW              3
+#define HOME_PARK                   4       //moving clear of the last switch found
+#define HOME_DONE                   5       //zero and travel are known
+#define HOME_FAILED                 6
+
+//define homing results
+#define HOME_OK                     0x0000
+#define HOME_NOT_FOUND              0x0001  //a switch did not close within HOME_MAX_TRAVEL
+#define HOME_STUCK                  0x0002  //a switch stayed closed after backing off
+#define HOME_ABORTED                0x0003
+#define HOME_LIMIT                  0x0004  //a switch closed during a move outside homing, the motor was halted
+
+//declare functions
+void    InitialiseHome(void);
+void    EndstopInterrupt(void);
+unsigned int    EndstopClosed(unsigned int);
+unsigned int    HomeStart(void);
+unsigned int    HomeVerify(void);
+void    HomeAbort(void);
+void    HomeService(void);
+unsigned int    HomeState(void);
+unsigned int    HomeResult(void);
+unsigned int    HomeIsDone(void);
+signed long     HomeGetTravel(void);
+signed long     HomeLimitPosition(signed long);
+unsigned int    HomeInTravel(signed long);
+
+
+
+#endif	/* HOME_H */
+
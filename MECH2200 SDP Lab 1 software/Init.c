@@ -17,6 +17,10 @@ void    InitialisePorts(void)
     
     RXPPS = PORTC_BIT7;
     SSPDATPPS = PORTC_BIT4;
+    T5CKIPPS = PORTD_BIT2;      //timer 5 counts the stepper STEP pulses
+    //the input buffer of an analogue pin is off so RD2 must be digital for
+    //timer 5 to see the pulses it drives out
+    DRV8711_STEP_TYPE = DIGITAL;
     
     //define ports for output
     
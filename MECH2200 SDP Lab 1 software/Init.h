@@ -112,6 +112,8 @@
 #define DRV8711_STEP_WRITE          LATDbits.LATD2
 #define DRV8711_STEP_READ_LATCH     LATDbits.LATD2
 #define DRV8711_STEP_DIRECTION      TRISDbits.TRISD2
+#define DRV8711_STEP_TYPE           ANSELDbits.ANSD2
+#define DRV8711_STEP_SOURCE         RD2PPS          //LATCH_OUTPUT or STEP_PWM_OUTPUT
 
 #define DRV8711_RESET_WRITE         LATDbits.LATD3
 #define DRV8711_RESET_READ_LATCH    LATDbits.LATD3
@@ -174,6 +176,13 @@
 
 //add further definitions in the 'Init.h' file and include it in all files
 
+#define FOSC_FREQUENCY      32000000UL      //8 MHz crystal with 4x PLL
+#define INSTRUCTION_FREQUENCY   (FOSC_FREQUENCY / 4)
+
+//distances are signed long values in hundredths of a millimetre
+//so no floating point library is needed. Enter them with StringToFixed
+#define DISTANCE_DECIMALS   2
+
 #define OUTPUT              0b0
 #define INPUT               0b1
 #define DIGITAL             0b0
@@ -186,6 +195,8 @@
 #define ON                  0b1
 #define PORTC_BIT7          0b00010111
 #define PORTC_BIT4          0b00010100
+#define PORTD_BIT2          0b00011010
+#define LATCH_OUTPUT        0b00000000
 #define TX_OUTPUT           0b00100100
 #define SDO_OUTPUT          0b00100011
 #define SCLK_OUTPUT         0b00100001
@@ -193,6 +204,7 @@
 #define PWM4_OUTPUT         0b00011010      //(10 bit PWM)
 #define PWM5_OUTPUT         0b00011101      //(16 bit PWM)
 #define PWM6_OUTPUT         0b00011110      //(16 bit PWM)
+#define STEP_PWM_OUTPUT     0b00011111      //PWM11 (16 bit PWM), PWM11OUT between PWM6OUT and PWM12OUT in the RxyPPS table
 
 
 void    InitialisePorts(void);
@@ -0,0 +1,639 @@
+/*
+ * File: Lift.c
+ * Author: Roger Berry
+ * Comments: Floor calls served in LOOK order
+ *           Hall calls ask for the lift to go up or down from a floor, car
+ *           calls ask for a floor from inside the car. Each waiting call is
+ *           a bit in one of three masks with the time it was made. The lift
+ *           keeps going in one direction while there are calls ahead of it,
+ *           stopping for car calls and hall calls in its own direction on
+ *           the way. The furthest call ahead is served whatever its
+ *           direction, then the lift turns round, or rests when no calls
+ *           are left. Calls are not served first come first served, so a
+ *           call the lift is about to pass does not send it back and forth.
+ *           A stop is chosen when the lift leaves a floor, a call for a
+ *           floor it is already moving past is served on the way back.
+ *           LiftService is called on every pass of the main loop and never
+ *           waits for the motor or the doors. Times are kept in ms from
+ *           the system tick and must be sampled at least every 65 s.
+ *           The dwell at a floor is timed by a software timer started once
+ *           the doors are fully open.
+ *           When the lift leaves the drive is enabled and its current
+ *           raised while the doors close, so the move starts as soon as
+ *           they are shut. A call at the floor while they close opens them
+ *           again.
+ *           Calibration moves are made through LiftManualMove, only while
+ *           the lift is at rest with its doors shut. The lift is then no
+ *           longer at a floor and stays where it was put until the next
+ *           call, which it serves from the nearest floor.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Motion.h"
+#include "Home.h"
+#include "Door.h"
+#include "SoftTimer.h"
+#include "Lift.h"
+
+//define external global variables
+extern  volatile signed long GLOBAL_Floor1Position;
+extern  volatile signed long GLOBAL_Floor2Position;
+extern  volatile signed long GLOBAL_Floor3Position;
+
+//define variables used in this file
+unsigned char LiftCalls[LIFT_CALL_TYPES];           //bit n set for a call at floor n
+unsigned long CallTime[LIFT_FLOORS][LIFT_CALL_TYPES];   //ms when each waiting call was made
+unsigned char LiftRunState = LIFT_WAIT_HOME;
+unsigned char LiftFloor = LIFT_NO_FLOOR;            //floor the lift is stopped at or last left
+unsigned char LiftTarget;                           //floor being moved to
+unsigned char LiftDirection = LIFT_DIRECTION_NONE;
+unsigned long LiftTime = 0;                         //ms since start up
+unsigned int LiftLastTime;                          //tick count when the time was last updated
+LIFT_STATISTICS LiftStatistics;
+
+
+
+//***************************************************************
+//Clear the calls and statistics, call after InitialiseTimers
+
+void    InitialiseLift(void)
+{
+    unsigned char Type;
+
+    for(Type = 0; Type < LIFT_CALL_TYPES; Type++)
+    {
+        LiftCalls[Type] = 0;
+    }
+    LiftRunState = LIFT_WAIT_HOME;
+    LiftFloor = LIFT_NO_FLOOR;
+    LiftDirection = LIFT_DIRECTION_NONE;
+    LiftTime = 0;
+    LiftLastTime = GetTickCount();
+    LiftClearStatistics();
+}
+
+
+
+//***************************************************************
+//Count the ms passed since the last call
+
+static void    UpdateLiftTime(void)
+{
+    unsigned int Now;
+
+    Now = GetTickCount();
+    LiftTime = LiftTime + (unsigned int)(Now - LiftLastTime);
+    LiftLastTime = Now;
+}
+
+
+
+//***************************************************************
+//Get the step position of the passed floor
+
+static signed long    FloorPosition(unsigned char Floor)
+{
+    if(Floor == 0)
+    {
+        return GLOBAL_Floor1Position;
+    }
+    if(Floor == 1)
+    {
+        return GLOBAL_Floor2Position;
+    }
+    return GLOBAL_Floor3Position;
+}
+
+
+
+//***************************************************************
+//Find the floor nearest the present position
+
+static unsigned char    NearestFloor(void)
+{
+    signed long Position;
+    signed long Distance;
+    signed long Best;
+    unsigned char Floor;
+    unsigned char Nearest;
+
+    Position = MotionGetPosition();
+    Nearest = 0;
+    Best = 0;
+    for(Floor = 0; Floor < LIFT_FLOORS; Floor++)
+    {
+        Distance = FloorPosition(Floor) - Position;
+        if(Distance < 0)
+        {
+            Distance = -Distance;
+        }
+        if(Floor == 0 || Distance < Best)
+        {
+            Best = Distance;
+            Nearest = Floor;
+        }
+    }
+    return Nearest;
+}
+
+
+
+//***************************************************************
+//Record the time a served call waited and clear it
+
+static void    ServeCall(unsigned char Floor, unsigned char Type)
+{
+    unsigned char Mask;
+    unsigned long Elapsed;
+    unsigned int Time;
+
+    Mask = (unsigned char)(1 << Floor);
+    if((LiftCalls[Type] & Mask) == 0)
+    {
+        return;
+    }
+    LiftCalls[Type] &= (unsigned char)~Mask;
+
+    Elapsed = LiftTime - CallTime[Floor][Type];
+    Time = 0xFFFF;
+    if(Elapsed < 0xFFFF)
+    {
+        Time = (unsigned int)Elapsed;
+    }
+    if(Type == LIFT_CALL_CAR)
+    {
+        LiftStatistics.TravelCount++;
+        LiftStatistics.TravelTotal += Time;
+        LiftStatistics.TravelLast = Time;
+        if(Time > LiftStatistics.TravelMax)
+        {
+            LiftStatistics.TravelMax = Time;
+        }
+    }
+    else
+    {
+        LiftStatistics.WaitCount++;
+        LiftStatistics.WaitTotal += Time;
+        LiftStatistics.WaitLast = Time;
+        if(Time > LiftStatistics.WaitMax)
+        {
+            LiftStatistics.WaitMax = Time;
+        }
+    }
+}
+
+
+
+//***************************************************************
+//Find the next stop beyond the present floor in the passed direction
+//the nearest car call or hall call in that direction, otherwise the
+//furthest hall call the other way. Returns LIFT_NO_FLOOR if none
+
+static unsigned char    FindStop(unsigned char Direction)
+{
+    unsigned char Floor;
+    unsigned char Mask;
+
+    if(Direction == LIFT_DIRECTION_UP)
+    {
+        for(Floor = LiftFloor + 1; Floor < LIFT_FLOORS; Floor++)
+        {
+            Mask = (unsigned char)(1 << Floor);
+            if((LiftCalls[LIFT_CALL_CAR] | LiftCalls[LIFT_CALL_UP]) & Mask)
+            {
+                return Floor;
+            }
+        }
+        for(Floor = LIFT_FLOORS - 1; Floor > LiftFloor; Floor--)
+        {
+            if(LiftCalls[LIFT_CALL_DOWN] & (unsigned char)(1 << Floor))
+            {
+                return Floor;
+            }
+        }
+    }
+    else if(Direction == LIFT_DIRECTION_DOWN)
+    {
+        for(Floor = LiftFloor; Floor > 0; Floor--)
+        {
+            Mask = (unsigned char)(1 << (Floor - 1));
+            if((LiftCalls[LIFT_CALL_CAR] | LiftCalls[LIFT_CALL_DOWN]) & Mask)
+            {
+                return Floor - 1;
+            }
+        }
+        for(Floor = 0; Floor < LiftFloor; Floor++)
+        {
+            if(LiftCalls[LIFT_CALL_UP] & (unsigned char)(1 << Floor))
+            {
+                return Floor;
+            }
+        }
+    }
+    return LIFT_NO_FLOOR;
+}
+
+
+
+//***************************************************************
+//Serve the calls at the present floor, returns 1 if any were served
+//a hall call the other way is only served at the end of a sweep, when
+//the lift turns round
+
+static unsigned int    ServeFloor(void)
+{
+    unsigned char Mask;
+    unsigned char Served;
+
+    Mask = (unsigned char)(1 << LiftFloor);
+    Served = 0;
+    if(LiftCalls[LIFT_CALL_CAR] & Mask)
+    {
+        ServeCall(LiftFloor, LIFT_CALL_CAR);
+        Served = 1;
+    }
+
+    if(LiftDirection == LIFT_DIRECTION_UP && (LiftCalls[LIFT_CALL_UP] & Mask))
+    {
+        ServeCall(LiftFloor, LIFT_CALL_UP);
+        return 1;
+    }
+    if(LiftDirection == LIFT_DIRECTION_DOWN && (LiftCalls[LIFT_CALL_DOWN] & Mask))
+    {
+        ServeCall(LiftFloor, LIFT_CALL_DOWN);
+        return 1;
+    }
+    if(LiftDirection == LIFT_DIRECTION_NONE || FindStop(LiftDirection) == LIFT_NO_FLOOR)
+    {
+        //nothing further on, turn round for a call here
+        if(LiftCalls[LIFT_CALL_UP] & Mask)
+        {
+            LiftDirection = LIFT_DIRECTION_UP;
+            ServeCall(LiftFloor, LIFT_CALL_UP);
+            return 1;
+        }
+        if(LiftCalls[LIFT_CALL_DOWN] & Mask)
+        {
+            LiftDirection = LIFT_DIRECTION_DOWN;
+            ServeCall(LiftFloor, LIFT_CALL_DOWN);
+            return 1;
+        }
+    }
+    return Served;
+}
+
+
+
+//***************************************************************
+//Find the oldest waiting call, returns its floor or LIFT_NO_FLOOR
+
+static unsigned char    OldestCall(void)
+{
+    unsigned char Floor;
+    unsigned char Type;
+    unsigned char Oldest;
+    unsigned long Age;
+    unsigned long Longest;
+
+    Oldest = LIFT_NO_FLOOR;
+    Longest = 0;
+    for(Floor = 0; Floor < LIFT_FLOORS; Floor++)
+    {
+        for(Type = 0; Type < LIFT_CALL_TYPES; Type++)
+        {
+            if(LiftCalls[Type] & (unsigned char)(1 << Floor))
+            {
+                Age = LiftTime - CallTime[Floor][Type];
+                if(Oldest == LIFT_NO_FLOOR || Age > Longest)
+                {
+                    Oldest = Floor;
+                    Longest = Age;
+                }
+            }
+        }
+    }
+    return Oldest;
+}
+
+
+
+//***************************************************************
+//Open the doors for the dwell time, a move being got ready is dropped
+
+static void    OpenDoors(void)
+{
+    MotionRelease();
+    DoorOpen();
+    SoftTimerStop(SOFT_TIMER_DOOR_DWELL);
+    LiftRunState = LIFT_DOOR_OPEN;
+}
+
+
+
+//***************************************************************
+//Start the move to the passed floor, the state is left unchanged if the
+//motor is busy so the move is tried again on the next pass
+
+static void    MoveToFloor(unsigned char Floor)
+{
+    if(MotionMoveTo(FloorPosition(Floor)) == MOTION_OK)
+    {
+        LiftTarget = Floor;
+        LiftRunState = LIFT_MOVING;
+    }
+}
+
+
+
+//***************************************************************
+//Leave for the passed floor, the doors are closed first with the drive
+//made ready for the move while they close
+
+static void    Depart(unsigned char Floor)
+{
+    if(DoorIsClosed() != 0)
+    {
+        MoveToFloor(Floor);
+        return;
+    }
+    DoorClose();
+    MotionPrepare();
+    LiftTarget = Floor;
+    LiftRunState = LIFT_DOOR_CLOSING;
+}
+
+
+
+//***************************************************************
+//Pick the next stop once the lift is at rest at a floor
+
+static void    ChooseNextStop(void)
+{
+    unsigned char Floor;
+
+    LiftRunState = LIFT_IDLE;
+    if(LiftFloor == LIFT_NO_FLOOR)
+    {
+        //not at a floor since homing, go to the nearest one first
+        LiftDirection = LIFT_DIRECTION_NONE;
+        Depart(NearestFloor());
+        return;
+    }
+
+    //carry on the same way, otherwise turn round
+    Floor = LIFT_NO_FLOOR;
+    if(LiftDirection != LIFT_DIRECTION_NONE)
+    {
+        Floor = FindStop(LiftDirection);
+        if(Floor == LIFT_NO_FLOOR)
+        {
+            if(LiftDirection == LIFT_DIRECTION_UP)
+            {
+                LiftDirection = LIFT_DIRECTION_DOWN;
+            }
+            else
+            {
+                LiftDirection = LIFT_DIRECTION_UP;
+            }
+            Floor = FindStop(LiftDirection);
+        }
+    }
+    if(Floor == LIFT_NO_FLOOR)
+    {
+        //starting from rest, head for the oldest call
+        LiftDirection = LIFT_DIRECTION_NONE;
+        Floor = OldestCall();
+        if(Floor == LIFT_NO_FLOOR)
+        {
+            //rest with the doors shut
+            DoorClose();
+            return;
+        }
+        //stop on the way for calls in the same direction
+        if(Floor > LiftFloor)
+        {
+            LiftDirection = LIFT_DIRECTION_UP;
+            Floor = FindStop(LiftDirection);
+        }
+        else if(Floor < LiftFloor)
+        {
+            LiftDirection = LIFT_DIRECTION_DOWN;
+            Floor = FindStop(LiftDirection);
+        }
+    }
+
+    if(Floor == LiftFloor)
+    {
+        if(ServeFloor() != 0)
+        {
+            OpenDoors();
+        }
+        return;
+    }
+    Depart(Floor);
+}
+
+
+
+//***************************************************************
+//Make a call, Floor is from 0 and Call is LIFT_CALL_UP, LIFT_CALL_DOWN
+//or LIFT_CALL_CAR. A call already waiting keeps its first time
+//returns LIFT_OK or LIFT_INVALID_CALL
+
+unsigned int    LiftCall(unsigned int Floor, unsigned int Call)
+{
+    unsigned char Mask;
+
+    if(Floor >= LIFT_FLOORS || Call >= LIFT_CALL_TYPES)
+    {
+        return LIFT_INVALID_CALL;
+    }
+    if((Call == LIFT_CALL_UP && Floor == LIFT_FLOORS - 1) || (Call == LIFT_CALL_DOWN && Floor == 0))
+    {
+        return LIFT_INVALID_CALL;
+    }
+
+    UpdateLiftTime();
+    Mask = (unsigned char)(1 << Floor);
+    if((LiftCalls[Call] & Mask) == 0)
+    {
+        LiftCalls[Call] |= Mask;
+        CallTime[Floor][Call] = LiftTime;
+    }
+
+    //a call for the floor the doors are open at is served at once
+    if((LiftRunState == LIFT_DOOR_OPEN || LiftRunState == LIFT_DOOR_CLOSING) && Floor == LiftFloor)
+    {
+        if(ServeFloor() != 0)
+        {
+            OpenDoors();
+        }
+    }
+    return LIFT_OK;
+}
+
+
+
+//***************************************************************
+//Test for a call waiting, returns 1 if so
+
+unsigned int    LiftCallPending(unsigned int Floor, unsigned int Call)
+{
+    if(Floor >= LIFT_FLOORS || Call >= LIFT_CALL_TYPES)
+    {
+        return 0;
+    }
+    return (LiftCalls[Call] & (unsigned char)(1 << Floor)) != 0;
+}
+
+
+
+//***************************************************************
+//Run the lift, called on every pass of the main loop
+
+void    LiftService(void)
+{
+    UpdateLiftTime();
+
+    //hold the calls until the floor positions can be trusted
+    if(HomeIsDone() == 0)
+    {
+        if(LiftRunState != LIFT_MOVING || MotionBusy() == 0)
+        {
+            if(LiftRunState == LIFT_DOOR_CLOSING)
+            {
+                MotionRelease();
+            }
+            DoorClose();
+            LiftRunState = LIFT_WAIT_HOME;
+            LiftFloor = LIFT_NO_FLOOR;
+            LiftDirection = LIFT_DIRECTION_NONE;
+        }
+        return;
+    }
+
+    switch(LiftRunState)
+    {
+        case LIFT_WAIT_HOME:
+        case LIFT_IDLE:
+            ChooseNextStop();
+            break;
+
+        case LIFT_MANUAL:
+            if(MotionBusy() == 0 && OldestCall() != LIFT_NO_FLOOR)
+            {
+                ChooseNextStop();
+            }
+            break;
+
+        case LIFT_MOVING:
+            if(MotionBusy() != 0)
+            {
+                break;
+            }
+            LiftFloor = LiftTarget;
+            if(ServeFloor() != 0)
+            {
+                OpenDoors();
+            }
+            else
+            {
+                ChooseNextStop();
+            }
+            break;
+
+        case LIFT_DOOR_OPEN:
+            if(DoorIsOpen() == 0)
+            {
+                break;
+            }
+            if(SoftTimerExpired(SOFT_TIMER_DOOR_DWELL) != 0)
+            {
+                ChooseNextStop();
+            }
+            else if(SoftTimerRunning(SOFT_TIMER_DOOR_DWELL) == 0)
+            {
+                SoftTimerStart(SOFT_TIMER_DOOR_DWELL, DoorGetDwell(), 0, NULL);
+            }
+            break;
+
+        case LIFT_DOOR_CLOSING:
+            if(DoorIsClosed() != 0)
+            {
+                MoveToFloor(LiftTarget);
+            }
+            break;
+    }
+}
+
+
+
+//***************************************************************
+//Move the car to the passed position for calibration, refused unless
+//the lift is at rest or waiting for homing with its doors shut
+//the lift no longer counts as at a floor and is held where it stops
+//until the next call
+//returns LIFT_OK or LIFT_BUSY
+
+unsigned int    LiftManualMove(signed long Position)
+{
+    if(LiftRunState != LIFT_IDLE && LiftRunState != LIFT_WAIT_HOME && LiftRunState != LIFT_MANUAL)
+    {
+        return LIFT_BUSY;
+    }
+    if(DoorIsClosed() == 0)
+    {
+        return LIFT_BUSY;
+    }
+    if(MotionMoveTo(Position) != MOTION_OK)
+    {
+        return LIFT_BUSY;
+    }
+    LiftFloor = LIFT_NO_FLOOR;
+    LiftDirection = LIFT_DIRECTION_NONE;
+    LiftRunState = LIFT_MANUAL;
+    return LIFT_OK;
+}
+
+
+
+//***************************************************************
+//Get the lift state, floor and direction of travel
+
+unsigned int    LiftState(void)
+{
+    return LiftRunState;
+}
+
+unsigned int    LiftGetFloor(void)
+{
+    return LiftFloor;
+}
+
+unsigned int    LiftGetDirection(void)
+{
+    return LiftDirection;
+}
+
+
+
+//***************************************************************
+//Get or clear the wait and travel times of the calls served
+
+const LIFT_STATISTICS  *LiftGetStatistics(void)
+{
+    return &LiftStatistics;
+}
+
+void    LiftClearStatistics(void)
+{
+    LiftStatistics.WaitCount = 0;
+    LiftStatistics.WaitTotal = 0;
+    LiftStatistics.WaitMax = 0;
+    LiftStatistics.WaitLast = 0;
+    LiftStatistics.TravelCount = 0;
+    LiftStatistics.TravelTotal = 0;
+    LiftStatistics.TravelMax = 0;
+    LiftStatistics.TravelLast = 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * File: Lift.h
+ * Author: Roger Berry
+ * Comments: Floor calls served in LOOK order
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef LIFT_H
+#define	LIFT_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define lift constants, floors are numbered from 0 at the bottom
+#define LIFT_FLOORS                 3
+#define LIFT_NO_FLOOR               0xFF        //between floors, not yet at a floor
+
+//define call types
+#define LIFT_CALL_UP                0           //hall call to go up
+#define LIFT_CALL_DOWN              1           //hall call to go down
+#define LIFT_CALL_CAR               2           //floor chosen inside the car
+#define LIFT_CALL_TYPES             3
+
+//define travel directions
+#define LIFT_DIRECTION_NONE         0
+#define LIFT_DIRECTION_UP           1
+#define LIFT_DIRECTION_DOWN         2
+
+//define lift states
+#define LIFT_IDLE                   0           //no calls
+#define LIFT_MOVING                 1
+#define LIFT_DOOR_OPEN              2           //stopped at a floor, doors opening or held open
+#define LIFT_WAIT_HOME              3           //calls waiting for homing to finish
+#define LIFT_DOOR_CLOSING           4           //doors closing before the move to the next stop
+#define LIFT_MANUAL                 5           //moved by LiftManualMove, held until the next call
+
+//define call status
+#define LIFT_OK                     0x0000
+#define LIFT_INVALID_CALL           0x0001  //no such floor, or up from the top or down from the bottom
+#define LIFT_BUSY                   0x0002  //serving calls, doors not closed or the motor is moving
+
+//wait is from a hall call to the doors opening at its floor
+//travel is from a car call to the doors opening at the chosen floor
+typedef struct
+{
+    unsigned int WaitCount;
+    unsigned long WaitTotal;                //ms
+    unsigned int WaitMax;
+    unsigned int WaitLast;
+    unsigned int TravelCount;
+    unsigned long TravelTotal;
+    unsigned int TravelMax;
+    unsigned int TravelLast;
+} LIFT_STATISTICS;
+
+//declare functions
+void    InitialiseLift(void);
+unsigned int    LiftCall(unsigned int, unsigned int);
+unsigned int    LiftCallPending(unsigned int, unsigned int);
+void    LiftService(void);
+unsigned int    LiftManualMove(signed long);
+unsigned int    LiftState(void);
+unsigned int    LiftGetFloor(void);
+unsigned int    LiftGetDirection(void);
+const LIFT_STATISTICS  *LiftGetStatistics(void);
+void    LiftClearStatistics(void);
+
+
+
+#endif	/* LIFT_H */
+
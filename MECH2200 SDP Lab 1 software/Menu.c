@@ -0,0 +1,317 @@
+/*
+ * File: Menu.c
+ * Author: Roger Berry
+ * Comments: Table driven operator menus serviced from the main loop
+ *           The menu never waits for the transmit buffer. Each step sends
+ *           at most MENU_LINE_SPACE characters, one status line, one
+ *           option or one command's output, and a step only starts when
+ *           the buffer has that much room. A line entered is only acted on
+ *           once its echo has left room for the command's output.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Comms.h"
+#include "Menu.h"
+#include "Protocol.h"
+#include "SoftTimer.h"
+
+//define external global variables
+extern volatile unsigned char GLOBAL_RxString[RX_STRING_LENGTH];
+
+//define strings
+const unsigned char MenuSelectMessage[] = "\r\nEnter option number: ";
+
+//string error messages
+const unsigned char MessageTooLong[] = "\r\n String entered is too long";
+const unsigned char MessageNoValue[] = "\r\n No Value Entered";
+const unsigned char InvalidNumber[] = "\r\n Value out of range";
+const unsigned char TooManyDecimalPoints[] = "\r\n Too many decimal points";
+const unsigned char TooLarge[] = "\r\n Value too large";
+const unsigned char TooSmall[] = "\r\n Value too small";
+const unsigned char TimedOut[] = "\r\n No value entered in time";
+
+//define variables used in this file
+const MENU *CurrentMenu = NULL;
+unsigned int MenuState = MENU_SHOW_OPTIONS;
+LINE_READER MenuLine;
+void (*ValueHandler)(unsigned int, volatile unsigned char *) = NULL;
+void (*KeyHandler)(unsigned int) = NULL;
+unsigned int (*WaitHandler)(void) = NULL;
+unsigned int (*LineHandler)(unsigned int) = NULL;
+unsigned int MenuLineNumber = 0;                    //next status, option or command line to send
+unsigned int MenuLineStatus = LINE_PENDING;         //line read but not yet acted on
+
+
+
+//***************************************************************
+//Make the passed menu the active menu
+//it is displayed the next time the menu is serviced
+
+void    MenuSelect(const MENU *Menu)
+{
+    CurrentMenu = Menu;
+    MenuState = MENU_SHOW_OPTIONS;
+}
+
+
+
+//***************************************************************
+//Send the prompt and pass the next line entered to the handler
+//instead of selecting a menu option
+//the handler is passed the string status and the string, TIME_OUT if
+//nothing is entered within MENU_VALUE_TIMEOUT
+
+void    MenuRequestValue(const unsigned char *Prompt, unsigned int Length, unsigned int Mode, void (*Handler)(unsigned int, volatile unsigned char *))
+{
+    SendMessage(Prompt);
+    StartLine(&MenuLine, GLOBAL_RxString, Length, Mode);
+    MenuLineStatus = LINE_PENDING;
+    ValueHandler = Handler;
+    MenuState = MENU_WAIT_VALUE;
+    SetMasterTimeOut(MENU_VALUE_TIMEOUT);
+}
+
+
+
+//***************************************************************
+//Pass the next character received to the handler
+//binary protocol frames are not passed on
+
+void    MenuRequestKey(void (*Handler)(unsigned int))
+{
+    KeyHandler = Handler;
+    MenuState = MENU_WAIT_KEY;
+}
+
+
+
+//***************************************************************
+//Call the handler on every pass until it returns something other than
+//LINE_PENDING, for a command that takes longer than one pass
+
+void    MenuRequestWait(unsigned int (*Handler)(void))
+{
+    WaitHandler = Handler;
+    MenuState = MENU_WAIT_DONE;
+}
+
+
+
+//***************************************************************
+//Call the handler with 0, 1, 2... on later passes until it returns
+//MENU_LINES_DONE, for output longer than one line. Each call may send up
+//to MENU_LINE_SPACE characters. The last call may request a value.
+
+void    MenuRequestLines(unsigned int (*Handler)(unsigned int))
+{
+    LineHandler = Handler;
+    MenuLineNumber = 0;
+    MenuState = MENU_SEND_LINES;
+}
+
+
+
+//***************************************************************
+//Service the active menu. This never waits for input or for room to
+//send and is called from the menu task on each tick and character.
+//A handler may select another menu or request a value or key. If it
+//does neither the menu is displayed again.
+
+void    MenuService(void)
+{
+    unsigned int StringStatus;
+    unsigned int Value;
+    unsigned int Index;
+    unsigned int RxChar;
+    const MENU_COMMAND *Command;
+
+    //test for no menu selected
+    if(CurrentMenu == NULL)
+    {
+        return;
+    }
+    //every step may send a line, so wait until there is room for one
+    if(GetTxSpace() < MENU_LINE_SPACE)
+    {
+        return;
+    }
+
+    switch(MenuState)
+    {
+        case MENU_SHOW_OPTIONS:
+            //display status and options list a line at a time
+            MenuLineNumber = 0;
+            MenuState = MENU_SEND_STATUS;
+            if(CurrentMenu->ShowStatus == NULL)
+            {
+                MenuState = MENU_SEND_OPTIONS;
+            }
+            break;
+
+        case MENU_SEND_STATUS:
+            if(CurrentMenu->ShowStatus(MenuLineNumber) == MENU_LINES_DONE)
+            {
+                MenuLineNumber = 0;
+                MenuState = MENU_SEND_OPTIONS;
+                break;
+            }
+            MenuLineNumber++;
+            break;
+
+        case MENU_SEND_OPTIONS:
+            if(MenuLineNumber == 0)
+            {
+                SendMessage(CurrentMenu->Title);
+            }
+            else if(MenuLineNumber <= CurrentMenu->CommandCount)
+            {
+                SendMessage(CurrentMenu->Commands[MenuLineNumber - 1].Text);
+            }
+            else
+            {
+                SendMessage(MenuSelectMessage);
+                //start reading the option number
+                StartLine(&MenuLine, GLOBAL_RxString, CurrentMenu->OptionLength, LINE_INTEGER);
+                MenuLineStatus = LINE_PENDING;
+                MenuState = MENU_WAIT_OPTION;
+                break;
+            }
+            MenuLineNumber++;
+            break;
+
+        case MENU_SEND_LINES:
+            //return to the menu unless the last line asks for more
+            if(LineHandler(MenuLineNumber) == MENU_LINES_DONE)
+            {
+                if(MenuState == MENU_SEND_LINES)
+                {
+                    MenuState = MENU_SHOW_OPTIONS;
+                }
+                break;
+            }
+            MenuLineNumber++;
+            break;
+
+        case MENU_WAIT_OPTION:
+            if(MenuLineStatus == LINE_PENDING)
+            {
+                MenuLineStatus = ReadLine(&MenuLine);
+            }
+            //the echo may have used the room the command needs
+            if(MenuLineStatus == LINE_PENDING || GetTxSpace() < MENU_LINE_SPACE)
+            {
+                break;
+            }
+            StringStatus = MenuLineStatus;
+            MenuLineStatus = LINE_PENDING;
+            //redisplay the menu unless the command changes the state
+            MenuState = MENU_SHOW_OPTIONS;
+            if(StringStatus != STRING_OK)
+            {
+                //string error
+                DisplayStringError(StringStatus);
+                break;
+            }
+            //convert string to binary value and find the command
+            Value = StringToInteger(GLOBAL_RxString);
+            Command = NULL;
+            for(Index = 0; Index < CurrentMenu->CommandCount; Index++)
+            {
+                if(CurrentMenu->Commands[Index].Number == Value)
+                {
+                    Command = &CurrentMenu->Commands[Index];
+                    break;
+                }
+            }
+            if(Command == NULL)
+            {
+                //invalid entry
+                DisplayStringError(OUT_OF_RANGE);
+            }
+            else
+            {
+                Command->Handler();
+            }
+            break;
+
+        case MENU_WAIT_VALUE:
+            if(MenuLineStatus == LINE_PENDING)
+            {
+                MenuLineStatus = ReadLine(&MenuLine);
+            }
+            if(MenuLineStatus == LINE_PENDING || GetTxSpace() < MENU_LINE_SPACE)
+            {
+                break;
+            }
+            StringStatus = MenuLineStatus;
+            MenuLineStatus = LINE_PENDING;
+            //return to the menu unless the handler asks for more
+            SetMasterTimeOut(0);
+            MenuState = MENU_SHOW_OPTIONS;
+            ValueHandler(StringStatus, GLOBAL_RxString);
+            break;
+
+        case MENU_WAIT_KEY:
+            RxChar = GetChar();
+            //binary frames are handled without passing on the key
+            if(RxChar != 0xFFFF && ProtocolReceiveByte((unsigned char)RxChar) == 0)
+            {
+                MenuState = MENU_SHOW_OPTIONS;
+                KeyHandler(RxChar);
+            }
+            break;
+
+        case MENU_WAIT_DONE:
+            if(WaitHandler() != LINE_PENDING)
+            {
+                MenuState = MENU_SHOW_OPTIONS;
+            }
+            break;
+
+        default:    //corrupt state
+            MenuState = MENU_SHOW_OPTIONS;
+    }
+}
+
+
+
+//***************************************************************
+//display string error
+
+void    DisplayStringError(unsigned int ErrorValue)
+{
+    switch(ErrorValue)
+    {
+        case TOO_LONG:  //string is too long
+            SendMessage(MessageTooLong);
+            break;
+
+        case NO_DATA:  //string has no data
+            SendMessage(MessageNoValue);
+            break;
+
+        case INVALID_STRING:  //string has too many decimal points
+            SendMessage(TooManyDecimalPoints);
+            break;
+
+        case VALUE_TOO_LARGE:  //string exceeds maximum value
+            SendMessage(TooLarge);
+            break;
+
+        case VALUE_TOO_SMALL:  //string exceeds minimum value
+            SendMessage(TooSmall);
+            break;
+
+        case OUT_OF_RANGE:  //value or option not in the permitted range
+            SendMessage(InvalidNumber);
+            break;
+
+        case TIME_OUT:  //nothing entered in the time allowed
+            SendMessage(TimedOut);
+            break;
+
+        //No default
+    }
+}
+
@@ -0,0 +1,67 @@
+/*
+ * File: Menu.h
+ * Author: Roger Berry
+ * Comments: Table driven operator menus serviced from the main loop
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef MENU_H
+#define	MENU_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define menu states
+#define MENU_SHOW_OPTIONS           0       //display the menu and start reading an option
+#define MENU_WAIT_OPTION            1       //reading an option number
+#define MENU_WAIT_VALUE             2       //reading a value for a command
+#define MENU_WAIT_KEY               3       //waiting for any character
+#define MENU_WAIT_DONE              4       //waiting for a command to finish
+#define MENU_SEND_STATUS            5       //sending the status lines
+#define MENU_SEND_OPTIONS           6       //sending the title and option list
+#define MENU_SEND_LINES             7       //sending the lines of a command
+
+//define menu output, each step of the menu sends at most one line and
+//only starts when the transmit buffer has room for it, so no send waits
+#define MENU_LINE_SPACE             TX_BUFFER_SIZE  //most characters one line or handler may send
+#define MENU_LINES_DONE             0       //returned after the last line
+#define MENU_LINES_MORE             1       //returned while more lines follow
+
+//define time allowed to enter a value
+#define MENU_VALUE_TIMEOUT          60000   //ms, the command is dropped after this
+
+//one entry in a menu command table
+typedef struct
+{
+    unsigned int Number;                    //number typed to select the command
+    const unsigned char *Text;              //line shown in the option list
+    void (*Handler)(void);
+} MENU_COMMAND;
+
+//a menu, the option list is built from the command table
+typedef struct
+{
+    const unsigned char *Title;
+    unsigned int (*ShowStatus)(unsigned int);   //sends status line n before the title, may be NULL
+    const MENU_COMMAND *Commands;
+    unsigned int CommandCount;
+    unsigned int OptionLength;              //maximum digits in an option number
+} MENU;
+
+//number of entries in a command table
+#define MENU_COMMAND_COUNT(Table)   (sizeof(Table) / sizeof(Table[0]))
+
+//declare functions
+void    MenuSelect(const MENU *);
+void    MenuRequestValue(const unsigned char *, unsigned int, unsigned int, void (*)(unsigned int, volatile unsigned char *));
+void    MenuRequestKey(void (*)(unsigned int));
+void    MenuRequestWait(unsigned int (*)(void));
+void    MenuRequestLines(unsigned int (*)(unsigned int));
+void    MenuService(void);
+void    DisplayStringError(unsigned int);
+
+
+
+#endif	/* MENU_H */
+
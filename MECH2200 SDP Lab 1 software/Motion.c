@@ -0,0 +1,1655 @@
+/*
+ * File: Motion.c
+ * Author: Roger Berry
+ * Comments: Stepper motor acceleration profiles generated in the Timer3 interrupt
+ *           The step interval is worked out for every step with the integer
+ *           recurrence from Atmel application note AVR446
+ *              c(n) = c(n-1) - 2 * c(n-1) / (4 * n + 1)
+ *           n counts up from 0 while accelerating and up from minus the
+ *           number of deceleration steps to 0 while decelerating.
+ *           The remainder of each division is carried to the next step,
+ *           it is found by multiplying back as a second division is slow.
+ *           The cruise speed is the step interval in GLOBAL_StepperMotorSpeed.
+ *           Every step is counted in a signed position, positive steps are
+ *           made with the direction output low.
+ *           With hardware cruise selected the constant speed part of a move
+ *           is made by PWM11 and the pulses counted by Timer5, so there is no
+ *           interrupt per step between the ramps.
+ *           The S curve profile limits the jerk. Its acceleration rises and
+ *           falls linearly with time, peaking at the set acceleration. Each
+ *           ramp is split into segments of equal time and every step in a
+ *           segment has the same interval. The segments are worked out from
+ *           a table of the distance covered by a normalised ramp when the
+ *           move is started, so the interrupt only reads the tables.
+ *           Moves from the motion queue arrive as blocks of steps at a fixed
+ *           interval in a ring written by the main loop and read by the
+ *           interrupt. Each side only writes its own index so no lock is
+ *           needed.
+ *           With step mode switching selected a fast trapezoid move changes
+ *           the DRV8711 to coarse steps once the speed is high enough and
+ *           back to fine steps as it slows down. Each pulse is then 2 fine
+ *           steps and the recurrence runs in coarse steps. The change is
+ *           only made when the driver is on a coarse step so the position,
+ *           which is always in fine steps, stays exact. The interrupt only
+ *           queues the DRV8711 writes, a new step size is taken up on the
+ *           first pulse after its write has finished.
+ *           The motor current is set for each part of the move, full while
+ *           the speed changes, less while cruising and less again to hold
+ *           at rest. The step interrupt writes the cruise and deceleration
+ *           currents, the main loop the others. The hold current is kept
+ *           at rest, unless MotionSetIdleTimeout is given a time to disable
+ *           the drive after, for a load that cannot fall. MotionPrepare
+ *           enables the drive and sets the full current ahead of a move, so
+ *           the lift can do this while its doors close.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Timer.h"
+#include "PWM.h"
+#include "SPI.h"
+#include "SoftTimer.h"
+#include "Motion.h"
+
+//define external global variables
+extern  volatile unsigned int GLOBAL_StepperMotorSpeed;
+
+//profile settings in steps/s/s
+unsigned int MotionAcceleration = DEFAULT_ACCELERATION;
+unsigned int MotionDeceleration = DEFAULT_DECELERATION;
+
+//move state, written by the interrupt once the move has started
+volatile unsigned char MotionRunState = MOTION_STOPPED;
+volatile unsigned char MotionActive = 0;            //set until the last step pulse has finished
+volatile unsigned char MotionStopRequest = 0;
+volatile unsigned char MotionComplete = 1;          //set when a move has finished
+volatile unsigned char MotionHalted = 0;            //set by MotionHalt, no move starts until cleared
+volatile signed long MotionPosition = 0;            //absolute position in steps, written by the interrupt
+signed long MotionTarget = 0;                       //position the last move was sent to
+signed char MotionDirection = 1;                    //+1 or -1 added to the position each step
+unsigned int StepDelay;                             //interval of the step being made in us
+unsigned int RampDelay;                             //interval in the recurrence, in present steps
+unsigned int MinStepDelay;                          //cruise interval of a fine step
+unsigned int LastAccelDelay;                        //fine step interval at the end of acceleration
+signed long AccelCount;                             //n in the recurrence
+signed long StepRest;                               //remainder carried between steps
+unsigned long StepCount;                            //fine steps made in this move
+unsigned long MotionSteps;                          //fine steps in the move, 0 if it has no end
+unsigned long DecelStart;                           //step count at which deceleration starts
+signed long DecelValue;                             //minus the number of deceleration steps
+unsigned long CruiseDecelSteps;                     //steps to stop from the cruise speed
+unsigned char MotionHardwareCruise = 0;             //set to make the cruise steps with PWM11
+volatile unsigned char CruiseHardwareActive = 0;    //set while PWM11 is making the steps
+unsigned long CruiseStepsLeft;                      //hardware steps after the present block
+unsigned int CruiseBlockStart;                      //step counter value at the start of the block
+unsigned char MotionShape = MOTION_SHAPE_TRAPEZOID; //profile used for the next move
+unsigned int SCurveAccelSteps[MOTION_SEGMENTS];     //steps in each acceleration segment
+unsigned int SCurveAccelDelay[MOTION_SEGMENTS];     //step interval in each acceleration segment
+unsigned int SCurveDecelSteps[MOTION_SEGMENTS];     //deceleration segments, used from the last
+unsigned int SCurveDecelDelay[MOTION_SEGMENTS];
+unsigned char MotionModeSwitch = 0;                 //set to change to coarse steps at speed
+unsigned char StepShift = 0;                        //log2 of the fine steps made by each pulse
+signed char StepMove = 1;                           //fine steps added to the position each pulse
+unsigned char StepPhase = 0;                        //low bits of the fine steps made since the driver was set up
+SPI_TRANSACTION ModeTransaction;                    //step mode write from the interrupt
+unsigned char ModeShift = 0;                        //step size being written to the DRV8711
+unsigned char ModeChange = MODE_CHANGE_NONE;        //progress of the step mode write
+SPI_TRANSACTION TorqueTransaction;                  //torque write from the interrupt
+unsigned char TorqueValue = 0;                      //last torque written, 0 until the first move
+unsigned char MotionIdleOff = 0;                    //set when the drive was disabled at rest
+unsigned char MotionPrepared = 0;                   //set while the full current is held for the next move
+unsigned long IdleTime = 0;                         //ms at rest
+unsigned long IdleTimeout = MOTION_IDLE_TIMEOUT;    //ms at rest before the drive is disabled, 0 never
+unsigned int IdleLastTime;                          //tick count at the last idle check
+
+//torque for each motion state
+const unsigned char MotionTorque[] =
+{
+    MOTION_TORQUE_HOLD,                             //MOTION_STOPPED
+    MOTION_TORQUE_ACCEL,                            //MOTION_ACCEL
+    MOTION_TORQUE_CRUISE,                           //MOTION_CRUISE
+    MOTION_TORQUE_ACCEL                             //MOTION_DECEL
+};
+unsigned long SegmentCruiseSteps;                   //intervals at the cruise speed
+unsigned long SegmentStepsLeft;                     //intervals left in the present segment
+unsigned char SegmentIndex;                         //present segment
+
+//step blocks from the motion queue
+MOTION_BLOCK MotionBlocks[MOTION_BLOCK_COUNT];
+volatile unsigned char BlockHead = 0;               //written by the main loop
+volatile unsigned char BlockTail = 0;               //written by the interrupt
+volatile unsigned char BlocksEnd = 1;               //set when no more blocks will be added
+volatile unsigned char MotionBlockMode = 0;         //set while the steps come from blocks
+volatile unsigned int BlockUnderrunCount = 0;       //times the interrupt waited for a block
+unsigned int BlockStepsLeft;                        //steps left in the present block
+unsigned int BlockInterval;                         //interval of the present block
+
+//distance covered by the end of each segment of an S curve ramp as a
+//fraction of the ramp distance, 32768 is the whole ramp
+//1.333 t^3 for the first half of the ramp, 1 - 2((1 - t) - 0.667(1 - t)^3) for the second
+const unsigned int SCurveDistance[MOTION_SEGMENTS] =
+{
+    3, 25, 85, 202, 395, 683, 1084, 1618, 2304, 3160, 4207, 5461,
+    6937, 8622, 10496, 12541, 14737, 17067, 19510, 22048, 24661, 27332, 30040, 32768
+};
+
+
+
+//***************************************************************
+//Initialise motion, the stepper output is low and the motor stopped
+
+void    InitialiseMotion(void)
+{
+    StepperTimerOff();
+    StepPWM_Off();
+    StepCounterOff();
+    CruiseHardwareActive = 0;
+    MotionBlockMode = 0;
+    BlocksEnd = 1;
+    BlockTail = BlockHead;
+    DRV8711_STEP_WRITE = 0b0;
+    MotionRunState = MOTION_STOPPED;
+    MotionActive = 0;
+    MotionStopRequest = 0;
+    MotionComplete = 1;
+    MotionHalted = 0;
+    //InitialiseDRV8711 sets fine steps
+    StepShift = 0;
+    StepMove = 1;
+    ModeChange = MODE_CHANGE_NONE;
+}
+
+
+
+//***************************************************************
+//Set the acceleration and deceleration in steps/s/s
+//the values are used from the next move
+
+void    MotionSetProfile(unsigned int Acceleration, unsigned int Deceleration)
+{
+    if(Acceleration < MIN_ACCELERATION)
+    {
+        Acceleration = MIN_ACCELERATION;
+    }
+    if(Acceleration > MAX_ACCELERATION)
+    {
+        Acceleration = MAX_ACCELERATION;
+    }
+    if(Deceleration < MIN_ACCELERATION)
+    {
+        Deceleration = MIN_ACCELERATION;
+    }
+    if(Deceleration > MAX_ACCELERATION)
+    {
+        Deceleration = MAX_ACCELERATION;
+    }
+    MotionAcceleration = Acceleration;
+    MotionDeceleration = Deceleration;
+}
+
+unsigned int    MotionGetAcceleration(void)
+{
+    return MotionAcceleration;
+}
+
+unsigned int    MotionGetDeceleration(void)
+{
+    return MotionDeceleration;
+}
+
+
+
+//***************************************************************
+//Select making the cruise steps with PWM11, 0 makes every step in the
+//Timer3 interrupt. Used from the next move
+
+void    MotionSetHardwareCruise(unsigned int Enable)
+{
+    if(MotionActive == 0)
+    {
+        MotionHardwareCruise = (Enable != 0);
+    }
+}
+
+unsigned int    MotionGetHardwareCruise(void)
+{
+    return MotionHardwareCruise;
+}
+
+
+
+//***************************************************************
+//Select the profile shape, MOTION_SHAPE_TRAPEZOID or MOTION_SHAPE_SCURVE
+//used from the next move
+
+void    MotionSetShape(unsigned int Shape)
+{
+    if(MotionActive == 0 && Shape <= MOTION_SHAPE_SCURVE)
+    {
+        MotionShape = (unsigned char)Shape;
+    }
+}
+
+unsigned int    MotionGetShape(void)
+{
+    return MotionShape;
+}
+
+
+
+//***************************************************************
+//Turn step mode switching on (1) or off (0), used from the next move
+//only trapezoid moves change step mode
+
+void    MotionSetModeSwitch(unsigned int Enable)
+{
+    MotionModeSwitch = (Enable != 0);
+}
+
+unsigned int    MotionGetModeSwitch(void)
+{
+    return MotionModeSwitch;
+}
+
+
+
+//***************************************************************
+//Integer square root of a 32 bit value, rounded down
+
+unsigned int    SquareRoot(unsigned long Value)
+{
+    unsigned long Result = 0;
+    unsigned long Bit = 0x40000000UL;
+    
+    //start with the highest power of 4 not above the value
+    while(Bit > Value)
+    {
+        Bit = Bit >> 2;
+    }
+    
+    while(Bit != 0)
+    {
+        if(Value >= Result + Bit)
+        {
+            Value = Value - (Result + Bit);
+            Result = (Result >> 1) + Bit;
+        }
+        else
+        {
+            Result = Result >> 1;
+        }
+        Bit = Bit >> 2;
+    }
+    
+    return (unsigned int)Result;
+}
+
+
+
+//***************************************************************
+//Work out a trapezoid profile
+//Steps is MOTION_CONTINUOUS to run at the cruise speed until MotionStop
+
+static void    PlanTrapezoid(unsigned long Steps, unsigned long Speed)
+{
+    unsigned long MaxSpeedSteps;
+    unsigned long AccelLimit;
+    unsigned long DecelSteps;
+    unsigned long FirstDelay;
+    unsigned long Total;
+    
+    //steps to reach the cruise speed, v * v / (2 * a)
+    MaxSpeedSteps = (Speed * Speed) / (2UL * MotionAcceleration);
+    if(MaxSpeedSteps == 0)
+    {
+        MaxSpeedSteps = 1;
+    }
+    //steps to stop from the cruise speed
+    CruiseDecelSteps = (MaxSpeedSteps * MotionAcceleration) / MotionDeceleration;
+    
+    //first step interval
+    FirstDelay = MOTION_C0_CONSTANT / SquareRoot((unsigned long)MotionAcceleration << MOTION_C0_SHIFT);
+    if(FirstDelay > MOTION_MAX_DELAY)
+    {
+        FirstDelay = MOTION_MAX_DELAY;
+    }
+    if(FirstDelay < MinStepDelay)
+    {
+        FirstDelay = MinStepDelay;
+    }
+    
+    if(Steps == MOTION_CONTINUOUS)
+    {
+        //deceleration only starts on request
+        DecelStart = 0xFFFFFFFFUL;
+        DecelValue = -(signed long)CruiseDecelSteps;
+    }
+    else
+    {
+        //steps before deceleration must start if the cruise speed is not reached
+        //n * d / (a + d) split to avoid 32 bit overflow
+        Total = (unsigned long)MotionAcceleration + MotionDeceleration;
+        AccelLimit = (Steps / Total) * MotionDeceleration + ((Steps % Total) * MotionDeceleration) / Total;
+        if(AccelLimit == 0)
+        {
+            AccelLimit = 1;
+        }
+        if(MaxSpeedSteps < AccelLimit)
+        {
+            DecelSteps = CruiseDecelSteps;
+        }
+        else
+        {
+            DecelSteps = Steps - AccelLimit;
+        }
+        if(DecelSteps == 0)
+        {
+            DecelSteps = 1;
+        }
+        DecelStart = Steps - DecelSteps;
+        DecelValue = -(signed long)DecelSteps;
+    }
+    
+    MotionSteps = Steps;
+    StepDelay = (unsigned int)FirstDelay;
+    RampDelay = StepDelay;
+    if(Steps == 1)
+    {
+        //a single step is the last step of a deceleration
+        AccelCount = -1;
+        MotionRunState = MOTION_DECEL;
+    }
+    else
+    {
+        AccelCount = 0;
+        LastAccelDelay = StepDelay;
+        MotionRunState = MOTION_ACCEL;
+    }
+}
+
+
+
+//***************************************************************
+//Work out the segments of one S curve ramp to the passed speed
+//returns the steps in the ramp
+//the time of segments too short for a step is carried to the next
+//the steps are rounded down to whole steps so a segment may get fewer
+//than its share, no segment is made slower than the one before it or
+//the speed would drop part way up the ramp
+
+static unsigned long    BuildSegments(unsigned int *SegmentSteps, unsigned int *SegmentDelay, unsigned long Speed, unsigned int Rate)
+{
+    unsigned long Ramp;
+    unsigned long SegmentTime;
+    unsigned long Time;
+    unsigned long Distance;
+    unsigned long LastDistance;
+    unsigned long Delay;
+    unsigned long LastDelay;
+    unsigned int Index;
+    
+    //the ramp takes 2 * v / a so covers v * v / a steps
+    Ramp = (Speed * Speed) / Rate;
+    SegmentTime = (Speed * ((2UL * MOTION_TIMER_FREQUENCY) / MOTION_SEGMENTS)) / Rate;
+    
+    LastDistance = 0;
+    LastDelay = MOTION_MAX_DELAY;
+    Time = 0;
+    for(Index = 0; Index < MOTION_SEGMENTS; Index++)
+    {
+        //ramp * fraction / 32768 split to avoid 32 bit overflow
+        Distance = (Ramp >> 15) * SCurveDistance[Index] + (((Ramp & 0x7FFF) * SCurveDistance[Index]) >> 15);
+        SegmentSteps[Index] = (unsigned int)(Distance - LastDistance);
+        LastDistance = Distance;
+        
+        Time = Time + SegmentTime;
+        SegmentDelay[Index] = MOTION_MAX_DELAY;
+        if(SegmentSteps[Index] != 0)
+        {
+            Delay = Time / SegmentSteps[Index];
+            if(Delay > LastDelay)
+            {
+                Delay = LastDelay;
+            }
+            Time = Time - (Delay * SegmentSteps[Index]);
+            if(Delay < MinStepDelay)
+            {
+                Delay = MinStepDelay;
+            }
+            SegmentDelay[Index] = (unsigned int)Delay;
+            LastDelay = Delay;
+        }
+    }
+    
+    return LastDistance;
+}
+
+
+
+//***************************************************************
+//Get the next step interval of an S curve profile
+//returns 0 when there are no more steps
+
+static unsigned int    NextSegmentDelay(void)
+{
+    while(SegmentStepsLeft == 0)
+    {
+        switch(MotionRunState)
+        {
+            case MOTION_ACCEL:
+                SegmentIndex++;
+                if(SegmentIndex >= MOTION_SEGMENTS)
+                {
+                    SegmentStepsLeft = SegmentCruiseSteps;
+                    MotionRunState = MOTION_CRUISE;
+                }
+                else
+                {
+                    SegmentStepsLeft = SCurveAccelSteps[SegmentIndex];
+                }
+                break;
+                
+            case MOTION_CRUISE:
+                //deceleration uses the segments from the last
+                SegmentIndex = MOTION_SEGMENTS - 1;
+                SegmentStepsLeft = SCurveDecelSteps[SegmentIndex];
+                MotionRunState = MOTION_DECEL;
+                break;
+                
+            case MOTION_DECEL:
+                if(SegmentIndex == 0)
+                {
+                    return 0;
+                }
+                SegmentIndex--;
+                SegmentStepsLeft = SCurveDecelSteps[SegmentIndex];
+                break;
+                
+            default:    //stopped
+                return 0;
+        }
+    }
+    
+    SegmentStepsLeft--;
+    if(MotionRunState == MOTION_ACCEL)
+    {
+        return SCurveAccelDelay[SegmentIndex];
+    }
+    if(MotionRunState == MOTION_DECEL)
+    {
+        return SCurveDecelDelay[SegmentIndex];
+    }
+    return MinStepDelay;
+}
+
+
+
+//***************************************************************
+//Work out an S curve profile
+//Steps is MOTION_CONTINUOUS to run at the cruise speed until MotionStop
+//a move too short for both ramps at the cruise speed uses a lower speed
+//so the jerk is still limited
+
+static void    PlanSCurve(unsigned long Steps, unsigned long Speed)
+{
+    unsigned long Intervals;
+    unsigned long Harmonic;
+    unsigned long RampSteps;
+    
+    Intervals = 0xFFFFFFFFUL;
+    if(Steps != MOTION_CONTINUOUS)
+    {
+        //the ramps take v * v / a + v * v / d = v * v / h steps
+        //h = a * d / (a + d), the last step has no interval after it
+        Intervals = Steps - 1;
+        Harmonic = ((unsigned long)MotionAcceleration * MotionDeceleration) / ((unsigned long)MotionAcceleration + MotionDeceleration);
+        if(Intervals < (Speed * Speed) / Harmonic)
+        {
+            Speed = SquareRoot(Intervals * Harmonic);
+            if(Speed < MOTION_TIMER_FREQUENCY / MOTION_MAX_DELAY + 1)
+            {
+                Speed = MOTION_TIMER_FREQUENCY / MOTION_MAX_DELAY + 1;
+            }
+            //any steps left between the ramps are made at this speed
+            MinStepDelay = (unsigned int)(MOTION_TIMER_FREQUENCY / Speed);
+        }
+    }
+    
+    RampSteps = BuildSegments(SCurveAccelSteps, SCurveAccelDelay, Speed, MotionAcceleration);
+    RampSteps = RampSteps + BuildSegments(SCurveDecelSteps, SCurveDecelDelay, Speed, MotionDeceleration);
+    if(Steps == MOTION_CONTINUOUS)
+    {
+        SegmentCruiseSteps = 0xFFFFFFFFUL;
+    }
+    else if(RampSteps < Intervals)
+    {
+        SegmentCruiseSteps = Intervals - RampSteps;
+    }
+    else
+    {
+        SegmentCruiseSteps = 0;
+    }
+    
+    SegmentIndex = 0;
+    SegmentStepsLeft = SCurveAccelSteps[0];
+    MotionRunState = MOTION_ACCEL;
+    StepDelay = NextSegmentDelay();
+}
+
+
+
+//***************************************************************
+//Write the torque for the present motion state, called from the step
+//interrupt when the state may have changed. The write is not waited for,
+//a late change of current does not lose steps. If the last write is
+//still waiting for the bus or the queue is full the change is tried
+//again on the next step.
+
+static void    CheckTorque(void)
+{
+    unsigned char Torque;
+    
+    Torque = MotionTorque[MotionRunState];
+    if(Torque == TorqueValue)
+    {
+        return;
+    }
+    if(TorqueTransaction.Status == SPI_QUEUED || TorqueTransaction.Status == SPI_ACTIVE || SPI_QueueSpace() == 0)
+    {
+        return;
+    }
+    QueueDRV8711Update(&TorqueTransaction, DRV_TORQUE_REG, TORQUE_MASK, Torque);
+    QueueSPI(&TorqueTransaction);
+    TorqueValue = Torque;
+}
+
+
+
+//***************************************************************
+//Set the full current and enable a drive disabled at rest before a move
+
+static void    StartTorque(void)
+{
+    if(MotionIdleOff != 0)
+    {
+        MotionIdleOff = 0;
+        MotorOn();
+    }
+    if(TorqueValue != MOTION_TORQUE_ACCEL)
+    {
+        LoadTorque(MOTION_TORQUE_ACCEL);
+        TorqueValue = MOTION_TORQUE_ACCEL;
+    }
+    IdleTime = 0;
+    MotionPrepared = 0;
+}
+
+
+
+//***************************************************************
+//Enable the drive and set the full current before a move is started
+//the current is held until the next move or MotionRelease
+
+void    MotionPrepare(void)
+{
+    if(MotionActive != 0 || MotionBlockMode != 0)
+    {
+        return;
+    }
+    StartTorque();
+    MotionPrepared = 1;
+}
+
+
+
+//***************************************************************
+//Let the current fall to the hold value after MotionPrepare, for a
+//move that is not going to be made
+
+void    MotionRelease(void)
+{
+    MotionPrepared = 0;
+}
+
+
+
+//***************************************************************
+//Set the ms at rest before the drive is disabled, 0 keeps the hold
+//current on. The lift car falls when the drive is disabled, only set a
+//time for a load that cannot fall. Longer times are cut to
+//MOTION_MAX_IDLE_TIMEOUT
+
+void    MotionSetIdleTimeout(unsigned long Timeout)
+{
+    if(Timeout > MOTION_MAX_IDLE_TIMEOUT)
+    {
+        Timeout = MOTION_MAX_IDLE_TIMEOUT;
+    }
+    IdleTimeout = Timeout;
+    IdleTime = 0;
+}
+
+unsigned long   MotionGetIdleTimeout(void)
+{
+    return IdleTimeout;
+}
+
+
+
+//***************************************************************
+//Reduce the current at rest and disable the drive after the idle time
+//if one is set, called from the main loop
+
+void    MotionTorqueService(void)
+{
+    unsigned int Time;
+    unsigned int Elapsed;
+    
+    Time = GetTickCount();
+    Elapsed = Time - IdleLastTime;
+    IdleLastTime = Time;
+    if(MotionActive != 0 || MotionPrepared != 0)
+    {
+        IdleTime = 0;
+        return;
+    }
+    
+    //the torque is left at its power up value until the first move
+    if(TorqueValue != 0 && TorqueValue != MOTION_TORQUE_HOLD)
+    {
+        LoadTorque(MOTION_TORQUE_HOLD);
+        TorqueValue = MOTION_TORQUE_HOLD;
+    }
+    
+    //only a drive that is enabled is timed, a drive enabled again
+    //by MotorOn is no longer counted as disabled at rest
+    if((GetDRV8711Shadow(DRV_CTRL_REG) & ENABLE_DRIVE) == 0)
+    {
+        IdleTime = 0;
+        return;
+    }
+    MotionIdleOff = 0;
+    if(IdleTimeout == 0)
+    {
+        return;
+    }
+    IdleTime = IdleTime + Elapsed;
+    if(IdleTime >= IdleTimeout)
+    {
+        MotorOff();
+        MotionIdleOff = 1;
+        IdleTime = 0;
+    }
+}
+
+
+
+//***************************************************************
+//Work out the profile and start the step interrupt
+//Steps is MOTION_CONTINUOUS to run at the cruise speed until MotionStop
+
+static void    StartMotion(unsigned long Steps)
+{
+    unsigned long Speed;
+    
+    //test for a move already running or a halt
+    if(MotionActive != 0 || MotionBlockMode != 0 || MotionHalted != 0)
+    {
+        return;
+    }
+    
+    //cruise interval and speed in steps/s
+    //coarse steps allow fine step intervals shorter than the interrupt can make
+    MinStepDelay = GLOBAL_StepperMotorSpeed;
+    if(MotionModeSwitch != 0 && MotionShape == MOTION_SHAPE_TRAPEZOID)
+    {
+        if(MinStepDelay < (MOTION_MIN_DELAY >> MOTION_COARSE_SHIFT))
+        {
+            MinStepDelay = MOTION_MIN_DELAY >> MOTION_COARSE_SHIFT;
+        }
+    }
+    else if(MinStepDelay < MOTION_MIN_DELAY)
+    {
+        MinStepDelay = MOTION_MIN_DELAY;
+    }
+    Speed = MOTION_TIMER_FREQUENCY / MinStepDelay;
+    
+    StepCount = 0;
+    StepRest = 0;
+    MotionStopRequest = 0;
+    MotionComplete = 0;
+    //position count follows the direction output
+    if(DRV8711_DIR_READ_LATCH == 0)
+    {
+        MotionDirection = 1;
+    }
+    else
+    {
+        MotionDirection = -1;
+    }
+    StepMove = MotionDirection;
+    if(MotionShape == MOTION_SHAPE_SCURVE)
+    {
+        PlanSCurve(Steps, Speed);
+    }
+    else
+    {
+        PlanTrapezoid(Steps, Speed);
+    }
+    StartTorque();
+    MotionActive = 1;
+    
+    //the first interrupt makes the first step
+    DRV8711_STEP_WRITE = 0b0;
+    StepperTimerOn(MOTION_START_DELAY);
+}
+
+
+
+//***************************************************************
+//Move the passed number of steps in the present direction
+
+void    MotionMove(unsigned long Steps)
+{
+    if(Steps != 0)
+    {
+        StartMotion(Steps);
+    }
+}
+
+
+
+//***************************************************************
+//Move to the passed absolute position in steps
+//returns MOTION_BUSY without moving if a move is running or
+//MOTION_HALTED after MotionHalt
+
+unsigned int    MotionMoveTo(signed long Target)
+{
+    signed long Steps;
+    
+    if(MotionActive != 0 || MotionBlockMode != 0)
+    {
+        return MOTION_BUSY;
+    }
+    if(MotionHalted != 0)
+    {
+        return MOTION_HALTED;
+    }
+    
+    //the position is not changing so it can be read directly
+    MotionTarget = Target;
+    Steps = Target - MotionPosition;
+    if(Steps < 0)
+    {
+        DRV8711_DIR_WRITE = 0b1;
+        Steps = -Steps;
+    }
+    else
+    {
+        DRV8711_DIR_WRITE = 0b0;
+    }
+    
+    if(Steps == 0)
+    {
+        //already there, the current from MotionPrepare is not needed
+        MotionComplete = 1;
+        MotionPrepared = 0;
+    }
+    else
+    {
+        StartMotion((unsigned long)Steps);
+    }
+    return MOTION_OK;
+}
+
+
+
+//***************************************************************
+//Move the passed number of steps from the present position
+//returns MOTION_BUSY without moving if a move is running or
+//MOTION_HALTED after MotionHalt
+
+unsigned int    MotionMoveBy(signed long Steps)
+{
+    if(MotionActive != 0 || MotionBlockMode != 0)
+    {
+        return MOTION_BUSY;
+    }
+    return MotionMoveTo(MotionPosition + Steps);
+}
+
+
+
+//***************************************************************
+//Convert a distance in 0.01 mm into steps
+
+signed long     MotionDistanceToSteps(signed long Distance)
+{
+    return (Distance * STEPS_PER_MM) / 100;
+}
+
+
+
+//***************************************************************
+//Get the absolute position in steps
+//interrupts are held off so all four bytes come from the same step
+//steps made by PWM11 are added from the step counter
+
+signed long     MotionGetPosition(void)
+{
+    signed long Position;
+    unsigned long Counted;
+    unsigned int Counter;
+    unsigned char Overflow;
+    unsigned char InterruptEnable;
+    
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    Position = MotionPosition;
+    if(CruiseHardwareActive != 0)
+    {
+        //the end of a block may be waiting for the interrupt
+        do
+        {
+            Overflow = TIMER_5_INTERRUPT_FLAG;
+            Counter = GetStepCounter();
+        }
+        while(Overflow != TIMER_5_INTERRUPT_FLAG);
+        if(Overflow != 0)
+        {
+            Counted = (0x10000UL - CruiseBlockStart) + Counter;
+        }
+        else
+        {
+            Counted = (unsigned int)(Counter - CruiseBlockStart);
+        }
+        Counted = Counted << StepShift;
+        if(MotionDirection > 0)
+        {
+            Position = Position + (signed long)Counted;
+        }
+        else
+        {
+            Position = Position - (signed long)Counted;
+        }
+    }
+    INTCONbits.GIE = InterruptEnable;
+    
+    return Position;
+}
+
+
+
+//***************************************************************
+//Set the absolute position, for example after finding the home switch
+//ignored while a move is running
+
+void    MotionSetPosition(signed long Position)
+{
+    if(MotionActive == 0)
+    {
+        MotionPosition = Position;
+        MotionTarget = Position;
+    }
+}
+
+
+
+//***************************************************************
+//Get the position the last move was sent to
+
+signed long     MotionGetTarget(void)
+{
+    return MotionTarget;
+}
+
+
+
+//***************************************************************
+//Test for the last move having finished, returns 1 once the last step
+//pulse is complete. Polled by the main loop instead of waiting
+
+unsigned int    MotionIsComplete(void)
+{
+    return MotionComplete;
+}
+
+
+
+//***************************************************************
+//Accelerate to the cruise speed and keep going until MotionStop
+
+void    MotionRun(void)
+{
+    StartMotion(MOTION_CONTINUOUS);
+}
+
+
+
+//***************************************************************
+//Decelerate to a stop, use MotionBusy to find when the motor has stopped
+
+void    MotionStop(void)
+{
+    //the motion queue acts on the request in the main loop
+    if(MotionActive != 0 || MotionBlockMode != 0)
+    {
+        MotionStopRequest = 1;
+        //steps made by PWM11 are stopped at the next pulse
+        if(CruiseHardwareActive != 0)
+        {
+            STEP_PWM_PHASE_INTERRUPT_FLAG = CLEAR_FLAG;
+            STEP_PWM_PHASE_INTERRUPT_ENABLE = INTERRUPT_ENABLED;
+        }
+    }
+}
+
+
+
+//***************************************************************
+//Test for a move in progress, returns 1 until the last step has finished
+
+unsigned int    MotionBusy(void)
+{
+    return MotionActive;
+}
+
+unsigned int    MotionState(void)
+{
+    return MotionRunState;
+}
+
+
+
+//***************************************************************
+//Queue the DRV8711 step mode write if there is room, called from the
+//step interrupt
+
+static void    QueueStepMode(void)
+{
+    if(SPI_QueueSpace() == 0)
+    {
+        return;
+    }
+    QueueDRV8711Update(&ModeTransaction, DRV_CTRL_REG, STEP_MASK, MOTION_FINE_MODE - ((unsigned int)ModeShift << MOTION_MODE_SHIFT));
+    QueueSPI(&ModeTransaction);
+    ModeChange = MODE_CHANGE_QUEUED;
+}
+
+
+
+//***************************************************************
+//Start the change to pulses of 2 to the power Shift fine steps, called
+//from the step interrupt just after a pulse. The write is not waited
+//for, the next pulse is held back until it has reached the driver.
+
+static void    SetStepMode(unsigned char Shift)
+{
+    ModeShift = Shift;
+    ModeChange = MODE_CHANGE_WAITING;
+    QueueStepMode();
+}
+
+
+
+//***************************************************************
+//Test for the step mode matching the driver before a pulse, returns 1
+//if the pulse can be made. A change is taken up once its write is done.
+
+static unsigned int    StepModeReady(void)
+{
+    if(ModeChange == MODE_CHANGE_WAITING)
+    {
+        QueueStepMode();
+    }
+    if(ModeChange == MODE_CHANGE_QUEUED && ModeTransaction.Status == SPI_DONE)
+    {
+        StepShift = ModeShift;
+        StepMove = (signed char)(MotionDirection * (1 << ModeShift));
+        ModeChange = MODE_CHANGE_NONE;
+    }
+    return ModeChange == MODE_CHANGE_NONE;
+}
+
+
+
+//***************************************************************
+//Get the recurrence count that starts deceleration from the cruise speed
+//in the present step size
+
+static signed long    DecelCount(void)
+{
+    return -(signed long)((unsigned long)(-DecelValue) >> StepShift);
+}
+
+
+
+//***************************************************************
+//Change step mode at the speed thresholds, called from the step interrupt
+//once the next interval is known
+//Coarse steps are only started when the SPI is free so the write goes
+//out at once, the return to fine steps may have to wait for the bus. The
+//recurrence count and interval are rescaled so the ramp carries on at the
+//same speed.
+
+static void    CheckStepMode(void)
+{
+    if(StepShift == 0)
+    {
+        //the driver must be on a coarse step so the position stays exact
+        if(MotionModeSwitch != 0 && MotionRunState != MOTION_DECEL && RampDelay < MOTION_COARSE_DELAY
+           && (StepPhase & MOTION_COARSE_MASK) == 0 && SPI_Idle() != 0)
+        {
+            SetStepMode(MOTION_COARSE_SHIFT);
+            RampDelay = RampDelay << MOTION_COARSE_SHIFT;
+            AccelCount = AccelCount >> MOTION_COARSE_SHIFT;
+            StepRest = 0;
+        }
+        return;
+    }
+    
+    //back to fine steps as the motor slows and before the last step
+    if((MotionRunState == MOTION_DECEL && (RampDelay >= (MOTION_COARSE_DELAY << StepShift) || AccelCount > -2))
+       || (MotionSteps != 0 && MotionSteps - StepCount < (2UL << StepShift)))
+    {
+        RampDelay = RampDelay >> StepShift;
+        AccelCount = AccelCount * (1 << StepShift);
+        StepRest = 0;
+        SetStepMode(0);
+    }
+}
+
+
+
+//***************************************************************
+//Finish the move after the last step pulse
+
+static void    EndMotion(void)
+{
+    StepperTimerOff();
+    if(StepShift != 0)
+    {
+        //the first pulse of the next move waits for the driver to be
+        //back on fine steps
+        SetStepMode(0);
+        StepShift = 0;
+        StepMove = MotionDirection;
+    }
+    MotionRunState = MOTION_STOPPED;
+    MotionActive = 0;
+    MotionComplete = 1;
+}
+
+
+
+//***************************************************************
+//Add a block of steps at a fixed interval to the step block ring
+//returns MOTION_QUEUE_FULL if there is no room, called from the main loop
+//Direction is +1 or -1, it may only change when the motor is stopped
+
+unsigned int    MotionPushBlock(unsigned int Steps, unsigned int Interval, signed char Direction)
+{
+    MOTION_BLOCK *Block;
+    
+    if((unsigned char)(BlockHead - BlockTail) >= MOTION_BLOCK_COUNT)
+    {
+        return MOTION_QUEUE_FULL;
+    }
+    
+    //more blocks follow, the interrupt waits for them instead of stopping
+    BlocksEnd = 0;
+    //fill the block before the interrupt can see it
+    Block = &MotionBlocks[BlockHead & MOTION_BLOCK_MASK];
+    Block->Steps = Steps;
+    Block->Interval = Interval;
+    Block->Direction = Direction;
+    BlockHead++;
+    MotionBlockMode = 1;
+    return MOTION_OK;
+}
+
+
+
+//***************************************************************
+//Get the number of blocks that can be added
+
+unsigned int    MotionBlockSpace(void)
+{
+    return MOTION_BLOCK_COUNT - (unsigned char)(BlockHead - BlockTail);
+}
+
+unsigned int    MotionGetUnderrunCount(void)
+{
+    return BlockUnderrunCount;
+}
+
+unsigned int    MotionBlocksActive(void)
+{
+    return MotionBlockMode;
+}
+
+
+
+//***************************************************************
+//Start making the steps in the block ring if the motor is stopped
+//LastBlock is set when no more blocks will be added, the move then
+//finishes when the ring is empty
+
+void    MotionRunBlocks(unsigned int LastBlock)
+{
+    BlocksEnd = (LastBlock != 0);
+    if(MotionActive != 0 || BlockHead == BlockTail || MotionHalted != 0)
+    {
+        return;
+    }
+    
+    StepCount = 0;
+    BlockStepsLeft = 0;
+    BlockInterval = 0;
+    MotionStopRequest = 0;
+    MotionComplete = 0;
+    MotionBlockMode = 1;
+    //queued moves change speed in every block so the full current is kept
+    StartTorque();
+    MotionActive = 1;
+    
+    //the first interrupt takes the first block
+    DRV8711_STEP_WRITE = 0b0;
+    StepperTimerOn(MOTION_START_DELAY);
+}
+
+
+
+//***************************************************************
+//Drop the blocks the step interrupt has not started, to stop sooner
+//than the blocks would. The block being made is finished.
+//Returns the interval of the block being made, 0 if there is none, with
+//the position and direction at its end
+
+unsigned int    MotionDropBlocks(signed long *Position, signed char *Direction)
+{
+    unsigned int Interval;
+    unsigned char InterruptEnable;
+    
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    BlockHead = BlockTail;
+    Interval = BlockInterval;
+    *Position = MotionPosition + (signed long)BlockStepsLeft * MotionDirection;
+    *Direction = MotionDirection;
+    INTCONbits.GIE = InterruptEnable;
+    
+    return Interval;
+}
+
+
+
+//***************************************************************
+//Make the steps from the block ring, called from the step interrupt
+//Each interrupt makes one step of the present block. When the block is
+//finished the next is taken and its interval added to the timer. If the
+//main loop has not added a block yet the interrupt looks again after
+//MOTION_BLOCK_WAIT.
+
+static void    BlockStepInterrupt(void)
+{
+    MOTION_BLOCK *Block;
+    unsigned int Interval;
+    
+    if(BlockStepsLeft != 0)
+    {
+        DRV8711_STEP_WRITE = 1;
+        StepCount++;
+        MotionPosition = MotionPosition + MotionDirection;
+        StepPhase = StepPhase + MotionDirection;
+        BlockStepsLeft--;
+        DRV8711_STEP_WRITE = 0;
+    }
+    
+    Interval = BlockInterval;
+    if(BlockStepsLeft == 0)
+    {
+        if(BlockTail != BlockHead)
+        {
+            Block = &MotionBlocks[BlockTail & MOTION_BLOCK_MASK];
+            BlockStepsLeft = Block->Steps;
+            BlockInterval = Block->Interval;
+            if(Block->Direction != MotionDirection)
+            {
+                //the direction only changes at rest so the set up time is met
+                MotionDirection = Block->Direction;
+                if(MotionDirection > 0)
+                {
+                    DRV8711_DIR_WRITE = 0b0;
+                }
+                else
+                {
+                    DRV8711_DIR_WRITE = 0b1;
+                }
+            }
+            BlockTail++;
+            Interval = BlockInterval;
+        }
+        else if(BlocksEnd != 0)
+        {
+            MotionBlockMode = 0;
+            EndMotion();
+            return;
+        }
+        else
+        {
+            BlockUnderrunCount++;
+            Interval = MOTION_BLOCK_WAIT;
+        }
+    }
+    TIMER_3_TIME = TIMER_3_TIME - Interval;
+}
+
+
+
+//***************************************************************
+//Load the next block of hardware cruise steps into the step counter
+//called just after a pulse so the counter is not changing
+
+static void    LoadCruiseBlock(void)
+{
+    unsigned long Block;
+    
+    Block = CruiseStepsLeft;
+    if(Block > 0x10000UL)
+    {
+        Block = 0x10000UL;
+    }
+    CruiseStepsLeft = CruiseStepsLeft - Block;
+    //a block of 65536 starts from 0
+    CruiseBlockStart = (unsigned int)(0x10000UL - Block);
+    TIMER_5_TIME = CruiseBlockStart;
+}
+
+
+
+//***************************************************************
+//Count steps made by PWM11 into the position
+
+static void    AddCruiseSteps(unsigned long Steps)
+{
+    Steps = Steps << StepShift;
+    StepCount = StepCount + Steps;
+    StepPhase = StepPhase + (unsigned char)Steps * MotionDirection;
+    if(MotionDirection > 0)
+    {
+        MotionPosition = MotionPosition + (signed long)Steps;
+    }
+    else
+    {
+        MotionPosition = MotionPosition - (signed long)Steps;
+    }
+}
+
+
+
+//***************************************************************
+//Hand the cruise steps to PWM11, called from the step interrupt just
+//after a cruise step. The first PWM11 pulse is made when Timer3 would
+//have made the next step
+
+static void    StartHardwareCruise(unsigned long Steps)
+{
+    unsigned int Remaining;
+    
+    Remaining = 0 - TIMER_3_TIME;
+    StepperTimerOff();
+    CruiseStepsLeft = Steps;
+    LoadCruiseBlock();
+    StepCounterOn(0 - CruiseBlockStart);
+    CruiseHardwareActive = 1;
+    StepPWM_On(MinStepDelay << StepShift, (MinStepDelay << StepShift) - Remaining);
+}
+
+
+
+//***************************************************************
+//Hand the steps back to Timer3 to decelerate, called just after the
+//last PWM11 pulse. The next step is one cruise interval after the pulse
+//as it is when Timer3 makes the cruise steps
+
+static void    EndHardwareCruise(void)
+{
+    unsigned int Elapsed;
+    unsigned int CruiseDelay;
+    
+    //let the pulse finish before the STEP pin returns to its latch
+    while(STEP_PWM_TIME < STEP_PULSE_WIDTH);
+    Elapsed = STEP_PWM_TIME;
+    StepPWM_Off();
+    StepCounterOff();
+    CruiseHardwareActive = 0;
+    CruiseDelay = MinStepDelay << StepShift;
+    if(Elapsed >= CruiseDelay)
+    {
+        Elapsed = CruiseDelay - 1;
+    }
+    
+    //a stopped move no longer ends at its target
+    if(MotionStopRequest != 0)
+    {
+        MotionStopRequest = 0;
+        MotionSteps = 0;
+    }
+    if(MotionShape == MOTION_SHAPE_SCURVE)
+    {
+        SegmentStepsLeft = 0;
+        MotionRunState = MOTION_CRUISE;
+        StepDelay = NextSegmentDelay();
+    }
+    else
+    {
+        //coarse cruise steps may stop short of the deceleration, the last
+        //steps are then made at the end of the ramp
+        AccelCount = DecelCount();
+        StepDelay = LastAccelDelay << StepShift;
+        RampDelay = StepDelay;
+        StepRest = 0;
+        MotionRunState = MOTION_DECEL;
+    }
+    CheckTorque();
+    StepperTimerOn(CruiseDelay - Elapsed);
+}
+
+
+
+//***************************************************************
+//Step counter and step PWM interrupts, called from the high priority
+//interrupt while PWM11 makes the cruise steps
+//The step counter interrupt is taken at the end of each block of steps.
+//The phase interrupt is only enabled by a stop request and is taken at
+//the next pulse.
+
+void    MotionCruiseInterrupt(void)
+{
+    unsigned int Counted;
+    
+    if(TIMER_5_INTERRUPT_ENABLE && TIMER_5_INTERRUPT_FLAG)
+    {
+        TIMER_5_INTERRUPT_FLAG = CLEAR_FLAG;
+        AddCruiseSteps(0x10000UL - CruiseBlockStart);
+        if(CruiseStepsLeft == 0)
+        {
+            EndHardwareCruise();
+            return;
+        }
+        LoadCruiseBlock();
+    }
+    
+    if(STEP_PWM_PHASE_INTERRUPT_ENABLE && STEP_PWM_PHASE_INTERRUPT_FLAG)
+    {
+        STEP_PWM_PHASE_INTERRUPT_FLAG = CLEAR_FLAG;
+        PERIPHERAL_STEP_PWM_INTERRUPT_FLAG = CLEAR_FLAG;
+        //the pulse that caused the interrupt has been counted
+        Counted = GetStepCounter() - CruiseBlockStart;
+        AddCruiseSteps(Counted);
+        EndHardwareCruise();
+    }
+}
+
+
+
+//***************************************************************
+//Stop the motor at once without a ramp, for a limit switch closing
+//during a move, called from the high priority interrupt
+//Steps made by PWM11 are counted before it is stopped. A pulse cut
+//short may not be seen by the driver so the position is not exact
+//after a halt. No move is started again until MotionClearHalt.
+
+void    MotionHalt(void)
+{
+    StepperTimerOff();
+    if(CruiseHardwareActive != 0)
+    {
+        StepPWM_Off();
+        //the end of a block may be waiting for the interrupt
+        if(TIMER_5_INTERRUPT_FLAG != 0)
+        {
+            AddCruiseSteps(0x10000UL - CruiseBlockStart);
+            CruiseBlockStart = 0;
+        }
+        AddCruiseSteps((unsigned int)(GetStepCounter() - CruiseBlockStart));
+        StepCounterOff();
+        CruiseHardwareActive = 0;
+    }
+    
+    //blocks not yet made are dropped
+    BlockTail = BlockHead;
+    BlocksEnd = 1;
+    MotionBlockMode = 0;
+    MotionStopRequest = 0;
+    MotionHalted = 1;
+    if(MotionActive != 0)
+    {
+        EndMotion();
+    }
+}
+
+//returns 1 from MotionHalt until MotionClearHalt
+unsigned int    MotionIsHalted(void)
+{
+    return MotionHalted;
+}
+
+//allow moves again, the position must be found again first
+void    MotionClearHalt(void)
+{
+    MotionHalted = 0;
+}
+
+
+
+//***************************************************************
+//Work out the next interval of an S curve profile, called from the step
+//interrupt after each step
+//A stop request while accelerating decelerates from the same segment,
+//the acceleration changes sign there without a jerk limit.
+
+static void    SCurveStep(void)
+{
+    unsigned int NewDelay;
+    
+    //no interval after this step, it was the last
+    if(StepDelay == 0)
+    {
+        EndMotion();
+        return;
+    }
+    
+    if(MotionStopRequest != 0)
+    {
+        MotionStopRequest = 0;
+        if(MotionRunState == MOTION_ACCEL)
+        {
+            SegmentStepsLeft = SCurveDecelSteps[SegmentIndex];
+            MotionRunState = MOTION_DECEL;
+        }
+        else if(MotionRunState == MOTION_CRUISE)
+        {
+            SegmentStepsLeft = 0;
+        }
+    }
+    
+    NewDelay = NextSegmentDelay();
+    CheckTorque();
+    if(MotionRunState == MOTION_CRUISE && StepDelay == MinStepDelay && MotionHardwareCruise != 0 && SegmentStepsLeft >= MOTION_HARDWARE_MIN_STEPS && TIMER_3_INTERRUPT_FLAG == 0)
+    {
+        //the steps up to the last cruise interval are made by PWM11
+        StartHardwareCruise(SegmentStepsLeft + 1);
+        return;
+    }
+    StepDelay = NewDelay;
+}
+
+
+
+//***************************************************************
+//Timer3 interrupt, called from the high priority interrupt
+//Each interrupt makes one complete step pulse and works out the interval
+//of the next step. The step output is held high while the timer is
+//reloaded and the position counted, which is longer than the DRV8711
+//minimum high time of 1.9 us.
+//The interval is added to the timer rather than loaded so the time taken
+//to reach the interrupt does not lengthen the step.
+//While a step mode write is on its way the pulse is held back
+//MOTION_MODE_WAIT us at a time, the SPI is never waited for here.
+
+void    MotionStepInterrupt(void)
+{
+    signed long Numerator;
+    signed long Denominator;
+    signed long Quotient;
+    signed long NewDelay;
+    
+    TIMER_3_INTERRUPT_FLAG = CLEAR_FLAG;
+    
+    //hold the pulse back while a step mode write is on its way
+    if(StepModeReady() == 0)
+    {
+        TIMER_3_TIME = -MOTION_MODE_WAIT;
+        return;
+    }
+    
+    if(MotionBlockMode != 0)
+    {
+        BlockStepInterrupt();
+        return;
+    }
+    
+    //make the step using the interval worked out on the last step
+    DRV8711_STEP_WRITE = 1;
+    TIMER_3_TIME = TIMER_3_TIME - StepDelay;
+    StepCount = StepCount + (1U << StepShift);
+    MotionPosition = MotionPosition + StepMove;
+    StepPhase = StepPhase + StepMove;
+    DRV8711_STEP_WRITE = 0;
+    if(MotionShape == MOTION_SHAPE_SCURVE)
+    {
+        SCurveStep();
+        return;
+    }
+    NewDelay = RampDelay;
+    
+    //a stop request starts deceleration from the present speed
+    if(MotionStopRequest != 0)
+    {
+        MotionStopRequest = 0;
+        MotionSteps = 0;
+        if(MotionRunState == MOTION_ACCEL)
+        {
+            //steps to stop are the steps taken to accelerate scaled by a / d
+            AccelCount = -(signed long)(((unsigned long)AccelCount * MotionAcceleration) / MotionDeceleration);
+            MotionRunState = MOTION_DECEL;
+        }
+        else if(MotionRunState == MOTION_CRUISE)
+        {
+            AccelCount = DecelCount();
+            NewDelay = (signed long)LastAccelDelay << StepShift;
+            MotionRunState = MOTION_DECEL;
+        }
+        if(AccelCount >= 0)
+        {
+            //too slow to need a ramp
+            EndMotion();
+            return;
+        }
+        StepDelay = (unsigned int)NewDelay;
+        RampDelay = StepDelay;
+        CheckStepMode();
+        CheckTorque();
+        return;
+    }
+    
+    switch(MotionRunState)
+    {
+        case MOTION_ACCEL:
+            AccelCount++;
+            Numerator = (2 * (signed long)RampDelay) + StepRest;
+            Denominator = (4 * AccelCount) + 1;
+            Quotient = Numerator / Denominator;
+            NewDelay = (signed long)RampDelay - Quotient;
+            StepRest = Numerator - (Quotient * Denominator);
+            if(StepCount >= DecelStart)
+            {
+                //move too short to reach the cruise speed
+                AccelCount = DecelCount();
+                MotionRunState = MOTION_DECEL;
+            }
+            else if(NewDelay <= ((signed long)MinStepDelay << StepShift))
+            {
+                LastAccelDelay = (unsigned int)(NewDelay >> StepShift);
+                NewDelay = (signed long)MinStepDelay << StepShift;
+                StepRest = 0;
+                MotionRunState = MOTION_CRUISE;
+            }
+            break;
+            
+        case MOTION_CRUISE:
+            NewDelay = (signed long)MinStepDelay << StepShift;
+            if(StepCount >= DecelStart)
+            {
+                AccelCount = DecelCount();
+                NewDelay = (signed long)LastAccelDelay << StepShift;
+                MotionRunState = MOTION_DECEL;
+            }
+            else if(MotionHardwareCruise != 0 && ((DecelStart - StepCount) >> StepShift) >= MOTION_HARDWARE_MIN_STEPS && TIMER_3_INTERRUPT_FLAG == 0)
+            {
+                //an overrun interrupt would miss the first PWM11 pulse
+                StartHardwareCruise((DecelStart - StepCount) >> StepShift);
+                return;
+            }
+            break;
+            
+        case MOTION_DECEL:
+            //the count stops at 0 if a coarse ramp ended before the last step
+            if(AccelCount < 0)
+            {
+                AccelCount++;
+                Numerator = (2 * (signed long)RampDelay) + StepRest;
+                Denominator = (4 * AccelCount) + 1;
+                Quotient = Numerator / Denominator;
+                NewDelay = (signed long)RampDelay - Quotient;
+                StepRest = Numerator - (Quotient * Denominator);
+            }
+            if(MotionSteps != 0)
+            {
+                if(StepCount >= MotionSteps)
+                {
+                    //this was the last step
+                    EndMotion();
+                    return;
+                }
+            }
+            else if(AccelCount >= 0)
+            {
+                //stopped without a target
+                EndMotion();
+                return;
+            }
+            break;
+            
+        default:    //stopped
+            EndMotion();
+            return;
+    }
+    
+    //keep the interval within the timer range
+    if(NewDelay > MOTION_MAX_DELAY)
+    {
+        NewDelay = MOTION_MAX_DELAY;
+    }
+    if(NewDelay < MOTION_MIN_DELAY)
+    {
+        NewDelay = MOTION_MIN_DELAY;
+    }
+    StepDelay = (unsigned int)NewDelay;
+    RampDelay = StepDelay;
+    CheckStepMode();
+    CheckTorque();
+}
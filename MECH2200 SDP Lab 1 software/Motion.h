@@ -0,0 +1,131 @@
+/*
+ * File: Motion.h
+ * Author: Roger Berry
+ * Comments: Stepper motor acceleration profiles generated in the Timer3 interrupt
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef MOTION_H
+#define	MOTION_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define motion states
+#define MOTION_STOPPED              0
+#define MOTION_ACCEL                1
+#define MOTION_CRUISE               2
+#define MOTION_DECEL                3
+
+//define profile shapes
+#define MOTION_SHAPE_TRAPEZOID      0           //constant acceleration
+#define MOTION_SHAPE_SCURVE         1           //jerk limited, the acceleration is the peak
+
+//define motion constants
+#define MOTION_TIMER_FREQUENCY      1000000UL   //Timer3 counts in us
+#define MOTION_MIN_DELAY            125         //shortest step interval in us, ramp steps take up to about 90 us
+#define MOTION_MAX_DELAY            65535       //longest step interval in us, Timer3 range
+#define MOTION_CONTINUOUS           0           //step count for a move that runs until MotionStop
+#define MOTION_START_DELAY          10          //us from starting the timer to the first step
+#define DEFAULT_ACCELERATION        2000        //steps/s/s
+#define DEFAULT_DECELERATION        2000        //steps/s/s
+#define MIN_ACCELERATION            100         //steps/s/s, slower ramps exceed the first step time
+#define MAX_ACCELERATION            60000       //steps/s/s
+#define MOTION_HARDWARE_MIN_STEPS   16          //shortest cruise handed to PWM11
+#define MOTION_SEGMENTS             24          //segments in each S curve ramp
+
+//define step mode switching, positions are always in fine steps
+//the DRV8711 MODE field is log2 of the microsteps per full step
+#define MOTION_FINE_MODE            (DRV_CTRL_REG_VALUE & STEP_MASK)    //step mode set up by InitialiseDRV8711
+#define MOTION_MODE_SHIFT           3           //position of the MODE field
+#define MOTION_COARSE_SHIFT         1           //log2 of the fine steps in a coarse step, 1/2 steps from 1/4
+#define MOTION_COARSE_MASK          ((1 << MOTION_COARSE_SHIFT) - 1)
+#define MOTION_COARSE_DELAY         250         //fine step interval in us below which coarse steps are used
+#define MOTION_MODE_WAIT            20          //us a pulse is held back while the step mode write finishes
+
+//define step mode write progress
+#define MODE_CHANGE_NONE            0           //the driver is on the step size in use
+#define MODE_CHANGE_WAITING         1           //write waiting for room in the SPI queue
+#define MODE_CHANGE_QUEUED          2           //write queued or on the bus
+
+//define motor current for each part of a move, DRV8711 TORQUE values
+#define MOTION_TORQUE_ACCEL         (DRV_TORQUE_REG_VALUE & TORQUE_MASK)    //full current to speed up and slow down
+#define MOTION_TORQUE_CRUISE        0x18        //80 %, only friction and the load to overcome
+#define MOTION_TORQUE_HOLD          0x0F        //50 %, holds the lift at rest
+#define MOTION_IDLE_TIMEOUT         0UL         //ms at rest before the drive is disabled at power up, 0 never disables it
+                                                //the lift car falls if the drive is disabled
+#define MOTION_MAX_IDLE_TIMEOUT     3600000UL   //longest ms at rest MotionSetIdleTimeout takes
+
+//define move status
+#define MOTION_OK                   0x0000
+#define MOTION_BUSY                 0xFFFF  //a move is already running
+#define MOTION_QUEUE_FULL           0xFFFE  //no room for another move or block
+#define MOTION_HALTED               0xFFFD  //stopped by MotionHalt, cleared by MotionClearHalt
+
+//define distance conversion, distances are in 0.01 mm (DISTANCE_DECIMALS)
+//800 quarter steps per revolution on an 8 mm lead screw, change to suit the lift drive
+#define STEPS_PER_MM                100
+
+//first step interval c0 = 0.676 * f * sqrt(2 / a), AVR446 equation 15
+//0.676 * 1000000 * sqrt(2) = 956008, sqrt(a) is found as isqrt(a << 8) / 16
+#define MOTION_C0_CONSTANT          (956008UL * 16)
+#define MOTION_C0_SHIFT             8
+
+//step blocks passed from the motion queue to the step interrupt
+#define MOTION_BLOCK_COUNT          16          //power of 2
+#define MOTION_BLOCK_MASK           (MOTION_BLOCK_COUNT - 1)
+#define MOTION_BLOCK_WAIT           1000        //us between looks for a block when the ring is empty
+
+typedef struct
+{
+    unsigned int Steps;                     //steps in the block, at least 1
+    unsigned int Interval;                  //us before each step
+    signed char Direction;                  //+1 or -1
+} MOTION_BLOCK;
+
+//declare functions
+void    InitialiseMotion(void);
+void    MotionSetProfile(unsigned int, unsigned int);
+unsigned int    MotionGetAcceleration(void);
+unsigned int    MotionGetDeceleration(void);
+void    MotionSetHardwareCruise(unsigned int);
+unsigned int    MotionGetHardwareCruise(void);
+void    MotionSetShape(unsigned int);
+unsigned int    MotionGetShape(void);
+void    MotionSetModeSwitch(unsigned int);
+unsigned int    MotionGetModeSwitch(void);
+void    MotionSetIdleTimeout(unsigned long);
+unsigned long   MotionGetIdleTimeout(void);
+void    MotionTorqueService(void);
+void    MotionPrepare(void);
+void    MotionRelease(void);
+void    MotionMove(unsigned long);
+unsigned int    MotionMoveTo(signed long);
+unsigned int    MotionMoveBy(signed long);
+signed long     MotionDistanceToSteps(signed long);
+signed long     MotionGetPosition(void);
+void    MotionSetPosition(signed long);
+signed long     MotionGetTarget(void);
+unsigned int    MotionIsComplete(void);
+void    MotionRun(void);
+void    MotionStop(void);
+void    MotionHalt(void);
+unsigned int    MotionIsHalted(void);
+void    MotionClearHalt(void);
+unsigned int    MotionBusy(void);
+unsigned int    MotionState(void);
+void    MotionStepInterrupt(void);
+void    MotionCruiseInterrupt(void);
+unsigned int    MotionPushBlock(unsigned int, unsigned int, signed char);
+unsigned int    MotionBlockSpace(void);
+unsigned int    MotionGetUnderrunCount(void);
+unsigned int    MotionBlocksActive(void);
+unsigned int    MotionDropBlocks(signed long *, signed char *);
+void    MotionRunBlocks(unsigned int);
+unsigned int    SquareRoot(unsigned long);
+
+
+
+#endif	/* MOTION_H */
+
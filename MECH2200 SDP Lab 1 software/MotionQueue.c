@@ -0,0 +1,367 @@
+/*
+ * File: MotionQueue.c
+ * Author: Roger Berry
+ * Comments: Queue of stepper moves joined without stopping by look ahead
+ *           Each move is a target position, a cruise interval and an
+ *           acceleration. When a move is added the exit speed of every move
+ *           still waiting is planned again, a backward pass from the last
+ *           move, which must stop, limits each exit speed to what the
+ *           following moves can slow down from and a forward pass limits it
+ *           to what the move can speed up to. Moves in the same direction
+ *           join at the lower of their cruise speeds, a reversal joins at 0.
+ *           The moves are cut into blocks of about 8 ms of steps at a fixed
+ *           interval which are passed to the step interrupt through the
+ *           block ring in Motion.c. Only the main loop uses this file.
+ *           MotionQueueService must be called often enough to keep the ring
+ *           from emptying, the ring holds about 128 ms of steps.
+ *           A stop drops the blocks not yet started and slows down from
+ *           the block being made. The binary protocol MOVE_TO command
+ *           queues its moves here so a host can send a path of positions.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Motion.h"
+#include "MotionQueue.h"
+
+//define external global variables
+extern volatile unsigned char MotionStopRequest;
+
+//define variables used in this file
+MOTION_MOVE MotionMoves[MOTION_QUEUE_SIZE];
+unsigned char MoveHead = 0;                         //next free move
+unsigned char MoveTail = 0;                         //move being cut into blocks
+unsigned char MoveStarted = 0;                      //set once the tail move has blocks, its exit speed is then fixed
+unsigned long MoveStep = 0;                         //steps of the tail move already in blocks
+unsigned int MoveEntrySpeed = 0;                    //speed at the start of the tail move
+signed long QueuePosition = 0;                      //position at the end of the last move queued
+signed long PreparedPosition = 0;                   //position at the end of the last move in blocks
+unsigned int BlockAcceleration = DEFAULT_ACCELERATION;  //acceleration of the move the last block came from
+
+
+
+//***************************************************************
+//Empty the queue, call after InitialiseMotion
+
+void    InitialiseMotionQueue(void)
+{
+    MoveHead = 0;
+    MoveTail = 0;
+    MoveStarted = 0;
+    MoveStep = 0;
+    MoveEntrySpeed = 0;
+    QueuePosition = MotionGetPosition();
+    PreparedPosition = QueuePosition;
+}
+
+
+
+//***************************************************************
+//Find the speed reached from Speed after Steps at the passed acceleration
+//v * v = u * u + 2 * a * s, limited to the fastest step rate
+
+static unsigned int    ReachSpeed(unsigned int Speed, unsigned int Acceleration, unsigned long Steps)
+{
+    unsigned long Square;
+
+    Square = (unsigned long)Speed * Speed;
+    //2 * a * s must stay below the limit so the sum cannot overflow
+    if(Steps >= ((unsigned long)MOTION_MAX_SPEED * MOTION_MAX_SPEED - Square) / (2UL * Acceleration))
+    {
+        return MOTION_MAX_SPEED;
+    }
+    return SquareRoot(Square + 2UL * Acceleration * Steps);
+}
+
+
+
+//***************************************************************
+//Find the speed for step number Step of the tail move, counted from 1
+//the lowest of the cruise speed, the speed reached from the entry speed
+//and the speed the move can still slow down to its exit speed from
+
+static unsigned int    SpeedAt(MOTION_MOVE *Move, unsigned long Step)
+{
+    unsigned int Speed;
+    unsigned int Limit;
+
+    Speed = Move->Speed;
+    Limit = ReachSpeed(MoveEntrySpeed, Move->Acceleration, Step);
+    if(Limit < Speed)
+    {
+        Speed = Limit;
+    }
+    Limit = ReachSpeed(Move->ExitSpeed, Move->Acceleration, Move->Steps - Step + 1);
+    if(Limit < Speed)
+    {
+        Speed = Limit;
+    }
+    return Speed;
+}
+
+
+
+//***************************************************************
+//Plan the exit speed of each move that has no blocks yet
+
+static void    LookAhead(void)
+{
+    MOTION_MOVE *Move;
+    MOTION_MOVE *NextMove;
+    unsigned char First;
+    unsigned char Index;
+    unsigned int Speed;
+    unsigned int Limit;
+
+    //the exit speed of a move already in blocks cannot change
+    First = MoveTail;
+    Speed = MoveEntrySpeed;
+    if(MoveStarted != 0)
+    {
+        Speed = MotionMoves[First & MOTION_QUEUE_MASK].ExitSpeed;
+        First++;
+    }
+    if(First == MoveHead)
+    {
+        return;
+    }
+
+    //backward pass, the last move stops
+    Index = MoveHead - 1;
+    MotionMoves[Index & MOTION_QUEUE_MASK].ExitSpeed = 0;
+    while(Index != First)
+    {
+        NextMove = &MotionMoves[Index & MOTION_QUEUE_MASK];
+        Index--;
+        Move = &MotionMoves[Index & MOTION_QUEUE_MASK];
+        Move->ExitSpeed = 0;
+        if(Move->Direction == NextMove->Direction)
+        {
+            Move->ExitSpeed = Move->Speed;
+            if(NextMove->Speed < Move->ExitSpeed)
+            {
+                Move->ExitSpeed = NextMove->Speed;
+            }
+            Limit = ReachSpeed(NextMove->ExitSpeed, NextMove->Acceleration, NextMove->Steps);
+            if(Limit < Move->ExitSpeed)
+            {
+                Move->ExitSpeed = Limit;
+            }
+        }
+    }
+
+    //forward pass from the speed at the start of the first move
+    for(Index = First; Index != MoveHead; Index++)
+    {
+        Move = &MotionMoves[Index & MOTION_QUEUE_MASK];
+        Limit = ReachSpeed(Speed, Move->Acceleration, Move->Steps);
+        if(Limit < Move->ExitSpeed)
+        {
+            Move->ExitSpeed = Limit;
+        }
+        Speed = Move->ExitSpeed;
+    }
+}
+
+
+
+//***************************************************************
+//Add a move to the passed position to the queue
+//Interval is the cruise step interval in us, Acceleration is in steps/s/s
+//returns MOTION_QUEUE_FULL if there is no room, MOTION_BUSY if a single
+//move from Motion.c is running or MOTION_HALTED after MotionHalt
+
+unsigned int    MotionQueueAdd(signed long Target, unsigned int Interval, unsigned int Acceleration)
+{
+    MOTION_MOVE *Move;
+    signed long Steps;
+
+    if(MotionIsHalted() != 0)
+    {
+        return MOTION_HALTED;
+    }
+    if((unsigned char)(MoveHead - MoveTail) >= MOTION_QUEUE_SIZE)
+    {
+        return MOTION_QUEUE_FULL;
+    }
+    if(MotionBlocksActive() == 0)
+    {
+        if(MotionBusy() != 0)
+        {
+            return MOTION_BUSY;
+        }
+        //the queue is idle, start from where the motor is
+        QueuePosition = MotionGetPosition();
+        PreparedPosition = QueuePosition;
+    }
+
+    Steps = Target - QueuePosition;
+    if(Steps == 0)
+    {
+        return MOTION_OK;
+    }
+
+    Move = &MotionMoves[MoveHead & MOTION_QUEUE_MASK];
+    Move->Target = Target;
+    Move->Direction = 1;
+    if(Steps < 0)
+    {
+        Move->Direction = -1;
+        Steps = -Steps;
+    }
+    Move->Steps = (unsigned long)Steps;
+    if(Interval < MOTION_MIN_DELAY)
+    {
+        Interval = MOTION_MIN_DELAY;
+    }
+    Move->Speed = (unsigned int)(MOTION_TIMER_FREQUENCY / Interval);
+    if(Acceleration < MIN_ACCELERATION)
+    {
+        Acceleration = MIN_ACCELERATION;
+    }
+    if(Acceleration > MAX_ACCELERATION)
+    {
+        Acceleration = MAX_ACCELERATION;
+    }
+    Move->Acceleration = Acceleration;
+    Move->ExitSpeed = 0;
+    MoveHead++;
+    QueuePosition = Target;
+
+    LookAhead();
+    MotionQueueService();
+    return MOTION_OK;
+}
+
+
+
+//***************************************************************
+//Stop the queued moves as quickly as the acceleration allows
+//the blocks the step interrupt has not started are dropped and the
+//queue replaced by one move that slows down from the speed of the block
+//being made, so only that block runs on at speed
+
+static void    StopQueue(void)
+{
+    MOTION_MOVE *Move;
+    unsigned int Interval;
+    unsigned int Acceleration;
+    signed long Position;
+    signed char Direction;
+    unsigned long StopSteps;
+
+    Interval = MotionDropBlocks(&Position, &Direction);
+    Acceleration = BlockAcceleration;
+    MoveHead = MoveTail;
+    MoveStep = 0;
+    MoveStarted = 0;
+    MoveEntrySpeed = 0;
+    PreparedPosition = Position;
+    QueuePosition = Position;
+    if(Interval == 0)
+    {
+        //no step has been made yet
+        return;
+    }
+
+    //steps to stop from the present speed, s = v * v / (2 * a)
+    Move = &MotionMoves[MoveHead & MOTION_QUEUE_MASK];
+    Move->Speed = (unsigned int)(MOTION_TIMER_FREQUENCY / Interval);
+    StopSteps = (unsigned long)Move->Speed * Move->Speed / (2UL * Acceleration) + 1;
+    Move->Steps = StopSteps;
+    Move->Direction = Direction;
+    Move->Target = Position + (signed long)StopSteps * Direction;
+    Move->Acceleration = Acceleration;
+    Move->ExitSpeed = 0;
+    MoveEntrySpeed = Move->Speed;
+    MoveStarted = 1;
+    MoveHead++;
+    QueuePosition = Move->Target;
+}
+
+
+
+//***************************************************************
+//Cut queued moves into step blocks while the block ring has room
+//called from the main loop every ms
+
+void    MotionQueueService(void)
+{
+    MOTION_MOVE *Move;
+    unsigned long Count;
+    unsigned int Speed;
+
+    //nothing queued and no blocks being made
+    if(MoveTail == MoveHead && MotionBlocksActive() == 0)
+    {
+        return;
+    }
+
+    //a halt has dropped the blocks, the moves left are dropped too
+    if(MotionIsHalted() != 0)
+    {
+        MoveHead = MoveTail;
+        MoveStep = 0;
+        MoveStarted = 0;
+        MoveEntrySpeed = 0;
+        return;
+    }
+
+    //MotionStop sets the request, single moves act on it themselves
+    if(MotionStopRequest != 0 && MotionBlocksActive() != 0)
+    {
+        MotionStopRequest = 0;
+        StopQueue();
+    }
+
+    while(MoveTail != MoveHead && MotionBlockSpace() != 0)
+    {
+        Move = &MotionMoves[MoveTail & MOTION_QUEUE_MASK];
+        MoveStarted = 1;
+
+        //steps in 8 ms at the speed of the first step in the block
+        Count = SpeedAt(Move, MoveStep + 1) / MOTION_BLOCK_RATE;
+        if(Count == 0)
+        {
+            Count = 1;
+        }
+        if(Count > Move->Steps - MoveStep)
+        {
+            Count = Move->Steps - MoveStep;
+        }
+
+        //every step in the block is made at the speed of its middle step
+        Speed = SpeedAt(Move, MoveStep + (Count + 1) / 2);
+        if(Speed < MOTION_MIN_SPEED)
+        {
+            Speed = MOTION_MIN_SPEED;
+        }
+        MotionPushBlock((unsigned int)Count, (unsigned int)(MOTION_TIMER_FREQUENCY / Speed), Move->Direction);
+        BlockAcceleration = Move->Acceleration;
+        MoveStep = MoveStep + Count;
+
+        //go on to the next move
+        if(MoveStep >= Move->Steps)
+        {
+            MoveEntrySpeed = Move->ExitSpeed;
+            PreparedPosition = Move->Target;
+            MoveTail++;
+            MoveStep = 0;
+            MoveStarted = 0;
+        }
+    }
+
+    //the step interrupt stops when the ring empties after the last move
+    MotionRunBlocks(MoveTail == MoveHead);
+}
+
+
+
+//***************************************************************
+//Get the number of moves waiting or being cut into blocks
+
+unsigned int    MotionQueueCount(void)
+{
+    return (unsigned char)(MoveHead - MoveTail);
+}
+
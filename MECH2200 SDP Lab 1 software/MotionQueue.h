@@ -0,0 +1,42 @@
+/*
+ * File: MotionQueue.h
+ * Author: Roger Berry
+ * Comments: Queue of stepper moves joined without stopping by look ahead
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef MOTION_QUEUE_H
+#define	MOTION_QUEUE_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define queue constants
+#define MOTION_QUEUE_SIZE           4           //moves waiting, power of 2
+#define MOTION_QUEUE_MASK           (MOTION_QUEUE_SIZE - 1)
+#define MOTION_BLOCK_RATE           125         //blocks per second at any speed, 8 ms each
+#define MOTION_MAX_SPEED            (unsigned int)(MOTION_TIMER_FREQUENCY / MOTION_MIN_DELAY)
+#define MOTION_MIN_SPEED            (unsigned int)(MOTION_TIMER_FREQUENCY / MOTION_MAX_DELAY + 1)
+
+//one queued move, speeds are in steps/s
+typedef struct
+{
+    signed long Target;                     //absolute position at the end of the move
+    unsigned long Steps;
+    signed char Direction;                  //+1 or -1
+    unsigned int Speed;                     //cruise speed
+    unsigned int Acceleration;              //steps/s/s used to speed up and slow down
+    unsigned int ExitSpeed;                 //speed at the end of the move, set by the look ahead
+} MOTION_MOVE;
+
+//declare functions
+void    InitialiseMotionQueue(void);
+unsigned int    MotionQueueAdd(signed long, unsigned int, unsigned int);
+void    MotionQueueService(void);
+unsigned int    MotionQueueCount(void);
+
+
+
+#endif	/* MOTION_QUEUE_H */
+
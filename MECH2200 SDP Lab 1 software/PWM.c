@@ -186,5 +186,52 @@ void    Disable_10BitPWM_Timer(void)
 
 
 
+//****************************************************
+//Start step pulses on the STEP pin every Interval us
+//Elapsed is the time already passed in the first interval
+//each pulse starts at the phase match as the timer rolls over
+
+void    StepPWM_On(unsigned int Interval, unsigned int Elapsed)
+{
+    PWM11CON = 0x00;                                //ensure PWM11 is off
+    PWM11OFCONbits.OFM = 0b00;                      //independent run mode
+    PWM11CLKCONbits.CS = 0b00;                      //clock source Fosc
+    PWM11CLKCONbits.PS = 0b101;                     //1:32 prescaler, 1 us count
+    PWM11OF = 0x0000;                               //no offset applied
+    PWM11PH = 0x0000;                               //pulse starts as the timer rolls over
+    PWM11DC = STEP_PULSE_WIDTH;                     //pulse ends after the pulse width
+    PWM11PR = Interval - 1;                         //period in us
+    
+    //a timer inside the pulse would make an extra step
+    if(Elapsed < STEP_PULSE_WIDTH)
+    {
+        Elapsed = STEP_PULSE_WIDTH;
+    }
+    PWM11TMR = Elapsed;
+    
+    //the phase interrupt is only enabled to stop at the next pulse
+    STEP_PWM_PHASE_INTERRUPT_ENABLE = 0b0;
+    STEP_PWM_PHASE_INTERRUPT_FLAG = 0b0;
+    PERIPHERAL_STEP_PWM_INTERRUPT_FLAG = 0b0;
+    PERIPHERAL_STEP_PWM_INTERRUPT_ENABLE = 0b1;
+    
+    PWM11LDCONbits.LDA = 0b1;                       //load all values into buffers
+    PWM11CONbits.EN = 0b1;                          //enable PWM module
+    DRV8711_STEP_SOURCE = STEP_PWM_OUTPUT;          //STEP pin driven by PWM11
+}
 
 
+
+//****************************************************
+//Stop step pulses and return the STEP pin to its latch, which is low
+
+void    StepPWM_Off(void)
+{
+    DRV8711_STEP_WRITE = 0b0;
+    DRV8711_STEP_SOURCE = LATCH_OUTPUT;             //STEP pin driven by its latch
+    PWM11CONbits.EN = 0b0;                          //disable PWM module
+    STEP_PWM_PHASE_INTERRUPT_ENABLE = 0b0;
+    STEP_PWM_PHASE_INTERRUPT_FLAG = 0b0;
+    PERIPHERAL_STEP_PWM_INTERRUPT_FLAG = 0b0;
+}
+
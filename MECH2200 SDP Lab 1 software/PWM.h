@@ -22,6 +22,14 @@
 #define PWM6_INTERRUPT_FLAG                     PWM6INTFbits.PRIF
 #define PWM6_LOAD                               PWM6LDCONbits.LDA
 
+//PWM11 makes the stepper STEP pulses at the cruise speed
+#define STEP_PWM_TIME                           PWM11TMR
+#define PERIPHERAL_STEP_PWM_INTERRUPT_ENABLE    PIE6bits.PWM11IE
+#define PERIPHERAL_STEP_PWM_INTERRUPT_FLAG      PIR6bits.PWM11IF
+#define STEP_PWM_PHASE_INTERRUPT_ENABLE         PWM11INTEbits.PHIE
+#define STEP_PWM_PHASE_INTERRUPT_FLAG           PWM11INTFbits.PHIF
+#define STEP_PULSE_WIDTH                        3       //us, DRV8711 minimum is 1.9 us
+
 #define TIMER2_INTERRUPT_FLAG                   PIR1bits.TMR2IF
 #define TIMER2_INTERRUPT_ENABLE                 PIE1bits.TMR2IE
 #define TIMER4_INTERRUPT_FLAG                   PIR4bits.TMR4IF
@@ -36,6 +44,8 @@ void    EnablePWM_2(void);
 void    DisablePWM_2(void);
 void    Enable_10BitPWM_Timer(void);
 void    Disable_10BitPWM_Timer(void);
+void    StepPWM_On(unsigned int, unsigned int);
+void    StepPWM_Off(void);
 
 
 
@@ -0,0 +1,387 @@
+/*
+ * File: Protocol.c
+ * Author: Roger Berry
+ * Comments: Binary framed command protocol used alongside the ASCII menu
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Comms.h"
+#include "Protocol.h"
+#include "SPI.h"
+#include "ADC.h"
+#include "Motion.h"
+#include "MotionQueue.h"
+
+//define external global variables
+extern  volatile unsigned int GLOBAL_StepperMotorSpeed;
+extern  volatile unsigned int GLOBAL_DirectionStatus;
+
+//parser for frames arriving through the UART
+FRAME_PARSER UART_FrameParser = {FRAME_WAIT_SYNC, 0, 0, 0, 0};
+
+
+
+//***************************************************************
+//Update the CRC-8 with the passed byte
+
+unsigned char   ProtocolCrc8(unsigned char Crc, unsigned char Value)
+{
+    unsigned char Loop;
+
+    Crc = Crc ^ Value;
+    for(Loop = 0; Loop < 8; Loop++)
+    {
+        //test the top bit before shifting
+        if(Crc & 0x80)
+        {
+            Crc = (unsigned char)(Crc << 1) ^ PROTOCOL_CRC_POLYNOMIAL;
+        }
+        else
+        {
+            Crc = (unsigned char)(Crc << 1);
+        }
+    }
+    return Crc;
+}
+
+
+
+//***************************************************************
+//Build a frame in the passed buffer from the opcode and payload
+//the buffer must hold PROTOCOL_MAX_FRAME bytes
+//returns the frame length or 0 if the payload is too long
+
+unsigned int    ProtocolEncodeFrame(unsigned char Opcode, const unsigned char *Payload, unsigned int Length, unsigned char *Frame)
+{
+    unsigned int Index;
+    unsigned char Crc;
+
+    //test for payload too long
+    if(Length > PROTOCOL_MAX_PAYLOAD)
+    {
+        return 0;
+    }
+
+    //header
+    Frame[0] = PROTOCOL_SYNC;
+    Frame[1] = (unsigned char)Length;
+    Frame[2] = Opcode;
+    Crc = ProtocolCrc8(0, (unsigned char)Length);
+    Crc = ProtocolCrc8(Crc, Opcode);
+
+    //payload
+    for(Index = 0; Index < Length; Index++)
+    {
+        Frame[Index + 3] = Payload[Index];
+        Crc = ProtocolCrc8(Crc, Payload[Index]);
+    }
+
+    //CRC
+    Frame[Length + 3] = Crc;
+
+    return Length + 4;
+}
+
+
+
+//***************************************************************
+//Reset the passed parser to wait for a sync byte
+
+void    ProtocolResetParser(FRAME_PARSER *Parser)
+{
+    Parser->State = FRAME_WAIT_SYNC;
+    Parser->Count = 0;
+}
+
+
+
+//***************************************************************
+//Pass the next received byte to the parser
+//returns FRAME_COMPLETE when a frame with a valid CRC is held in the parser
+
+unsigned int    ProtocolParseByte(FRAME_PARSER *Parser, unsigned char Value)
+{
+    unsigned int Result = FRAME_PENDING;
+
+    switch(Parser->State)
+    {
+        case FRAME_WAIT_SYNC:
+            //ignore everything until a sync byte
+            if(Value == PROTOCOL_SYNC)
+            {
+                Parser->State = FRAME_WAIT_LENGTH;
+            }
+            break;
+
+        case FRAME_WAIT_LENGTH:
+            //test for payload too long, the sync byte was probably noise
+            if(Value > PROTOCOL_MAX_PAYLOAD)
+            {
+                ProtocolResetParser(Parser);
+                Result = FRAME_LENGTH_ERROR;
+            }
+            else
+            {
+                Parser->Length = Value;
+                Parser->Crc = ProtocolCrc8(0, Value);
+                Parser->State = FRAME_WAIT_OPCODE;
+            }
+            break;
+
+        case FRAME_WAIT_OPCODE:
+            Parser->Opcode = Value;
+            Parser->Crc = ProtocolCrc8(Parser->Crc, Value);
+            Parser->Count = 0;
+            //skip the payload state for frames without one
+            if(Parser->Length == 0)
+            {
+                Parser->State = FRAME_WAIT_CRC;
+            }
+            else
+            {
+                Parser->State = FRAME_WAIT_PAYLOAD;
+            }
+            break;
+
+        case FRAME_WAIT_PAYLOAD:
+            Parser->Payload[Parser->Count] = Value;
+            Parser->Crc = ProtocolCrc8(Parser->Crc, Value);
+            Parser->Count++;
+            if(Parser->Count >= Parser->Length)
+            {
+                Parser->State = FRAME_WAIT_CRC;
+            }
+            break;
+
+        case FRAME_WAIT_CRC:
+            //frame finished, wait for the next sync byte whatever the result
+            Parser->State = FRAME_WAIT_SYNC;
+            if(Value == Parser->Crc)
+            {
+                Result = FRAME_COMPLETE;
+            }
+            else
+            {
+                Result = FRAME_CRC_ERROR;
+            }
+            break;
+
+        default:    //corrupt state
+            ProtocolResetParser(Parser);
+    }
+
+    return Result;
+}
+
+
+
+//***************************************************************
+//Test for a UART frame being received
+//while a frame is active every byte belongs to it, not to the ASCII menu
+
+unsigned int    ProtocolFrameActive(void)
+{
+    return UART_FrameParser.State != FRAME_WAIT_SYNC;
+}
+
+
+
+//***************************************************************
+//Pass a byte from the UART to the frame parser and act on complete frames
+//returns 1 if the byte was used by the protocol, 0 if it belongs to the ASCII menu
+
+unsigned int    ProtocolReceiveByte(unsigned char Value)
+{
+    unsigned int Result;
+    unsigned char Nak[2];
+    unsigned char Frame[PROTOCOL_MAX_FRAME];
+    unsigned int Length;
+    unsigned int Index;
+
+    //test for a byte that is not part of a frame
+    if(UART_FrameParser.State == FRAME_WAIT_SYNC && Value != PROTOCOL_SYNC)
+    {
+        return 0;
+    }
+
+    Result = ProtocolParseByte(&UART_FrameParser, Value);
+    if(Result == FRAME_COMPLETE)
+    {
+        ProtocolExecute(&UART_FrameParser);
+    }
+    else if(Result == FRAME_CRC_ERROR)
+    {
+        //tell the host the frame was not acted on
+        Nak[0] = UART_FrameParser.Opcode;
+        Nak[1] = PROTOCOL_ERROR_CRC;
+        Length = ProtocolEncodeFrame(PROTOCOL_NAK, Nak, 2, Frame);
+        for(Index = 0; Index < Length; Index++)
+        {
+            SendChar(Frame[Index]);
+        }
+    }
+
+    return 1;
+}
+
+
+
+//***************************************************************
+//Carry out the command held in the passed parser and send the reply
+
+void    ProtocolExecute(FRAME_PARSER *Parser)
+{
+    unsigned char Reply[PROTOCOL_MAX_PAYLOAD];
+    unsigned char Frame[PROTOCOL_MAX_FRAME];
+    unsigned int ReplyLength = 0;
+    unsigned char Error = 0;
+    unsigned int Value = 0;
+    signed long Position;
+    unsigned int Length;
+    unsigned int Index;
+
+    switch(Parser->Opcode)
+    {
+        case PROTOCOL_QUERY_STATUS:
+            //DRV8711 status, step interval and direction
+            Value = ReadSPI(DRV_STATUS_REG);
+            Reply[0] = (unsigned char)(Value >> 8);
+            Reply[1] = (unsigned char)Value;
+            Reply[2] = (unsigned char)(GLOBAL_StepperMotorSpeed >> 8);
+            Reply[3] = (unsigned char)GLOBAL_StepperMotorSpeed;
+            Reply[4] = (unsigned char)GLOBAL_DirectionStatus;
+            ReplyLength = 5;
+            break;
+
+        case PROTOCOL_SET_SPEED:
+            if(Parser->Length != 2)
+            {
+                Error = PROTOCOL_ERROR_LENGTH;
+                break;
+            }
+            Value = ((unsigned int)Parser->Payload[0] << 8) | Parser->Payload[1];
+            //same limit as the menu entry
+            if(Value < 500)
+            {
+                Error = PROTOCOL_ERROR_VALUE;
+                break;
+            }
+            GLOBAL_StepperMotorSpeed = Value;
+            break;
+
+        case PROTOCOL_READ_REGISTER:
+            if(Parser->Length != 1)
+            {
+                Error = PROTOCOL_ERROR_LENGTH;
+                break;
+            }
+            if(Parser->Payload[0] > DRV_STATUS_REG)
+            {
+                Error = PROTOCOL_ERROR_VALUE;
+                break;
+            }
+            Value = ReadSPI(Parser->Payload[0]);
+            Reply[0] = Parser->Payload[0];
+            Reply[1] = (unsigned char)(Value >> 8);
+            Reply[2] = (unsigned char)Value;
+            ReplyLength = 3;
+            break;
+
+        case PROTOCOL_WRITE_REGISTER:
+            if(Parser->Length != 3)
+            {
+                Error = PROTOCOL_ERROR_LENGTH;
+                break;
+            }
+            Value = ((unsigned int)Parser->Payload[1] << 8) | Parser->Payload[2];
+            //registers are 12 bits wide
+            if(Parser->Payload[0] > DRV_STATUS_REG || Value > 0x0FFF)
+            {
+                Error = PROTOCOL_ERROR_VALUE;
+                break;
+            }
+            //keep the shadow copy up to date
+            if(WriteDRV8711(Parser->Payload[0], Value) != DRV_SETTINGS_OK)
+            {
+                Error = PROTOCOL_ERROR_VALUE;
+            }
+            break;
+
+        case PROTOCOL_READ_ADC:
+            if(Parser->Length != 1)
+            {
+                Error = PROTOCOL_ERROR_LENGTH;
+                break;
+            }
+            switch(Parser->Payload[0])
+            {
+                case 0:     //speed control potentiometer
+                    Value = GetSpeedControlValue();
+                    break;
+
+                case 1:     //analogue input 1
+                    Value = GetAnalogueChannel_1_Value();
+                    break;
+
+                case 2:     //analogue input 2
+                    Value = GetAnalogueChannel_2_Value();
+                    break;
+
+                default:    //no such channel
+                    Error = PROTOCOL_ERROR_VALUE;
+            }
+            Reply[0] = (unsigned char)(Value >> 8);
+            Reply[1] = (unsigned char)Value;
+            ReplyLength = 2;
+            break;
+
+        case PROTOCOL_MOVE_TO:
+            if(Parser->Length != 4)
+            {
+                Error = PROTOCOL_ERROR_LENGTH;
+                break;
+            }
+            Position = (signed long)(((unsigned long)Parser->Payload[0] << 24) | ((unsigned long)Parser->Payload[1] << 16) |
+                                     ((unsigned long)Parser->Payload[2] << 8) | Parser->Payload[3]);
+            //the reply is sent when the move is queued, poll GET_POSITION for completion
+            //moves in the same direction join without stopping
+            if(MotionQueueAdd(Position, GLOBAL_StepperMotorSpeed, MotionGetAcceleration()) != MOTION_OK)
+            {
+                Error = PROTOCOL_ERROR_BUSY;
+            }
+            break;
+            
+        case PROTOCOL_GET_POSITION:
+            Position = MotionGetPosition();
+            Reply[0] = (unsigned char)(Position >> 24);
+            Reply[1] = (unsigned char)(Position >> 16);
+            Reply[2] = (unsigned char)(Position >> 8);
+            Reply[3] = (unsigned char)Position;
+            Reply[4] = (unsigned char)MotionIsComplete();
+            ReplyLength = 5;
+            break;
+
+        default:    //unknown opcode
+            Error = PROTOCOL_ERROR_OPCODE;
+    }
+
+    //build the reply or NAK frame
+    if(Error != 0)
+    {
+        Reply[0] = Parser->Opcode;
+        Reply[1] = Error;
+        Length = ProtocolEncodeFrame(PROTOCOL_NAK, Reply, 2, Frame);
+    }
+    else
+    {
+        Length = ProtocolEncodeFrame(Parser->Opcode | PROTOCOL_REPLY, Reply, ReplyLength, Frame);
+    }
+
+    //send the frame, it contains binary values so it cannot be sent as a string
+    for(Index = 0; Index < Length; Index++)
+    {
+        SendChar(Frame[Index]);
+    }
+}
+
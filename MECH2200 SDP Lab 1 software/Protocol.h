@@ -0,0 +1,82 @@
+/*
+ * File: Protocol.h
+ * Author: Roger Berry
+ * Comments: Binary framed command protocol used alongside the ASCII menu
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef PROTOCOL_H
+#define	PROTOCOL_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//frame format
+//  SYNC | LENGTH | OPCODE | PAYLOAD (LENGTH bytes) | CRC
+//the CRC is CRC-8 (polynomial 0x07, initial value 0) over LENGTH, OPCODE and PAYLOAD
+//multi byte values are sent high byte first
+//a reply uses the request opcode with the reply bit set, errors use PROTOCOL_NAK
+
+//define frame constants
+#define PROTOCOL_SYNC               0xA5    //never produced by the ASCII menu
+#define PROTOCOL_MAX_PAYLOAD        8
+#define PROTOCOL_MAX_FRAME          (PROTOCOL_MAX_PAYLOAD + 4)
+#define PROTOCOL_CRC_POLYNOMIAL     0x07
+#define PROTOCOL_REPLY              0x80    //set in the opcode of a reply
+
+//define opcodes
+#define PROTOCOL_QUERY_STATUS       0x01    //no payload, reply DRV8711 status, step interval, direction
+#define PROTOCOL_SET_SPEED          0x02    //step interval in us (2 bytes)
+#define PROTOCOL_READ_REGISTER      0x03    //DRV8711 register address (1 byte), reply address and value
+#define PROTOCOL_WRITE_REGISTER     0x04    //DRV8711 register address (1 byte) and value (2 bytes)
+#define PROTOCOL_READ_ADC           0x05    //ADC channel (1 byte), reply result (2 bytes)
+#define PROTOCOL_MOVE_TO            0x06    //signed step position (4 bytes), queued behind earlier moves
+#define PROTOCOL_GET_POSITION       0x07    //no payload, reply signed step position (4 bytes) and move complete (1 byte)
+#define PROTOCOL_NAK                0xFF    //payload is the failed opcode and an error code
+
+//define NAK error codes
+#define PROTOCOL_ERROR_CRC          0x01
+#define PROTOCOL_ERROR_OPCODE       0x02
+#define PROTOCOL_ERROR_LENGTH       0x03
+#define PROTOCOL_ERROR_VALUE        0x04
+#define PROTOCOL_ERROR_UNSUPPORTED  0x05
+#define PROTOCOL_ERROR_BUSY         0x06
+
+//define parser states
+#define FRAME_WAIT_SYNC             0
+#define FRAME_WAIT_LENGTH           1
+#define FRAME_WAIT_OPCODE           2
+#define FRAME_WAIT_PAYLOAD          3
+#define FRAME_WAIT_CRC              4
+
+//define parser results
+#define FRAME_PENDING               0       //more bytes needed
+#define FRAME_COMPLETE              1       //valid frame held in the parser
+#define FRAME_CRC_ERROR             2       //frame discarded
+#define FRAME_LENGTH_ERROR          3       //frame discarded
+
+//frame parser, one per byte stream
+typedef struct
+{
+    unsigned char State;
+    unsigned char Length;
+    unsigned char Opcode;
+    unsigned char Count;
+    unsigned char Crc;
+    unsigned char Payload[PROTOCOL_MAX_PAYLOAD];
+} FRAME_PARSER;
+
+//declare functions
+unsigned char   ProtocolCrc8(unsigned char, unsigned char);
+unsigned int    ProtocolEncodeFrame(unsigned char, const unsigned char *, unsigned int, unsigned char *);
+void    ProtocolResetParser(FRAME_PARSER *);
+unsigned int    ProtocolParseByte(FRAME_PARSER *, unsigned char);
+unsigned int    ProtocolFrameActive(void);
+unsigned int    ProtocolReceiveByte(unsigned char);
+void    ProtocolExecute(FRAME_PARSER *);
+
+
+
+#endif	/* PROTOCOL_H */
+
@@ -14,6 +14,43 @@
 extern volatile unsigned int GLOBAL_StepperPowerStatus;
 extern volatile unsigned char GLOBAL_ResultString[RESULT_STRING_LENGTH];
 
+//clock settings for each device, in device number order
+//both are mode 0 i.e. data is sampled on the rising edge of the clock and shifted out on the falling edge
+const SPI_DEVICE SPI_Devices[SPI_DEVICE_COUNT] =
+{
+    {DRV8711_CLOCK_DIVIDER, 0b0, 0b1, 0b1},     //DRV8711, sample at end of data time
+    {LED_CLOCK_DIVIDER, 0b0, 0b1, 0b0}          //LED display, write only
+};
+unsigned char SPI_CurrentDevice = SPI_NO_DEVICE;    //device whose profile is loaded
+unsigned int SPI_StartTime;                         //time the transaction on the bus started
+volatile unsigned int SPI_TransferTime[SPI_DEVICE_COUNT];  //last transaction time for each device in us
+
+//SPI transaction queue, holds pointers to the caller's transactions
+SPI_TRANSACTION * volatile SPI_Queue[SPI_QUEUE_SIZE];
+volatile unsigned char SPI_QueueHeadIndex = 0;      //next free location, written by the main code
+volatile unsigned char SPI_QueueTailIndex = 0;      //transaction on the bus, written by the interrupt
+volatile unsigned char SPI_Busy = 0;                //set while the interrupt is working through the queue
+
+//DRV8711 power up settings, in register address order
+const unsigned int DRV8711_Settings[DRV_REGISTER_COUNT] =
+{
+    DRV_CTRL_REG_VALUE,
+    DRV_TORQUE_REG_VALUE,
+    DRV_OFF_REG_VALUE,
+    DRV_BLANK_REG_VALUE,
+    DRV_DECAY_REG_VALUE,
+    DRV_STALL_REG_VALUE,
+    DRV_DRIVE_REG_VALUE
+};
+
+//copy of the values written to the DRV8711 so fields can be changed without reading the device
+unsigned int DRV8711_Shadow[DRV_REGISTER_COUNT];
+unsigned int DRV8711_Verify = 0;            //read back every write when set
+unsigned int DRV8711_CheckRegister = 0;     //register being compared by CheckDRV8711
+unsigned int DRV8711_CheckExpected;         //shadow value when the read was queued
+SPI_TRANSACTION DRV8711_CheckTransaction;
+unsigned int DRV8711_RestoreCount = 0;      //times the device was found to have lost its settings
+
 
 //*******************************************************
 //Initialise SPI
@@ -25,109 +62,310 @@ void    InitialiseSPI(void)
     //the clock idle state is low 
     
     SSP1CON1bits.SSPEN = 0b0;               //disable SPI        
-    SSP1ADD = 63;                           //DRV8711 SPI speed limit is 250 KHz so set for 125 KHz
-    SSP1CON1bits.SSPM = 0b1010;             //set for SPI master mode FOSC/(SSP1ADD + 1)
+    SSP1CON1bits.SSPM = 0b1010;             //set for SPI master mode FOSC/(4 * (SSP1ADD + 1))
     SSP1CON3bits.BOEN = 0b1;                //load rx byte regardless of the state of BF flag
-    SPI_CLOCK_IDLE_STATE_CKP = 0b0;         //clock idle state is low
-    SPI_RX_BIT_SAMPLE_SMP = 0b1;            //sample at end of data time
-    SPI_TX_CLOCK_EDGE_CKE = 0b1;            //Data changes when clock goes from active to idle (high to low)
+    //the clock speed and mode are loaded from the device profile when a transaction starts
+    SPI_CurrentDevice = SPI_NO_DEVICE;
     SSP1CON1bits.SSPEN = 0b1;               //enable SPI        
     
+    //LED display chip select is active low so idle high
+    GPIO_8_WRITE = 0b1;
+    GPIO_8_DIRECTION = OUTPUT;
+    
+    //empty transaction queue, the interrupt is enabled when a transaction is queued
+    SPI_QueueHeadIndex = 0;
+    SPI_QueueTailIndex = 0;
+    SPI_Busy = 0;
+    SPI_INTERRUPT_ENABLE = INTERRUPT_DISABLED;
+    SPI_INTERRUPT_FLAG = CLEAR_FLAG;
 }
 
 
 
 //***************************************************************
-//SPI Transmit
+//Drive the chip select of the passed device
 
-void    WriteSPI(unsigned int RegisterAddress, unsigned int Value)
+static void    SelectDevice(unsigned char Device, unsigned char Select)
 {
-    unsigned char TxByteHigh;
-    unsigned char TxByteLow;
-    unsigned char RxByte;
-    unsigned int RxWord;
+    switch(Device)
+    {
+        case SPI_DEVICE_DRV8711:    //active high
+            SPI_ENABLE_WRITE = Select;
+            break;
+            
+        case SPI_DEVICE_LED:        //active low
+            GPIO_8_WRITE = !Select;
+            break;
+            
+        //no default
+    }
+}
 
-    //prep data
-    //construct write command 
-    RegisterAddress = RegisterAddress << 12;
-    Value = Value | RegisterAddress;
-    TxByteHigh = (char)(Value >> 8);
-    TxByteLow = (char)Value;
-
-    //enable device
-    SPI_ENABLE_WRITE = 0b1;
-                
+
+
+//***************************************************************
+//Load the clock profile for the transaction at the tail of the queue,
+//select the device and send the first byte
+
+static void    StartTransaction(SPI_TRANSACTION *Transaction)
+{
+    const SPI_DEVICE *Profile;
+    
+    //load the device profile if the last transaction was for another device
+    //the clock can only be changed with the port disabled
+    if(Transaction->Device != SPI_CurrentDevice)
+    {
+        Profile = &SPI_Devices[Transaction->Device];
+        SSP1CON1bits.SSPEN = 0b0;
+        SSP1ADD = Profile->ClockDivider;
+        SPI_CLOCK_IDLE_STATE_CKP = Profile->ClockIdleState;
+        SPI_TX_CLOCK_EDGE_CKE = Profile->ClockEdge;
+        SPI_RX_BIT_SAMPLE_SMP = Profile->SampleTime;
+        SSP1CON1bits.SSPEN = 0b1;
+        SPI_CurrentDevice = Transaction->Device;
+    }
+    
+    SPI_StartTime = GetTime();
+    Transaction->Count = 0;
+    Transaction->Status = SPI_ACTIVE;
+    SelectDevice(Transaction->Device, 1);
     //clear overflow condition
     SSP1CON1bits.SSPOV = 0;
-    //transmit high byte
-    SSP1BUF = TxByteHigh;
-    //wait for received byte
-    while(SPI_RX_BUFFER_FULL == 0);
-    //get received SPI byte
-    RxByte = SSP1BUF;
-    //shift and save
-    RxWord = (unsigned int)RxByte << 8;
-    //transmit low byte
-    SSP1BUF = TxByteLow;
-    //wait for received byte
-    while(SPI_RX_BUFFER_FULL == 0);
-    //get received SPI byte
-    RxByte = SSP1BUF;
-    //shift and save
-    RxWord = RxWord | (unsigned int)RxByte;
-    
-    //disable chip select
-    SPI_ENABLE_WRITE = 0b0;
+    SSP1BUF = Transaction->TxData[0];
+}
+
+
+
+//***************************************************************
+//SPI interrupt, called from the high priority interrupt when a byte
+//has been exchanged. Also called by WaitSPI when interrupts are off.
+//Each byte received is saved and the next one sent. When a transaction
+//finishes the device is released and the next transaction started.
+
+void    SPI_InterruptService(void)
+{
+    SPI_TRANSACTION *Transaction;
+    
+    SPI_INTERRUPT_FLAG = CLEAR_FLAG;
+    
+    //test for nothing queued, can happen on the first call
+    if(SPI_QueueTailIndex == SPI_QueueHeadIndex)
+    {
+        SPI_Busy = 0;
+        SPI_INTERRUPT_ENABLE = INTERRUPT_DISABLED;
+        return;
+    }
+    
+    Transaction = SPI_Queue[SPI_QueueTailIndex & SPI_QUEUE_MASK];
+    
+    //test for the transaction being started by QueueSPI
+    if(Transaction->Status == SPI_QUEUED)
+    {
+        StartTransaction(Transaction);
+        return;
+    }
+    
+    //save the byte received and send the next
+    Transaction->RxData[Transaction->Count] = SSP1BUF;
+    Transaction->Count++;
+    if(Transaction->Count < Transaction->Length)
+    {
+        SSP1BUF = Transaction->TxData[Transaction->Count];
+        return;
+    }
+    
+    //transaction finished
+    SelectDevice(Transaction->Device, 0);
+    SPI_TransferTime[Transaction->Device] = GetTime() - SPI_StartTime;
+    SPI_QueueTailIndex++;
+    Transaction->Status = SPI_DONE;
+    if(Transaction->Callback != NULL)
+    {
+        Transaction->Callback(Transaction);
+    }
     
+    //start the next transaction or stop
+    if(SPI_QueueTailIndex != SPI_QueueHeadIndex)
+    {
+        StartTransaction(SPI_Queue[SPI_QueueTailIndex & SPI_QUEUE_MASK]);
+    }
+    else
+    {
+        SPI_Busy = 0;
+        SPI_INTERRUPT_ENABLE = INTERRUPT_DISABLED;
+    }
 }
 
+
+
 //***************************************************************
-//SPI Receive
+//Get the time taken by the last transaction for a device in microseconds
+//this is from chip select to the end of the last byte
 
-unsigned int    ReadSPI(unsigned int RegisterAddress)
+unsigned int    GetSPI_TransferTime(unsigned int Device)
 {
-    unsigned char TxByteHigh;
-    unsigned char TxByteLow;
-    unsigned char RxByte;
-    unsigned int RxWord;
-    unsigned int Value;
+    unsigned int Time;
+    
+    //the interrupt writes the value so stop it changing during the read
+    SPI_INTERRUPT_ENABLE = INTERRUPT_DISABLED;
+    Time = SPI_TransferTime[Device];
+    if(SPI_Busy != 0)
+    {
+        SPI_INTERRUPT_ENABLE = INTERRUPT_ENABLED;
+    }
+    
+    return Time;
+}
+
 
-    //prepare data
+
+//***************************************************************
+//Place a filled in transaction in the queue
+//returns SPI_QUEUE_FULL without waiting if there is no room
+//the transaction status becomes SPI_DONE when the bytes have been exchanged
+
+unsigned int    QueueSPI(SPI_TRANSACTION *Transaction)
+{
+    unsigned char InterruptEnable;
+    
+    //the step interrupt also queues transactions so hold interrupts off
+    //while the head is moved
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    
+    //test for no room
+    if((unsigned char)(SPI_QueueHeadIndex - SPI_QueueTailIndex) >= SPI_QUEUE_SIZE)
+    {
+        INTCONbits.GIE = InterruptEnable;
+        return SPI_QUEUE_FULL;
+    }
+    
+    Transaction->Status = SPI_QUEUED;
+    SPI_Queue[SPI_QueueHeadIndex & SPI_QUEUE_MASK] = Transaction;
+    SPI_QueueHeadIndex++;
+    
+    //if the bus is idle set the flag so the interrupt starts the transaction
+    if(SPI_Busy == 0)
+    {
+        SPI_Busy = 1;
+        SPI_INTERRUPT_FLAG = 1;
+        SPI_INTERRUPT_ENABLE = INTERRUPT_ENABLED;
+    }
+    INTCONbits.GIE = InterruptEnable;
+    return SPI_QUEUE_OK;
+}
+
+
+
+//***************************************************************
+//Test for no transactions queued or on the bus
+
+unsigned int    SPI_Idle(void)
+{
+    return (SPI_Busy == 0);
+}
+
+
+
+//***************************************************************
+//Get the number of transactions that can be queued without waiting
+
+unsigned int    SPI_QueueSpace(void)
+{
+    return SPI_QUEUE_SIZE - (unsigned char)(SPI_QueueHeadIndex - SPI_QueueTailIndex);
+}
+
+
+
+//***************************************************************
+//Wait for a queued transaction to finish
+//if interrupts are off, for example during initialisation, the
+//interrupt service is called from here instead
+
+void    WaitSPI(SPI_TRANSACTION *Transaction)
+{
+    while(Transaction->Status != SPI_DONE)
+    {
+        if(INTCONbits.GIE == 0 && SPI_INTERRUPT_FLAG == 1)
+        {
+            SPI_InterruptService();
+        }
+    }
+}
+
+
+
+//***************************************************************
+//Fill in a DRV8711 register write transaction
+//set the callback after this if one is needed
+
+void    QueueDRV8711Write(SPI_TRANSACTION *Transaction, unsigned int RegisterAddress, unsigned int Value)
+{
+    //construct write command 
+    Value = (Value & DRV_REGISTER_MASK) | (RegisterAddress << 12);
+    Transaction->Device = SPI_DEVICE_DRV8711;
+    Transaction->Length = 2;
+    Transaction->TxData[0] = (unsigned char)(Value >> 8);
+    Transaction->TxData[1] = (unsigned char)Value;
+    Transaction->Status = SPI_IDLE;
+    Transaction->Callback = NULL;
+}
+
+
+
+//***************************************************************
+//Fill in a DRV8711 register read transaction
+//use GetDRV8711Result when it is done
+
+void    QueueDRV8711Read(SPI_TRANSACTION *Transaction, unsigned int RegisterAddress)
+{
     //construct read command. Note the data is just 0's 
-    RegisterAddress = RegisterAddress << 12;
-    Value = RegisterAddress | 0x8000;   //set MSB for read
-    TxByteHigh = (char)(Value >> 8);
-    TxByteLow = (char)Value;
-
-    //enable device
-    SPI_ENABLE_WRITE = 0b1;
-                
-    //clear overflow condition
-    SSP1CON1bits.SSPOV = 0;
-    //transmit high byte
-    SSP1BUF = TxByteHigh;
-    //wait for received byte
-    while(SPI_RX_BUFFER_FULL == 0);
-    //get received SPI byte
-    RxByte = SSP1BUF;
-    //shift and save
-    RxWord = (unsigned int)RxByte << 8;
-    //transmit low byte 
-    SSP1BUF = TxByteLow;
-    //wait for received byte
-    while(SPI_RX_BUFFER_FULL == 0);
-    //get received SPI byte
-    RxByte = SSP1BUF;
-    //shift and save
-    RxWord = RxWord | (unsigned int)RxByte;
+    QueueDRV8711Write(Transaction, RegisterAddress, 0);
+    Transaction->TxData[0] = Transaction->TxData[0] | 0x80;     //set MSB for read
+}
+
 
+
+//***************************************************************
+//Get the register value from a finished DRV8711 read transaction
+
+unsigned int    GetDRV8711Result(SPI_TRANSACTION *Transaction)
+{
+    unsigned int RxWord;
+    
+    RxWord = ((unsigned int)Transaction->RxData[0] << 8) | Transaction->RxData[1];
     //mask off upper 4 bits i.e. address and read/write bit
-    RxWord = RxWord & 0x0fff;
+    return RxWord & DRV_REGISTER_MASK;
+}
+
+
+
+//***************************************************************
+//SPI Transmit
+//waits for the queue so it is only used outside the interrupt
+
+void    WriteSPI(unsigned int RegisterAddress, unsigned int Value)
+{
+    SPI_TRANSACTION Transaction;
+    
+    QueueDRV8711Write(&Transaction, RegisterAddress, Value);
+    while(QueueSPI(&Transaction) != SPI_QUEUE_OK);
+    WaitSPI(&Transaction);
+}
+
+//***************************************************************
+//SPI Receive
+//waits for the queue so it is only used outside the interrupt
+
+unsigned int    ReadSPI(unsigned int RegisterAddress)
+{
+    SPI_TRANSACTION Transaction;
     
-    //disable device
-    SPI_ENABLE_WRITE = 0b0;
+    QueueDRV8711Read(&Transaction, RegisterAddress);
+    while(QueueSPI(&Transaction) != SPI_QUEUE_OK);
+    WaitSPI(&Transaction);
     
-    return RxWord;
+    return GetDRV8711Result(&Transaction);
 }
 
 
@@ -137,45 +375,174 @@ unsigned int    ReadSPI(unsigned int RegisterAddress)
 void    InitialiseDRV8711(void)
 {
     //declare variables
-    unsigned int SPIAddress = 0;
-    unsigned int SPIValue = 0;
+    unsigned int SPIAddress;
 
     
-    //wait 10 ms
+    //wait 10 ms, the interrupts are not running yet so the tick is not counted
     Delay(10000);
     //release drive reset
     DRV8711_RESET_WRITE = 0b0;
     //wait 10 ms
     Delay(10000);
     
-    //load driver with parametric settings
-    SPIAddress = DRV_CTRL_REG;
-    SPIValue = DRV_CTRL_REG_VALUE; 
-    WriteSPI(SPIAddress,SPIValue);
-        
-    SPIAddress = DRV_TORQUE_REG;
-    SPIValue = DRV_TORQUE_REG_VALUE; 
-    WriteSPI(SPIAddress,SPIValue);
+    //load driver with parametric settings, this also fills the shadow copy
+    for(SPIAddress = 0; SPIAddress < DRV_REGISTER_COUNT; SPIAddress++)
+    {
+        WriteDRV8711(SPIAddress, DRV8711_Settings[SPIAddress]);
+    }
+    DRV8711_CheckRegister = 0;
+    DRV8711_CheckTransaction.Status = SPI_IDLE;
+}
+
+
+
+//*************************************************
+//Write a DRV8711 register and keep the shadow copy
+//returns DRV_VERIFY_FAILED if verify is on and the value does not read back
+
+unsigned int    WriteDRV8711(unsigned int SPIAddress, unsigned int SPIValue)
+{
+    unsigned int ReadValue;
+    
+    SPIValue = SPIValue & DRV_REGISTER_MASK;
+    //the status register is not shadowed
+    if(SPIAddress < DRV_REGISTER_COUNT)
+    {
+        DRV8711_Shadow[SPIAddress] = SPIValue;
+    }
+    WriteSPI(SPIAddress, SPIValue);
     
-    SPIAddress = DRV_OFF_REG;
-    SPIValue = DRV_OFF_REG_VALUE;
-    WriteSPI(SPIAddress,SPIValue);
+    //optional read back
+    if(DRV8711_Verify != 0 && SPIAddress < DRV_REGISTER_COUNT)
+    {
+        ReadValue = ReadSPI(SPIAddress);
+        //RSTEP clears itself so it is not compared
+        if(SPIAddress == DRV_CTRL_REG)
+        {
+            ReadValue = ReadValue | (SPIValue & RSTEP_MASK);
+        }
+        if(ReadValue != SPIValue)
+        {
+            return DRV_VERIFY_FAILED;
+        }
+    }
+    return DRV_SETTINGS_OK;
+}
+
+
+
+//*************************************************
+//Change a field of a DRV8711 register from the shadow copy
+//the bits in ClearMask are cleared then the bits in SetValue are set
+
+unsigned int    UpdateDRV8711(unsigned int SPIAddress, unsigned int ClearMask, unsigned int SetValue)
+{
+    return WriteDRV8711(SPIAddress, (DRV8711_Shadow[SPIAddress] & ~ClearMask) | SetValue);
+}
+
+
+
+//*************************************************
+//Fill in a write of a changed DRV8711 register field and keep the shadow
+//copy, for use in the interrupt where WriteDRV8711 cannot wait
+//the bits in ClearMask are cleared then the bits in SetValue are set
+
+void    QueueDRV8711Update(SPI_TRANSACTION *Transaction, unsigned int SPIAddress, unsigned int ClearMask, unsigned int SetValue)
+{
+    DRV8711_Shadow[SPIAddress] = ((DRV8711_Shadow[SPIAddress] & ~ClearMask) | SetValue) & DRV_REGISTER_MASK;
+    QueueDRV8711Write(Transaction, SPIAddress, DRV8711_Shadow[SPIAddress]);
+}
+
+
+
+//*************************************************
+//Get the value last written to a DRV8711 register
+
+unsigned int    GetDRV8711Shadow(unsigned int SPIAddress)
+{
+    return DRV8711_Shadow[SPIAddress];
+}
+
+
+
+//*************************************************
+//Turn DRV8711 write verification on (1) or off (0)
+
+void    SetDRV8711Verify(unsigned int Verify)
+{
+    DRV8711_Verify = Verify;
+}
+
+
+
+//*************************************************
+//Compare one DRV8711 register with the shadow copy. The register is
+//read through the SPI queue, so each call compares the result of the
+//read queued by the previous call and queues the next register.
+//A mismatch means the driver has reset, so all registers are reloaded
+//from the shadow copy with the drive disabled.
+
+unsigned int    CheckDRV8711(void)
+{
+    unsigned int ReadValue;
+    unsigned int Expected;
+    unsigned int SPIAddress;
+    unsigned int Result = DRV_SETTINGS_OK;
     
-    SPIAddress = DRV_BLANK_REG;
-    SPIValue = DRV_BLANK_REG_VALUE;
-    WriteSPI(SPIAddress,SPIValue);
+    //test for the last read still waiting for the bus
+    if(DRV8711_CheckTransaction.Status == SPI_QUEUED || DRV8711_CheckTransaction.Status == SPI_ACTIVE)
+    {
+        return DRV_SETTINGS_OK;
+    }
     
-    SPIAddress = DRV_DECAY_REG;
-    SPIValue = DRV_DECAY_REG_VALUE;
-    WriteSPI(SPIAddress,SPIValue);
+    if(DRV8711_CheckTransaction.Status == SPI_DONE)
+    {
+        ReadValue = GetDRV8711Result(&DRV8711_CheckTransaction);
+        Expected = DRV8711_CheckExpected;
+        //RSTEP clears itself so it is not compared
+        if(DRV8711_CheckRegister == DRV_CTRL_REG)
+        {
+            ReadValue = ReadValue & ~RSTEP_MASK;
+            Expected = Expected & ~RSTEP_MASK;
+        }
+        //the step interrupt changes the step mode and torque during moves,
+        //if the shadow copy changed after the read was queued the device
+        //may hold either value so it is not compared this time
+        if(ReadValue != Expected && DRV8711_Shadow[DRV8711_CheckRegister] == DRV8711_CheckExpected)
+        {
+            //reload the settings, enabling the drive last
+            DRV8711_RestoreCount++;
+            for(SPIAddress = DRV_REGISTER_COUNT; SPIAddress > 0; SPIAddress--)
+            {
+                WriteSPI(SPIAddress - 1, DRV8711_Shadow[SPIAddress - 1]);
+            }
+            Result = DRV_SETTINGS_RESTORED;
+        }
+        
+        DRV8711_CheckRegister++;
+        if(DRV8711_CheckRegister >= DRV_REGISTER_COUNT)
+        {
+            DRV8711_CheckRegister = 0;
+        }
+    }
     
-    SPIAddress = DRV_STALL_REG;
-    SPIValue = DRV_STALL_REG_VALUE;
-    WriteSPI(SPIAddress,SPIValue);
+    //queue the next read, the value is compared with the shadow copy as it is now
+    //since any later write will reach the device after the read
+    DRV8711_CheckExpected = DRV8711_Shadow[DRV8711_CheckRegister];
+    QueueDRV8711Read(&DRV8711_CheckTransaction, DRV8711_CheckRegister);
+    QueueSPI(&DRV8711_CheckTransaction);
     
-    SPIAddress = DRV_DRIVE_REG;
-    SPIValue = DRV_DRIVE_REG_VALUE;
-    WriteSPI(SPIAddress,SPIValue);
+    return Result;
+}
+
+
+
+//*************************************************
+//Get the number of times the DRV8711 settings were reloaded
+
+unsigned int    GetDRV8711RestoreCount(void)
+{
+    return DRV8711_RestoreCount;
 }
 
 
@@ -183,51 +550,24 @@ void    InitialiseDRV8711(void)
 //GLOBAL_STEP_INTERVAL
 void    MotorOn (void)
 {
-    //declare variables
-    unsigned int SPIAddress;
-    unsigned int SPIValue;
-     
-    //get the present value of the control register
-    SPIAddress = DRV_CTRL_REG;
-    //get the present value of the control register
-    SPIValue = ReadSPI(SPIAddress);
     //set the drive enable bit
-    SPIValue = SPIValue | ENABLE_DRIVE;
-    WriteSPI(SPIAddress,SPIValue);  
+    UpdateDRV8711(DRV_CTRL_REG, 0, ENABLE_DRIVE);
 }
 
 
 //disable stepper motor
 void    MotorOff (void)
 {
-    //declare variables
-    unsigned int SPIAddress;
-    unsigned int SPIValue;
-    
-    //get the present value of the control register
-    SPIAddress = DRV_CTRL_REG;
-    SPIValue = ReadSPI(SPIAddress);
     //clear the drive enable bit
-    SPIValue = SPIValue & DISABLE_DRIVE;
-    WriteSPI(SPIAddress,SPIValue); 
+    UpdateDRV8711(DRV_CTRL_REG, ENABLE_DRIVE, 0);
 }
 
 
 //load torque current
 void    LoadTorque (unsigned int TorqueValue)
 {
-    //declare variables
-    unsigned int SPIAddress;
-    unsigned int SPIValue;
-    
-    //get the present value of the control register
-    SPIAddress = DRV_TORQUE_REG;
-    SPIValue = ReadSPI(SPIAddress);
-    //clear the present torque value
-    SPIValue = SPIValue & CLEAR_TORQUE;
-    //load new torque value
-    SPIValue = SPIValue | TorqueValue;
-    WriteSPI(SPIAddress,SPIValue);       
+    //replace the present torque value
+    UpdateDRV8711(DRV_TORQUE_REG, TORQUE_MASK, TorqueValue & TORQUE_MASK);
 }
 
 
@@ -238,138 +578,89 @@ void    LoadTorque (unsigned int TorqueValue)
 
 void    SetDRV8711_Mode(unsigned int Mode)
 {
-    //declare variables
-    unsigned int SPIAddress;
-    unsigned int SPIValue;
-    
-    //get the present value of the control register
-    SPIAddress = DRV_OFF_REG;
-    SPIValue = ReadSPI(SPIAddress);
-    
-    //clear the present mode value
-    SPIValue = SPIValue & CLEAR_MODE;
     //load the new mode
     switch(Mode)
     {
         case STEPPER_MODE:  //set the DRV8711 to stepper mode
-            SPIValue = SPIValue | SET_STEPPER_MODE;
+            UpdateDRV8711(DRV_OFF_REG, ~CLEAR_MODE, SET_STEPPER_MODE);
             break;
             
         case PWM_MODE:  //set the DRV8711 to PWM mode
-            SPIValue = SPIValue | SET_PWM_MODE;
+            UpdateDRV8711(DRV_OFF_REG, ~CLEAR_MODE, SET_PWM_MODE);
             break;
             
         //no default    
     }
-    //write new value to DRV8711
-    WriteSPI(SPIAddress,SPIValue);       
 }
 
 
 //***************************************************************
-//Write to the LED display through SPI format
+//Fill in an LED display transaction
 //pass the command, a pointer to the string to be actioned and also either the number of characters
 //or the cursor position depending on the command
 
-void    WriteLED_Display(unsigned char Command, volatile unsigned char *StringPointer, unsigned int Value )
+void    QueueLED_Display(SPI_TRANSACTION *Transaction, unsigned char Command, volatile unsigned char *StringPointer, unsigned int Value)
 {
-    //enable device
-    //note that the CS is active low
-    GPIO_8_WRITE = 0b0;
-                
-    //clear overflow condition
-    SSP1CON1bits.SSPOV = 0;
+    unsigned char Length = 0;
+    
+    Transaction->Device = SPI_DEVICE_LED;
+    Transaction->Status = SPI_IDLE;
+    Transaction->Callback = NULL;
+    
+    //every command starts with the command byte
+    Transaction->TxData[Length] = Command;
+    Length++;
     
     //test for Command
     switch(Command)
     {
         case LED_DISPLAY_CLEAR:
             //Clear display 
-            //transmit command
-            SPI_LED_DisplayWrite(Command);
-            //no more characters
-            break;
-            
-        case LED_DISPLAY_DCA_CONTROL:
-            //Decimal control
-            //controls the dots on the display
-            //transmit command
-            SPI_LED_DisplayWrite(Command);
-            //send the character in the passed string pointer
-            SPI_LED_DisplayWrite(*StringPointer);            
             //no more characters
             break;
             
         case LED_DISPLAY_CURSOR_CONTROL:
-            //Set for cursor control
-            SPI_LED_DisplayWrite(Command);
             //Set cursor position passed in 'Value'(left justified, 0 through to 3)
-            SPI_LED_DisplayWrite(Value);
-            //display string until NULL
-            //test for any characters to be displayed
-            while(*StringPointer != NULL)
+            Transaction->TxData[Length] = (unsigned char)Value;
+            Length++;
+            //display string until NULL or the transaction is full
+            while(*StringPointer != NULL && Length < SPI_MAX_TRANSFER)
             {
-                //send the character in the passed string pointer
-                SPI_LED_DisplayWrite(*StringPointer);  
+                Transaction->TxData[Length] = *StringPointer;
+                Length++;
                 //increment the character pointer 
                 StringPointer++;
             }
-            //no more characters
-            break;
-            
-        case LED_DISPLAY_BRIGHTNESS:
-            //Set brightness control
-            //transmit command
-            SPI_LED_DisplayWrite(Command);
-            //send the character in the passed string pointer
-            SPI_LED_DisplayWrite(*StringPointer);            
-            //no more characters
-            break;
-            
-        case LED_DISPLAY_DIGIT_1:
-            //Digit 1 segment control
-            SPI_LED_DisplayWrite(Command);
-            //send the value in the first location of the passed array pointer
-            SPI_LED_DisplayWrite(*StringPointer);  
             break;
             
+        case LED_DISPLAY_DCA_CONTROL:       //Decimal control, the dots on the display
+        case LED_DISPLAY_BRIGHTNESS:        //brightness control
+        case LED_DISPLAY_DIGIT_1:           //Digit segment control
         case LED_DISPLAY_DIGIT_2:
-            //Digit 2 segment control
-            SPI_LED_DisplayWrite(Command);
-            //send the value in the first location of the passed array pointer
-            SPI_LED_DisplayWrite(*StringPointer);  
-            break;
-            
         case LED_DISPLAY_DIGIT_3:
-            //Digit 3 segment control
-            SPI_LED_DisplayWrite(Command);
-            //send the value in the first location of the passed array pointer
-            SPI_LED_DisplayWrite(*StringPointer);  
-            break;
-
         case LED_DISPLAY_DIGIT_4:
-            //Digit 4 segment control
-            SPI_LED_DisplayWrite(Command);
             //send the value in the first location of the passed array pointer
-            SPI_LED_DisplayWrite(*StringPointer);  
+            Transaction->TxData[Length] = *StringPointer;
+            Length++;
             break;
             
             //no default
     }
     
-    //no more data    
-    //disable chip select i.e. set high
-    GPIO_8_WRITE = 0b1;
+    Transaction->Length = Length;
 }
 
 
-//***********************************************
-//SPI LED display write
 
-void    SPI_LED_DisplayWrite(unsigned char Value)
+//***************************************************************
+//Write to the LED display through SPI format
+//waits for the queue so it is only used outside the interrupt
+
+void    WriteLED_Display(unsigned char Command, volatile unsigned char *StringPointer, unsigned int Value )
 {
-    //transmit byte
-    SSP1BUF = Value;
-    //wait for transmission to be completed
-    while(SPI_RX_BUFFER_FULL == 0);
+    SPI_TRANSACTION Transaction;
+    
+    QueueLED_Display(&Transaction, Command, StringPointer, Value);
+    while(QueueSPI(&Transaction) != SPI_QUEUE_OK);
+    WaitSPI(&Transaction);
 }
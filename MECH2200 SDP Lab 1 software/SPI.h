@@ -19,6 +19,7 @@
 #define DRV_STALL_REG   5
 #define DRV_DRIVE_REG   6
 #define DRV_STATUS_REG  7
+#define DRV_REGISTER_COUNT  7   //writable registers held in the shadow copy, status is not included
 
 //define DRV8711 parameter masks
 #define ENABLE_DRIVE                        0b0000000000000001
@@ -41,6 +42,8 @@
 #define CLEAR_MODE                          0b0000000011111111
 #define SET_STEPPER_MODE                    0b0000000000000000
 #define SET_PWM_MODE                        0b0000000100000000
+#define RSTEP_MASK                          0b0000000000000100  //self clearing, always reads back as 0
+#define DRV_REGISTER_MASK                   0x0FFF              //registers are 12 bits wide
 
 //define DRV8711 register values
 
@@ -52,7 +55,7 @@
     // RSTEP = no action = 0b0 (default))
     // DIR = via pin = 0b0 (default)
     // ENBL = Motor disabled = 0b0 (default)
-#define DRV_CTRL_REG_VALUE 0b111100010000;
+#define DRV_CTRL_REG_VALUE 0b111100010000
 
     // From high bits to low bits
     // Reserved bit
@@ -101,12 +104,67 @@
 #define SPI_RX_BIT_SAMPLE_SMP       SSP1STATbits.SMP
 #define SPI_TX_CLOCK_EDGE_CKE       SSP1STATbits.CKE
 #define SPI_RX_BUFFER_FULL          SSP1STATbits.BF
+#define SPI_INTERRUPT_FLAG          PIR1bits.SSP1IF
+#define SPI_INTERRUPT_ENABLE        PIE1bits.SSP1IE
 
 //define modes
 
 #define STEPPER_MODE                0
 #define PWM_MODE                    1
 
+//define SPI devices, each has its own chip select and clock settings
+#define SPI_DEVICE_DRV8711          0       //chip select SPI_ENABLE_WRITE, active high
+#define SPI_DEVICE_LED              1       //chip select GPIO_8_WRITE, active low
+#define SPI_DEVICE_COUNT            2
+#define SPI_NO_DEVICE               0xFF    //no profile loaded yet
+
+//define SPI clock dividers
+#define DRV8711_CLOCK_DIVIDER       1       //4 MHz, DRV8711 minimum SCLK period is 250 ns
+#define LED_CLOCK_DIVIDER           31      //250 kHz, serial 7 segment display maximum
+
+//define SPI transaction queue constants
+#define SPI_QUEUE_SIZE              8       //must be a power of 2
+#define SPI_QUEUE_MASK              (SPI_QUEUE_SIZE - 1)
+#define SPI_MAX_TRANSFER            8       //bytes sent with one chip select
+#define SPI_QUEUE_OK                0x0000
+#define SPI_QUEUE_FULL              0xFFFF
+
+//define SPI transaction status
+#define SPI_IDLE                    0       //not queued, may be filled
+#define SPI_QUEUED                  1       //waiting for the bus
+#define SPI_ACTIVE                  2       //bytes being sent
+#define SPI_DONE                    3       //received bytes are in RxData
+
+//one chip select period on the SPI bus
+//the transaction must stay in place until it is done
+typedef struct SPI_TRANSACTION
+{
+    unsigned char Device;
+    unsigned char Length;
+    volatile unsigned char Count;
+    volatile unsigned char Status;
+    unsigned char TxData[SPI_MAX_TRANSFER];
+    volatile unsigned char RxData[SPI_MAX_TRANSFER];
+    void (*Callback)(struct SPI_TRANSACTION *);     //called from the interrupt when done, may be NULL
+} SPI_TRANSACTION;
+
+//clock settings for a device
+//SPI clock = FOSC / (4 * (ClockDivider + 1))
+typedef struct
+{
+    unsigned char ClockDivider;             //SSP1ADD
+    unsigned char ClockIdleState;           //CKP
+    unsigned char ClockEdge;                //CKE
+    unsigned char SampleTime;               //SMP
+} SPI_DEVICE;
+
+//define DRV8711 shadow register status
+#define DRV_SETTINGS_OK             0x0000  //device matches the shadow copy
+#define DRV_SETTINGS_RESTORED       0x0001  //device had lost its settings and was reloaded
+#define DRV_VERIFY_FAILED           0x0002  //value read back differs from the value written
+#define DRV_CHECK_INTERVAL          1000    //main loop passes between shadow register checks
+#define DRV_CHECK_PERIOD            20      //ms between shadow register checks
+
 #define LED_DISPLAY_CLEAR           0x76
 #define LED_DISPLAY_DCA_CONTROL     0x77
 #define LED_DISPLAY_CURSOR_CONTROL  0x79
@@ -117,15 +175,31 @@
 #define LED_DISPLAY_DIGIT_4         0x7E
 
 void    InitialiseSPI(void);
+unsigned int    QueueSPI(SPI_TRANSACTION *);
+unsigned int    SPI_Idle(void);
+unsigned int    SPI_QueueSpace(void);
+void    WaitSPI(SPI_TRANSACTION *);
+void    SPI_InterruptService(void);
+unsigned int    GetSPI_TransferTime(unsigned int);
+void    QueueDRV8711Write(SPI_TRANSACTION *, unsigned int, unsigned int);
+void    QueueDRV8711Read(SPI_TRANSACTION *, unsigned int);
+unsigned int    GetDRV8711Result(SPI_TRANSACTION *);
 void    WriteSPI(unsigned int, unsigned int);
 unsigned int    ReadSPI(unsigned int);
 void    InitialiseDRV8711(void);
+unsigned int    WriteDRV8711(unsigned int, unsigned int);
+unsigned int    UpdateDRV8711(unsigned int, unsigned int, unsigned int);
+void    QueueDRV8711Update(SPI_TRANSACTION *, unsigned int, unsigned int, unsigned int);
+unsigned int    GetDRV8711Shadow(unsigned int);
+void    SetDRV8711Verify(unsigned int);
+unsigned int    CheckDRV8711(void);
+unsigned int    GetDRV8711RestoreCount(void);
 void    MotorOn(void);
 void    MotorOff(void);
 void    LoadTorque(unsigned int);
 void    SetDRV8711_Mode(unsigned int);
+void    QueueLED_Display(SPI_TRANSACTION *, unsigned char, volatile unsigned char *, unsigned int);
 void    WriteLED_Display(unsigned char, volatile unsigned char *, unsigned int);
-void    SPI_LED_DisplayWrite(unsigned char);
 
 
 
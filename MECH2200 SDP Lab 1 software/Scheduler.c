@@ -0,0 +1,175 @@
+/*
+ * File: Scheduler.c
+ * Author: Roger Berry
+ * Comments: Cooperative run to completion task scheduler for the main loop
+ *           The tasks are listed in a constant table, highest priority
+ *           first. Each task waits for one or more events, set by the
+ *           interrupts or by other tasks, or is polled once on every pass.
+ *           The highest priority task that is ready is run to completion,
+ *           then the table is looked at again from the top, so an event
+ *           raised while a low priority task runs is served before the
+ *           rest of the pass. A pass ends when no task is ready, and the
+ *           polled tasks are then ready again.
+ *           Events are bits in one byte. The interrupts only OR bits in,
+ *           the scheduler takes the whole byte with the interrupts off and
+ *           passes each bit to every task waiting for it, so one tick
+ *           wakes all the tasks that run on the tick.
+ *           Each run is timed on Timer1 and the last and longest time kept
+ *           for each task. A task cannot be stopped part way, so the
+ *           longest time is the longest any task can be kept waiting.
+ *           The main loop calls SchedulerRun, which calls each task
+ *           directly, so a task is one level deeper than when it was
+ *           called from main. The deepest task and the deepest interrupt
+ *           path together must stay within the 16 level hardware stack.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Timer.h"
+#include "SoftTimer.h"
+#include "Scheduler.h"
+
+//define variables used in this file
+volatile unsigned char SchedulerEvents = 0;         //events not yet passed to the tasks
+unsigned char TaskPending[SCHEDULER_MAX_TASKS];     //events waiting for each task, TASK_POLL if due this pass
+TASK_STATISTICS TaskStatistics[SCHEDULER_MAX_TASKS];
+
+
+
+//***************************************************************
+//Make the polled tasks of the passed schedule due, call once everything
+//is initialised and before the first SchedulerRun
+
+void    SchedulerInitialise(const SCHEDULE *Schedule)
+{
+    unsigned char Task;
+
+    for(Task = 0; Task < Schedule->TaskCount; Task++)
+    {
+        TaskPending[Task] = Schedule->Tasks[Task].Events & TASK_POLL;
+    }
+}
+
+
+
+//***************************************************************
+//Run the highest priority task that is ready, called from the main loop
+//returns the task number in table order, SCHEDULER_NO_TASK at the end
+//of a pass when no task was ready
+
+unsigned int    SchedulerRun(const SCHEDULE *Schedule)
+{
+    unsigned char Task;
+    unsigned char Ready;
+    unsigned char Taken;
+    unsigned char InterruptEnable;
+    unsigned int StartTime;
+    unsigned int StartTick;
+    unsigned int RunTime;
+    TASK_STATISTICS *Statistics;
+
+    //take the events raised since the last look
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    Taken = SchedulerEvents;
+    SchedulerEvents = 0;
+    INTCONbits.GIE = InterruptEnable;
+
+    //pass them to the tasks and find the highest priority one ready
+    Ready = SCHEDULER_NO_TASK;
+    for(Task = 0; Task < Schedule->TaskCount; Task++)
+    {
+        TaskPending[Task] |= Taken & Schedule->Tasks[Task].Events;
+        if(Ready == SCHEDULER_NO_TASK && TaskPending[Task] != 0)
+        {
+            Ready = Task;
+        }
+    }
+    if(Ready == SCHEDULER_NO_TASK)
+    {
+        //end of the pass, the polled tasks are due again
+        SchedulerInitialise(Schedule);
+        return SCHEDULER_NO_TASK;
+    }
+
+    TaskPending[Ready] = 0;
+    StartTick = GetTickCount();
+    StartTime = GetTime();
+    Schedule->Tasks[Ready].Run();
+    RunTime = GetTime() - StartTime;
+    //Timer1 rolls over every 65 ms so longer runs are only counted as long
+    if((unsigned int)(GetTickCount() - StartTick) >= 65)
+    {
+        RunTime = TASK_TIME_OVERFLOW;
+    }
+
+    Statistics = &TaskStatistics[Ready];
+    if(Statistics->Runs != 0xFFFF)
+    {
+        Statistics->Runs++;
+    }
+    Statistics->LastTime = RunTime;
+    if(RunTime > Statistics->MaxTime)
+    {
+        Statistics->MaxTime = RunTime;
+    }
+    return Ready;
+}
+
+
+
+//***************************************************************
+//Raise events from the main loop, the tasks waiting for them run once
+//the task now running returns
+
+void    SchedulerSignal(unsigned char Events)
+{
+    unsigned char InterruptEnable;
+
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    SchedulerEvents |= Events & (unsigned char)~TASK_POLL;
+    INTCONbits.GIE = InterruptEnable;
+}
+
+
+
+//***************************************************************
+//Raise events from HIGH_ISR, the interrupts are already off
+
+void    SchedulerInterruptSignal(unsigned char Events)
+{
+    SchedulerEvents |= Events;
+}
+
+
+
+//***************************************************************
+//Get the run times of the passed task, numbered from 0 in table order
+
+const TASK_STATISTICS  *SchedulerGetStatistics(unsigned int Task)
+{
+    if(Task >= SCHEDULER_MAX_TASKS)
+    {
+        Task = 0;
+    }
+    return &TaskStatistics[Task];
+}
+
+
+
+//***************************************************************
+//Clear the run counts and times of every task
+
+void    SchedulerClearStatistics(void)
+{
+    unsigned char Task;
+
+    //the statistics are only written between tasks so a task can clear them
+    for(Task = 0; Task < SCHEDULER_MAX_TASKS; Task++)
+    {
+        TaskStatistics[Task].Runs = 0;
+        TaskStatistics[Task].LastTime = 0;
+        TaskStatistics[Task].MaxTime = 0;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * File: Scheduler.h
+ * Author: Roger Berry
+ * Comments: Cooperative run to completion task scheduler for the main loop
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef SCHEDULER_H
+#define	SCHEDULER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+
+//define events, set from HIGH_ISR or the main loop
+#define EVENT_TICK                  0x01        //1 ms system tick
+#define EVENT_BUTTON                0x02        //button change queued
+#define EVENT_ENDSTOP               0x04        //endstop switch closed
+#define EVENT_RX                    0x08        //character received
+#define TASK_POLL                   0x80        //run once on every pass, no event needed
+
+//define scheduler constants
+#define SCHEDULER_MAX_TASKS         8
+#define SCHEDULER_NO_TASK           0xFF
+#define TASK_TIME_OVERFLOW          0xFFFF      //run time of 65 ms or more
+
+//a task runs to completion and must not wait for anything
+typedef struct
+{
+    const unsigned char *Name;
+    void (*Run)(void);
+    unsigned char Events;                   //events that make the task ready
+} TASK;
+
+//tasks are listed highest priority first
+typedef struct
+{
+    const TASK *Tasks;
+    unsigned char TaskCount;                //up to SCHEDULER_MAX_TASKS
+} SCHEDULE;
+
+#define SCHEDULE_TASK_COUNT(Table)  (sizeof(Table) / sizeof(Table[0]))
+
+//run times in us
+typedef struct
+{
+    unsigned int Runs;                      //stops at 65535
+    unsigned int LastTime;
+    unsigned int MaxTime;                   //worst case seen
+} TASK_STATISTICS;
+
+//declare functions
+void    SchedulerInitialise(const SCHEDULE *);
+unsigned int    SchedulerRun(const SCHEDULE *);
+void    SchedulerSignal(unsigned char);
+void    SchedulerInterruptSignal(unsigned char);
+const TASK_STATISTICS  *SchedulerGetStatistics(unsigned int);
+void    SchedulerClearStatistics(void);
+
+
+
+#endif	/* SCHEDULER_H */
+
@@ -0,0 +1,283 @@
+/*
+ * File: SoftTimer.c
+ * Author: Roger Berry
+ * Comments: 1 ms system tick and software timers on a timing wheel
+ *           Every 4th Timer6 input sample interrupt is a 1 ms tick. The
+ *           interrupt only counts the ticks in GLOBAL_TimerEventCounter and
+ *           counts down the master time out used by ReadLine. The timers
+ *           are run by SoftTimerService from the main loop, which deals
+ *           with every tick since the last call, so a slow pass of the loop
+ *           makes timers late but never loses them.
+ *           The timers are kept in a wheel of 8 slots, one per tick, each
+ *           a list of the timers due on that slot's ticks. A timer further
+ *           off than one turn counts down the turns left each time its
+ *           slot comes round, so each tick only looks at one slot. An
+ *           expired timer sets its flag and calls its handler, and one with
+ *           a period is put back in the wheel to expire again.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "SoftTimer.h"
+#include "Scheduler.h"
+
+//define external global variables
+extern volatile unsigned int GLOBAL_TimerEventCounter;
+extern volatile unsigned int GLOBAL_TimerEventFlag;
+extern volatile unsigned int GLOBAL_MasterTimeOutCounter;
+extern volatile unsigned int GLOBAL_MasterTimeOutFlag;
+
+//define variables used in this file
+SOFT_TIMER SoftTimers[SOFT_TIMER_COUNT];
+unsigned char TimerWheel[SOFT_TIMER_SLOTS];         //first timer in each slot
+unsigned int WheelTick = 0;                         //last tick dealt with by the service
+unsigned char TickSamples = 0;                      //sample interrupts since the last tick
+
+
+
+//***************************************************************
+//Clear the timers and the wheel, call before the interrupts are enabled
+
+void    InitialiseSoftTimers(void)
+{
+    unsigned char Index;
+
+    for(Index = 0; Index < SOFT_TIMER_SLOTS; Index++)
+    {
+        TimerWheel[Index] = SOFT_TIMER_NONE;
+    }
+    for(Index = 0; Index < SOFT_TIMER_COUNT; Index++)
+    {
+        SoftTimers[Index].Running = 0;
+        SoftTimers[Index].Expired = 0;
+    }
+    TickSamples = 0;
+    GLOBAL_TimerEventCounter = 0;
+    GLOBAL_TimerEventFlag = 0;
+    GLOBAL_MasterTimeOutCounter = 0;
+    GLOBAL_MasterTimeOutFlag = 0;
+    WheelTick = 0;
+}
+
+
+
+//***************************************************************
+//Count the ticks, called from HIGH_ISR after each input sample
+
+void    SoftTimerInterrupt(void)
+{
+    TickSamples++;
+    if(TickSamples < TICK_SAMPLES)
+    {
+        return;
+    }
+    TickSamples = 0;
+    GLOBAL_TimerEventCounter++;
+    GLOBAL_TimerEventFlag = 1;
+    SchedulerInterruptSignal(EVENT_TICK);
+    if(GLOBAL_MasterTimeOutCounter != 0)
+    {
+        GLOBAL_MasterTimeOutCounter--;
+        if(GLOBAL_MasterTimeOutCounter == 0)
+        {
+            GLOBAL_MasterTimeOutFlag = 1;
+        }
+    }
+}
+
+
+
+//***************************************************************
+//Get the ms tick count, it rolls over every 65 s
+//the count is read until two reads agree so a tick between the bytes
+//is not missed
+
+unsigned int    GetTickCount(void)
+{
+    unsigned int Count;
+
+    do
+    {
+        Count = GLOBAL_TimerEventCounter;
+    }
+    while(Count != GLOBAL_TimerEventCounter);
+    return Count;
+}
+
+
+
+//***************************************************************
+//Put a timer in the slot for the tick Delay ms after the last one dealt with
+
+static void    InsertTimer(unsigned char Timer, unsigned int Delay)
+{
+    unsigned char Slot;
+
+    if(Delay == 0)
+    {
+        Delay = 1;
+    }
+    Slot = (unsigned char)((WheelTick + Delay) & SOFT_TIMER_SLOT_MASK);
+    SoftTimers[Timer].Rounds = (Delay - 1) >> SOFT_TIMER_SLOT_SHIFT;
+    SoftTimers[Timer].Slot = Slot;
+    SoftTimers[Timer].Next = TimerWheel[Slot];
+    TimerWheel[Slot] = Timer;
+    SoftTimers[Timer].Running = 1;
+}
+
+
+
+//***************************************************************
+//Take a running timer out of its slot
+
+static void    RemoveTimer(unsigned char Timer)
+{
+    unsigned char *Link;
+
+    Link = &TimerWheel[SoftTimers[Timer].Slot];
+    while(*Link != SOFT_TIMER_NONE)
+    {
+        if(*Link == Timer)
+        {
+            *Link = SoftTimers[Timer].Next;
+            break;
+        }
+        Link = &SoftTimers[*Link].Next;
+    }
+    SoftTimers[Timer].Running = 0;
+}
+
+
+
+//***************************************************************
+//Run the timers due on each tick since the last call, called on every
+//pass of the main loop, at least every 65 s
+
+void    SoftTimerService(void)
+{
+    unsigned int Now;
+    unsigned char Slot;
+    unsigned char Timer;
+    unsigned char Next;
+
+    GLOBAL_TimerEventFlag = 0;
+    Now = GetTickCount();
+    while(WheelTick != Now)
+    {
+        WheelTick++;
+        Slot = (unsigned char)(WheelTick & SOFT_TIMER_SLOT_MASK);
+        Timer = TimerWheel[Slot];
+        while(Timer != SOFT_TIMER_NONE)
+        {
+            //the handler may start or stop this timer so the next is read first
+            Next = SoftTimers[Timer].Next;
+            if(SoftTimers[Timer].Rounds != 0)
+            {
+                SoftTimers[Timer].Rounds--;
+            }
+            else
+            {
+                RemoveTimer(Timer);
+                SoftTimers[Timer].Expired = 1;
+                if(SoftTimers[Timer].Period != 0)
+                {
+                    InsertTimer(Timer, SoftTimers[Timer].Period);
+                }
+                if(SoftTimers[Timer].Handler != NULL)
+                {
+                    SoftTimers[Timer].Handler();
+                }
+            }
+            Timer = Next;
+        }
+    }
+}
+
+
+
+//***************************************************************
+//Start a timer to expire after Delay ms, then every Period ms if Period
+//is not 0. A running timer is started again and its expired flag cleared
+//returns SOFT_TIMER_OK or SOFT_TIMER_INVALID
+
+unsigned int    SoftTimerStart(unsigned int Timer, unsigned int Delay, unsigned int Period, void (*Handler)(void))
+{
+    if(Timer >= SOFT_TIMER_COUNT)
+    {
+        return SOFT_TIMER_INVALID;
+    }
+    if(SoftTimers[Timer].Running != 0)
+    {
+        RemoveTimer((unsigned char)Timer);
+    }
+    SoftTimers[Timer].Period = Period;
+    SoftTimers[Timer].Handler = Handler;
+    SoftTimers[Timer].Expired = 0;
+    InsertTimer((unsigned char)Timer, Delay);
+    return SOFT_TIMER_OK;
+}
+
+
+
+//***************************************************************
+//Stop a timer and clear its expired flag
+
+void    SoftTimerStop(unsigned int Timer)
+{
+    if(Timer >= SOFT_TIMER_COUNT)
+    {
+        return;
+    }
+    if(SoftTimers[Timer].Running != 0)
+    {
+        RemoveTimer((unsigned char)Timer);
+    }
+    SoftTimers[Timer].Expired = 0;
+}
+
+
+
+//***************************************************************
+//Test for a timer waiting to expire, returns 1 if so
+
+unsigned int    SoftTimerRunning(unsigned int Timer)
+{
+    if(Timer >= SOFT_TIMER_COUNT)
+    {
+        return 0;
+    }
+    return SoftTimers[Timer].Running;
+}
+
+
+
+//***************************************************************
+//Test for a timer having expired, returns 1 once for each expiry seen
+//a periodic timer that expires again before the test is counted once
+
+unsigned int    SoftTimerExpired(unsigned int Timer)
+{
+    if(Timer >= SOFT_TIMER_COUNT || SoftTimers[Timer].Expired == 0)
+    {
+        return 0;
+    }
+    SoftTimers[Timer].Expired = 0;
+    return 1;
+}
+
+
+
+//***************************************************************
+//Set GLOBAL_MasterTimeOutFlag after the passed ms, 0 cancels the time out
+//the flag is cleared either way
+
+void    SetMasterTimeOut(unsigned int Time)
+{
+    unsigned char InterruptEnable;
+
+    InterruptEnable = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    GLOBAL_MasterTimeOutCounter = Time;
+    GLOBAL_MasterTimeOutFlag = 0;
+    INTCONbits.GIE = InterruptEnable;
+}
@@ -0,0 +1,63 @@
+/*
+ * File: SoftTimer.h
+ * Author: Roger Berry
+ * Comments: 1 ms system tick and software timers on a timing wheel
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef SOFT_TIMER_H
+#define	SOFT_TIMER_H
+
+#include <xc.h> // include processor files - each processor file is guarded.
+#include "Timer.h"
+
+//define the tick, counted from the Timer6 input sample interrupt
+#define TICK_PERIOD_US              1000
+#define TICK_SAMPLES                (TICK_PERIOD_US / TIMER_6_PERIOD_US)
+
+//define the timing wheel
+#define SOFT_TIMER_SLOTS            8           //power of 2, ticks per turn
+#define SOFT_TIMER_SLOT_MASK        (SOFT_TIMER_SLOTS - 1)
+#define SOFT_TIMER_SLOT_SHIFT       3           //log2 of SOFT_TIMER_SLOTS
+#define SOFT_TIMER_NONE             0xFF        //end of a slot list
+
+//define the timers, each user has its own
+#define SOFT_TIMER_DOOR_DWELL       0           //doors held open at a floor
+#define SOFT_TIMER_DRV_CHECK        1           //DRV8711 register check
+#define SOFT_TIMER_DISPLAY          2           //LED display refresh
+#define SOFT_TIMER_BAUD_CONFIRM     3           //baud rate change handshake
+#define SOFT_TIMER_COUNT            4
+
+//define timer status
+#define SOFT_TIMER_OK               0x0000
+#define SOFT_TIMER_INVALID          0x0001  //no such timer
+
+//a timer with no handler only sets its expired flag
+typedef struct
+{
+    unsigned int Rounds;                    //turns of the wheel left before it expires
+    unsigned int Period;                    //ms between expiries, 0 for one shot
+    void (*Handler)(void);                  //called from SoftTimerService, or NULL
+    unsigned char Next;                     //next timer in the same slot
+    unsigned char Slot;
+    unsigned char Running;
+    unsigned char Expired;
+} SOFT_TIMER;
+
+//declare functions
+void    InitialiseSoftTimers(void);
+void    SoftTimerInterrupt(void);
+void    SoftTimerService(void);
+unsigned int    GetTickCount(void);
+unsigned int    SoftTimerStart(unsigned int, unsigned int, unsigned int, void (*)(void));
+void    SoftTimerStop(unsigned int);
+unsigned int    SoftTimerRunning(unsigned int);
+unsigned int    SoftTimerExpired(unsigned int);
+void    SetMasterTimeOut(unsigned int);
+
+
+
+#endif	/* SOFT_TIMER_H */
+
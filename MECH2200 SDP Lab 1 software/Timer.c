@@ -8,9 +8,6 @@
 #include "Timer.h"
 
 
-extern  volatile unsigned int GLOBAL_StepperMotorSpeed;
-
-
 //******************************************************
 //Initialise timers
 
@@ -19,15 +16,23 @@ void    InitialiseTimers(void)
     //note that timer 2 and timer 4 are used in 10 bit PWM generation and cannot be used for other purposes
     //and are initialised in the PWM initialisation
     
-    //Initialise timer 1 for 1 us increment used in 'Delay' function
+    //Initialise timer 1 for 1 us increment used as a free running time base
+    //for the 'Delay' function and for timing SPI transactions
     T1CONbits.CKPS = 0b11;      //clock pre scale 1:8
     T1CONbits.CS = 0b00;        //Clock source Fosc/4
+    TIMER_1_TIME = 0;
+    TIMER_1_ENABLE = TIMER_ON;
     
     
     //Initialise timer 3 for 1 us increment used in stepper motor speed control
     T3CONbits.CKPS = 0b11;      //clock pre scale 1:8
     T3CONbits.CS = 0b00;        //Clock source Fosc/4
     
+    //Initialise timer 5 to count the stepper STEP pulses made by the step PWM
+    //the STEP pin is routed to T5CKI in the port initialisation
+    T5CONbits.CKPS = 0b00;      //clock pre scale 1:1
+    T5CONbits.CS = 0b10;        //Clock source T5CKI rising edge
+    
     //initialise timer 2 for 10 bit PWM operation
     //do not enable timer at this point
     T2CLKCONbits.T2CS = 0b0001;                         //Fosc/4 clock source
@@ -36,40 +41,69 @@ void    InitialiseTimers(void)
     T2HLTbits.MODE = 0b00000;                           //free running timer reset by self compare
     T2HLTbits.CKSYNC = 0b1;                             //synch the timer 
     
+    //initialise timer 6 for a 250 us interrupt used to sample the inputs
+    T6CLKCONbits.T6CS = 0b0001;                         //Fosc/4 clock source
+    T6CONbits.T6CKPS = 0b100;                           //prescaler 16, 2 us count
+    T6PR = (TIMER_6_PERIOD_US / 2) - 1;                 //250 us period
+    T6HLTbits.MODE = 0b00000;                           //free running timer reset by self compare
+    T6HLTbits.CKSYNC = 0b1;                             //synch the timer
+    TIMER_6_INTERRUPT_FLAG = CLEAR_FLAG;
+    TIMER_6_INTERRUPT_ENABLE = INTERRUPT_ENABLED;
+    TIMER_6_ENABLE = TIMER_ON;
+    
 }
 
 
 
 
 
+//************************************************
+//Get the free running time in microseconds
+//the high byte is read either side of the low byte so a carry between
+//the two reads is not missed
+
+unsigned int    GetTime(void)
+{
+    unsigned char High;
+    unsigned char Low;
+    
+    do
+    {
+        High = TMR1H;
+        Low = TMR1L;
+    }
+    while(High != TMR1H);
+    
+    return ((unsigned int)High << 8) | Low;
+}
+
+
+
 //************************************************
 //Delay function that is passed a value in microseconds.
 //it is not an interrupt function and is therefore not accurate
+//interrupts taken while waiting do not lengthen the delay
+//only used at start up before the interrupts are enabled, later waits
+//use the software timers so the main loop keeps running
 
 void    Delay(unsigned int DelayTime)
 {
-    //test foe invalid value
-    if(DelayTime > 0)
-    {
-        TIMER_1_ENABLE = TIMER_OFF;     //ensure timer is off
-        TIMER_1_TIME = -DelayTime;      //load timer with - time in us
-        TIMER_1_FLAG = 0b0;
-        TIMER_1_ENABLE = TIMER_ON;      //timer on
-        while(TIMER_1_FLAG == 0b0);     //wait for time to elapse
-        TIMER_1_ENABLE = TIMER_OFF;     //turn timer off
-        TIMER_1_FLAG = 0b0;             //clear flag
-    }
+    unsigned int StartTime;
+    
+    StartTime = GetTime();
+    //unsigned subtraction gives the elapsed time across a timer roll over
+    while((unsigned int)(GetTime() - StartTime) < DelayTime);
 }
 
 
 
 //****************************************************
-//Stepper timer on 
+//Stepper timer on, the first interrupt is after the passed time in us
 
-void    StepperTimerOn(void)
+void    StepperTimerOn(unsigned int FirstInterval)
 {
     TIMER_3_ENABLE = TIMER_OFF;                     //ensure timer is off
-    TIMER_3_TIME = -GLOBAL_StepperMotorSpeed;       //load timer with - time in us
+    TIMER_3_TIME = -FirstInterval;                  //load timer with - time in us
     TIMER_3_INTERRUPT_FLAG = CLEAR_FLAG;            //clear timer flag
     TIMER_3_INTERRUPT_ENABLE = INTERRUPT_ENABLED;   //enable timer interrupts
     TIMER_3_ENABLE = TIMER_ON;                      //timer on
@@ -77,7 +111,7 @@ void    StepperTimerOn(void)
 
 
 //****************************************************
-//Stepper timer on 
+//Stepper timer off 
 
 void    StepperTimerOff(void)
 {
@@ -87,3 +121,49 @@ void    StepperTimerOff(void)
 }
 
 
+
+//************************************************
+//Start counting step pulses, the interrupt is taken after the passed
+//number of pulses. 0 counts 65536 pulses
+
+void    StepCounterOn(unsigned int Count)
+{
+    TIMER_5_ENABLE = TIMER_OFF;                     //ensure counter is off
+    TIMER_5_TIME = -Count;                          //load counter with - pulse count
+    TIMER_5_INTERRUPT_FLAG = CLEAR_FLAG;            //clear counter flag
+    TIMER_5_INTERRUPT_ENABLE = INTERRUPT_ENABLED;   //enable counter interrupts
+    TIMER_5_ENABLE = TIMER_ON;                      //counter on
+}
+
+
+
+//************************************************
+//Stop counting step pulses
+
+void    StepCounterOff(void)
+{
+    TIMER_5_ENABLE = TIMER_OFF;                     //ensure counter is off
+    TIMER_5_INTERRUPT_ENABLE = INTERRUPT_DISABLED;  //disable counter interrupts
+    TIMER_5_INTERRUPT_FLAG = CLEAR_FLAG;            //clear counter flag
+}
+
+
+
+//************************************************
+//Read the step pulse counter, read the same way as the free running time
+
+unsigned int    GetStepCounter(void)
+{
+    unsigned char High;
+    unsigned char Low;
+    
+    do
+    {
+        High = TMR5H;
+        Low = TMR5L;
+    }
+    while(High != TMR5H);
+    
+    return ((unsigned int)High << 8) | Low;
+}
+
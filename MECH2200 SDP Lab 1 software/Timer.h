@@ -21,6 +21,16 @@
 #define TIMER_3_INTERRUPT_FLAG      PIR4bits.TMR3IF
 #define TIMER_3_INTERRUPT_ENABLE    PIE4bits.TMR3IE
 
+#define TIMER_5_ENABLE              T5CONbits.T5ON
+#define TIMER_5_TIME                TMR5
+#define TIMER_5_INTERRUPT_FLAG      PIR4bits.TMR5IF
+#define TIMER_5_INTERRUPT_ENABLE    PIE4bits.TMR5IE
+
+#define TIMER_6_ENABLE              T6CONbits.T6ON
+#define TIMER_6_INTERRUPT_FLAG      PIR4bits.TMR6IF
+#define TIMER_6_INTERRUPT_ENABLE    PIE4bits.TMR6IE
+#define TIMER_6_PERIOD_US           250         //input sample period
+
 //define constants
 
 #define TIMER_OFF           0b0
@@ -34,9 +44,13 @@
 //function declarations
 
 void    InitialiseTimers(void);
+unsigned int    GetTime(void);
 void    Delay(unsigned int);
-void    StepperTimerOn(void);
+void    StepperTimerOn(unsigned int);
 void    StepperTimerOff(void);
+void    StepCounterOn(unsigned int);
+void    StepCounterOff(void);
+unsigned int    GetStepCounter(void);
 
 
 #endif	/* TIMER_H */
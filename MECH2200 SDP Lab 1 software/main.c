@@ -6,6 +6,18 @@
 #include "PWM.h"    //this file includes PWM functions
 #include "SPI.h"    //this file includes SPI and DREV8711 functions
 #include "Timer.h"  //this file includes timer functions
+#include "Menu.h"   //this file includes the table driven menus
+#include "Motion.h" //this file includes stepper motor acceleration profiles
+#include "MotionQueue.h"    //this file includes the queue of blended moves
+#include "Home.h"   //this file includes the endstops and homing
+#include "Format.h" //this file includes number formatting
+#include "Calibration.h"    //this file includes the calibration saved in flash
+#include "Lift.h"   //this file includes the floor call scheduler
+#include "Button.h" //this file includes the call buttons
+#include "Door.h"   //this file includes the door servos
+#include "SoftTimer.h"  //this file includes the 1 ms tick and software timers
+#include "Scheduler.h"  //this file includes the main loop task scheduler
+#include "Display.h"    //this file includes the LED floor display
 
 /*
  * The default state for the CONFIG registers is as follows:
@@ -52,17 +64,117 @@
 const unsigned char OptionMessage[] = "\r\n\r\n **** ELEVATOR CONTROL ****\r\n";
 const unsigned char OptionMessage1[] = "1. Run Elevator\r\n";
 const unsigned char OptionMessage2[] = "2. Elevator Calibration\r\n";
-const unsigned char OptionSelectMessage[] = "\r\nEnter option number: ";
+const unsigned char OptionMessage3[] = "3. Comms status\r\n";
+const unsigned char OptionMessage4[] = "4. Clear comms counters\r\n";
+const unsigned char OptionMessage5[] = "5. Change baud rate\r\n";
+const unsigned char OptionMessage16[] = "16. DRV8711 status\r\n";
+const unsigned char OptionMessage17[] = "17. Clear DRV8711 status\r\n";
+const unsigned char OptionMessage18[] = "18. Task run times\r\n";
+const unsigned char OptionMessage19[] = "19. Clear task run times\r\n";
 const unsigned char CRLF[] = "\r\n";
 
+const unsigned char CalibrationMessage[] = "\r\n\r\n **** ELEVATOR CALIBRATION ****\r\n";
+const unsigned char CalibrationMessage1[] = "1. Home and measure travel\r\n";
+const unsigned char CalibrationMessage2[] = "2. Move to floor\r\n";
+const unsigned char CalibrationMessage3[] = "3. Adjust position\r\n";
+const unsigned char CalibrationMessage4[] = "4. Save position as floor\r\n";
+const unsigned char CalibrationMessage5[] = "5. Stop\r\n";
+const unsigned char CalibrationMessage6[] = "6. Save calibration\r\n";
+const unsigned char CalibrationMessage7[] = "7. Door speeds and dwell\r\n";
+const unsigned char CalibrationMessage8[] = "8. Drive settings\r\n";
+const unsigned char CalibrationMessage9[] = "9. Exit\r\n";
+const unsigned char HomeStatusMessage[] = "\r\n Homing: ";
+const unsigned char HomeStatusMessage1[] = "\r\n Position (steps): ";
+const unsigned char HomeStatusMessage2[] = "\r\n Travel (steps): ";
+const unsigned char HomeStatusMessage3[] = "\r\n Floors (steps): ";
+const unsigned char HomeStatusMessage4[] = "\r\n Saved calibration: ";
+const unsigned char HomeStatusMessage5[] = "\r\n Door open/close (us per 20 ms), dwell (ms): ";
+const unsigned char HomeIdleMessage[] = "not homed";
+const unsigned char HomeRunningMessage[] = "running";
+const unsigned char HomeDoneMessage[] = "done";
+const unsigned char HomeNotFoundMessage[] = "failed, endstop not found";
+const unsigned char HomeStuckMessage[] = "failed, endstop stuck closed";
+const unsigned char HomeAbortedMessage[] = "stopped";
+const unsigned char HomeLimitMessage[] = "failed, endstop hit while moving, home again";
+const unsigned char FloorNumberMessage[] = "\r\n Enter floor number (1-3): ";
+const unsigned char AdjustMessage[] = "\r\n Enter distance to move in mm (-ve is down): ";
+const unsigned char NotHomedMessage[] = "\r\n Home the lift first";
+const unsigned char MotorBusyMessage[] = "\r\n Motor is moving";
+const unsigned char LiftBusyMessage[] = "\r\n Lift is busy, wait for it to stop with its doors shut";
+const unsigned char NearEndstopMessage[] = "\r\n Too close to an endstop, move further from it";
+const unsigned char SavedMessage[] = "\r\n Calibration saved";
+const unsigned char SaveFailedMessage[] = "\r\n Calibration not saved, flash write failed";
+const unsigned char DoorOpenRateMessage[] = "\r\n Enter door opening rate in us per 20 ms (1-1000): ";
+const unsigned char DoorCloseRateMessage[] = "\r\n Enter door closing rate in us per 20 ms (1-1000): ";
+const unsigned char DoorDwellMessage[] = "\r\n Enter door dwell time in ms: ";
+const unsigned char AccelerationMessage[] = "\r\n Enter acceleration in steps/s/s (100-60000): ";
+const unsigned char DecelerationMessage[] = "\r\n Enter deceleration in steps/s/s (100-60000): ";
+const unsigned char IdleTimeoutMessage[] = "\r\n The car falls when the drive is off, 0 keeps it on\r\n Enter s parked before the drive is off (0-3600): ";
+const unsigned char Yes[] = "yes";
+const unsigned char No[] = "no";
+const unsigned char Never[] = "never";
+const unsigned char Space[] = " ";
+const unsigned char Colon[] = ": ";
 
-//string error messages
-const unsigned char MessageTooLong[] = "\r\n String entered is too long";
-const unsigned char MessageNoValue[] = "\r\n No Value Entered";
-const unsigned char InvalidNumber[] = "\r\n Value out of range";
-const unsigned char TooManyDecimalPoints[] = "\r\n Too many decimal points";
-const unsigned char TooLarge[] = "\r\n Value too large";
-const unsigned char TooSmall[] = "\r\n Value too small";
+const unsigned char DriveMessage[] = "\r\n\r\n **** DRIVE SETTINGS ****\r\n";
+const unsigned char DriveMessage1[] = "1. Acceleration and deceleration\r\n";
+const unsigned char DriveMessage2[] = "2. Hardware cruise steps on/off\r\n";
+const unsigned char DriveMessage3[] = "3. S curve profile on/off\r\n";
+const unsigned char DriveMessage4[] = "4. Step mode switching on/off\r\n";
+const unsigned char DriveMessage5[] = "5. Drive off when parked\r\n";
+const unsigned char DriveMessage6[] = "6. Exit\r\n";
+const unsigned char DriveStatusMessage[] = "\r\n Acceleration/deceleration (steps/s/s): ";
+const unsigned char DriveStatusMessage1[] = "\r\n Hardware cruise steps: ";
+const unsigned char DriveStatusMessage2[] = "\r\n S curve profile: ";
+const unsigned char DriveStatusMessage3[] = "\r\n Step mode switching: ";
+const unsigned char DriveStatusMessage4[] = "\r\n Drive off when parked for (s): ";
+
+const unsigned char LiftMessage[] = "\r\n\r\n **** RUN ELEVATOR ****\r\n";
+const unsigned char LiftMessage1[] = "1. Call up\r\n";
+const unsigned char LiftMessage2[] = "2. Call down\r\n";
+const unsigned char LiftMessage3[] = "3. Choose floor in car\r\n";
+const unsigned char LiftMessage4[] = "4. Clear times\r\n";
+const unsigned char LiftMessage5[] = "5. Exit\r\n";
+const unsigned char LiftStatusMessage[] = "\r\n Floor: ";
+const unsigned char LiftStatusMessage1[] = "  Direction: ";
+const unsigned char LiftStatusMessage5[] = "  Doors: ";
+const unsigned char LiftStatusMessage2[] = "\r\n Calls up/down/car: ";
+const unsigned char LiftStatusMessage3[] = "\r\n Wait (ms) average/max: ";
+const unsigned char LiftStatusMessage4[] = "\r\n Travel (ms) average/max: ";
+const unsigned char LiftBetweenFloors[] = "-";
+const unsigned char LiftUp[] = "up";
+const unsigned char LiftDown[] = "down";
+const unsigned char LiftStopped[] = "none";
+const unsigned char LiftWaitHome[] = "  (waiting for homing)";
+const unsigned char DoorClosedMessage[] = "closed";
+const unsigned char DoorOpeningMessage[] = "opening";
+const unsigned char DoorOpenMessage[] = "open";
+const unsigned char DoorClosingMessage[] = "closing";
+const unsigned char InvalidCallMessage[] = "\r\n No call in that direction from that floor";
+const unsigned char Slash[] = "/";
+
+const unsigned char CommsStatusMessage[] = "\r\n RX dropped/overrun/framing: ";
+const unsigned char CommsStatusMessage1[] = "\r\n TX high water/waits: ";
+const unsigned char CommsStatusMessage2[] = "\r\n Last SPI transfer DRV8711/LED (us): ";
+const unsigned char BaudRateMessage[] = "\r\n Enter baud rate option: ";
+const unsigned char BaudRateErrorMessage[] = "\r\n Baud rate error: ";
+const unsigned char BaudRateConfirmMessage[] = "%\r\n Change terminal rate and send Y within 5 s\r\n";
+const unsigned char BaudRateChangedMessage[] = "\r\n Baud rate changed";
+const unsigned char BaudRateUnchangedMessage[] = "\r\n No confirmation, baud rate unchanged";
+const unsigned long BaudRateOptions[] = {9600, 19200, 57600, 115200, 250000, 500000};
+#define BAUD_RATE_OPTION_COUNT      (sizeof(BaudRateOptions) / sizeof(BaudRateOptions[0]))
+
+const unsigned char TaskTimesMessage[] = "\r\n Task: runs, last/max (us)";
+const unsigned char TaskComma[] = ", ";
+const unsigned char TaskOverflow[] = ">65000";
+const unsigned char TaskTimers[] = "Timers";
+const unsigned char TaskMotion[] = "Motion planning";
+const unsigned char TaskHoming[] = "Homing";
+const unsigned char TaskButtons[] = "Buttons";
+const unsigned char TaskLift[] = "Lift";
+const unsigned char TaskDriver[] = "Driver monitor";
+const unsigned char TaskMenu[] = "Menu";
+const unsigned char TaskDisplay[] = "Display";
 
 //global variables
 volatile unsigned int GLOBAL_TimerEventCounter = 0;
@@ -73,36 +185,148 @@ volatile unsigned char GLOBAL_ResultString[RESULT_STRING_LENGTH];
 volatile unsigned char GLOBAL_RxString[RX_STRING_LENGTH];
 volatile unsigned int GLOBAL_StepperMotorSpeed;
 volatile unsigned int GLOBAL_DirectionStatus;
+volatile unsigned int GLOBAL_PWM1_PulseTime;
+volatile unsigned int GLOBAL_PWM2_PulseTime;
+volatile unsigned int GLOBAL_PWM3_PulseTime;        //PWM5 door servo, us
+volatile unsigned int GLOBAL_PWM4_PulseTime;        //PWM6 door servo, us
 
-volatile unsigned int GLOBAL_Floor1Position = 0;
-volatile unsigned int GLOBAL_Floor2Position = 1;
-volatile unsigned int GLOBAL_Floor3Position = 2;
+//floor positions in steps above the bottom endstop edge
+volatile signed long GLOBAL_Floor1Position = 0;
+volatile signed long GLOBAL_Floor2Position = 0;
+volatile signed long GLOBAL_Floor3Position = 0;
 
-volatile unsigned int GLOBAL_MaxPosition = 100;
+//travel in steps from the bottom endstop edge to the top endstop edge
+volatile signed long GLOBAL_MaxPosition = 0;
 
-//***************************************************************
-//interrupt routine
-void __interrupt () HIGH_ISR(void)
-{
-    if(PIR1bits.RCIF)
-    {
-    reach_bottom = 1;
-    PIR1bits.RCIF = 0;
-    }
-    if(PIR2bits.RCIF)
-    {
-        reach_top = 1;
-        PIR2bits.RCIF = 0;
-    }
-}
+//door opening rate held while the closing rate is entered
+unsigned int DoorOpenRateEntry;
+
+//acceleration held while the deceleration is entered
+unsigned int AccelerationEntry;
+
+//baud rate option held while its error and the confirm request are sent
+unsigned int BaudRateEntry;
 
 
 
 //list functions
-void DisplayStringError(unsigned int ErrorValue);
-void MainMenu();
-void RunElevator();
-void CalibrationMenu();
+void    RunElevator(void);
+void    CalibrationMenu(void);
+void    DisplayCommsStatus(void);
+unsigned int    SendCommsStatus(unsigned int);
+void    ClearCommsStatus(void);
+void    SelectBaudRate(void);
+unsigned int    SendBaudRateOptions(unsigned int);
+void    BaudRateEntered(unsigned int, volatile unsigned char *);
+unsigned int    SendBaudRateConfirm(unsigned int);
+unsigned int    BaudRateConfirmed(void);
+void    DisplayDRV8711Status(void);
+void    ClearDRV8711Status(void);
+void    DisplayTaskTimes(void);
+unsigned int    SendTaskTimes(unsigned int);
+void    ClearTaskTimes(void);
+void    DriverService(void);
+unsigned int    DisplayCalibrationStatus(unsigned int);
+void    StartHoming(void);
+void    SelectFloor(void);
+void    FloorEntered(unsigned int, volatile unsigned char *);
+void    AdjustPosition(void);
+void    AdjustEntered(unsigned int, volatile unsigned char *);
+void    SaveFloor(void);
+void    SaveFloorEntered(unsigned int, volatile unsigned char *);
+void    StopCalibration(void);
+void    SaveCalibration(void);
+void    DoorSettings(void);
+void    DoorOpenRateEntered(unsigned int, volatile unsigned char *);
+void    DoorCloseRateEntered(unsigned int, volatile unsigned char *);
+void    DoorDwellEntered(unsigned int, volatile unsigned char *);
+void    DriveSettings(void);
+unsigned int    DisplayDriveStatus(unsigned int);
+void    SetProfile(void);
+void    AccelerationEntered(unsigned int, volatile unsigned char *);
+void    DecelerationEntered(unsigned int, volatile unsigned char *);
+void    ToggleHardwareCruise(void);
+void    ToggleProfileShape(void);
+void    ToggleModeSwitch(void);
+void    SetIdleTimeout(void);
+void    IdleTimeoutEntered(unsigned int, volatile unsigned char *);
+void    ExitDriveSettings(void);
+void    ExitCalibration(void);
+void    MoveStepper(signed long);
+unsigned int    DisplayLiftStatus(unsigned int);
+void    CallUp(void);
+void    CallUpEntered(unsigned int, volatile unsigned char *);
+void    CallDown(void);
+void    CallDownEntered(unsigned int, volatile unsigned char *);
+void    CallCar(void);
+void    CallCarEntered(unsigned int, volatile unsigned char *);
+void    ClearLiftTimes(void);
+void    ExitLift(void);
+
+//menu tables
+const MENU_COMMAND MainCommands[] =
+{
+    {1, OptionMessage1, RunElevator},
+    {2, OptionMessage2, CalibrationMenu},
+    {3, OptionMessage3, DisplayCommsStatus},
+    {4, OptionMessage4, ClearCommsStatus},
+    {5, OptionMessage5, SelectBaudRate},
+    {16, OptionMessage16, DisplayDRV8711Status},
+    {17, OptionMessage17, ClearDRV8711Status},
+    {18, OptionMessage18, DisplayTaskTimes},
+    {19, OptionMessage19, ClearTaskTimes}
+};
+const MENU MainMenu = {OptionMessage, NULL, MainCommands, MENU_COMMAND_COUNT(MainCommands), 2};
+
+const MENU_COMMAND CalibrationCommands[] =
+{
+    {1, CalibrationMessage1, StartHoming},
+    {2, CalibrationMessage2, SelectFloor},
+    {3, CalibrationMessage3, AdjustPosition},
+    {4, CalibrationMessage4, SaveFloor},
+    {5, CalibrationMessage5, StopCalibration},
+    {6, CalibrationMessage6, SaveCalibration},
+    {7, CalibrationMessage7, DoorSettings},
+    {8, CalibrationMessage8, DriveSettings},
+    {9, CalibrationMessage9, ExitCalibration}
+};
+const MENU CalibrationMenuTable = {CalibrationMessage, DisplayCalibrationStatus, CalibrationCommands, MENU_COMMAND_COUNT(CalibrationCommands), 1};
+
+const MENU_COMMAND DriveCommands[] =
+{
+    {1, DriveMessage1, SetProfile},
+    {2, DriveMessage2, ToggleHardwareCruise},
+    {3, DriveMessage3, ToggleProfileShape},
+    {4, DriveMessage4, ToggleModeSwitch},
+    {5, DriveMessage5, SetIdleTimeout},
+    {6, DriveMessage6, ExitDriveSettings}
+};
+const MENU DriveMenuTable = {DriveMessage, DisplayDriveStatus, DriveCommands, MENU_COMMAND_COUNT(DriveCommands), 1};
+
+const MENU_COMMAND LiftCommands[] =
+{
+    {1, LiftMessage1, CallUp},
+    {2, LiftMessage2, CallDown},
+    {3, LiftMessage3, CallCar},
+    {4, LiftMessage4, ClearLiftTimes},
+    {5, LiftMessage5, ExitLift}
+};
+const MENU LiftMenuTable = {LiftMessage, DisplayLiftStatus, LiftCommands, MENU_COMMAND_COUNT(LiftCommands), 1};
+
+//task table, highest priority first
+//no task waits, the tick tasks run every ms and the rest as their events arrive
+const TASK MainTasks[] =
+{
+    {TaskTimers, SoftTimerService, EVENT_TICK},
+    {TaskMotion, MotionQueueService, EVENT_TICK},           //keeps the step block ring filled
+    {TaskHoming, HomeService, EVENT_TICK | EVENT_ENDSTOP},
+    {TaskButtons, ButtonService, EVENT_BUTTON},
+    {TaskLift, LiftService, EVENT_TICK},
+    {TaskDriver, DriverService, EVENT_TICK},
+    {TaskMenu, MenuService, EVENT_TICK | EVENT_RX},
+    {TaskDisplay, DisplayService, EVENT_TICK}
+};
+const SCHEDULE MainSchedule = {MainTasks, SCHEDULE_TASK_COUNT(MainTasks)};
 
 
 
@@ -110,175 +334,1071 @@ void CalibrationMenu();
 
 void main(void) {
     
-    unsigned int StringStatus;
-    unsigned int Value;
-    unsigned int SPIAddress;
-    unsigned int SPIValue;
-
     //wait for PLL to stabilise
     while(OSCSTATbits.PLLR == 0);
     
     InitialisePorts(); 
     InitialiseComms();
     InitialisePWM_16Bit();
+    InitialiseDoor();
     InitialiseTimers();
+    InitialiseSoftTimers();
+    InitialiseMotion();
+    InitialiseMotionQueue();
+    InitialiseHome();
+    InitialiseLift();
+    InitialiseButtons();
     InitialiseSPI();
     InitialiseDRV8711();
+    InitialiseDisplay();
     
     //enable interrupts
     INTCONbits.PEIE = 1;        //enable peripheral interrupts
     INTCONbits.GIE = 1;         //enable interrupts
     
-    MainMenu();
+    //with a saved calibration only the zero has to be found again
+    if(CalibrationLoad() == CALIBRATION_OK)
+    {
+        HomeVerify();
+    }
+    
+    //compare one DRV8711 register with its shadow copy now and again
+    //to find a driver that has reset and lost its settings
+    SoftTimerStart(SOFT_TIMER_DRV_CHECK, DRV_CHECK_PERIOD, DRV_CHECK_PERIOD, NULL);
+    
+    //start at the main menu
+    MenuSelect(&MainMenu);
+    
     //main loop
+    //the tasks are run in priority order as their events arrive
+    SchedulerInitialise(&MainSchedule);
     while(1)
     {
-        //display options list
-        DisplaySystemOptionsList();
-        
-        //test for any string entry
-        StringStatus = GetString(2,GLOBAL_RxString);
-        if(StringStatus != STRING_OK)
+        SchedulerRun(&MainSchedule);
+    }
+    //end of main loop. Should never get to this point
+    return;
+}
+
+
+
+//*********************************************
+//Reduce the motor current at rest and compare a DRV8711 register with
+//its shadow copy when the check is due
+
+void    DriverService(void)
+{
+    MotionTorqueService();
+    if(SoftTimerExpired(SOFT_TIMER_DRV_CHECK) != 0)
+    {
+        CheckDRV8711();
+    }
+}
+
+
+
+//*********************************************
+//Display the run count and the last and longest run time of each task
+//one task on each line sent
+
+static void    SendTaskTime(unsigned int Time)
+{
+    if(Time == TASK_TIME_OVERFLOW)
+    {
+        SendMessage(TaskOverflow);
+        return;
+    }
+    FormatUnsigned16(Time, 1, GLOBAL_ResultString);
+    SendString(GLOBAL_ResultString);
+}
+
+void    DisplayTaskTimes(void)
+{
+    MenuRequestLines(SendTaskTimes);
+}
+
+unsigned int    SendTaskTimes(unsigned int Line)
+{
+    const TASK_STATISTICS *Statistics;
+
+    if(Line == 0)
+    {
+        SendMessage(TaskTimesMessage);
+        return MENU_LINES_MORE;
+    }
+    Statistics = SchedulerGetStatistics(Line - 1);
+    SendMessage(CRLF);
+    SendMessage(Space);
+    SendMessage(MainTasks[Line - 1].Name);
+    SendMessage(Colon);
+    FormatUnsigned16(Statistics->Runs, 1, GLOBAL_ResultString);
+    SendString(GLOBAL_ResultString);
+    SendMessage(TaskComma);
+    SendTaskTime(Statistics->LastTime);
+    SendMessage(Slash);
+    SendTaskTime(Statistics->MaxTime);
+    if(Line < MainSchedule.TaskCount)
+    {
+        return MENU_LINES_MORE;
+    }
+    SendMessage(CRLF);
+    return MENU_LINES_DONE;
+}
+
+void    ClearTaskTimes(void)
+{
+    SchedulerClearStatistics();
+}
+
+//*********************************************
+//Display the receive error counters, the transmit buffer high water mark
+//and wait count and the time of the last SPI transfer to each device
+
+void    DisplayCommsStatus(void)
+{
+    MenuRequestLines(SendCommsStatus);
+}
+
+unsigned int    SendCommsStatus(unsigned int Line)
+{
+    switch(Line)
+    {
+        case 0:
+            SendMessage(CommsStatusMessage);
+            FormatUnsigned16(GetRxDroppedCount(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Slash);
+            FormatUnsigned16(GetRxOverrunCount(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Slash);
+            FormatUnsigned16(GetRxFrameErrorCount(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            break;
+
+        case 1:
+            SendMessage(CommsStatusMessage1);
+            FormatUnsigned16(GetTxHighWaterMark(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Slash);
+            FormatUnsigned16(GetTxWaitCount(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            break;
+
+        default:
+            SendMessage(CommsStatusMessage2);
+            FormatUnsigned16(GetSPI_TransferTime(SPI_DEVICE_DRV8711), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Slash);
+            FormatUnsigned16(GetSPI_TransferTime(SPI_DEVICE_LED), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(CRLF);
+            return MENU_LINES_DONE;
+    }
+    return MENU_LINES_MORE;
+}
+
+//*********************************************
+//Clear the receive error counters and the transmit high water mark
+
+void    ClearCommsStatus(void)
+{
+    ClearCommsCounters();
+}
+
+//*********************************************
+//Select a new baud rate from the list, the new rate is only kept if the
+//host sends the confirm character at it. The menu keeps running while
+//the last characters are sent and the handshake is waited for
+
+void    SelectBaudRate(void)
+{
+    MenuRequestLines(SendBaudRateOptions);
+}
+
+unsigned int    SendBaudRateOptions(unsigned int Line)
+{
+    if(Line < BAUD_RATE_OPTION_COUNT)
+    {
+        SendMessage(CRLF);
+        SendMessage(Space);
+        SendChar('1' + Line);
+        SendMessage(Colon);
+        FormatUnsigned32(BaudRateOptions[Line], 1, GLOBAL_ResultString);
+        SendString(GLOBAL_ResultString);
+        return MENU_LINES_MORE;
+    }
+    MenuRequestValue(BaudRateMessage, 1, LINE_INTEGER, BaudRateEntered);
+    return MENU_LINES_DONE;
+}
+
+void    BaudRateEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, &BaudRateEntry);
+    }
+    if(StringStatus == STRING_OK && (BaudRateEntry < 1 || BaudRateEntry > BAUD_RATE_OPTION_COUNT))
+    {
+        StringStatus = OUT_OF_RANGE;
+    }
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = ChangeBaudRate(BaudRateOptions[BaudRateEntry - 1]);
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+        return;
+    }
+    //the rate changes once the confirm request has been sent
+    MenuRequestLines(SendBaudRateConfirm);
+}
+
+unsigned int    SendBaudRateConfirm(unsigned int Line)
+{
+    signed int Error;
+
+    if(Line == 0)
+    {
+        //display the error for the selected rate as a signed percentage
+        Error = GetBaudError(BaudRateOptions[BaudRateEntry - 1]);
+        SendMessage(BaudRateErrorMessage);
+        if(Error >= 0)
         {
-            //string error
-            DisplayStringError(StringStatus);
+            SendChar('+');
         }
-        else
-        {
-            //string ok
-            //convert string to binary value
-            Value = StringToInteger(GLOBAL_RxString);
-            //test for required action
-            switch(Value)
-            {                   
-                case 11:    //test PWM 3
-                    TestPWM_16Bit(3);
-                    break;
+        FormatFixed(Error, 2, GLOBAL_ResultString);
+        SendString(GLOBAL_ResultString);
+        return MENU_LINES_MORE;
+    }
+    SendMessage(BaudRateConfirmMessage);
+    MenuRequestWait(BaudRateConfirmed);
+    return MENU_LINES_DONE;
+}
+
+unsigned int    BaudRateConfirmed(void)
+{
+    unsigned int Status;
 
-                case 13:    //test stepper motor
-                    TestStepperMotor();
+    Status = BaudChangeService();
+    if(Status == STRING_OK)
+    {
+        SendMessage(BaudRateChangedMessage);
+    }
+    else if(Status != LINE_PENDING)
+    {
+        SendMessage(BaudRateUnchangedMessage);
+    }
+    return Status;
+}
+
+//*********************************************
+//Get DRV8711 status and display
+
+void    DisplayDRV8711Status(void)
+{
+    unsigned int SPIValue;
+    
+    SPIValue = ReadSPI(DRV_STATUS_REG);
+    //display binary value
+    BinaryToResultString(2, GLOBAL_ResultString, SPIValue);
+    //display the result
+    SendMessage(CRLF);
+    SendString(GLOBAL_ResultString);
+}
+
+//*********************************************
+//Clear the DRV8711 status latches
+
+void    ClearDRV8711Status(void)
+{
+    WriteSPI(DRV_STATUS_REG, 0);
+}
+
+//*********************************************
+//Show the lift menu, calls are served from the main loop in LOOK order
+//so more calls can be made while the lift moves
+
+void    RunElevator(void)
+{
+    MenuSelect(&LiftMenuTable);
+}
+
+
+
+//*********************************************
+//Show the calibration menu, homing and floor moves run from the main
+//loop so the menu stays live while the lift moves
+
+void    CalibrationMenu(void)
+{
+    MenuSelect(&CalibrationMenuTable);
+}
+
+
+
+//*********************************************
+//Display the homing state, position, travel and floor positions
+//one item on each line sent
+
+unsigned int    DisplayCalibrationStatus(unsigned int Line)
+{
+    switch(Line)
+    {
+        case 0:
+            SendMessage(HomeStatusMessage);
+            switch(HomeState())
+            {
+                case HOME_IDLE:
+                    SendMessage(HomeIdleMessage);
                     break;
-                    
-                case 16:    //Get DRV8711 status and display
-                    SPIAddress = DRV_STATUS_REG;
-                    SPIValue = ReadSPI(SPIAddress);
-                    //display binary value
-                    BinaryToResultString(2, GLOBAL_ResultString, SPIValue);
-                    //display the result
-                    SendMessage(CRLF);
-                    SendString(GLOBAL_ResultString);
+                case HOME_DONE:
+                    SendMessage(HomeDoneMessage);
                     break;
-
-                case 17:    //Get DRV8711 status
-                    SPIAddress = DRV_STATUS_REG;
-                    SPIValue = 0;
-                    WriteSPI(SPIAddress,SPIValue);
+                case HOME_FAILED:
+                    if(HomeResult() == HOME_NOT_FOUND)
+                    {
+                        SendMessage(HomeNotFoundMessage);
+                    }
+                    else if(HomeResult() == HOME_STUCK)
+                    {
+                        SendMessage(HomeStuckMessage);
+                    }
+                    else if(HomeResult() == HOME_LIMIT)
+                    {
+                        SendMessage(HomeLimitMessage);
+                    }
+                    else
+                    {
+                        SendMessage(HomeAbortedMessage);
+                    }
+                    break;
+                default:
+                    SendMessage(HomeRunningMessage);
                     break;
-                    
-                default:    //invalid entry
-                    SendMessage(InvalidNumber);
-                    
             }
-        }
+            break;
+
+        case 1:
+            SendMessage(HomeStatusMessage1);
+            FormatSigned32(MotionGetPosition(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            break;
+
+        case 2:
+            SendMessage(HomeStatusMessage2);
+            FormatSigned32(GLOBAL_MaxPosition, 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            break;
+
+        case 3:
+            SendMessage(HomeStatusMessage3);
+            FormatSigned32(GLOBAL_Floor1Position, 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Space);
+            FormatSigned32(GLOBAL_Floor2Position, 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Space);
+            FormatSigned32(GLOBAL_Floor3Position, 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            break;
+
+        case 4:
+            SendMessage(HomeStatusMessage4);
+            if(CalibrationIsLoaded() == 0)
+            {
+                SendMessage(No);
+            }
+            else
+            {
+                SendMessage(Yes);
+            }
+            break;
+
+        case 5:
+            SendMessage(HomeStatusMessage5);
+            FormatUnsigned16(DoorGetOpenRate(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Slash);
+            FormatUnsigned16(DoorGetCloseRate(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Space);
+            FormatUnsigned16(DoorGetDwell(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            break;
+
+        default:
+            SendMessage(CRLF);
+            return MENU_LINES_DONE;
     }
-    //end of main loop. Should never get to this point
-    return;
+    return MENU_LINES_MORE;
 }
 
-void    DisplayStringError(unsigned int ErrorValue)
+
+
+//*********************************************
+//Find the bottom and top endstops, homing sets GLOBAL_MaxPosition
+
+void    StartHoming(void)
 {
-    switch(ErrorValue)
+    if(HomeStart() != MOTION_OK)
     {
-        case TOO_LONG:  //string is too long
-            SendMessage(MessageTooLong);
-            break;
-            
-        case NO_DATA:  //string has no data
-            SendMessage(MessageNoValue);
-            break;
-            
-        case INVALID_STRING:  //string has too many decimal points
-            SendMessage(TooManyDecimalPoints);
+        SendMessage(MotorBusyMessage);
+    }
+}
+
+
+
+//*********************************************
+//Get the position of the passed floor number, NULL if out of range
+
+static volatile signed long    *FloorPosition(unsigned int Floor)
+{
+    switch(Floor)
+    {
+        case 1:
+            return &GLOBAL_Floor1Position;
+        case 2:
+            return &GLOBAL_Floor2Position;
+        case 3:
+            return &GLOBAL_Floor3Position;
+    }
+    return NULL;
+}
+
+
+
+//*********************************************
+//Convert a floor number, returns STRING_OK if it is 1 to 3
+
+static unsigned int    FloorNumberEntered(unsigned int StringStatus, volatile unsigned char *String, unsigned int *Floor)
+{
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, Floor);
+    }
+    if(StringStatus == STRING_OK && *Floor < 1)
+    {
+        StringStatus = VALUE_TOO_SMALL;
+    }
+    if(StringStatus == STRING_OK && *Floor > 3)
+    {
+        StringStatus = VALUE_TOO_LARGE;
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+    }
+    return StringStatus;
+}
+
+
+
+//*********************************************
+//Move to a saved floor position
+
+void    SelectFloor(void)
+{
+    if(HomeIsDone() == 0)
+    {
+        SendMessage(NotHomedMessage);
+        return;
+    }
+    MenuRequestValue(FloorNumberMessage, 1, LINE_INTEGER, FloorEntered);
+}
+
+void    FloorEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int Floor;
+
+    if(FloorNumberEntered(StringStatus, String, &Floor) != STRING_OK)
+    {
+        return;
+    }
+    if(HomeInTravel(*FloorPosition(Floor)) == 0)
+    {
+        SendMessage(NearEndstopMessage);
+        return;
+    }
+    if(LiftManualMove(*FloorPosition(Floor)) != LIFT_OK)
+    {
+        SendMessage(LiftBusyMessage);
+    }
+}
+
+
+
+//*********************************************
+//Move up or down by a distance in mm, to 0.01 mm
+
+void    AdjustPosition(void)
+{
+    if(HomeIsDone() == 0)
+    {
+        SendMessage(NotHomedMessage);
+        return;
+    }
+    MenuRequestValue(AdjustMessage, 7, LINE_DECIMAL, AdjustEntered);
+}
+
+void    AdjustEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    signed long Distance;
+
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToFixed(String, DISTANCE_DECIMALS, &Distance);
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+        return;
+    }
+    MoveStepper(Distance);
+}
+
+
+
+//*********************************************
+//Save the present position as a floor position
+
+void    SaveFloor(void)
+{
+    if(HomeIsDone() == 0)
+    {
+        SendMessage(NotHomedMessage);
+        return;
+    }
+    MenuRequestValue(FloorNumberMessage, 1, LINE_INTEGER, SaveFloorEntered);
+}
+
+void    SaveFloorEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int Floor;
+
+    if(FloorNumberEntered(StringStatus, String, &Floor) != STRING_OK)
+    {
+        return;
+    }
+    if(MotionBusy() != 0)
+    {
+        SendMessage(MotorBusyMessage);
+        return;
+    }
+    if(HomeInTravel(MotionGetPosition()) == 0)
+    {
+        SendMessage(NearEndstopMessage);
+        return;
+    }
+    *FloorPosition(Floor) = MotionGetPosition();
+}
+
+
+
+//*********************************************
+//Stop homing or a calibration move
+
+void    StopCalibration(void)
+{
+    HomeAbort();
+    MotionStop();
+}
+
+
+
+//*********************************************
+//Save the floor positions, travel and move settings to flash
+
+void    SaveCalibration(void)
+{
+    unsigned int Status;
+
+    Status = CalibrationSave();
+    if(Status == CALIBRATION_OK)
+    {
+        SendMessage(SavedMessage);
+    }
+    else if(Status == CALIBRATION_BUSY)
+    {
+        SendMessage(MotorBusyMessage);
+    }
+    else
+    {
+        SendMessage(SaveFailedMessage);
+    }
+}
+
+
+
+//*********************************************
+//Set the door opening and closing rates, then the dwell time
+
+void    DoorSettings(void)
+{
+    MenuRequestValue(DoorOpenRateMessage, 4, LINE_INTEGER, DoorOpenRateEntered);
+}
+
+void    DoorOpenRateEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, &DoorOpenRateEntry);
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+        return;
+    }
+    MenuRequestValue(DoorCloseRateMessage, 4, LINE_INTEGER, DoorCloseRateEntered);
+}
+
+void    DoorCloseRateEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int CloseRate;
+
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, &CloseRate);
+    }
+    if(StringStatus == STRING_OK && DoorSetSpeed(DoorOpenRateEntry, CloseRate) != DOOR_OK)
+    {
+        StringStatus = OUT_OF_RANGE;
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+        return;
+    }
+    MenuRequestValue(DoorDwellMessage, 5, LINE_INTEGER, DoorDwellEntered);
+}
+
+void    DoorDwellEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int Dwell;
+
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, &Dwell);
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+        return;
+    }
+    DoorSetDwell(Dwell);
+}
+
+
+
+//*********************************************
+//Show the drive settings menu, the settings are kept by Save calibration
+//except the time parked before the drive is disabled
+
+void    DriveSettings(void)
+{
+    MenuSelect(&DriveMenuTable);
+}
+
+unsigned int    DisplayDriveStatus(unsigned int Line)
+{
+    unsigned int Setting;
+
+    switch(Line)
+    {
+        case 0:
+            SendMessage(DriveStatusMessage);
+            FormatUnsigned16(MotionGetAcceleration(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            SendMessage(Slash);
+            FormatUnsigned16(MotionGetDeceleration(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
+            return MENU_LINES_MORE;
+
+        case 1:
+            SendMessage(DriveStatusMessage1);
+            Setting = MotionGetHardwareCruise();
             break;
-            
-        case VALUE_TOO_LARGE:  //string exceeds maximum value
-            SendMessage(TooLarge);
+
+        case 2:
+            SendMessage(DriveStatusMessage2);
+            Setting = (MotionGetShape() != MOTION_SHAPE_TRAPEZOID);
             break;
-            
-        case VALUE_TOO_SMALL:  //string exceeds minimum value
-            SendMessage(TooSmall);
+
+        case 3:
+            SendMessage(DriveStatusMessage3);
+            Setting = MotionGetModeSwitch();
             break;
-            
-        //No default
+
+        case 4:
+            SendMessage(DriveStatusMessage4);
+            if(MotionGetIdleTimeout() == 0)
+            {
+                SendMessage(Never);
+            }
+            else
+            {
+                FormatUnsigned16((unsigned int)(MotionGetIdleTimeout() / 1000), 1, GLOBAL_ResultString);
+                SendString(GLOBAL_ResultString);
+            }
+            return MENU_LINES_MORE;
+
+        default:
+            SendMessage(CRLF);
+            return MENU_LINES_DONE;
+    }
+    if(Setting == 0)
+    {
+        SendMessage(No);
     }
+    else
+    {
+        SendMessage(Yes);
+    }
+    return MENU_LINES_MORE;
 }
 
-void    MainMenu(){
-    unsigned int StringStatus;
-    while(1)
+
+
+//*********************************************
+//Convert a rate in steps/s/s, returns STRING_OK if it is in range
+
+static unsigned int    RateEntered(unsigned int StringStatus, volatile unsigned char *String, unsigned int *Rate)
+{
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, Rate);
+    }
+    if(StringStatus == STRING_OK && *Rate < MIN_ACCELERATION)
+    {
+        StringStatus = VALUE_TOO_SMALL;
+    }
+    if(StringStatus == STRING_OK && *Rate > MAX_ACCELERATION)
+    {
+        StringStatus = VALUE_TOO_LARGE;
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+    }
+    return StringStatus;
+}
+
+
+
+//*********************************************
+//Set the acceleration, then the deceleration, used from the next move
+
+void    SetProfile(void)
+{
+    MenuRequestValue(AccelerationMessage, 5, LINE_INTEGER, AccelerationEntered);
+}
+
+void    AccelerationEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    if(RateEntered(StringStatus, String, &AccelerationEntry) != STRING_OK)
+    {
+        return;
+    }
+    MenuRequestValue(DecelerationMessage, 5, LINE_INTEGER, DecelerationEntered);
+}
+
+void    DecelerationEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int Deceleration;
+
+    if(RateEntered(StringStatus, String, &Deceleration) != STRING_OK)
+    {
+        return;
+    }
+    MotionSetProfile(AccelerationEntry, Deceleration);
+}
+
+
+
+//*********************************************
+//Make the cruise steps with PWM11 instead of the step interrupt, or back
+
+void    ToggleHardwareCruise(void)
+{
+    MotionSetHardwareCruise(MotionGetHardwareCruise() == 0);
+}
+
+
+
+//*********************************************
+//Change between the trapezoid and S curve profiles, used from the next move
+
+void    ToggleProfileShape(void)
+{
+    if(MotionGetShape() == MOTION_SHAPE_TRAPEZOID)
+    {
+        MotionSetShape(MOTION_SHAPE_SCURVE);
+    }
+    else
+    {
+        MotionSetShape(MOTION_SHAPE_TRAPEZOID);
+    }
+}
+
+
+
+//*********************************************
+//Change to coarser microsteps at speed, or keep the same microsteps
+
+void    ToggleModeSwitch(void)
+{
+    MotionSetModeSwitch(MotionGetModeSwitch() == 0);
+}
+
+
+
+//*********************************************
+//Set the time parked before the drive is disabled, 0 never disables it
+//The car falls when the drive is disabled, so this is for a lift with a
+//brake or a bench test without the car. Not kept by Save calibration,
+//the drive always holds the car after power up
+
+void    SetIdleTimeout(void)
+{
+    MenuRequestValue(IdleTimeoutMessage, 4, LINE_INTEGER, IdleTimeoutEntered);
+}
+
+void    IdleTimeoutEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int Seconds;
+
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, &Seconds);
+    }
+    if(StringStatus == STRING_OK && Seconds > MOTION_MAX_IDLE_TIMEOUT / 1000)
+    {
+        StringStatus = VALUE_TOO_LARGE;
+    }
+    if(StringStatus != STRING_OK)
+    {
+        DisplayStringError(StringStatus);
+        return;
+    }
+    MotionSetIdleTimeout(Seconds * 1000UL);
+}
+
+
+
+//*********************************************
+//Return to the calibration menu
+
+void    ExitDriveSettings(void)
+{
+    MenuSelect(&CalibrationMenuTable);
+}
+
+
+
+//*********************************************
+//Return to the main menu, the lift finishes any move in progress
+
+void    ExitCalibration(void)
+{
+    MenuSelect(&MainMenu);
+}
+
+
+
+//*********************************************
+//Move by a distance in 0.01 mm, limited to the travel found by homing
+//less HOME_LIMIT_MARGIN so the move stops short of the switches
+//the move is made through Lift.c so it is refused while the lift is
+//serving calls, poll MotionIsComplete for the end of the move
+
+void    MoveStepper(signed long Distance)
+{
+    signed long Target;
+
+    Target = HomeLimitPosition(MotionGetPosition() + MotionDistanceToSteps(Distance));
+    if(LiftManualMove(Target) != LIFT_OK)
     {
-        //Print options to user
-        SendMessage(OptionMessage);
-        SendMessage(OptionMessage1);
-        SendMessage(OptionMessage2);
-        SendMessage(OptionSelectMessage);
+        SendMessage(LiftBusyMessage);
+    }
+}
+
+
 
-        //Check for string entry
-        StringStatus = GetString(2,GLOBAL_RxString);
-        if(StringStatus != STRING_OK)
+//*********************************************
+//Display the floor, direction, waiting calls and call times
+
+static void    SendCalls(unsigned int Call)
+{
+    unsigned int Floor;
+
+    for(Floor = 0; Floor < LIFT_FLOORS; Floor++)
+    {
+        if(LiftCallPending(Floor, Call) != 0)
         {
-            //string error
-            DisplayStringError(StringStatus);
+            SendChar('1' + Floor);
         }
-        
-        else
-        {
-            //string ok
-            //convert string to binary value
-            Value = StringToInteger(GLOBAL_RxString);
-
-            //Execute user option
-            switch(Value){
-                case 1:
-                    RunElevator();
+    }
+}
+
+static void    SendAverage(unsigned long Total, unsigned int Count, unsigned int Max)
+{
+    if(Count != 0)
+    {
+        Total = Total / Count;
+    }
+    FormatUnsigned32(Total, 1, GLOBAL_ResultString);
+    SendString(GLOBAL_ResultString);
+    SendMessage(Slash);
+    FormatUnsigned16(Max, 1, GLOBAL_ResultString);
+    SendString(GLOBAL_ResultString);
+}
+
+unsigned int    DisplayLiftStatus(unsigned int Line)
+{
+    const LIFT_STATISTICS *Statistics;
+
+    Statistics = LiftGetStatistics();
+    switch(Line)
+    {
+        case 0:
+            SendMessage(LiftStatusMessage);
+            if(LiftGetFloor() == LIFT_NO_FLOOR)
+            {
+                SendMessage(LiftBetweenFloors);
+            }
+            else
+            {
+                SendChar('1' + LiftGetFloor());
+            }
+            SendMessage(LiftStatusMessage1);
+            if(LiftGetDirection() == LIFT_DIRECTION_UP)
+            {
+                SendMessage(LiftUp);
+            }
+            else if(LiftGetDirection() == LIFT_DIRECTION_DOWN)
+            {
+                SendMessage(LiftDown);
+            }
+            else
+            {
+                SendMessage(LiftStopped);
+            }
+            break;
+
+        case 1:
+            SendMessage(LiftStatusMessage5);
+            switch(DoorState())
+            {
+                case DOOR_OPENING:
+                    SendMessage(DoorOpeningMessage);
                     break;
-                case 2:
-                    CalibrationMenu();
+                case DOOR_OPEN:
+                    SendMessage(DoorOpenMessage);
+                    break;
+                case DOOR_CLOSING:
+                    SendMessage(DoorClosingMessage);
                     break;
                 default:
-                    SendMessage(InvalidNumber);
+                    SendMessage(DoorClosedMessage);
+                    break;
             }
-        }
+            if(LiftState() == LIFT_WAIT_HOME)
+            {
+                SendMessage(LiftWaitHome);
+            }
+            break;
+
+        case 2:
+            SendMessage(LiftStatusMessage2);
+            SendCalls(LIFT_CALL_UP);
+            SendMessage(Slash);
+            SendCalls(LIFT_CALL_DOWN);
+            SendMessage(Slash);
+            SendCalls(LIFT_CALL_CAR);
+            break;
+
+        case 3:
+            SendMessage(LiftStatusMessage3);
+            SendAverage(Statistics->WaitTotal, Statistics->WaitCount, Statistics->WaitMax);
+            break;
+
+        case 4:
+            SendMessage(LiftStatusMessage4);
+            SendAverage(Statistics->TravelTotal, Statistics->TravelCount, Statistics->TravelMax);
+            break;
+
+        default:
+            SendMessage(CRLF);
+            return MENU_LINES_DONE;
     }
+    return MENU_LINES_MORE;
 }
 
-void    RunElevator(){
-    unsigned int StringStatus;
-    unsigned int Value;
-    //While
-        //Move to bottom "floor"
-        //Open Door
-        //Ask User to enter a floor number
-        //Check if already at floor
-        //Close door
-        //Move to floor
-        //Open Door
-}
-
-void    CalibrationMenu(){
-    unsigned int StringStatus;
-    unsigned int Value;
-    //Move motor to bottom endstop
-    //Set current motor position to 0
-    //Move motor up until top endstop is hit
-    //Set as max motor position
-    //Allow user to enter a floor number
-    // Move to floor
-    // Ask user if position is ok
-    // Allow user to adjust position of motor /0.1/1/10mm
-    // Save floor position to global variable
-}
-
-void    MoveStepper(double mm){
-    //Step Motor for amount of steps = mm
+
+
+//*********************************************
+//Make a hall call or car call at the floor entered
+
+static void    MakeCall(unsigned int StringStatus, volatile unsigned char *String, unsigned int Call)
+{
+    unsigned int Floor;
+
+    if(FloorNumberEntered(StringStatus, String, &Floor) != STRING_OK)
+    {
+        return;
+    }
+    if(LiftCall(Floor - 1, Call) != LIFT_OK)
+    {
+        SendMessage(InvalidCallMessage);
+    }
+}
+
+void    CallUp(void)
+{
+    MenuRequestValue(FloorNumberMessage, 1, LINE_INTEGER, CallUpEntered);
+}
+
+void    CallUpEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    MakeCall(StringStatus, String, LIFT_CALL_UP);
+}
+
+void    CallDown(void)
+{
+    MenuRequestValue(FloorNumberMessage, 1, LINE_INTEGER, CallDownEntered);
+}
+
+void    CallDownEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    MakeCall(StringStatus, String, LIFT_CALL_DOWN);
+}
+
+void    CallCar(void)
+{
+    MenuRequestValue(FloorNumberMessage, 1, LINE_INTEGER, CallCarEntered);
+}
+
+void    CallCarEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    MakeCall(StringStatus, String, LIFT_CALL_CAR);
+}
+
+
+
+//*********************************************
+//Clear the wait and travel times
+
+void    ClearLiftTimes(void)
+{
+    LiftClearStatistics();
+}
+
+
+
+//*********************************************
+//Return to the main menu, waiting calls are still served
+
+void    ExitLift(void)
+{
+    MenuSelect(&MainMenu);
 }
@@ -14,6 +14,11 @@
 #include "PWM.h"    //this file includes PWM functions
 #include "SPI.h"    //this file includes SPI and DREV8711 functions
 #include "Timer.h"  //this file includes timer functions
+#include "Protocol.h"   //this file includes the binary command protocol
+#include "Menu.h"   //this file includes the table driven menus
+#include "Format.h" //this file includes number formatting functions
+#include "Motion.h" //this file includes stepper motor acceleration profiles
+#include "MotionQueue.h"    //this file includes the queue of blended moves
 
 /*
  * The default state for the CONFIG registers is as follows:
@@ -65,8 +70,12 @@
 
 //define strings
 const unsigned char OptionMessage[] = "\r\n\r\n **** g8 lift ****\r\n";
-const unsigned char OptionMessage1[] = " 1:Test option n";
-const unsigned char OptionMessage2[] = " 2:Run lift \n";
+const unsigned char OptionMessage1[] = " 1:Run lift\r\n";
+const unsigned char OptionMessage2[] = " 2:Test PWM 3\r\n";
+const unsigned char OptionMessage3[] = " 3:Test PWM 4\r\n";
+const unsigned char OptionMessage4[] = " 4:Test stepper motor\r\n";
+const unsigned char OptionMessage5[] = " 5:Comms status\r\n";
+const unsigned char OptionMessage6[] = " 6:Change baud rate\r\n";
 const unsigned char OptionSelectMessage[] = "\r\nEnter number: ";
 const unsigned char CRLF[] = "\r\n";
 
@@ -77,25 +86,53 @@ const unsigned char MotorOptionMessage2[] = " 2: Set the motor step interval\r\n
 const unsigned char MotorOptionMessage2a[] = " 2: Set the PWM duty cycle\r\n";
 const unsigned char MotorOptionMessage3[] = " 3: Start motor\r\n";
 const unsigned char MotorOptionMessage4[] = " 4: Return to main menu\r\n";
+const unsigned char MotorOptionMessage5[] = " 5: Set the acceleration\r\n";
+const unsigned char MotorOptionMessage6[] = " 6: Set the deceleration\r\n";
+const unsigned char MotorOptionMessage7[] = " 7: Toggle hardware cruise steps\r\n";
+const unsigned char MotorOptionMessage8[] = " 8: Toggle S curve profile\r\n";
+const unsigned char MotorOptionMessage9[] = " 9: Toggle step mode switching\r\n";
 const unsigned char MotorRunningMessage[] = "\r\n Motor running. Enter any character to stop: ";
 
 //stepper/DC Motor drive status messages
 const unsigned char StepperMotorStatusMessage[] = "\r\n\r\n*** STEPPER MOTOR DRIVE STATUS ***\r\n";
 const unsigned char StepperMotorStatusMessage1[] = "\r\n      Direction: ";
 const unsigned char StepperMotorStatusMessage2[] = "\r\n  Step interval: ";
+const unsigned char StepperMotorStatusMessage3[] = "\r\n   Acceleration: ";
+const unsigned char StepperMotorStatusMessage4[] = "\r\n   Deceleration: ";
+const unsigned char StepperMotorStatusMessage5[] = "\r\n       Position: ";
+const unsigned char StepperMotorStatusMessage6[] = "\r\n Hardware cruise: ";
+const unsigned char StepperMotorStatusMessage7[] = "\r\n        Profile: ";
+const unsigned char StepperMotorStatusMessage8[] = "\r\n Mode switching: ";
+const unsigned char Trapezoid[] = "TRAPEZOID";
+const unsigned char SCurve[] = "S CURVE";
+const unsigned char On[] = "ON";
+const unsigned char Off[] = "OFF";
 const unsigned char Clockwise[] = "CLOCKWISE";
 const unsigned char AntiClockwise[] = "ANTICLOCKWISE";
 
-//lift messages
-
+//comms status messages
+const unsigned char CommsStatusMessage[] = "\r\n\r\n*** COMMS STATUS ***\r\n";
+const unsigned char CommsStatusMessage1[] = "\r\n     RX dropped: ";
+const unsigned char CommsStatusMessage2[] = "\r\n     RX overrun: ";
+const unsigned char CommsStatusMessage3[] = "\r\n     RX framing: ";
+const unsigned char CommsStatusMessage4[] = "\r\n  TX high water: ";
+const unsigned char CommsStatusMessage5[] = "\r\n DRV8711 SPI us: ";
+const unsigned char CommsStatusMessage6[] = "\r\n     LED SPI us: ";
+
+//baud rate messages
+const unsigned char BaudRateOptionMessage[] = "\r\n\r\n*** BAUD RATE ***\r\n 1: 9600\r\n 2: 19200\r\n 3: 57600\r\n 4: 115200\r\n 5: 250000\r\n 6: 500000\r\n";
+const unsigned char BaudRateErrorMessage[] = "\r\n Baud rate error: ";
+const unsigned char BaudRateConfirmMessage[] = "%\r\n Change terminal rate and send Y within 5 s\r\n";
+const unsigned char BaudRateChangedMessage[] = "\r\n Baud rate changed";
+const unsigned char BaudRateUnchangedMessage[] = "\r\n No confirmation, baud rate unchanged";
+const unsigned long BaudRateOptions[] = {9600, 19200, 57600, 115200, 250000, 500000};
 
-//string error messages
-const unsigned char MessageTooLong[] = "\r\n String entered is too long";
-const unsigned char MessageNoValue[] = "\r\n No Value Entered";
-const unsigned char InvalidNumber[] = "\r\n Value out of range";
-const unsigned char TooManyDecimalPoints[] = "\r\n Too many decimal points";
-const unsigned char TooLarge[] = "\r\n Value too large";
-const unsigned char TooSmall[] = "\r\n Value too small";
+//lift messages
+const unsigned char LiftOptionMessage[] = "\r\n\r\n **** RUN LIFT ****\r\n";
+const unsigned char LiftOptionMessage1[] = " 1: Floor 0\r\n";
+const unsigned char LiftOptionMessage2[] = " 2: Floor 1\r\n";
+const unsigned char LiftOptionMessage3[] = " 3: Floor 2\r\n";
+const unsigned char LiftOptionMessage4[] = " 4: Return to main menu\r\n";
 
 //PWM test message
 const unsigned char PWM_16Bit_TestMessage[] = "\r\n Enter a value between 1000 and 2000. Enter 0 to exit: ";
@@ -103,6 +140,10 @@ const unsigned char PWM_10Bit_TestMessage[] = "\r\n Enter a percentage value bet
 
 //Stepper motor speed message
 const unsigned char StepperMotorSpeedMessage[] = "\r\n Enter a step interval in microseconds. Value between 500 and 9999: ";
+const unsigned char StepperMotorAccelMessage[] = "\r\n Enter a rate in steps/s/s. Value between 100 and 60000: ";
+
+//variables used in this file
+unsigned int PWM_TestNumber;
 
 //global variables
 volatile unsigned int GLOBAL_TimerEventCounter = 0;
@@ -111,6 +152,8 @@ volatile unsigned int GLOBAL_MasterTimeOutCounter = 0;
 volatile unsigned int GLOBAL_MasterTimeOutFlag = 0;
 volatile unsigned char GLOBAL_ResultString[RESULT_STRING_LENGTH];
 volatile unsigned char GLOBAL_RxString[RX_STRING_LENGTH];
+volatile unsigned int GLOBAL_PWM1_PulseTime = 100;
+volatile unsigned int GLOBAL_PWM2_PulseTime = 100;
 volatile unsigned int GLOBAL_PWM3_PulseTime;
 volatile unsigned int GLOBAL_PWM4_PulseTime;
 volatile unsigned int GLOBAL_StepperMotorSpeed;
@@ -119,28 +162,83 @@ volatile unsigned int GLOBAL_DirectionStatus;
 
 
 
+
+
+
 //list functions
-void    DisplaySystemOptionsList(void);
-void    DisplayStringError(unsigned int);
 void    DisplaySpeedControl(void);
 void    DisplayAnalogueInput_1(void);
 void    DisplayAnalogueInput_2(void);
 void    TestPWM_10Bit(unsigned int);
+void    PWM_10BitValueEntered(unsigned int, volatile unsigned char *);
 void    TestPWM_16Bit(unsigned int);
+void    PWM_16BitValueEntered(unsigned int, volatile unsigned char *);
+void    TestPWM_3(void);
+void    TestPWM_4(void);
 void    TestStepperMotor(void);
-void    DisplayStepperMotorOptionsList(unsigned int);
+void    ToggleStepperDirection(void);
 void    SetStepperMotorSpeed(void);
-void    DisplayStepperMotorStatus(void);
+void    StepperMotorSpeedEntered(unsigned int, volatile unsigned char *);
+void    StartStepperMotor(void);
+void    StopStepperMotor(unsigned int);
+void    SetStepperAcceleration(void);
+void    StepperAccelerationEntered(unsigned int, volatile unsigned char *);
+void    SetStepperDeceleration(void);
+void    StepperDecelerationEntered(unsigned int, volatile unsigned char *);
+void    ToggleHardwareCruise(void);
+void    ToggleProfileShape(void);
+void    ToggleModeSwitch(void);
+void    ExitStepperMotorTest(void);
+unsigned int    DisplayStepperMotorStatus(unsigned int);
+void    DisplayCommsStatus(void);
+void    SelectBaudRate(void);
+void    BaudRateEntered(unsigned int, volatile unsigned char *);
 void    RunLift(void);
+void    MoveToFloor_0(void);
+void    MoveToFloor_1(void);
+void    MoveToFloor_2(void);
+void    ExitLift(void);
+
+//menu tables
+const MENU_COMMAND SystemCommands[] =
+{
+    {1, OptionMessage1, RunLift},
+    {2, OptionMessage2, TestPWM_3},
+    {3, OptionMessage3, TestPWM_4},
+    {4, OptionMessage4, TestStepperMotor},
+    {5, OptionMessage5, DisplayCommsStatus},
+    {6, OptionMessage6, SelectBaudRate}
+};
+const MENU SystemMenu = {OptionMessage, NULL, SystemCommands, MENU_COMMAND_COUNT(SystemCommands), 2};
+
+const MENU_COMMAND StepperCommands[] =
+{
+    {1, MotorOptionMessage1, ToggleStepperDirection},
+    {2, MotorOptionMessage2, SetStepperMotorSpeed},
+    {3, MotorOptionMessage3, StartStepperMotor},
+    {4, MotorOptionMessage4, ExitStepperMotorTest},
+    {5, MotorOptionMessage5, SetStepperAcceleration},
+    {6, MotorOptionMessage6, SetStepperDeceleration},
+    {7, MotorOptionMessage7, ToggleHardwareCruise},
+    {8, MotorOptionMessage8, ToggleProfileShape},
+    {9, MotorOptionMessage9, ToggleModeSwitch}
+};
+const MENU StepperMenu = {StepperOptionMessage, DisplayStepperMotorStatus, StepperCommands, MENU_COMMAND_COUNT(StepperCommands), 1};
+
+const MENU_COMMAND LiftCommands[] =
+{
+    {1, LiftOptionMessage1, MoveToFloor_0},
+    {2, LiftOptionMessage2, MoveToFloor_1},
+    {3, LiftOptionMessage3, MoveToFloor_2},
+    {4, LiftOptionMessage4, ExitLift}
+};
+const MENU LiftMenu = {LiftOptionMessage, NULL, LiftCommands, MENU_COMMAND_COUNT(LiftCommands), 1};
 
 //main function
 
 void main(void) {
     
-    unsigned int StringStatus;
-    unsigned int Value;
-    unsigned int SPIAddress;
-    unsigned int SPIValue;
+    unsigned int CheckCount = 0;
 
     //wait for PLL to stabilise
     while(OSCSTATbits.PLLR == 0);
@@ -152,6 +250,8 @@ void main(void) {
     InitialisePWM_10Bit();
     InitialisePWM_16Bit();
     InitialiseTimers();
+    InitialiseMotion();
+    InitialiseMotionQueue();
     InitialiseSPI();
     InitialiseDRV8711();
     
@@ -159,49 +259,26 @@ void main(void) {
     INTCONbits.PEIE = 1;        //enable peripheral interrupts
     INTCONbits.GIE = 1;         //enable interrupts
     
+    //start at the system options list
+    MenuSelect(&SystemMenu);
     
     //main loop
+    //the menu never waits for input so other tasks can be added to this loop
     while(1)
     {
-        //display options list
-        DisplaySystemOptionsList();
+        MenuService();
+        //keep the step block ring filled from the queued moves
+        MotionQueueService();
+        //reduce the motor current at rest
+        MotionTorqueService();
         
-        //test for any string entry
-        StringStatus = GetString(2,GLOBAL_RxString);
-        if(StringStatus != STRING_OK)
+        //compare one DRV8711 register with its shadow copy now and again
+        //to find a driver that has reset and lost its settings
+        CheckCount++;
+        if(CheckCount >= DRV_CHECK_INTERVAL)
         {
-            //string error
-            DisplayStringError(StringStatus);
-        }
-        else
-        {
-            //string ok
-            //convert string to binary value
-            Value = StringToInteger(GLOBAL_RxString);
-            //test for required action
-            switch(Value)
-            {
-                case 1:     //test relay 1
-                    //run lift
-                    break;
-                    
-                case 2:    //test PWM 3
-                    TestPWM_16Bit(3);
-                    break;
-                    
-                case 3:    //test PWM 4
-                    TestPWM_16Bit(4);
-                    break;
-
-                case 4:    //test stepper motor
-                    TestStepperMotor();
-                    break;
-                   
-                    
-                default:    //invalid entry
-                    SendMessage(InvalidNumber);
-                    
-            }
+            CheckCount = 0;
+            CheckDRV8711();
         }
     }
     //end of main loop. Should never get to this point
@@ -269,9 +346,7 @@ void    DisplayAnalogueInput_2(void)
 
 void    TestPWM_10Bit(unsigned int PWM_Number)
 {
-    unsigned int Status = 0;
-    unsigned int StringStatus;
-    unsigned int Value;
+    PWM_TestNumber = PWM_Number;
     
     //enable selected PWM
     switch(PWM_Number)
@@ -289,55 +364,61 @@ void    TestPWM_10Bit(unsigned int PWM_Number)
         //no default    
     }
     
-    //loop until exit character received
-    while(Status == 0)
+    //ask for the first duty cycle
+    MenuRequestValue(PWM_10Bit_TestMessage, 2, LINE_INTEGER, PWM_10BitValueEntered);
+}
+
+
+
+//*********************************************
+//10 bit PWM duty cycle entered
+//ask again until 0 is entered
+
+void    PWM_10BitValueEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int Value;
+    
+    if(StringStatus != STRING_OK)
+    {
+        //string error
+        DisplayStringError(StringStatus);
+    }
+    else
     {
-        //send the command string
-        SendMessage(PWM_10Bit_TestMessage);
-        StringStatus = GetString(2,GLOBAL_RxString);
-        if(StringStatus != STRING_OK)
+        //convert string to binary
+        Value = StringToInteger(String);
+        //test for string value
+        if(Value == 0)
         {
-            //string error
-            DisplayStringError(StringStatus);
+            //exit PWM test
+            //turn 10 bit PWM timer off
+            Disable_10BitPWM_Timer();
+            //disable 10 bit PWMs
+            DisablePWM_1();
+            DisablePWM_2();
+            //reset PWM values to 10%
+            GLOBAL_PWM1_PulseTime = 100;
+            GLOBAL_PWM2_PulseTime = 100;
+            return;
         }
-        else
+        
+        //test for which PWM to change
+        switch(PWM_TestNumber)
         {
-            //convert string to binary
-            Value = StringToInteger(GLOBAL_RxString);
-            //test for string value
-            if(Value == 0)
-            {
-                //exit PWM test
-                Status = 1;
-            }
-            else
-            {
-                //test for which PWM to change
-                switch(PWM_Number)
-                {
-                    case 1: //load PWM 1 time value
-                        GLOBAL_PWM1_PulseTime = Value * 10;
-                        break;
+            case 1: //load PWM 1 time value
+                GLOBAL_PWM1_PulseTime = Value * 10;
+                break;
 
-                    case 2: //load PWM 2 time value
-                        GLOBAL_PWM2_PulseTime = Value * 10;
-                        break;
+            case 2: //load PWM 2 time value
+                GLOBAL_PWM2_PulseTime = Value * 10;
+                break;
 
-                    //No default
-                }
-
-            }
+            //No default
         }
     }
-    //turn 10 bit PWM timer off
-    Disable_10BitPWM_Timer();
-    //disable 10 bit PWMs
-    DisablePWM_1();
-    DisablePWM_2();
-    //reset PWM values to 10%
-    GLOBAL_PWM1_PulseTime = 100;
-    GLOBAL_PWM2_PulseTime = 100;
-}    
+    //ask for the next duty cycle
+    MenuRequestValue(PWM_10Bit_TestMessage, 2, LINE_INTEGER, PWM_10BitValueEntered);
+}
 
 
 
@@ -347,80 +428,96 @@ void    TestPWM_10Bit(unsigned int PWM_Number)
 
 void    TestPWM_16Bit(unsigned int PWM_Number)
 {
-    unsigned int Status = 0;
-    unsigned int StringStatus;
+    PWM_TestNumber = PWM_Number;
+    
+    //ask for the first pulse time
+    MenuRequestValue(PWM_16Bit_TestMessage, 4, LINE_INTEGER, PWM_16BitValueEntered);
+}
+
+
+
+//*********************************************
+//16 bit PWM pulse time entered
+//ask again until 0 is entered
+
+void    PWM_16BitValueEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
     unsigned int Value;
     
-    //loop until exit character received
-    while(Status == 0)
+    if(StringStatus != STRING_OK)
+    {
+        //string error
+        DisplayStringError(StringStatus);
+    }
+    else
     {
-        //send the command string
-        SendMessage(PWM_16Bit_TestMessage);
-        StringStatus = GetString(4,GLOBAL_RxString);
-        if(StringStatus != STRING_OK)
+        //convert string to binary
+        Value = StringToInteger(String);
+        //test for string value
+        if(Value == 0)
         {
+            //exit PWM test
+            //reset PWM values to 1500
+            GLOBAL_PWM3_PulseTime = 1500;
+            GLOBAL_PWM4_PulseTime = 1500;
+            return;
+        }
+        else if(Value < 1000)   
+        {
+            //string value is too small
             //string error
-            DisplayStringError(StringStatus);
+            DisplayStringError(VALUE_TOO_SMALL);
+        }
+        else if(Value > 2000)
+        {
+            //string value is too big
+            //string error
+            DisplayStringError(VALUE_TOO_LARGE);
         }
         else
         {
-            //convert string to binary
-            Value = StringToInteger(GLOBAL_RxString);
-            //test for string value
-            if(Value == 0)
-            {
-                //exit PWM test
-                Status = 1;
-            }
-            else if(Value < 1000)   
-            {
-                //string value is too small
-                //string error
-                DisplayStringError(VALUE_TOO_SMALL);
-            }
-            else if(Value > 2000)
-            {
-                //string value is too big
-                //string error
-                DisplayStringError(VALUE_TOO_LARGE);
-            }
-            else
+            //test for which PWM to change
+            switch(PWM_TestNumber)
             {
-                //test for which PWM to change
-                switch(PWM_Number)
-                {
-                    case 3: //load PWM 5 time value
-                        GLOBAL_PWM3_PulseTime = Value;
-                        break;
-
-                    case 4: //load PWM 6 time value
-                        GLOBAL_PWM4_PulseTime = Value;
-                        break;
+                case 3: //load PWM 5 time value
+                    GLOBAL_PWM3_PulseTime = Value;
+                    break;
 
-                    //No default
-                }
+                case 4: //load PWM 6 time value
+                    GLOBAL_PWM4_PulseTime = Value;
+                    break;
 
+                //No default
             }
         }
     }
-    //reset PWM values to 1500
-    GLOBAL_PWM3_PulseTime = 1500;
-    GLOBAL_PWM4_PulseTime = 1500;
+    //ask for the next pulse time
+    MenuRequestValue(PWM_16Bit_TestMessage, 4, LINE_INTEGER, PWM_16BitValueEntered);
+}
+
+
+
+//*********************************************
+//menu handlers for the 16 bit PWM tests
+
+void    TestPWM_3(void)
+{
+    TestPWM_16Bit(3);
+}
+
+void    TestPWM_4(void)
+{
+    TestPWM_16Bit(4);
 }
 
 
 
 //*********************************************
 //test stepper motor.
-//this has a secondary HMI for selecting direction, speed and motor on/off
+//this has a secondary menu for selecting direction, speed and motor on/off
 
 void    TestStepperMotor(void)
 {
-    unsigned int Status = 0;
-    unsigned int StringStatus;
-    unsigned int Value;
-    unsigned int MotorStopStatus;
-    
     //set for stepper mode
     SetDRV8711_Mode(STEPPER_MODE);
     
@@ -428,88 +525,28 @@ void    TestStepperMotor(void)
     GLOBAL_DirectionStatus = 0;
 
     //run motor control options menu
-    while(Status == 0)
-    {
-        //display status
-        DisplayStepperMotorStatus();
-        //display options list
-        DisplayStepperMotorOptionsList(STEPPER_MOTOR);
-
-        //test for any string entry
-        StringStatus = GetString(1,GLOBAL_RxString);
-        if(StringStatus != STRING_OK)
-        {
-            //string error
-            DisplayStringError(StringStatus);
-        }
-        else
-        {
-            //string ok
-            //convert string to binary value
-            Value = StringToInteger(GLOBAL_RxString);
-            //test for required action
-            switch(Value)
-            {
-                case 1:     //toggle motor direction
-                    if(GLOBAL_DirectionStatus == 0)
-                    {
-                        //change from clockwise to anticlockwise
-                        DRV8711_DIR_WRITE = 0b1;
-                        GLOBAL_DirectionStatus = 1;
-                    }
-                    else
-                    {
-                        //change from anticlockwise to clockwise
-                        DRV8711_DIR_WRITE = 0b0;
-                        GLOBAL_DirectionStatus = 0;
-                    }
-                    break;
+    MenuSelect(&StepperMenu);
+}
 
-                case 2:     //set motor speed
-                    SetStepperMotorSpeed();
-                    break;
 
-                case 3:     //switch motor on until character received
-                    SendMessage(MotorRunningMessage);
-                    //stepper is off therefore turn it on
-                    MotorOn();
-                    //enable the stepper interrupt timer
-                    StepperTimerOn();
-                    //wait for character to exit
-                    MotorStopStatus = 0;
-                    while(MotorStopStatus == 0)
-                    {
-                        Value = GetChar();
-                        if(Value != 0xFFFF)
-                        {
-                            MotorStopStatus = 1;
-                        }
-                    }
-                    //disable the stepper interrupt timer
-                    StepperTimerOff();
-                    //set the step output to 0
-                    DRV8711_STEP_WRITE = 0b0;
-                    //switch motor drive off
-                    MotorOff();
-                    break;
 
-                case 4:     //return to main screen
-                    Status = 1;
-                    break;
+//*********************************************
+//toggle stepper motor direction
 
-                default:    //invalid entry
-                    SendMessage(InvalidNumber);
-            }
-        }
+void    ToggleStepperDirection(void)
+{
+    if(GLOBAL_DirectionStatus == 0)
+    {
+        //change from clockwise to anticlockwise
+        DRV8711_DIR_WRITE = 0b1;
+        GLOBAL_DirectionStatus = 1;
+    }
+    else
+    {
+        //change from anticlockwise to clockwise
+        DRV8711_DIR_WRITE = 0b0;
+        GLOBAL_DirectionStatus = 0;
     }
-    //ensure the stepper interrupt timer is off
-    StepperTimerOff();
-    //set the step output to 0
-    DRV8711_STEP_WRITE = 0b0;
-    //ensure that motor drive is off
-    MotorOff();
-    //set stepper direction output to 0 and clockwise
-    DRV8711_DIR_WRITE = 0; 
 }
 
 
@@ -518,14 +555,20 @@ void    TestStepperMotor(void)
 //Set stepper motor speed. load a value between 500 and 9999
 
 void    SetStepperMotorSpeed(void)
+{
+    //send the command string, maximum 4 characters
+    MenuRequestValue(StepperMotorSpeedMessage, 4, LINE_INTEGER, StepperMotorSpeedEntered);
+}
+
+
+
+//***********************************************
+//stepper motor speed entered
+
+void    StepperMotorSpeedEntered(unsigned int StringStatus, volatile unsigned char *String)
 {
     unsigned int    Value;
-    unsigned int    StringStatus; 
     
-    //send the command string
-    SendMessage(StepperMotorSpeedMessage);
-    //get the string, maximum 4 characters
-    StringStatus = GetString(4,GLOBAL_RxString);
     if(StringStatus != STRING_OK)
     {
         //string error
@@ -534,7 +577,7 @@ void    SetStepperMotorSpeed(void)
     else
     {
         //convert string to binary
-        Value = StringToInteger(GLOBAL_RxString);
+        Value = StringToInteger(String);
         //test for value too small
         if(Value < 500)
         {
@@ -547,141 +590,383 @@ void    SetStepperMotorSpeed(void)
         }
     }
 }    
+
+
+
+//***********************************************
+//Set stepper motor acceleration and deceleration in steps/s/s
+
+void    SetStepperAcceleration(void)
+{
+    MenuRequestValue(StepperMotorAccelMessage, 5, LINE_INTEGER, StepperAccelerationEntered);
+}
+
+void    SetStepperDeceleration(void)
+{
+    MenuRequestValue(StepperMotorAccelMessage, 5, LINE_INTEGER, StepperDecelerationEntered);
+}
+
+
+
+//***********************************************
+//stepper motor acceleration or deceleration entered
+
+void    StepperAccelerationEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int    Value;
+    
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, &Value);
+    }
+    if(StringStatus == STRING_OK && Value < MIN_ACCELERATION)
+    {
+        StringStatus = VALUE_TOO_SMALL;
+    }
+    if(StringStatus == STRING_OK && Value > MAX_ACCELERATION)
+    {
+        StringStatus = VALUE_TOO_LARGE;
+    }
+    if(StringStatus != STRING_OK)
+    {
+        //string error
+        DisplayStringError(StringStatus);
+        return;
+    }
+    MotionSetProfile(Value, MotionGetDeceleration());
+}
+
+void    StepperDecelerationEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int    Value;
     
+    if(StringStatus == STRING_OK)
+    {
+        StringStatus = StringToUnsigned(String, &Value);
+    }
+    if(StringStatus == STRING_OK && Value < MIN_ACCELERATION)
+    {
+        StringStatus = VALUE_TOO_SMALL;
+    }
+    if(StringStatus == STRING_OK && Value > MAX_ACCELERATION)
+    {
+        StringStatus = VALUE_TOO_LARGE;
+    }
+    if(StringStatus != STRING_OK)
+    {
+        //string error
+        DisplayStringError(StringStatus);
+        return;
+    }
+    MotionSetProfile(MotionGetAcceleration(), Value);
+}
+
 
 
 //*********************************************
-//***************************************************
-//option list
-void    DisplaySystemOptionsList(void)
+//switch motor on until character received
+
+void    StartStepperMotor(void)
 {
-    //list the user options
-    SendMessage(OptionMessage);
-    SendMessage(OptionMessage1);
-    SendMessage(OptionMessage2);
-    SendMessage(OptionSelectMessage);
+    SendMessage(MotorRunningMessage);
+    //stepper is off therefore turn it on
+    MotorOn();
+    //accelerate to the step interval and keep going
+    MotionRun();
+    //wait for character to exit
+    MenuRequestKey(StopStepperMotor);
 }
 
 
 
 //*********************************************
-//display Stepper motor drive options list
+//character received while the motor is running
 
-void    DisplayStepperMotorOptionsList(unsigned int MotorType)
+void    StopStepperMotor(unsigned int RxChar)
 {
-     SendMessage(StepperOptionMessage);
-     //no default
-    SendMessage(MotorOptionMessage1);
-    SendMessage(MotorOptionMessage2);
-    SendMessage(MotorOptionMessage3);
-    SendMessage(MotorOptionMessage4);
-    SendMessage(OptionSelectMessage);
+    //decelerate and wait for the last step before switching the drive off
+    MotionStop();
+    while(MotionBusy() != 0);
+    //switch motor drive off
+    MotorOff();
 }
 
 
+
 //*********************************************
-//display stepper motor status
+//toggle making the cruise steps with PWM11 instead of the step interrupt
 
-void    DisplayStepperMotorStatus(void)
+void    ToggleHardwareCruise(void)
 {
-    //send status header message
-    SendMessage(StepperMotorStatusMessage);
-    
-    //send motor direction information
-    SendMessage(StepperMotorStatusMessage1);
-    if(GLOBAL_DirectionStatus == 0)
+    if(MotionGetHardwareCruise() == 0)
     {
-        SendMessage(Clockwise);
+        MotionSetHardwareCruise(1);
     }
     else
     {
-        SendMessage(AntiClockwise);
+        MotionSetHardwareCruise(0);
     }
+}
 
-    //send motor speed information
-    SendMessage(StepperMotorStatusMessage2);
-    //convert the integer value into a string
-    DecimalToResultString(GLOBAL_StepperMotorSpeed, GLOBAL_ResultString, 4);
-    //display the result
-    SendString(GLOBAL_ResultString);
+
+
+//*********************************************
+//toggle between the trapezoid and S curve profiles
+
+void    ToggleProfileShape(void)
+{
+    if(MotionGetShape() == MOTION_SHAPE_TRAPEZOID)
+    {
+        MotionSetShape(MOTION_SHAPE_SCURVE);
+    }
+    else
+    {
+        MotionSetShape(MOTION_SHAPE_TRAPEZOID);
+    }
+}
+
+
+
+//*********************************************
+//toggle changing to coarse steps at speed
+
+void    ToggleModeSwitch(void)
+{
+    if(MotionGetModeSwitch() == 0)
+    {
+        MotionSetModeSwitch(1);
+    }
+    else
+    {
+        MotionSetModeSwitch(0);
+    }
 }
 
+
+
 //*********************************************
-//display string error
+//return to main screen
 
-void    DisplayStringError(unsigned int ErrorValue)
+void    ExitStepperMotorTest(void)
 {
-    switch(ErrorValue)
+    //ensure the stepper interrupt timer is off and the step output is 0
+    InitialiseMotion();
+    //ensure that motor drive is off
+    MotorOff();
+    //set stepper direction output to 0 and clockwise
+    DRV8711_DIR_WRITE = 0; 
+    
+    MenuSelect(&SystemMenu);
+}
+
+
+
+//*********************************************
+//display stepper motor status, one line on each call
+//returns MENU_LINES_DONE after the last line
+
+unsigned int    DisplayStepperMotorStatus(unsigned int Line)
+{
+    switch(Line)
     {
-        case TOO_LONG:  //string is too long
-            SendMessage(MessageTooLong);
+        case 0:
+            //send status header message
+            SendMessage(StepperMotorStatusMessage);
+            
+            //send motor direction information
+            SendMessage(StepperMotorStatusMessage1);
+            if(GLOBAL_DirectionStatus == 0)
+            {
+                SendMessage(Clockwise);
+            }
+            else
+            {
+                SendMessage(AntiClockwise);
+            }
             break;
             
-        case NO_DATA:  //string has no data
-            SendMessage(MessageNoValue);
+        case 1:
+            //send motor speed information
+            SendMessage(StepperMotorStatusMessage2);
+            //convert the integer value into a string
+            DecimalToResultString(GLOBAL_StepperMotorSpeed, GLOBAL_ResultString, 4);
+            //display the result
+            SendString(GLOBAL_ResultString);
             break;
             
-        case INVALID_STRING:  //string has too many decimal points
-            SendMessage(TooManyDecimalPoints);
+        case 2:
+            //send acceleration profile information
+            SendMessage(StepperMotorStatusMessage3);
+            DecimalToResultString(MotionGetAcceleration(), GLOBAL_ResultString, 1);
+            SendString(GLOBAL_ResultString);
+            SendMessage(StepperMotorStatusMessage4);
+            DecimalToResultString(MotionGetDeceleration(), GLOBAL_ResultString, 1);
+            SendString(GLOBAL_ResultString);
             break;
             
-        case VALUE_TOO_LARGE:  //string exceeds maximum value
-            SendMessage(TooLarge);
+        case 3:
+            //send step position
+            SendMessage(StepperMotorStatusMessage5);
+            FormatSigned32(MotionGetPosition(), 1, GLOBAL_ResultString);
+            SendString(GLOBAL_ResultString);
             break;
             
-        case VALUE_TOO_SMALL:  //string exceeds minimum value
-            SendMessage(TooSmall);
+        case 4:
+            //send step generator information
+            SendMessage(StepperMotorStatusMessage6);
+            if(MotionGetHardwareCruise() == 0)
+            {
+                SendMessage(Off);
+            }
+            else
+            {
+                SendMessage(On);
+            }
+            SendMessage(StepperMotorStatusMessage7);
+            if(MotionGetShape() == MOTION_SHAPE_TRAPEZOID)
+            {
+                SendMessage(Trapezoid);
+            }
+            else
+            {
+                SendMessage(SCurve);
+            }
+            SendMessage(StepperMotorStatusMessage8);
+            if(MotionGetModeSwitch() == 0)
+            {
+                SendMessage(Off);
+            }
+            else
+            {
+                SendMessage(On);
+            }
             break;
             
-        //No default
+        default:
+            return MENU_LINES_DONE;
     }
+    return MENU_LINES_MORE;
 }
-void RunLift(void){
+
+//*********************************************
+//display comms receiver error counters, transmit buffer usage and SPI transaction times
+
+void    DisplayCommsStatus(void)
+{
+    //send status header message
+    SendMessage(CommsStatusMessage);
     
-    unsigned int StringStatus;
-    unsigned int Value;
+    SendMessage(CommsStatusMessage1);
+    DecimalToResultString(GetRxDroppedCount(), GLOBAL_ResultString, 1);
+    SendString(GLOBAL_ResultString);
     
-    while(1)
+    SendMessage(CommsStatusMessage2);
+    DecimalToResultString(GetRxOverrunCount(), GLOBAL_ResultString, 1);
+    SendString(GLOBAL_ResultString);
+    
+    SendMessage(CommsStatusMessage3);
+    DecimalToResultString(GetRxFrameErrorCount(), GLOBAL_ResultString, 1);
+    SendString(GLOBAL_ResultString);
+    
+    SendMessage(CommsStatusMessage4);
+    DecimalToResultString(GetTxHighWaterMark(), GLOBAL_ResultString, 1);
+    SendString(GLOBAL_ResultString);
+    
+    //time of the last SPI transaction to each device
+    SendMessage(CommsStatusMessage5);
+    DecimalToResultString(GetSPI_TransferTime(SPI_DEVICE_DRV8711), GLOBAL_ResultString, 1);
+    SendString(GLOBAL_ResultString);
+    
+    SendMessage(CommsStatusMessage6);
+    DecimalToResultString(GetSPI_TransferTime(SPI_DEVICE_LED), GLOBAL_ResultString, 1);
+    SendString(GLOBAL_ResultString);
+}
+
+//*********************************************
+//select a new baud rate from the list
+
+void    SelectBaudRate(void)
+{
+    //send the rate list
+    SendMessage(BaudRateOptionMessage);
+    MenuRequestValue(OptionSelectMessage, 1, LINE_INTEGER, BaudRateEntered);
+}
+
+//*********************************************
+//baud rate selected, switch to it
+//the new rate is only kept if the host confirms it
+
+void    BaudRateEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int    Value;
+    signed int      Error;
+    
+    if(StringStatus != STRING_OK)
     {
-        //display options list
-        DisplaySystemOptionsList();
-        
-        //test for any string entry
-        StringStatus = GetString(2,GLOBAL_RxString);
-        if(StringStatus != STRING_OK)
-        {
-            //string error
-            DisplayStringError(StringStatus);
-        }
-        else
-        {
-            //string ok
-            //convert string to binary value
-            Value = StringToInteger(GLOBAL_RxString);
-            //test for required action
-            switch(Value)
-            {
-                case 1:     //test relay 1
-                    //floor 0
-                    break;
-                    
-                case 2:     //test relay 2
-                    //floor 1
-                    break;
-                    
-                case 3:     //test relay 3
-                    //floor 2
-                    break;
-                default:    //invalid entry
-                    SendMessage(InvalidNumber);      
-            }
-        }
+        //string error
+        DisplayStringError(StringStatus);
+        return;
     }
-    //end of main loop. Should never get to this point
-    return;
+    Value = StringToInteger(String);
+    if(Value < 1 || Value > sizeof(BaudRateOptions) / sizeof(BaudRateOptions[0]))
+    {
+        DisplayStringError(OUT_OF_RANGE);
+        return;
+    }
+    
+    //display the error for the selected rate as a signed percentage
+    Error = GetBaudError(BaudRateOptions[Value - 1]);
+    SendMessage(BaudRateErrorMessage);
+    if(Error >= 0)
+    {
+        SendChar('+');
+    }
+    FormatFixed(Error, 2, GLOBAL_ResultString);
+    SendString(GLOBAL_ResultString);
+    SendMessage(BaudRateConfirmMessage);
+    
+    //switch and wait for the host to confirm
+    if(ChangeBaudRate(BaudRateOptions[Value - 1]) == STRING_OK)
+    {
+        SendMessage(BaudRateChangedMessage);
+    }
+    else
+    {
+        SendMessage(BaudRateUnchangedMessage);
+    }
+}
+
+//*********************************************
+//run lift. Select the floor to move to
+
+void    RunLift(void)
+{
+    MenuSelect(&LiftMenu);
+}
+
+void    MoveToFloor_0(void)
+{
+    //floor 0
+}
+
+void    MoveToFloor_1(void)
+{
+    //floor 1
+}
+
+void    MoveToFloor_2(void)
+{
+    //floor 2
+}
+
+void    ExitLift(void)
+{
+    MenuSelect(&SystemMenu);
 }
 
-void MoveMM(double mm){
-    //amount in mm 
+void MoveMM(signed long Distance){
+    //amount in 0.01 mm units
+    //poll MotionIsComplete for the end of the move
+    MotionMoveBy(MotionDistanceToSteps(Distance));
 }
 
@@ -0,0 +1,27 @@
+/*
+ * File: Globals.c
+ * Author: Roger Berry
+ * Comments: The global variables main.c defines for the firmware, main.c
+ *           itself is not built on the host
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Comms.h"
+
+volatile unsigned int GLOBAL_TimerEventCounter = 0;
+volatile unsigned int GLOBAL_TimerEventFlag = 0;
+volatile unsigned int GLOBAL_MasterTimeOutCounter = 0;
+volatile unsigned int GLOBAL_MasterTimeOutFlag = 0;
+volatile unsigned char GLOBAL_ResultString[RESULT_STRING_LENGTH];
+volatile unsigned char GLOBAL_RxString[RX_STRING_LENGTH];
+volatile unsigned int GLOBAL_StepperMotorSpeed;
+volatile unsigned int GLOBAL_DirectionStatus;
+volatile unsigned int GLOBAL_PWM1_PulseTime;
+volatile unsigned int GLOBAL_PWM2_PulseTime;
+volatile unsigned int GLOBAL_PWM3_PulseTime;
+volatile unsigned int GLOBAL_PWM4_PulseTime;
+volatile signed long GLOBAL_Floor1Position = 0;
+volatile signed long GLOBAL_Floor2Position = 0;
+volatile signed long GLOBAL_Floor3Position = 0;
+volatile signed long GLOBAL_MaxPosition = 0;
@@ -0,0 +1,266 @@
+/*
+ * File: Host.c
+ * Author: Roger Berry
+ * Comments: Models of the UART, MSSP, Timer1, Timer3 and the 1 ms tick
+ *           for the host unit tests
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include "Init.h"
+#include "Comms.h"
+#include "SoftTimer.h"
+#include "Timer.h"
+#include "SPI.h"
+#include "Motion.h"
+#include "Host.h"
+
+//define variables used in this file
+static unsigned char ReceivedChar;
+static char Transmitted[HOST_TX_LENGTH + 1];
+static unsigned int TransmittedCount = 0;
+static unsigned char SPI_Buffer;
+static unsigned char SPI_Loaded = 0;            //set between a byte being loaded and read back
+static HOST_SPI_BYTE SPI_Bytes[HOST_SPI_LENGTH];
+static unsigned int SPI_ByteCount = 0;
+static unsigned char (*SPI_Reply)(unsigned char, unsigned char) = NULL;
+static unsigned char InStepInterrupt = 0;       //set while the step interrupt runs
+static unsigned long StepSPIBytes = 0;          //bytes exchanged from inside the step interrupt
+
+
+
+//***************************************************************
+//Reading RCREG clears the receive flag as the receiver FIFO empties
+
+unsigned char   HostReadRCREG(void)
+{
+    PIR1bits.RCIF = 0;
+    return ReceivedChar;
+}
+
+
+
+//***************************************************************
+//Timer1 model, time moves on 1 us each time the low byte is read
+
+unsigned char   HostReadTMR1L(void)
+{
+    TMR1++;
+    return (unsigned char)TMR1;
+}
+
+
+
+//***************************************************************
+//Pass each character of the string to the receive interrupt
+
+void    HostReceive(const char *String)
+{
+    while(*String != 0)
+    {
+        ReceivedChar = (unsigned char)*String;
+        PIR1bits.RCIF = 1;
+        HIGH_ISR();
+        String++;
+    }
+}
+
+
+
+//***************************************************************
+//Run the transmit interrupt until the transmit buffer is empty
+//returns the number of characters sent, they are kept for HostTransmitted
+
+unsigned int    HostTransmit(void)
+{
+    return HostTransmitSome(0xFFFFFFFFU);
+}
+
+//send no more than Limit characters, as a slow line would
+unsigned int    HostTransmitSome(unsigned int Limit)
+{
+    unsigned int Count = 0;
+
+    while(PIE1bits.TXIE != 0 && Count < Limit)
+    {
+        PIR1bits.TXIF = 1;
+        HIGH_ISR();
+        //the interrupt turns itself off instead of loading TXREG when empty
+        if(PIE1bits.TXIE == 0)
+        {
+            break;
+        }
+        if(TransmittedCount < HOST_TX_LENGTH)
+        {
+            Transmitted[TransmittedCount] = (char)TXREG;
+            TransmittedCount++;
+            Transmitted[TransmittedCount] = 0;
+        }
+        Count++;
+    }
+    PIR1bits.TXIF = 0;
+    return Count;
+}
+
+const char  *HostTransmitted(void)
+{
+    return Transmitted;
+}
+
+void    HostClearTransmitted(void)
+{
+    TransmittedCount = 0;
+    Transmitted[0] = 0;
+}
+
+
+
+//***************************************************************
+//Run the tick interrupt and the software timers for the passed ms
+
+void    HostTick(unsigned int Time)
+{
+    unsigned int Sample;
+
+    while(Time != 0)
+    {
+        for(Sample = 0; Sample < TICK_SAMPLES; Sample++)
+        {
+            SoftTimerInterrupt();
+        }
+        SoftTimerService();
+        Time--;
+    }
+}
+
+
+
+//***************************************************************
+//MSSP model, every byte loaded into SSP1BUF is exchanged at once
+//SPI.c loads a byte and reads the reply in turn, so the accesses
+//alternate. A load sets the interrupt flag, a read returns the reply.
+//Timer1 is moved on by the time the 8 clocks take, FOSC / (4 * (SSP1ADD + 1))
+//is one clock every (SSP1ADD + 1) / 8 us at 32 MHz, so SSP1ADD + 1 us a byte
+
+static unsigned char    SelectedDevice(void)
+{
+    if(SPI_ENABLE_WRITE != 0)
+    {
+        return SPI_DEVICE_DRV8711;
+    }
+    if(GPIO_8_WRITE == 0)
+    {
+        return SPI_DEVICE_LED;
+    }
+    return SPI_NO_DEVICE;
+}
+
+unsigned char   *HostSSP1BUF(void)
+{
+    HOST_SPI_BYTE *Byte;
+    unsigned char Device;
+
+    if(SPI_Loaded == 0)
+    {
+        //the byte about to be written goes out at once
+        SPI_Loaded = 1;
+        TMR1 = (unsigned short)(TMR1 + SSP1ADD + 1);
+        PIR1bits.SSP1IF = 1;
+        return &SPI_Buffer;
+    }
+
+    //the byte written last time is read back as the reply
+    SPI_Loaded = 0;
+    Device = SelectedDevice();
+    if(InStepInterrupt != 0)
+    {
+        StepSPIBytes++;
+    }
+    if(SPI_ByteCount < HOST_SPI_LENGTH)
+    {
+        Byte = &SPI_Bytes[SPI_ByteCount];
+        Byte->Sent = SPI_Buffer;
+        Byte->Device = Device;
+        SPI_ByteCount++;
+    }
+    if(SPI_Reply != NULL)
+    {
+        SPI_Buffer = SPI_Reply(Device, SPI_Buffer);
+    }
+    else
+    {
+        SPI_Buffer = 0;
+    }
+    if(SPI_ByteCount <= HOST_SPI_LENGTH)
+    {
+        SPI_Bytes[SPI_ByteCount - 1].Received = SPI_Buffer;
+    }
+    return &SPI_Buffer;
+}
+
+//the reply function is passed the selected device and the byte sent,
+//NULL replies with 0
+void    HostSPIReply(unsigned char (*Reply)(unsigned char, unsigned char))
+{
+    SPI_Reply = Reply;
+}
+
+unsigned int    HostSPICount(void)
+{
+    return SPI_ByteCount;
+}
+
+const HOST_SPI_BYTE *HostSPIByte(unsigned int Index)
+{
+    return &SPI_Bytes[Index];
+}
+
+void    HostClearSPI(void)
+{
+    SPI_ByteCount = 0;
+}
+
+
+
+//bytes exchanged while the step interrupt was running, the interrupt
+//must only queue its transfers
+unsigned long   HostStepSPIBytes(void)
+{
+    return StepSPIBytes;
+}
+
+
+
+//***************************************************************
+//Timer3 model, run the step interrupt as the timer overflows, then the
+//SPI transfers it queued as HIGH_ISR would before the next step
+//returns the us until the next interrupt, 0 once the timer is stopped
+
+unsigned int    HostStepInterrupt(void)
+{
+    return HostStepInterruptLate(0);
+}
+
+//run the step interrupt the passed us after the timer overflowed, the
+//timer has counted on by then, returns the us from entering the
+//interrupt to the next overflow
+unsigned int    HostStepInterruptLate(unsigned int Late)
+{
+    if(TIMER_3_ENABLE == 0)
+    {
+        return 0;
+    }
+    TIMER_3_TIME = (unsigned short)Late;
+    TIMER_3_INTERRUPT_FLAG = 1;
+    InStepInterrupt = 1;
+    MotionStepInterrupt();
+    InStepInterrupt = 0;
+    while(SPI_INTERRUPT_ENABLE != 0 && SPI_INTERRUPT_FLAG != 0)
+    {
+        SPI_InterruptService();
+    }
+    if(TIMER_3_ENABLE == 0)
+    {
+        return 0;
+    }
+    return (unsigned int)(0x10000UL - TIMER_3_TIME);
+}
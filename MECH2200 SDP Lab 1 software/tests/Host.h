@@ -0,0 +1,43 @@
+/*
+ * File: Host.h
+ * Author: Roger Berry
+ * Comments: Models of the UART, MSSP, Timer1, Timer3 and the 1 ms tick
+ *           for the host unit tests.
+ *           Characters go in and out through HIGH_ISR as on the PIC.
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef HOST_H
+#define	HOST_H
+
+#define HOST_TX_LENGTH              4096    //characters kept by HostTransmit
+#define HOST_SPI_LENGTH             256     //bytes kept by the MSSP model
+
+//one byte exchanged by the MSSP model
+typedef struct
+{
+    unsigned char Sent;
+    unsigned char Received;
+    unsigned char Device;                   //SPI_DEVICE_DRV8711 or SPI_DEVICE_LED selected, SPI_NO_DEVICE if neither
+} HOST_SPI_BYTE;
+
+//declare functions
+void    HostReceive(const char *);
+unsigned int    HostTransmit(void);
+unsigned int    HostTransmitSome(unsigned int);
+const char  *HostTransmitted(void);
+void    HostClearTransmitted(void);
+void    HostTick(unsigned int);
+void    HostSPIReply(unsigned char (*)(unsigned char, unsigned char));
+unsigned int    HostSPICount(void);
+const HOST_SPI_BYTE *HostSPIByte(unsigned int);
+void    HostClearSPI(void);
+unsigned long   HostStepSPIBytes(void);
+unsigned int    HostStepInterrupt(void);
+unsigned int    HostStepInterruptLate(unsigned int);
+
+
+
+#endif	/* HOST_H */
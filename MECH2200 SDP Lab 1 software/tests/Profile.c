@@ -0,0 +1,159 @@
+/*
+ * File: Profile.c
+ * Author: Roger Berry
+ * Comments: Host tool that prints the profile of one move as CSV for
+ *           plotting, not a test.
+ *           The move is run through the Timer3 model with no interrupt
+ *           latency and each step is printed with its time, the position,
+ *           the speed from the interval before it and the acceleration
+ *           from the speeds PROFILE_SPAN steps either side. The speed of
+ *           an S curve is held through each segment, the span smooths
+ *           the steps between segments out of the acceleration.
+ *           build/Profile [s|t] [steps] [cruise us] [acceleration] [deceleration]
+ *           s is an S curve, t a trapezoid, the defaults are below and the
+ *           deceleration defaults to the acceleration.
+ *           build/Profile s > profile.csv then plot any column against
+ *           time_us, for example with a spreadsheet or gnuplot.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Init.h"
+#include "SPI.h"
+#include "Timer.h"
+#include "Motion.h"
+#include "Host.h"
+
+#define PROFILE_STEPS               10000   //most steps printed
+#define PROFILE_SPAN                8       //steps either side for the acceleration
+#define PROFILE_MOVE_STEPS          4000    //default move
+#define PROFILE_INTERVAL            250     //default cruise interval in us
+#define PROFILE_ACCELERATION        20000   //default steps/s/s
+
+//globals normally in main.c
+extern volatile unsigned int GLOBAL_StepperMotorSpeed;
+
+static unsigned long StepTimes[PROFILE_STEPS];  //us from the first step
+
+
+
+//***************************************************************
+//Run the present move and keep the time of every step in us from the
+//first, returns the number of steps kept
+
+static unsigned long    RunMove(void)
+{
+    unsigned long Time;
+    unsigned long Count = 0;
+    unsigned int Next;
+    signed long Position;
+
+    Position = MotionGetPosition();
+    Time = 0x10000UL - TIMER_3_TIME;
+    while(TIMER_3_ENABLE != 0 && Count < PROFILE_STEPS)
+    {
+        Next = HostStepInterrupt();
+        if(MotionGetPosition() != Position)
+        {
+            Position = MotionGetPosition();
+            StepTimes[Count] = Time;
+            Count++;
+        }
+        if(Next == 0)
+        {
+            break;
+        }
+        Time = Time + Next;
+    }
+    for(Next = 1; Next < Count; Next++)
+    {
+        StepTimes[Next] = StepTimes[Next] - StepTimes[0];
+    }
+    StepTimes[0] = 0;
+    return Count;
+}
+
+//speed in steps/s over the interval before the passed step, 0 at the first
+static double   StepSpeed(unsigned long Step)
+{
+    if(Step == 0)
+    {
+        return 0;
+    }
+    return (double)MOTION_TIMER_FREQUENCY / (StepTimes[Step] - StepTimes[Step - 1]);
+}
+
+//time in us of the middle of the interval before the passed step
+static double   StepMiddle(unsigned long Step)
+{
+    if(Step == 0)
+    {
+        return 0;
+    }
+    return (StepTimes[Step] + StepTimes[Step - 1]) / 2.0;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+    unsigned int Shape = MOTION_SHAPE_SCURVE;
+    unsigned long Steps = PROFILE_MOVE_STEPS;
+    unsigned int Acceleration = PROFILE_ACCELERATION;
+    unsigned int Deceleration;
+    unsigned long Count;
+    unsigned long Step;
+    unsigned long Before;
+    unsigned long After;
+    double Slope;
+
+    GLOBAL_StepperMotorSpeed = PROFILE_INTERVAL;
+    if(argc > 1 && argv[1][0] == 't')
+    {
+        Shape = MOTION_SHAPE_TRAPEZOID;
+    }
+    if(argc > 2)
+    {
+        Steps = strtoul(argv[2], NULL, 10);
+    }
+    if(argc > 3)
+    {
+        GLOBAL_StepperMotorSpeed = (unsigned int)strtoul(argv[3], NULL, 10);
+    }
+    if(argc > 4)
+    {
+        Acceleration = (unsigned int)strtoul(argv[4], NULL, 10);
+    }
+    Deceleration = Acceleration;
+    if(argc > 5)
+    {
+        Deceleration = (unsigned int)strtoul(argv[5], NULL, 10);
+    }
+
+    INTCONbits.GIE = 0;
+    InitialiseSPI();
+    InitialiseDRV8711();
+    InitialiseMotion();
+    MotionSetShape(Shape);
+    MotionSetModeSwitch(0);
+    MotionSetHardwareCruise(0);
+    MotionSetProfile(Acceleration, Deceleration);
+    MotionSetPosition(0);
+    MotionMoveBy((signed long)Steps);
+    Count = RunMove();
+
+    printf("step,time_us,position,velocity_steps_s,acceleration_steps_s2\n");
+    for(Step = 0; Step < Count; Step++)
+    {
+        Before = Step > PROFILE_SPAN ? Step - PROFILE_SPAN : 1;
+        After = Step + PROFILE_SPAN < Count ? Step + PROFILE_SPAN : Count - 1;
+        Slope = 0;
+        if(After > Before)
+        {
+            Slope = (StepSpeed(After) - StepSpeed(Before)) * MOTION_TIMER_FREQUENCY / (StepMiddle(After) - StepMiddle(Before));
+        }
+        printf("%lu,%lu,%lu,%.1f,%.0f\n", Step, StepTimes[Step], Step + 1, StepSpeed(Step), Slope);
+    }
+    return 0;
+}
@@ -0,0 +1,10 @@
+/*
+ * File: Registers.c
+ * Author: Roger Berry
+ * Comments: Storage for the special function registers declared in the
+ *           host xc.h. Tests set and read them directly.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#define SFR_STORAGE
+#include <xc.h>
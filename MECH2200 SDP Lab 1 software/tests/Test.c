@@ -0,0 +1,49 @@
+/*
+ * File: Test.c
+ * Author: Roger Berry
+ * Comments: Checks for the host unit tests
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include "Test.h"
+
+//define variables used in this file
+static unsigned long Checks = 0;
+static unsigned long Failures = 0;
+
+
+
+//***************************************************************
+//Count a check and report it if it failed
+
+void    TestCheck(int Passed, const char *Condition, const char *File, int Line)
+{
+    Checks++;
+    if(Passed == 0)
+    {
+        Failures++;
+        printf("%s:%d: check failed: %s\n", File, Line, Condition);
+    }
+}
+
+void    TestCheckEqual(long Expected, long Actual, const char *Name, const char *File, int Line)
+{
+    Checks++;
+    if(Expected != Actual)
+    {
+        Failures++;
+        printf("%s:%d: %s is %ld, expected %ld\n", File, Line, Name, Actual, Expected);
+    }
+}
+
+
+
+//***************************************************************
+//Print the result, returns the exit status for main
+
+int     TestSummary(const char *Name)
+{
+    printf("%s: %lu checks, %lu failed\n", Name, Checks, Failures);
+    return Failures == 0 ? 0 : 1;
+}
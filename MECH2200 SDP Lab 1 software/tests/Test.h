@@ -0,0 +1,28 @@
+/*
+ * File: Test.h
+ * Author: Roger Berry
+ * Comments: Checks for the host unit tests. A failed check prints the
+ *           file, line and condition and the test carries on, the
+ *           summary sets the exit status for make.
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef TEST_H
+#define	TEST_H
+
+//check a condition, the test goes on if it fails
+#define CHECK(Condition)    TestCheck((Condition) != 0, #Condition, __FILE__, __LINE__)
+
+//check two integer values are equal, both are shown if they are not
+#define CHECK_EQUAL(Expected, Actual)   TestCheckEqual((long)(Expected), (long)(Actual), #Actual, __FILE__, __LINE__)
+
+//declare functions
+void    TestCheck(int, const char *, const char *, int);
+void    TestCheckEqual(long, long, const char *, const char *, int);
+int     TestSummary(const char *);
+
+
+
+#endif	/* TEST_H */
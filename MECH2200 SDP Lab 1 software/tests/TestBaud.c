@@ -0,0 +1,121 @@
+/*
+ * File: TestBaud.c
+ * Author: Roger Berry
+ * Comments: Baud rate generator divisors and errors at each rate offered
+ *           by the main menu, and the baud rate change handshake
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include "Test.h"
+#include "Init.h"
+#include "Comms.h"
+#include "SoftTimer.h"
+#include "Host.h"
+
+//rate, divisor for FOSC / (4 * (SPBRG + 1)) with FOSC 32 MHz and the
+//error in 0.01% units, the actual rate is truncated to whole baud first
+typedef struct
+{
+    unsigned long Rate;
+    unsigned int Divisor;
+    signed int Error;
+} BAUD_CASE;
+
+static const BAUD_CASE BaudCases[] =
+{
+    {9600, 832, 3},         //9603 baud
+    {19200, 416, -8},       //19184 baud
+    {57600, 138, -8},       //57553 baud
+    {115200, 68, 64},       //115942 baud
+    {250000, 31, 0},        //exact
+    {500000, 15, 0}         //exact
+};
+
+
+
+//***************************************************************
+//Each rate gives the divisor and error worked out by hand from the
+//datasheet formula and is inside the error limit
+
+static void    TestDivisors(void)
+{
+    unsigned int Index;
+
+    for(Index = 0; Index < sizeof(BaudCases) / sizeof(BaudCases[0]); Index++)
+    {
+        printf("%7lu baud: divisor %u, error %d\n", BaudCases[Index].Rate,
+               GetBaudDivisor(BaudCases[Index].Rate), GetBaudError(BaudCases[Index].Rate));
+        CHECK_EQUAL(BaudCases[Index].Divisor, GetBaudDivisor(BaudCases[Index].Rate));
+        CHECK_EQUAL(BaudCases[Index].Error, GetBaudError(BaudCases[Index].Rate));
+        CHECK(SetBaudRate(BaudCases[Index].Rate) == STRING_OK);
+        CHECK_EQUAL(BaudCases[Index].Divisor, (SPBRGH << 8) | SPBRGL);
+    }
+    SetBaudRate(DEFAULT_BAUD_RATE);
+}
+
+//***************************************************************
+//The rate only changes once the last character has gone, and is kept
+//when the confirm character arrives or restored after the confirm time
+
+static unsigned int    Divisor(void)
+{
+    return (SPBRGH << 8) | SPBRGL;
+}
+
+static void    TestHandshake(void)
+{
+    unsigned int Time;
+
+    InitialiseComms();
+    InitialiseSoftTimers();
+    TX_BUFFER_STATUS = 1;
+
+    CHECK(ChangeBaudRate(3000000) == BAUD_RATE_INVALID);
+    CHECK(BaudChangeService() == STRING_OK);
+
+    //confirmed change
+    QueueChar('x');
+    CHECK(ChangeBaudRate(115200) == STRING_OK);
+    CHECK(BaudChangeService() == LINE_PENDING);
+    CHECK_EQUAL(832, Divisor());
+    HostTransmit();
+    TX_BUFFER_STATUS = 0;
+    CHECK(BaudChangeService() == LINE_PENDING);
+    CHECK_EQUAL(832, Divisor());
+    TX_BUFFER_STATUS = 1;
+    CHECK(BaudChangeService() == LINE_PENDING);
+    CHECK_EQUAL(68, Divisor());
+    HostTick(1000);
+    HostReceive("a");
+    CHECK(BaudChangeService() == LINE_PENDING);
+    HostReceive("Y");
+    CHECK(BaudChangeService() == STRING_OK);
+    CHECK_EQUAL(115200, GetBaudRate());
+    CHECK(SoftTimerRunning(SOFT_TIMER_BAUD_CONFIRM) == 0);
+
+    //no confirmation, the previous rate comes back after the confirm time
+    CHECK(ChangeBaudRate(9600) == STRING_OK);
+    CHECK(BaudChangeService() == LINE_PENDING);
+    CHECK_EQUAL(832, Divisor());
+    for(Time = 1; Time < BAUD_CONFIRM_TIME; Time++)
+    {
+        HostTick(1);
+        if(BaudChangeService() != LINE_PENDING)
+        {
+            break;
+        }
+    }
+    CHECK_EQUAL(BAUD_CONFIRM_TIME, Time);
+    HostTick(1);
+    CHECK(BaudChangeService() == BAUD_RATE_NOT_CONFIRMED);
+    CHECK_EQUAL(115200, GetBaudRate());
+    CHECK_EQUAL(68, Divisor());
+}
+
+int main(void)
+{
+    TestDivisors();
+    TestHandshake();
+    return TestSummary("TestBaud");
+}
@@ -0,0 +1,241 @@
+/*
+ * File: TestComms.c
+ * Author: Roger Berry
+ * Comments: The interrupt driven transmit and receive buffers.
+ *           The queue functions must return at once whatever the state of
+ *           the UART, queue a string whole or not at all, and keep the
+ *           order of the characters as the indexes wrap round.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Test.h"
+#include "Init.h"
+#include "Comms.h"
+#include "Host.h"
+
+#define RANDOM_STEPS                5000    //random queue and send operations
+
+//a string that fills the transmit buffer exactly
+const unsigned char FullLine[] = "0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF";
+const unsigned char ShortLine[] = "abcde";
+
+//define variables used in this file
+static unsigned long RandomSeed = 1;
+static char Expected[HOST_TX_LENGTH + 1];
+static unsigned int ExpectedCount;
+
+
+
+//***************************************************************
+//Repeatable pseudo random number from 0 to Range - 1
+
+static unsigned long    Random(unsigned long Range)
+{
+    RandomSeed = RandomSeed * 1103515245UL + 12345UL;
+    return ((RandomSeed >> 8) & 0xFFFFFFUL) % Range;
+}
+
+static void    Reset(void)
+{
+    InitialiseComms();
+    HostTransmit();
+    HostClearTransmitted();
+    ClearCommsCounters();
+    while(GetChar() != 0xFFFF)
+    {
+    }
+}
+
+
+
+//***************************************************************
+//A full buffer is reported instead of waited on, the UART is never
+//written by the queue functions, only by the interrupt
+
+static void    TestQueue(void)
+{
+    volatile unsigned char String[8];
+
+    Reset();
+    //the transmitter never becomes ready, a wait would hang here
+    TX_BUFFER_STATUS = 0;
+    TXREG = 0;
+
+    CHECK_EQUAL(TX_BUFFER_SIZE, GetTxSpace());
+    CHECK_EQUAL(TX_QUEUE_OK, QueueMessage(FullLine));
+    CHECK_EQUAL(0, GetTxSpace());
+    CHECK_EQUAL(TX_BUFFER_SIZE, GetTxHighWaterMark());
+    CHECK_EQUAL(1, PIE1bits.TXIE);
+    CHECK_EQUAL(0, TXREG);
+    CHECK_EQUAL(TX_QUEUE_FULL, QueueChar('x'));
+    CHECK_EQUAL(TX_QUEUE_FULL, QueueMessage(ShortLine));
+    strcpy((char *)String, "xyz");
+    CHECK_EQUAL(TX_QUEUE_FULL, QueueString(String));
+    String[0] = 0;
+    CHECK_EQUAL(TX_QUEUE_OK, QueueString(String));
+    CHECK_EQUAL(0, GetTxWaitCount());
+
+    //the interrupt sends everything queued then turns itself off
+    CHECK_EQUAL(TX_BUFFER_SIZE, HostTransmit());
+    CHECK(strcmp(HostTransmitted(), (const char *)FullLine) == 0);
+    CHECK_EQUAL(0, PIE1bits.TXIE);
+    CHECK_EQUAL(TX_BUFFER_SIZE, GetTxSpace());
+
+    //a string that does not fit leaves the buffer as it was
+    HostClearTransmitted();
+    QueueMessage(FullLine);
+    HostTransmitSome(4);
+    CHECK_EQUAL(TX_QUEUE_FULL, QueueMessage(ShortLine));
+    CHECK_EQUAL(4, GetTxSpace());
+    strcpy((char *)String, "wxyz");
+    CHECK_EQUAL(TX_QUEUE_OK, QueueString(String));
+    CHECK_EQUAL(0, GetTxSpace());
+    HostTransmit();
+    CHECK(strncmp(HostTransmitted(), (const char *)FullLine, TX_BUFFER_SIZE) == 0);
+    CHECK(strcmp(HostTransmitted() + TX_BUFFER_SIZE, "wxyz") == 0);
+}
+
+
+
+//***************************************************************
+//Random strings queued and random numbers of characters sent, the
+//indexes wrap many times and every character must come out in order
+
+static void    TestOrder(void)
+{
+    unsigned long Step;
+    unsigned int Length;
+    unsigned int Index;
+    unsigned int Status;
+    unsigned int Space;
+    unsigned int Rejected = 0;
+    unsigned int Errors = 0;
+    unsigned int Total = 0;
+    volatile unsigned char String[TX_BUFFER_SIZE + 1];
+
+    Reset();
+    for(Step = 0; Step < RANDOM_STEPS; Step++)
+    {
+        HostClearTransmitted();
+        Length = (unsigned int)Random(TX_BUFFER_SIZE + 1);
+        for(Index = 0; Index < Length; Index++)
+        {
+            String[Index] = (unsigned char)('!' + Random(90));
+        }
+        String[Length] = 0;
+        Space = GetTxSpace();
+        Status = QueueString(String);
+        if((Length <= Space) != (Status == TX_QUEUE_OK))
+        {
+            Errors++;
+        }
+        if(Status != TX_QUEUE_OK)
+        {
+            Rejected++;
+        }
+        else
+        {
+            Total = Total + Length;
+        }
+        //the line sends some of what is waiting before the next string
+        HostTransmitSome((unsigned int)Random(TX_BUFFER_SIZE));
+    }
+    printf("%u characters queued, %u strings did not fit\n", Total, Rejected);
+    CHECK(Total > 256 * 4);
+    CHECK(Rejected > 0);
+    CHECK_EQUAL(0, Errors);
+    CHECK(GetTxHighWaterMark() <= TX_BUFFER_SIZE);
+
+    //check the order with characters that count up
+    Reset();
+    ExpectedCount = 0;
+    //stop before the host copy of the characters sent is full
+    while(ExpectedCount + 20 < HOST_TX_LENGTH)
+    {
+        Length = 1 + (unsigned int)Random(20);
+        for(Index = 0; Index < Length; Index++)
+        {
+            String[Index] = (unsigned char)('A' + (ExpectedCount + Index) % 26);
+        }
+        String[Length] = 0;
+        if(QueueString(String) == TX_QUEUE_OK)
+        {
+            memcpy(&Expected[ExpectedCount], (const char *)String, Length);
+            ExpectedCount = ExpectedCount + Length;
+        }
+        HostTransmitSome((unsigned int)Random(24));
+    }
+    HostTransmit();
+    Expected[ExpectedCount] = 0;
+    printf("%u characters checked in order\n", ExpectedCount);
+    CHECK(ExpectedCount > 256 * 4);
+    CHECK(strcmp(HostTransmitted(), Expected) == 0);
+}
+
+
+
+//***************************************************************
+//Received characters are kept in order, those that do not fit and
+//those with framing errors are counted, an overrun restarts the receiver
+
+static void    TestReceive(void)
+{
+    unsigned int Index;
+    char Text[RX_BUFFER_SIZE + 9];
+
+    Reset();
+    CHECK_EQUAL(0xFFFF, GetChar());
+    HostReceive("abc");
+    CHECK_EQUAL('a', GetChar());
+    CHECK_EQUAL('b', GetChar());
+    CHECK_EQUAL('c', GetChar());
+    CHECK_EQUAL(0xFFFF, GetChar());
+
+    //8 more than the buffer holds
+    for(Index = 0; Index < RX_BUFFER_SIZE + 8; Index++)
+    {
+        Text[Index] = (char)('a' + Index % 26);
+    }
+    Text[Index] = 0;
+    HostReceive(Text);
+    CHECK_EQUAL(8, GetRxDroppedCount());
+    for(Index = 0; Index < RX_BUFFER_SIZE; Index++)
+    {
+        if(GetChar() != (unsigned int)Text[Index])
+        {
+            break;
+        }
+    }
+    CHECK_EQUAL(RX_BUFFER_SIZE, Index);
+    CHECK_EQUAL(0xFFFF, GetChar());
+
+    //a character with a framing error is thrown away
+    RCSTAbits.FERR = 1;
+    HostReceive("x");
+    RCSTAbits.FERR = 0;
+    CHECK_EQUAL(1, GetRxFrameErrorCount());
+    CHECK_EQUAL(0xFFFF, GetChar());
+
+    RCSTAbits.OERR = 1;
+    HostReceive("y");
+    RCSTAbits.OERR = 0;
+    CHECK_EQUAL(1, GetRxOverrunCount());
+    CHECK_EQUAL(1, RC1STAbits.CREN);
+    CHECK_EQUAL('y', GetChar());
+
+    ClearCommsCounters();
+    CHECK_EQUAL(0, GetRxDroppedCount());
+    CHECK_EQUAL(0, GetRxFrameErrorCount());
+    CHECK_EQUAL(0, GetRxOverrunCount());
+    CHECK_EQUAL(0, GetTxHighWaterMark());
+}
+
+int main(void)
+{
+    TestQueue();
+    TestOrder();
+    TestReceive();
+    return TestSummary("TestComms");
+}
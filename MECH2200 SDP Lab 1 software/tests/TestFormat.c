@@ -0,0 +1,370 @@
+/*
+ * File: TestFormat.c
+ * Author: Roger Berry
+ * Comments: The division free formatting routines against printf, every
+ *           16 bit value with every padding, and a benchmark against the
+ *           divide and modulo DecimalToResultString they replaced.
+ *           Host times say little about the PIC, so the benchmark also
+ *           counts loop passes, the shift and subtract passes of the XC8
+ *           16 bit divide library against the subtract and count passes.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Test.h"
+#include "Init.h"
+#include "Comms.h"
+#include "Format.h"
+
+#define RANDOM_VALUES               2000000 //random 32 bit values checked
+#define BENCHMARK_REPEATS           50      //passes over every 16 bit value
+
+//define variables used in this file
+static unsigned long RandomSeed = 1;
+static unsigned long LibraryPasses;         //shift and subtract passes in the divide library
+static unsigned long Mismatches;
+static char Text[32];
+static volatile unsigned char Result[32];
+
+
+
+//***************************************************************
+//Repeatable pseudo random 32 bit number
+
+static unsigned long    Random32(void)
+{
+    RandomSeed = RandomSeed * 1103515245UL + 12345UL;
+    return ((RandomSeed >> 8) & 0xFFFFUL) | (((RandomSeed >> 40) & 0xFFFFUL) << 16);
+}
+
+//count a mismatch and show the first few
+static void    Compare(unsigned int Length, const char *Name, long Value, unsigned int Digits)
+{
+    if(strcmp((const char *)Result, Text) != 0 || Length != strlen(Text))
+    {
+        if(Mismatches < 10)
+        {
+            printf("%s(%ld, %u) gave \"%s\" length %u, expected \"%s\"\n", Name, Value, Digits, (const char *)Result, Length, Text);
+        }
+        Mismatches++;
+    }
+}
+
+
+
+//***************************************************************
+//The 16 bit divide as the XC8 library does it, the divisor is shifted
+//up to the top bit then shifted back one place a pass, subtracting when
+//it fits. Every pass is counted.
+
+static unsigned int    LibraryDivide(unsigned int Dividend, unsigned int Divisor, unsigned int *Remainder)
+{
+    unsigned int Quotient = 0;
+    unsigned int Count = 1;
+
+    while((Divisor & 0x8000) == 0)
+    {
+        Divisor = Divisor << 1;
+        Count++;
+        LibraryPasses++;
+    }
+    while(Count != 0)
+    {
+        Quotient = Quotient << 1;
+        if(Dividend >= Divisor)
+        {
+            Dividend = Dividend - Divisor;
+            Quotient = Quotient | 1;
+        }
+        Divisor = Divisor >> 1;
+        Count--;
+        LibraryPasses++;
+    }
+    *Remainder = Dividend;
+    return Quotient;
+}
+
+static unsigned int    LibraryDiv(unsigned int Dividend, unsigned int Divisor)
+{
+    unsigned int Remainder;
+
+    return LibraryDivide(Dividend, Divisor, &Remainder);
+}
+
+static unsigned int    LibraryMod(unsigned int Dividend, unsigned int Divisor)
+{
+    unsigned int Remainder;
+
+    LibraryDivide(Dividend, Divisor, &Remainder);
+    return Remainder;
+}
+
+
+
+//***************************************************************
+//DecimalToResultString as it was before the formatting routines, with
+//its divides and modulos done by the library model
+
+static void    OldDecimalToResultString(unsigned int Value, volatile unsigned char *ResultString, unsigned int Length)
+{
+    unsigned int Status = 0;
+
+    *ResultString = (unsigned char)NULL;
+    if(Value >= 10000 || Length == 5)
+    {
+        *ResultString = (unsigned char)(LibraryDiv(Value, 10000) + ASCII_NUMBER_OFFSET);
+        Value = LibraryMod(Value, 10000);
+        Status = 1;
+        ResultString++;
+    }
+    if(Status == 1 || Value >= 1000 || Length == 4)
+    {
+        *ResultString = (unsigned char)(LibraryDiv(Value, 1000) + ASCII_NUMBER_OFFSET);
+        Value = LibraryMod(Value, 1000);
+        Status = 1;
+        ResultString++;
+    }
+    if(Status == 1 || Value >= 100 || Length == 3)
+    {
+        *ResultString = (unsigned char)(LibraryDiv(Value, 100) + ASCII_NUMBER_OFFSET);
+        Value = LibraryMod(Value, 100);
+        Status = 1;
+        ResultString++;
+    }
+    if(Status == 1 || Value >= 10 || Length == 2)
+    {
+        *ResultString = (unsigned char)(LibraryDiv(Value, 10) + ASCII_NUMBER_OFFSET);
+        Value = LibraryMod(Value, 10);
+        Status = 1;
+        ResultString++;
+    }
+    *ResultString = (unsigned char)(Value + ASCII_NUMBER_OFFSET);
+    ResultString++;
+    *ResultString = (unsigned char)NULL;
+}
+
+//subtract and count passes FormatUnsigned16 makes, one compare for each
+//subtraction and one more that ends each of the four digit loops
+static unsigned long    SubtractPasses(unsigned int Value)
+{
+    unsigned long Passes = 4;
+
+    while(Value != 0)
+    {
+        Passes = Passes + Value % 10;
+        Value = Value / 10;
+    }
+    return Passes;
+}
+
+
+
+//***************************************************************
+//Every 8 and 16 bit value with every padding matches printf, the length
+//returned is the string length
+
+static void    TestExhaustive16(void)
+{
+    unsigned long Value;
+    signed long Signed;
+    unsigned int Digits;
+    unsigned long Magnitude;
+
+    Mismatches = 0;
+    for(Value = 0; Value <= 0xFFFF; Value++)
+    {
+        for(Digits = 0; Digits <= 7; Digits++)
+        {
+            sprintf(Text, "%0*lu", (int)Digits, Value);
+            Compare(FormatUnsigned16((unsigned int)Value, Digits, Result), "FormatUnsigned16", (long)Value, Digits);
+            if(Value <= 0xFF)
+            {
+                Compare(FormatUnsigned8((unsigned char)Value, Digits, Result), "FormatUnsigned8", (long)Value, Digits);
+            }
+
+            //the sign is not counted as a digit
+            Signed = (signed long)Value - 0x8000;
+            Magnitude = Signed < 0 ? (unsigned long)-Signed : (unsigned long)Signed;
+            sprintf(Text, "%s%0*lu", Signed < 0 ? "-" : "", (int)Digits, Magnitude);
+            Compare(FormatSigned16((signed int)Signed, Digits, Result), "FormatSigned16", Signed, Digits);
+            if(Signed >= -128 && Signed <= 127)
+            {
+                Compare(FormatSigned8((signed char)Signed, Digits, Result), "FormatSigned8", Signed, Digits);
+            }
+        }
+        for(Digits = 0; Digits <= 9; Digits++)
+        {
+            sprintf(Text, "%0*lX", (int)(Digits > 8 ? 8 : Digits), Value);
+            Compare(FormatHex(Value, Digits, Result), "FormatHex", (long)Value, Digits);
+        }
+        for(Digits = 0; Digits <= 5; Digits++)
+        {
+            //the old call keeps its output
+            OldDecimalToResultString((unsigned int)Value, (volatile unsigned char *)Text, Digits);
+            DecimalToResultString((unsigned int)Value, Result, Digits);
+            Compare((unsigned int)strlen(Text), "DecimalToResultString", (long)Value, Digits);
+        }
+    }
+    CHECK_EQUAL(0, Mismatches);
+}
+
+
+
+//***************************************************************
+//Fixed point with every 16 bit signed value and 0 to 5 decimals
+
+static void    TestFixed(void)
+{
+    signed long Value;
+    unsigned long Magnitude;
+    unsigned long Scale;
+    unsigned int Decimals;
+    unsigned int Index;
+
+    Mismatches = 0;
+    for(Value = -0x8000; Value <= 0x7FFF; Value++)
+    {
+        Magnitude = Value < 0 ? (unsigned long)-Value : (unsigned long)Value;
+        Scale = 1;
+        for(Decimals = 0; Decimals <= 5; Decimals++)
+        {
+            if(Decimals == 0)
+            {
+                sprintf(Text, "%ld", Value);
+            }
+            else
+            {
+                sprintf(Text, "%s%lu.%0*lu", Value < 0 ? "-" : "", Magnitude / Scale, (int)Decimals, Magnitude % Scale);
+            }
+            Compare(FormatFixed(Value, Decimals, Result), "FormatFixed", Value, Decimals);
+            Scale = Scale * 10;
+        }
+    }
+    CHECK_EQUAL(0, Mismatches);
+
+    //more decimals than fit in 32 bits are limited
+    CHECK_EQUAL(11, FormatFixed(1, 12, Result));
+    CHECK(strcmp((const char *)Result, "0.000000001") == 0);
+    Index = FormatFixed(-2147483647L - 1, 9, Result);
+    CHECK(strcmp((const char *)Result, "-2.147483648") == 0);
+    CHECK_EQUAL(12, Index);
+}
+
+
+
+//***************************************************************
+//32 bit values, the edges of each digit count and random values
+
+static void    Check32(unsigned long Value)
+{
+    signed long Signed;
+    unsigned int Digits;
+
+    for(Digits = 0; Digits <= 12; Digits += 3)
+    {
+        sprintf(Text, "%0*lu", (int)Digits, Value);
+        Compare(FormatUnsigned32(Value, Digits, Result), "FormatUnsigned32", (long)Value, Digits);
+    }
+    //the same bits as a 32 bit signed value
+    Signed = (signed long)(signed int)Value;
+    sprintf(Text, "%s%0*lu", Signed < 0 ? "-" : "", 3, Signed < 0 ? (unsigned long)-Signed : (unsigned long)Signed);
+    Compare(FormatSigned32(Signed, 3, Result), "FormatSigned32", Signed, 3);
+    sprintf(Text, "%08lX", Value);
+    Compare(FormatHex(Value, 8, Result), "FormatHex", (long)Value, 8);
+}
+
+static void    Test32(void)
+{
+    unsigned long Power;
+    unsigned long Step;
+
+    Mismatches = 0;
+    Check32(0);
+    Check32(0xFFFFFFFFUL);
+    Check32(0x7FFFFFFFUL);
+    Check32(0x80000000UL);
+    Check32(0x10000UL);
+    for(Power = 1; Power <= 1000000000UL; Power = Power * 10)
+    {
+        Check32(Power - 1);
+        Check32(Power);
+        Check32(Power + 1);
+    }
+    for(Step = 0; Step < RANDOM_VALUES; Step++)
+    {
+        Check32(Random32());
+        //smaller values as often as large ones
+        Check32(Random32() >> (Step % 32));
+    }
+    CHECK_EQUAL(0, Mismatches);
+}
+
+
+
+//***************************************************************
+//Loop passes and host time for every 16 bit value, old against new
+
+static void    Benchmark(void)
+{
+    unsigned long Value;
+    unsigned long Passes = 0;
+    unsigned long OldWorst = 0;
+    unsigned long NewWorst = 0;
+    unsigned long Before;
+    unsigned int Repeat;
+    clock_t Start;
+    double OldTime;
+    double NewTime;
+
+    LibraryPasses = 0;
+    for(Value = 0; Value <= 0xFFFF; Value++)
+    {
+        Before = LibraryPasses;
+        OldDecimalToResultString((unsigned int)Value, Result, 1);
+        if(LibraryPasses - Before > OldWorst)
+        {
+            OldWorst = LibraryPasses - Before;
+        }
+        Passes = Passes + SubtractPasses((unsigned int)Value);
+        if(SubtractPasses((unsigned int)Value) > NewWorst)
+        {
+            NewWorst = SubtractPasses((unsigned int)Value);
+        }
+    }
+    printf("loop passes per 16 bit value, divide library %.1f (worst %lu), subtract and count %.1f (worst %lu)\n",
+           LibraryPasses / 65536.0, OldWorst, Passes / 65536.0, NewWorst);
+    CHECK(Passes * 4 < LibraryPasses);
+    CHECK(NewWorst < OldWorst);
+
+    Start = clock();
+    for(Repeat = 0; Repeat < BENCHMARK_REPEATS; Repeat++)
+    {
+        for(Value = 0; Value <= 0xFFFF; Value++)
+        {
+            OldDecimalToResultString((unsigned int)Value, Result, 1);
+        }
+    }
+    OldTime = (double)(clock() - Start) / CLOCKS_PER_SEC;
+    Start = clock();
+    for(Repeat = 0; Repeat < BENCHMARK_REPEATS; Repeat++)
+    {
+        for(Value = 0; Value <= 0xFFFF; Value++)
+        {
+            FormatUnsigned16((unsigned int)Value, 1, Result);
+        }
+    }
+    NewTime = (double)(clock() - Start) / CLOCKS_PER_SEC;
+    printf("host time per value, divide library model %.1f ns, subtract and count %.1f ns\n",
+           OldTime * 1e9 / (BENCHMARK_REPEATS * 65536.0), NewTime * 1e9 / (BENCHMARK_REPEATS * 65536.0));
+}
+
+int main(void)
+{
+    TestExhaustive16();
+    TestFixed();
+    Test32();
+    Benchmark();
+    return TestSummary("TestFormat");
+}
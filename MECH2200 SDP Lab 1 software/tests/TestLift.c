@@ -0,0 +1,836 @@
+/*
+ * File: TestLift.c
+ * Author: Roger Berry
+ * Comments: The LOOK pick order of the floor calls and its service time
+ *           against first come first served.
+ *           The lift runs against simulated ms with the step interrupt,
+ *           the door servo steps and the software timers as on the PIC,
+ *           homing is not simulated. Random passenger traces are replayed
+ *           through Lift.c and through a first come first served lift made
+ *           from the same motion and door calls. The first come first
+ *           served lift lets everyone at a floor on or off when it stops
+ *           there, it only differs in not stopping on the way.
+ *           The car is checked to be held by the drive while it is parked
+ *           unless a time is set to disable the drive, and to stop on the
+ *           spot at an endstop outside homing. Manual moves to the ends of
+ *           the travel are checked to stop short of the switches, and to
+ *           be refused unless the lift is at rest with its doors shut.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include "Test.h"
+#include "Init.h"
+#include "SPI.h"
+#include "Timer.h"
+#include "PWM.h"
+#include "Motion.h"
+#include "MotionQueue.h"
+#include "Home.h"
+#include "Door.h"
+#include "SoftTimer.h"
+#include "Lift.h"
+#include "Host.h"
+
+#define FLOOR_SPACING               8000    //steps between floors
+#define CRUISE_DELAY                250     //step interval in us, 4000 steps/s
+#define PASSENGERS                  150     //passengers in each trace
+#define TRACE_LIMIT                 600000UL    //ms after the last arrival a trace must be finished in
+#define LOAD_COUNT                  3
+#define MAX_STOPS                   16      //door openings kept by the pick order tests
+#define SWITCH_SPREAD               2       //steps short of its homed edge a switch may close
+
+//passenger states
+#define PASSENGER_COMING            0       //not arrived yet
+#define PASSENGER_WAITING           1       //hall call made
+#define PASSENGER_RIDING            2       //car call made
+#define PASSENGER_DELIVERED         3
+
+//define external global variables
+extern volatile unsigned int GLOBAL_StepperMotorSpeed;
+extern volatile signed long GLOBAL_Floor1Position;
+extern volatile signed long GLOBAL_Floor2Position;
+extern volatile signed long GLOBAL_Floor3Position;
+extern volatile signed long GLOBAL_MaxPosition;
+extern volatile unsigned char HomeRunState;
+extern unsigned int CruiseBlockStart;
+
+//one passenger of a trace
+typedef struct
+{
+    unsigned long Arrival;                  //ms
+    unsigned char From;
+    unsigned char To;
+    unsigned char State;
+    unsigned long Boarded;                  //ms the doors opened for them at From
+    unsigned long Delivered;                //ms the doors opened at To
+} PASSENGER;
+
+//define variables used in this file
+static const unsigned long MeanGaps[LOAD_COUNT] = {40000, 15000, 6000};   //ms between arrivals
+static unsigned long RandomSeed = 1;
+static unsigned long Now;                   //simulated time in ms
+static unsigned long NextStep;              //us of the next step interrupt, 0 when Timer3 is off
+static PASSENGER Passengers[PASSENGERS];
+static unsigned char Stops[MAX_STOPS];      //floors the doors opened at
+static unsigned int StopCount;
+static unsigned int LastLiftState;
+static unsigned char SwitchesModelled;      //set to close the endstops from the position
+
+//first come first served lift
+static unsigned char FifoCalls[2 * PASSENGERS];     //floors in the order they were called
+static unsigned int FifoCount;
+static unsigned int FifoState;
+static unsigned char FifoFloor;
+static unsigned long FifoDwellEnd;
+
+
+
+//***************************************************************
+//Repeatable pseudo random number from 0 to Range - 1
+
+static unsigned long    Random(unsigned long Range)
+{
+    RandomSeed = RandomSeed * 1103515245UL + 12345UL;
+    return ((RandomSeed >> 8) & 0xFFFFFFUL) % Range;
+}
+
+
+
+//***************************************************************
+//Close each endstop while the car is at or past its edge, 0 and
+//GLOBAL_MaxPosition, less the steps a switch edge may vary by. The
+//closing edge interrupts as on the PIC
+
+static void    ModelSwitches(void)
+{
+    if(MotionGetPosition() <= SWITCH_SPREAD)
+    {
+        if(ENDSTOP_BOTTOM_READ != ENDSTOP_CLOSED)
+        {
+            ENDSTOP_BOTTOM_READ = ENDSTOP_CLOSED;
+            ENDSTOP_BOTTOM_FLAG = 1;
+            EndstopInterrupt();
+        }
+    }
+    else
+    {
+        ENDSTOP_BOTTOM_READ = !ENDSTOP_CLOSED;
+    }
+    if(MotionGetPosition() >= GLOBAL_MaxPosition - SWITCH_SPREAD)
+    {
+        if(ENDSTOP_TOP_READ != ENDSTOP_CLOSED)
+        {
+            ENDSTOP_TOP_READ = ENDSTOP_CLOSED;
+            ENDSTOP_TOP_FLAG = 1;
+            EndstopInterrupt();
+        }
+    }
+    else
+    {
+        ENDSTOP_TOP_READ = !ENDSTOP_CLOSED;
+    }
+}
+
+
+
+//***************************************************************
+//Run the hardware for one ms, the step interrupts due, the SPI
+//transfers queued, the door servo every PWM5 period and the tick
+
+static void    RunMillisecond(void)
+{
+    unsigned long End;
+    unsigned int Interval;
+
+    End = (Now + 1) * 1000UL;
+    if(NextStep == 0 && TIMER_3_ENABLE != 0)
+    {
+        NextStep = Now * 1000UL + (0x10000UL - TIMER_3_TIME);
+    }
+    while(NextStep != 0 && NextStep <= End)
+    {
+        Interval = HostStepInterrupt();
+        NextStep = Interval != 0 ? NextStep + Interval : 0;
+        if(SwitchesModelled != 0)
+        {
+            ModelSwitches();
+        }
+    }
+    while(SPI_INTERRUPT_ENABLE != 0 && SPI_INTERRUPT_FLAG != 0)
+    {
+        SPI_InterruptService();
+    }
+    Now++;
+    if(Now % DOOR_PERIOD == 0)
+    {
+        DoorInterrupt();
+    }
+    HostTick(1);
+}
+
+//the lift at rest at the bottom floor with the doors shut
+static void    Reset(void)
+{
+    INTCONbits.GIE = 0;
+    InitialiseSPI();
+    InitialiseDRV8711();
+    InitialiseMotion();
+    InitialiseSoftTimers();
+    InitialiseDoor();
+    GLOBAL_StepperMotorSpeed = CRUISE_DELAY;
+    GLOBAL_Floor1Position = 0;
+    GLOBAL_Floor2Position = FLOOR_SPACING;
+    GLOBAL_Floor3Position = 2 * FLOOR_SPACING;
+    MotionSetPosition(0);
+    //the floor positions are taken as known, as after homing
+    HomeRunState = HOME_DONE;
+    InitialiseLift();
+    Now = 0;
+    NextStep = 0;
+    StopCount = 0;
+    SwitchesModelled = 0;
+    LastLiftState = LiftState();
+}
+
+//run Lift.c and the motor current for the passed ms as the main loop
+//does, keeping the floors the doors open at
+static void    RunLift(unsigned long Time)
+{
+    unsigned long End;
+
+    End = Now + Time;
+    while(Now < End)
+    {
+        LiftService();
+        MotionTorqueService();
+        if(LiftState() == LIFT_DOOR_OPEN && LastLiftState != LIFT_DOOR_OPEN && StopCount < MAX_STOPS)
+        {
+            Stops[StopCount] = (unsigned char)LiftGetFloor();
+            StopCount++;
+        }
+        LastLiftState = LiftState();
+        RunMillisecond();
+    }
+}
+
+
+
+//***************************************************************
+//The pick order, the lift stops on the way for calls in its own
+//direction and leaves calls the other way for the way back
+
+static void    TestPickOrder(void)
+{
+    const LIFT_STATISTICS *Statistics;
+
+    //invalid calls
+    Reset();
+    CHECK_EQUAL(LIFT_INVALID_CALL, LiftCall(LIFT_FLOORS, LIFT_CALL_CAR));
+    CHECK_EQUAL(LIFT_INVALID_CALL, LiftCall(0, LIFT_CALL_DOWN));
+    CHECK_EQUAL(LIFT_INVALID_CALL, LiftCall(LIFT_FLOORS - 1, LIFT_CALL_UP));
+    CHECK_EQUAL(LIFT_INVALID_CALL, LiftCall(0, LIFT_CALL_TYPES));
+
+    //the first move from rest goes to the nearest floor
+    RunLift(100);
+    CHECK_EQUAL(LIFT_IDLE, LiftState());
+    CHECK_EQUAL(0, LiftGetFloor());
+
+    //going up to 2, the up call at 1 is picked up on the way
+    CHECK_EQUAL(LIFT_OK, LiftCall(2, LIFT_CALL_CAR));
+    CHECK_EQUAL(LIFT_OK, LiftCall(1, LIFT_CALL_UP));
+    RunLift(500);
+    CHECK_EQUAL(LIFT_DIRECTION_UP, LiftGetDirection());
+    RunLift(60000);
+    CHECK_EQUAL(2, StopCount);
+    CHECK_EQUAL(1, Stops[0]);
+    CHECK_EQUAL(2, Stops[1]);
+    CHECK_EQUAL(0, LiftCallPending(1, LIFT_CALL_UP));
+    CHECK_EQUAL(0, LiftCallPending(2, LIFT_CALL_CAR));
+    CHECK_EQUAL(2 * FLOOR_SPACING, MotionGetPosition());
+    CHECK_EQUAL(LIFT_IDLE, LiftState());
+    CHECK(DoorIsClosed());
+
+    //going down to 0, the down call at 1 is taken on the way, the up
+    //call at 1 is left for the way back
+    StopCount = 0;
+    LiftCall(0, LIFT_CALL_CAR);
+    LiftCall(1, LIFT_CALL_UP);
+    LiftCall(1, LIFT_CALL_DOWN);
+    RunLift(60000);
+    CHECK_EQUAL(3, StopCount);
+    CHECK_EQUAL(1, Stops[0]);
+    CHECK_EQUAL(0, Stops[1]);
+    CHECK_EQUAL(1, Stops[2]);
+    CHECK_EQUAL(0, LiftCallPending(1, LIFT_CALL_UP));
+
+    //a call for a floor the lift has already left for is served on the
+    //way back, the stop is chosen as the lift leaves
+    StopCount = 0;
+    LiftCall(0, LIFT_CALL_CAR);
+    RunLift(60000);
+    StopCount = 0;
+    LiftCall(2, LIFT_CALL_CAR);
+    RunLift(500);
+    CHECK(MotionBusy());
+    LiftCall(1, LIFT_CALL_UP);
+    RunLift(60000);
+    CHECK_EQUAL(2, StopCount);
+    CHECK_EQUAL(2, Stops[0]);
+    CHECK_EQUAL(1, Stops[1]);
+
+    //from rest the lift heads for the oldest call
+    StopCount = 0;
+    LiftCall(2, LIFT_CALL_DOWN);
+    RunMillisecond();
+    LiftCall(0, LIFT_CALL_UP);
+    RunLift(60000);
+    CHECK_EQUAL(2, StopCount);
+    CHECK_EQUAL(2, Stops[0]);
+    CHECK_EQUAL(0, Stops[1]);
+
+    Statistics = LiftGetStatistics();
+    CHECK_EQUAL(6, Statistics->WaitCount);
+    CHECK_EQUAL(4, Statistics->TravelCount);
+    CHECK(Statistics->WaitMax >= Statistics->WaitLast);
+    CHECK(Statistics->WaitTotal >= Statistics->WaitMax);
+
+    //nothing moves until homing is done
+    Reset();
+    HomeRunState = HOME_IDLE;
+    LiftCall(2, LIFT_CALL_CAR);
+    RunLift(5000);
+    CHECK_EQUAL(LIFT_WAIT_HOME, LiftState());
+    CHECK_EQUAL(0, MotionGetPosition());
+    HomeRunState = HOME_DONE;
+    RunLift(60000);
+    CHECK_EQUAL(2 * FLOOR_SPACING, MotionGetPosition());
+}
+
+
+
+//***************************************************************
+//A parked car is held at the hold current however long it waits, the
+//drive is never disabled under it unless a time is set for that
+
+static void    TestParked(void)
+{
+    Reset();
+    MotorOn();
+    LiftCall(1, LIFT_CALL_CAR);
+    RunLift(60000);
+    CHECK_EQUAL(LIFT_IDLE, LiftState());
+    CHECK_EQUAL(FLOOR_SPACING, MotionGetPosition());
+
+    //ten minutes parked, well past the 16 bit Timer1 and tick counts
+    RunLift(600000);
+    CHECK(GetDRV8711Shadow(DRV_CTRL_REG) & ENABLE_DRIVE);
+    CHECK_EQUAL(MOTION_TORQUE_HOLD, GetDRV8711Shadow(DRV_TORQUE_REG) & TORQUE_MASK);
+    CHECK_EQUAL(FLOOR_SPACING, MotionGetPosition());
+
+    //and moves off again at the full current
+    LiftCall(0, LIFT_CALL_CAR);
+    RunLift(500);
+    CHECK(MotionBusy());
+    CHECK_EQUAL(MOTION_TORQUE_ACCEL, GetDRV8711Shadow(DRV_TORQUE_REG) & TORQUE_MASK);
+    RunLift(60000);
+    CHECK_EQUAL(0, MotionGetPosition());
+
+    //a time set to disable the drive at rest, for a load that cannot fall
+    MotionSetIdleTimeout(30000);
+    RunLift(29000);
+    CHECK(GetDRV8711Shadow(DRV_CTRL_REG) & ENABLE_DRIVE);
+    RunLift(2000);
+    CHECK_EQUAL(0, GetDRV8711Shadow(DRV_CTRL_REG) & ENABLE_DRIVE);
+    LiftCall(1, LIFT_CALL_CAR);
+    RunLift(500);
+    CHECK(GetDRV8711Shadow(DRV_CTRL_REG) & ENABLE_DRIVE);
+    RunLift(60000);
+    CHECK_EQUAL(FLOOR_SPACING, MotionGetPosition());
+    MotionSetIdleTimeout(MOTION_MAX_IDLE_TIMEOUT + 1);
+    CHECK_EQUAL(MOTION_MAX_IDLE_TIMEOUT, MotionGetIdleTimeout());
+    MotionSetIdleTimeout(0);
+}
+
+
+
+//***************************************************************
+//An endstop closing during a move outside homing stops the motor on the
+//step it is at and the lift waits to be homed again. Homing itself
+//still slows down past the switch.
+
+static void    HitTopSwitch(void)
+{
+    ENDSTOP_TOP_FLAG = 1;
+    EndstopInterrupt();
+}
+
+static void    TestLimit(void)
+{
+    signed long Position;
+    unsigned int Time;
+
+    //a lift move, a switch the other way is ignored
+    Reset();
+    LiftCall(2, LIFT_CALL_CAR);
+    RunLift(2000);
+    CHECK(MotionBusy());
+    ENDSTOP_BOTTOM_FLAG = 1;
+    EndstopInterrupt();
+    CHECK(MotionBusy());
+    Position = MotionGetPosition();
+    HitTopSwitch();
+    CHECK_EQUAL(0, TIMER_3_ENABLE);
+    CHECK_EQUAL(0, MotionBusy());
+    CHECK_EQUAL(Position, MotionGetPosition());
+    CHECK_EQUAL(HOME_FAILED, HomeState());
+    CHECK_EQUAL(HOME_LIMIT, HomeResult());
+    RunLift(5000);
+    CHECK_EQUAL(Position, MotionGetPosition());
+    CHECK_EQUAL(LIFT_WAIT_HOME, LiftState());
+    CHECK_EQUAL(MOTION_HALTED, MotionMoveBy(-100));
+    CHECK_EQUAL(MOTION_HALTED, MotionQueueAdd(0, CRUISE_DELAY, MAX_ACCELERATION));
+
+    //homing clears the halt and ramps down at the switch it is looking for
+    ENDSTOP_BOTTOM_READ = !ENDSTOP_CLOSED;
+    ENDSTOP_TOP_READ = !ENDSTOP_CLOSED;
+    CHECK_EQUAL(MOTION_OK, HomeStart());
+    CHECK_EQUAL(0, MotionIsHalted());
+    RunLift(500);
+    CHECK(MotionBusy());
+    ENDSTOP_BOTTOM_FLAG = 1;
+    EndstopInterrupt();
+    CHECK(MotionBusy());
+    CHECK_EQUAL(HOME_SEEK_FAST, HomeState());
+    HomeAbort();
+    RunLift(2000);
+    HomeService();
+    CHECK_EQUAL(HOME_ABORTED, HomeResult());
+
+    //queued moves, the blocks and moves left are dropped
+    Reset();
+    InitialiseMotionQueue();
+    MotionQueueAdd(FLOOR_SPACING, CRUISE_DELAY, MAX_ACCELERATION);
+    MotionQueueAdd(2 * FLOOR_SPACING, CRUISE_DELAY, MAX_ACCELERATION);
+    for(Time = 0; Time < 500; Time++)
+    {
+        MotionQueueService();
+        RunMillisecond();
+    }
+    CHECK(MotionBlocksActive());
+    Position = MotionGetPosition();
+    HitTopSwitch();
+    CHECK_EQUAL(0, MotionBlocksActive());
+    for(Time = 0; Time < 500; Time++)
+    {
+        MotionQueueService();
+        RunMillisecond();
+    }
+    CHECK_EQUAL(0, MotionQueueCount());
+    CHECK_EQUAL(0, TIMER_3_ENABLE);
+    CHECK_EQUAL(Position, MotionGetPosition());
+
+    //cruise steps made by PWM11, the pulses counted so far are kept
+    Reset();
+    MotionSetHardwareCruise(1);
+    LiftCall(2, LIFT_CALL_CAR);
+    for(Time = 0; Time < 20000 && (TIMER_3_ENABLE != 0 || MotionBusy() == 0); Time++)
+    {
+        LiftService();
+        RunMillisecond();
+    }
+    CHECK(PWM11CONbits.EN);
+    TMR5H = (unsigned char)(CruiseBlockStart >> 8);
+    TMR5L = (unsigned char)CruiseBlockStart;
+    Position = MotionGetPosition();
+    TMR5H = (unsigned char)((CruiseBlockStart + 100) >> 8);
+    TMR5L = (unsigned char)(CruiseBlockStart + 100);
+    HitTopSwitch();
+    CHECK_EQUAL(0, PWM11CONbits.EN);
+    CHECK_EQUAL(0, TIMER_5_ENABLE);
+    CHECK_EQUAL(0, MotionBusy());
+    CHECK_EQUAL(Position + 100, MotionGetPosition());
+    MotionSetHardwareCruise(0);
+}
+
+
+
+//***************************************************************
+//Manual moves to each end of the travel stop HOME_LIMIT_MARGIN short of
+//the switch edge and the lift stays homed, a move to the edge itself
+//closes the switch and halts the lift
+
+static void    TestAdjustLimit(void)
+{
+    Reset();
+    GLOBAL_MaxPosition = 3 * FLOOR_SPACING;
+    RunLift(100);
+    SwitchesModelled = 1;
+    CHECK_EQUAL(0, HomeInTravel(0));
+    CHECK_EQUAL(0, HomeInTravel(HOME_LIMIT_MARGIN - 1));
+    CHECK_EQUAL(1, HomeInTravel(HOME_LIMIT_MARGIN));
+    CHECK_EQUAL(1, HomeInTravel(GLOBAL_MaxPosition - HOME_LIMIT_MARGIN));
+    CHECK_EQUAL(0, HomeInTravel(GLOBAL_MaxPosition));
+
+    //adjust down and up by more than the travel
+    CHECK_EQUAL(LIFT_OK, LiftManualMove(HomeLimitPosition(MotionGetPosition() - 100000L)));
+    RunLift(60000);
+    CHECK_EQUAL(HOME_LIMIT_MARGIN, MotionGetPosition());
+    CHECK(HomeIsDone());
+    CHECK_EQUAL(LIFT_OK, LiftManualMove(HomeLimitPosition(MotionGetPosition() + 100000L)));
+    RunLift(60000);
+    CHECK_EQUAL(GLOBAL_MaxPosition - HOME_LIMIT_MARGIN, MotionGetPosition());
+    CHECK(HomeIsDone());
+    CHECK_EQUAL(LIFT_MANUAL, LiftState());
+
+    //the old limit, the switch edge
+    LiftManualMove(GLOBAL_MaxPosition);
+    RunLift(60000);
+    CHECK_EQUAL(HOME_FAILED, HomeState());
+    CHECK_EQUAL(HOME_LIMIT, HomeResult());
+    CHECK_EQUAL(GLOBAL_MaxPosition - SWITCH_SPREAD, MotionGetPosition());
+
+    GLOBAL_MaxPosition = 0;
+    SwitchesModelled = 0;
+}
+
+
+
+//***************************************************************
+//Calibration moves are only made at rest with the doors shut, the car
+//is held where it is put and the next call is served from a floor
+
+static void    TestManualMove(void)
+{
+    unsigned int Time;
+
+    Reset();
+    RunLift(100);
+    CHECK_EQUAL(LIFT_OK, LiftManualMove(FLOOR_SPACING / 4));
+    CHECK_EQUAL(LIFT_MANUAL, LiftState());
+    CHECK_EQUAL(LIFT_NO_FLOOR, LiftGetFloor());
+    RunLift(60000);
+    CHECK_EQUAL(FLOOR_SPACING / 4, MotionGetPosition());
+    CHECK_EQUAL(LIFT_MANUAL, LiftState());
+    CHECK(DoorIsClosed());
+
+    //a call for the floor it was last at goes back to the floor first
+    LiftCall(0, LIFT_CALL_CAR);
+    RunLift(60000);
+    CHECK_EQUAL(1, StopCount);
+    CHECK_EQUAL(0, Stops[0]);
+    CHECK_EQUAL(0, MotionGetPosition());
+    CHECK_EQUAL(LIFT_IDLE, LiftState());
+
+    //refused while moving and while the doors are open
+    LiftCall(1, LIFT_CALL_CAR);
+    RunLift(500);
+    CHECK_EQUAL(LIFT_MOVING, LiftState());
+    CHECK_EQUAL(LIFT_BUSY, LiftManualMove(0));
+    for(Time = 0; Time < 60000 && LiftState() != LIFT_DOOR_OPEN; Time++)
+    {
+        RunLift(1);
+    }
+    CHECK_EQUAL(LIFT_DOOR_OPEN, LiftState());
+    CHECK_EQUAL(LIFT_BUSY, LiftManualMove(0));
+    CHECK_EQUAL(0, MotionBusy());
+    RunLift(60000);
+    CHECK_EQUAL(FLOOR_SPACING, MotionGetPosition());
+    CHECK_EQUAL(LIFT_OK, LiftManualMove(FLOOR_SPACING + 100));
+}
+
+
+
+//***************************************************************
+//Make a random trace, passengers arrive at random times and go from
+//one floor to another
+
+static void    MakeTrace(unsigned long MeanGap, unsigned long Seed)
+{
+    unsigned int Index;
+    unsigned long Time;
+
+    RandomSeed = Seed;
+    Time = 1000;
+    for(Index = 0; Index < PASSENGERS; Index++)
+    {
+        Time = Time + Random(2 * MeanGap);
+        Passengers[Index].Arrival = Time;
+        Passengers[Index].From = (unsigned char)Random(LIFT_FLOORS);
+        Passengers[Index].To = (unsigned char)((Passengers[Index].From + 1 + Random(LIFT_FLOORS - 1)) % LIFT_FLOORS);
+        Passengers[Index].State = PASSENGER_COMING;
+    }
+}
+
+static unsigned int    HallCall(const PASSENGER *Passenger)
+{
+    return Passenger->To > Passenger->From ? LIFT_CALL_UP : LIFT_CALL_DOWN;
+}
+
+//mean ms from arrival to the doors opening at the floor asked for,
+//and from arrival to boarding
+static void    TraceTimes(unsigned long *Service, unsigned long *Wait)
+{
+    unsigned int Index;
+    unsigned long ServiceTotal = 0;
+    unsigned long WaitTotal = 0;
+
+    for(Index = 0; Index < PASSENGERS; Index++)
+    {
+        ServiceTotal = ServiceTotal + (Passengers[Index].Delivered - Passengers[Index].Arrival);
+        WaitTotal = WaitTotal + (Passengers[Index].Boarded - Passengers[Index].Arrival);
+    }
+    *Service = ServiceTotal / PASSENGERS;
+    *Wait = WaitTotal / PASSENGERS;
+}
+
+static unsigned int    AllDelivered(void)
+{
+    unsigned int Index;
+
+    for(Index = 0; Index < PASSENGERS; Index++)
+    {
+        if(Passengers[Index].State != PASSENGER_DELIVERED)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+//***************************************************************
+//Replay the trace through Lift.c, a hall call served lets its
+//passengers on and they make their car calls, a car call served lets
+//its passengers off
+
+static unsigned int    ReplayLook(void)
+{
+    unsigned int Index;
+    PASSENGER *Passenger;
+
+    Reset();
+    while(AllDelivered() == 0 && Now < Passengers[PASSENGERS - 1].Arrival + TRACE_LIMIT)
+    {
+        for(Index = 0; Index < PASSENGERS; Index++)
+        {
+            Passenger = &Passengers[Index];
+            if(Passenger->State == PASSENGER_COMING && Passenger->Arrival <= Now)
+            {
+                LiftCall(Passenger->From, HallCall(Passenger));
+                Passenger->State = PASSENGER_WAITING;
+            }
+            if(Passenger->State == PASSENGER_WAITING && LiftCallPending(Passenger->From, HallCall(Passenger)) == 0)
+            {
+                Passenger->Boarded = Now;
+                LiftCall(Passenger->To, LIFT_CALL_CAR);
+                Passenger->State = PASSENGER_RIDING;
+            }
+            if(Passenger->State == PASSENGER_RIDING && LiftCallPending(Passenger->To, LIFT_CALL_CAR) == 0)
+            {
+                Passenger->Delivered = Now;
+                Passenger->State = PASSENGER_DELIVERED;
+            }
+        }
+        LiftService();
+        RunMillisecond();
+    }
+    return AllDelivered();
+}
+
+
+
+//***************************************************************
+//First come first served, the lift goes to the floors in the order they
+//were called. On arriving everyone waiting gets on and everyone riding
+//to that floor gets off, and later calls for the floor are dropped.
+
+#define FIFO_IDLE                   0
+#define FIFO_CLOSING                1
+#define FIFO_MOVING                 2
+#define FIFO_OPENING                3
+#define FIFO_DWELL                  4
+
+static void    FifoAdd(unsigned char Floor)
+{
+    FifoCalls[FifoCount] = Floor;
+    FifoCount++;
+}
+
+//let passengers on and off at the floor and drop its calls
+static void    FifoArrive(unsigned char Floor)
+{
+    unsigned int Index;
+    unsigned int Kept;
+    PASSENGER *Passenger;
+
+    for(Index = 0; Index < PASSENGERS; Index++)
+    {
+        Passenger = &Passengers[Index];
+        if(Passenger->State == PASSENGER_RIDING && Passenger->To == Floor)
+        {
+            Passenger->Delivered = Now;
+            Passenger->State = PASSENGER_DELIVERED;
+        }
+    }
+    for(Index = 0; Index < PASSENGERS; Index++)
+    {
+        Passenger = &Passengers[Index];
+        if(Passenger->State == PASSENGER_WAITING && Passenger->From == Floor)
+        {
+            Passenger->Boarded = Now;
+            Passenger->State = PASSENGER_RIDING;
+            FifoAdd(Passenger->To);
+        }
+    }
+    Kept = 0;
+    for(Index = 0; Index < FifoCount; Index++)
+    {
+        if(FifoCalls[Index] != Floor)
+        {
+            FifoCalls[Kept] = FifoCalls[Index];
+            Kept++;
+        }
+    }
+    FifoCount = Kept;
+    FifoFloor = Floor;
+    DoorOpen();
+    FifoState = FIFO_OPENING;
+}
+
+static void    FifoService(void)
+{
+    signed long Position;
+
+    switch(FifoState)
+    {
+        case FIFO_IDLE:
+            if(FifoCount == 0)
+            {
+                break;
+            }
+            if(FifoCalls[0] == FifoFloor)
+            {
+                FifoArrive(FifoFloor);
+                break;
+            }
+            DoorClose();
+            FifoState = FIFO_CLOSING;
+            break;
+
+        case FIFO_CLOSING:
+            if(DoorIsClosed() != 0)
+            {
+                Position = (signed long)FifoCalls[0] * FLOOR_SPACING;
+                if(MotionMoveTo(Position) == MOTION_OK)
+                {
+                    FifoState = FIFO_MOVING;
+                }
+            }
+            break;
+
+        case FIFO_MOVING:
+            if(MotionBusy() == 0)
+            {
+                FifoArrive(FifoCalls[0]);
+            }
+            break;
+
+        case FIFO_OPENING:
+            if(DoorIsOpen() != 0)
+            {
+                FifoDwellEnd = Now + DoorGetDwell();
+                FifoState = FIFO_DWELL;
+            }
+            break;
+
+        case FIFO_DWELL:
+            if(Now >= FifoDwellEnd)
+            {
+                FifoState = FIFO_IDLE;
+            }
+            break;
+    }
+}
+
+static unsigned int    ReplayFifo(void)
+{
+    unsigned int Index;
+    PASSENGER *Passenger;
+
+    Reset();
+    FifoCount = 0;
+    FifoState = FIFO_IDLE;
+    FifoFloor = 0;
+    while(AllDelivered() == 0 && Now < Passengers[PASSENGERS - 1].Arrival + TRACE_LIMIT)
+    {
+        for(Index = 0; Index < PASSENGERS; Index++)
+        {
+            Passenger = &Passengers[Index];
+            if(Passenger->State == PASSENGER_COMING && Passenger->Arrival <= Now)
+            {
+                FifoAdd(Passenger->From);
+                Passenger->State = PASSENGER_WAITING;
+            }
+        }
+        FifoService();
+        RunMillisecond();
+    }
+    return AllDelivered();
+}
+
+
+
+//***************************************************************
+//Service times of the same traces under LOOK and first come first
+//served at light, medium and heavy traffic
+
+static void    TestTraces(void)
+{
+    unsigned int Load;
+    unsigned long LookService;
+    unsigned long LookWait;
+    unsigned long FifoService;
+    unsigned long FifoWait;
+    const LIFT_STATISTICS *Statistics;
+
+    printf("mean gap    LOOK service   wait    FIFO service   wait  (ms)\n");
+    for(Load = 0; Load < LOAD_COUNT; Load++)
+    {
+        MakeTrace(MeanGaps[Load], Load + 1);
+        CHECK(ReplayLook());
+        TraceTimes(&LookService, &LookWait);
+
+        //a call is timed from the first passenger to make it, so the
+        //lift's longest wait is at least the passengers' mean
+        Statistics = LiftGetStatistics();
+        CHECK(Statistics->WaitCount > 0);
+        CHECK(Statistics->WaitCount <= PASSENGERS);
+        CHECK(Statistics->TravelCount <= PASSENGERS);
+        CHECK(Statistics->WaitMax >= LookWait);
+
+        MakeTrace(MeanGaps[Load], Load + 1);
+        CHECK(ReplayFifo());
+        TraceTimes(&FifoService, &FifoWait);
+
+        printf("%8lu  %14lu  %5lu  %14lu  %5lu\n", MeanGaps[Load], LookService, LookWait, FifoService, FifoWait);
+        //LOOK is never worse on average and better once calls overlap
+        CHECK(LookService <= FifoService);
+        if(Load == LOAD_COUNT - 1)
+        {
+            CHECK(LookService < FifoService);
+        }
+    }
+}
+
+int main(void)
+{
+    TestPickOrder();
+    TestParked();
+    TestLimit();
+    TestAdjustLimit();
+    TestManualMove();
+    TestTraces();
+    return TestSummary("TestLift");
+}
@@ -0,0 +1,297 @@
+/*
+ * File: TestMenu.c
+ * Author: Roger Berry
+ * Comments: The menus never wait for the transmit buffer. The transmit
+ *           interrupt is run a few characters at a time between services,
+ *           as a slow line would, and every status line, option, echo and
+ *           command line must arrive in order with no send waiting.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Test.h"
+#include "Init.h"
+#include "Comms.h"
+#include "Menu.h"
+#include "SoftTimer.h"
+#include "Host.h"
+
+#define SERVICE_PASSES              20000   //most services to reach a state
+#define LINE_DRAIN                  3       //characters sent between services
+
+//define external global variables
+extern unsigned int MenuState;
+
+//a 60 character line, near the most one menu step may send
+const unsigned char LongLine[] = "\r\n 0123456789012345678901234567890123456789012345678901234567";
+
+const unsigned char TestTitle[] = "\r\n\r\nTest menu";
+const unsigned char Option1[] = "\r\n 1: Long output";
+const unsigned char Option2[] = "\r\n 2: Enter a value";
+const unsigned char Option3[] = "\r\n 3: One line";
+const unsigned char ValuePrompt[] = "\r\n Enter value: ";
+const unsigned char OneLine[] = "\r\n One line done";
+const unsigned char CRLF[] = "\r\n";
+
+//define variables used in this file
+static unsigned int StatusCalls;
+static unsigned int LineCalls;
+static unsigned int ValueStatus;
+static char Value[RX_STRING_LENGTH + 1];
+static char Expected[HOST_TX_LENGTH + 1];
+
+void    LongOutput(void);
+void    EnterValue(void);
+void    SendOneLine(void);
+
+const MENU_COMMAND TestCommands[] =
+{
+    {1, Option1, LongOutput},
+    {2, Option2, EnterValue},
+    {3, Option3, SendOneLine}
+};
+
+
+
+//***************************************************************
+//Three status lines of 60 characters before the title
+
+static unsigned int    ShowTestStatus(unsigned int Line)
+{
+    StatusCalls++;
+    if(Line < 3)
+    {
+        SendMessage(LongLine);
+        return MENU_LINES_MORE;
+    }
+    SendMessage(CRLF);
+    return MENU_LINES_DONE;
+}
+
+const MENU TestMenu = {TestTitle, ShowTestStatus, TestCommands, MENU_COMMAND_COUNT(TestCommands), 1};
+
+
+
+//***************************************************************
+//Commands, ten long lines, a value and a single line
+
+static unsigned int    SendLongLines(unsigned int Line)
+{
+    LineCalls++;
+    SendMessage(LongLine);
+    if(Line < 9)
+    {
+        return MENU_LINES_MORE;
+    }
+    return MENU_LINES_DONE;
+}
+
+void    LongOutput(void)
+{
+    MenuRequestLines(SendLongLines);
+}
+
+static void    ValueEntered(unsigned int StringStatus, volatile unsigned char *String)
+{
+    unsigned int Index;
+
+    ValueStatus = StringStatus;
+    for(Index = 0; Index < RX_STRING_LENGTH && String[Index] != 0; Index++)
+    {
+        Value[Index] = (char)String[Index];
+    }
+    Value[Index] = 0;
+}
+
+void    EnterValue(void)
+{
+    MenuRequestValue(ValuePrompt, 5, LINE_INTEGER, ValueEntered);
+}
+
+void    SendOneLine(void)
+{
+    SendMessage(OneLine);
+}
+
+
+
+//***************************************************************
+//Service the menu with the line sending a few characters each pass
+//until the menu reaches the passed state
+
+static unsigned int    RunUntil(unsigned int State)
+{
+    unsigned int Pass;
+
+    for(Pass = 0; Pass < SERVICE_PASSES; Pass++)
+    {
+        MenuService();
+        if(MenuState == State)
+        {
+            return 1;
+        }
+        HostTransmitSome(LINE_DRAIN);
+    }
+    return 0;
+}
+
+//build the text the menu and its status lines are expected to send
+static void    ExpectMenu(void)
+{
+    unsigned int Line;
+
+    for(Line = 0; Line < 3; Line++)
+    {
+        strcat(Expected, (const char *)LongLine);
+    }
+    strcat(Expected, (const char *)CRLF);
+    strcat(Expected, (const char *)TestTitle);
+    strcat(Expected, (const char *)Option1);
+    strcat(Expected, (const char *)Option2);
+    strcat(Expected, (const char *)Option3);
+    strcat(Expected, "\r\nEnter option number: ");
+}
+
+static void    Reset(void)
+{
+    InitialiseComms();
+    InitialiseSoftTimers();
+    ClearCommsCounters();
+    HostTransmit();
+    HostClearTransmitted();
+    //a send that did wait would empty the buffer itself instead of hanging
+    TX_BUFFER_STATUS = 1;
+    StatusCalls = 0;
+    LineCalls = 0;
+    Expected[0] = 0;
+}
+
+
+
+//***************************************************************
+//The status and option list are sent a line at a time, over 200
+//characters through a 64 character buffer without a send waiting
+
+static void    TestShowMenu(void)
+{
+    Reset();
+    MenuSelect(&TestMenu);
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    HostTransmit();
+    ExpectMenu();
+    CHECK(strcmp(HostTransmitted(), Expected) == 0);
+    CHECK_EQUAL(4, StatusCalls);
+    CHECK_EQUAL(0, GetTxWaitCount());
+}
+
+
+
+//***************************************************************
+//A command's lines are sent one per pass, the menu comes back after
+//the last line
+
+static void    TestCommandLines(void)
+{
+    unsigned int Line;
+
+    Reset();
+    MenuSelect(&TestMenu);
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    HostReceive("1\r");
+    CHECK(RunUntil(MENU_SEND_LINES));
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    HostTransmit();
+
+    ExpectMenu();
+    strcat(Expected, "1");
+    for(Line = 0; Line < 10; Line++)
+    {
+        strcat(Expected, (const char *)LongLine);
+    }
+    ExpectMenu();
+    CHECK(strcmp(HostTransmitted(), Expected) == 0);
+    CHECK_EQUAL(10, LineCalls);
+    CHECK_EQUAL(0, GetTxWaitCount());
+}
+
+
+
+//***************************************************************
+//Characters typed while the buffer is full are left until their echo
+//fits, and the command only runs once there is room for its output
+
+static void    TestDeferredEcho(void)
+{
+    unsigned int Pass;
+
+    Reset();
+    MenuSelect(&TestMenu);
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    HostTransmit();
+    HostClearTransmitted();
+
+    //fill the buffer then type a command
+    SendMessage(LongLine);
+    HostReceive("3\r");
+    for(Pass = 0; Pass < 10; Pass++)
+    {
+        MenuService();
+    }
+    CHECK_EQUAL(MENU_WAIT_OPTION, MenuState);
+    CHECK(strstr(HostTransmitted(), "One line") == NULL);
+
+    //the echo goes once there is room, the command when the buffer is empty
+    HostTransmitSome(55);
+    MenuService();
+    CHECK_EQUAL(MENU_WAIT_OPTION, MenuState);
+    CHECK(RunUntil(MENU_SEND_STATUS));
+    HostTransmit();
+    strcat(Expected, (const char *)LongLine);
+    strcat(Expected, "3");
+    strcat(Expected, (const char *)OneLine);
+    CHECK(strcmp(HostTransmitted(), Expected) == 0);
+    CHECK_EQUAL(0, GetTxWaitCount());
+}
+
+
+
+//***************************************************************
+//A value request reads the line and passes it to the handler, an
+//unknown option is reported and the menu sent again
+
+static void    TestValue(void)
+{
+    Reset();
+    MenuSelect(&TestMenu);
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    HostReceive("2\r");
+    CHECK(RunUntil(MENU_WAIT_VALUE));
+    HostReceive("123\r");
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    CHECK_EQUAL(STRING_OK, ValueStatus);
+    CHECK(strcmp(Value, "123") == 0);
+
+    HostReceive("9\r");
+    CHECK(RunUntil(MENU_SEND_STATUS));
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    HostTransmit();
+    CHECK(strstr(HostTransmitted(), "9\r\n Value out of range") != NULL);
+    CHECK_EQUAL(0, GetTxWaitCount());
+
+    //the value time out returns to the menu
+    HostReceive("2\r");
+    CHECK(RunUntil(MENU_WAIT_VALUE));
+    HostTick(MENU_VALUE_TIMEOUT);
+    CHECK(RunUntil(MENU_WAIT_OPTION));
+    CHECK_EQUAL(TIME_OUT, ValueStatus);
+}
+
+int main(void)
+{
+    TestShowMenu();
+    TestCommandLines();
+    TestDeferredEcho();
+    TestValue();
+    return TestSummary("TestMenu");
+}
@@ -0,0 +1,335 @@
+/*
+ * File: TestMotionQueue.c
+ * Author: Roger Berry
+ * Comments: Stress test of the motion queue and the step block ring.
+ *           Random paths are queued while the main loop service and the
+ *           Timer3 step interrupt run against a simulated us clock, the
+ *           service at a random 1 to 20 ms. Every step is checked for the
+ *           acceleration limit and for reversals only at low speed, and a
+ *           stop is checked to run on no further than the block being
+ *           made and the distance to slow down.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "Test.h"
+#include "Init.h"
+#include "SPI.h"
+#include "Timer.h"
+#include "Motion.h"
+#include "MotionQueue.h"
+#include "Host.h"
+
+#define PATH_MOVES              400         //moves queued in each stress run
+#define PATH_RANGE              30000       //targets are within +/- this many steps
+#define SERVICE_MAX             20          //longest ms between queue services
+
+//define variables used in this file
+static unsigned long RandomSeed = 1;
+static unsigned long Now;                   //simulated time in us
+static unsigned long NextStep;              //time of the next step interrupt, 0 when Timer3 is off
+static unsigned long LastStepTime;          //0 until a step is made in this run
+static unsigned long LastGap;               //us between the last two steps, 0 if not known
+static signed long LastPosition;
+static signed int LastDirection;
+static unsigned int LastUnderruns;
+static unsigned int Acceleration;
+static unsigned long StepCount;
+static unsigned long BadSteps;              //position changes of more than one step
+static unsigned long FastSpeedChanges;
+static unsigned long FastReversals;
+static double MaxSpeedChange;               //as a fraction of the limit
+
+
+
+//***************************************************************
+//Repeatable pseudo random number from 0 to Range - 1
+
+static unsigned long    Random(unsigned long Range)
+{
+    RandomSeed = RandomSeed * 1103515245UL + 12345UL;
+    return ((RandomSeed >> 8) & 0xFFFFFFUL) % Range;
+}
+
+
+
+//***************************************************************
+//Speed change allowed between two steps in steps/s, two 8 ms blocks
+//at the acceleration, the first step from rest and the 1 us interval
+//rounding at the higher speed
+
+static double   SpeedChangeLimit(double Speed)
+{
+    return 2.0 * Acceleration / MOTION_BLOCK_RATE + sqrt(2.0 * Acceleration)
+           + 2.0 * Speed * Speed / MOTION_TIMER_FREQUENCY + 1.0;
+}
+
+//fastest speed a reversal may be made at, a block of steps at the
+//speed it can stop from in one block, or the first step from rest
+static double   ReversalLimit(void)
+{
+    return 2.0 * Acceleration / MOTION_BLOCK_RATE + sqrt(4.0 * Acceleration) + MOTION_MIN_SPEED;
+}
+
+
+
+//***************************************************************
+//Check the step just made against the one before it
+
+static void    CheckStep(void)
+{
+    signed long Position;
+    signed long Delta;
+    unsigned long Gap;
+    double Speed;
+    double LastSpeed;
+    double Change;
+
+    Position = MotionGetPosition();
+    Delta = Position - LastPosition;
+    if(Delta == 0)
+    {
+        //a block was taken, the ring was empty or the move ended
+        return;
+    }
+    LastPosition = Position;
+    StepCount++;
+    if(Delta != 1 && Delta != -1)
+    {
+        BadSteps++;
+        return;
+    }
+
+    Gap = 0;
+    if(LastStepTime != 0 && LastUnderruns == MotionGetUnderrunCount())
+    {
+        Gap = Now - LastStepTime;
+    }
+    LastStepTime = Now;
+    LastUnderruns = MotionGetUnderrunCount();
+
+    if(Gap != 0 && LastGap != 0)
+    {
+        Speed = (double)MOTION_TIMER_FREQUENCY / Gap;
+        LastSpeed = (double)MOTION_TIMER_FREQUENCY / LastGap;
+        if(Delta != LastDirection)
+        {
+            if(Speed > ReversalLimit() || LastSpeed > ReversalLimit())
+            {
+                FastReversals++;
+            }
+        }
+        Change = fabs(Speed - LastSpeed) / SpeedChangeLimit(Speed > LastSpeed ? Speed : LastSpeed);
+        if(Change > MaxSpeedChange)
+        {
+            MaxSpeedChange = Change;
+        }
+        if(Change > 1.0)
+        {
+            FastSpeedChanges++;
+        }
+    }
+    LastGap = Gap;
+    LastDirection = (signed int)Delta;
+}
+
+
+
+//***************************************************************
+//Run the step interrupt up to the passed time
+
+static void    RunUntil(unsigned long Time)
+{
+    unsigned int Interval;
+
+    //Timer3 is started by the main loop, the first interrupt is TMR3 us on
+    if(NextStep == 0 && TIMER_3_ENABLE != 0)
+    {
+        NextStep = Now + (0x10000UL - TIMER_3_TIME);
+    }
+    while(NextStep != 0 && NextStep <= Time)
+    {
+        Now = NextStep;
+        Interval = HostStepInterrupt();
+        CheckStep();
+        NextStep = 0;
+        if(Interval != 0)
+        {
+            NextStep = Now + Interval;
+        }
+        else
+        {
+            //the move has ended, the next starts from rest
+            LastStepTime = 0;
+            LastGap = 0;
+        }
+    }
+    Now = Time;
+}
+
+//run the main loop service every Period ms for the passed ms
+static void    RunService(unsigned long Time, unsigned int Period)
+{
+    unsigned long End;
+
+    End = Now + Time * 1000UL;
+    while(Now < End)
+    {
+        RunUntil(Now + Period * 1000UL);
+        MotionQueueService();
+        RunUntil(Now);
+    }
+}
+
+//run until the last queued step is made
+static unsigned int    RunToEnd(unsigned int Period)
+{
+    unsigned int Time;
+
+    for(Time = 0; Time < 600000; Time += Period)
+    {
+        if(MotionBusy() == 0 && MotionQueueCount() == 0)
+        {
+            return 1;
+        }
+        RunService(Period, Period);
+    }
+    return 0;
+}
+
+
+
+//***************************************************************
+//Start each test with the motor at rest at 0
+
+static void    Reset(unsigned int TestAcceleration)
+{
+    InitialiseSPI();
+    InitialiseDRV8711();
+    InitialiseMotion();
+    MotionSetPosition(0);
+    InitialiseMotionQueue();
+    HostClearSPI();
+
+    Now = 0;
+    NextStep = 0;
+    LastStepTime = 0;
+    LastGap = 0;
+    LastPosition = 0;
+    LastDirection = 0;
+    LastUnderruns = MotionGetUnderrunCount();
+    Acceleration = TestAcceleration;
+    StepCount = 0;
+    BadSteps = 0;
+    FastSpeedChanges = 0;
+    FastReversals = 0;
+    MaxSpeedChange = 0;
+}
+
+
+
+//***************************************************************
+//Queue a random path, the service runs at a random rate up to 20 ms
+//the motor must end at the last target with no steps lost, no empty
+//ring and every speed change within the acceleration
+
+static void    TestPath(unsigned int TestAcceleration, unsigned long Seed)
+{
+    unsigned int Moves;
+    unsigned int Underruns;
+    signed long Target;
+    unsigned int Interval;
+
+    Reset(TestAcceleration);
+    RandomSeed = Seed;
+    Underruns = MotionGetUnderrunCount();
+    Target = 0;
+
+    for(Moves = 0; Moves < PATH_MOVES; )
+    {
+        if(MotionQueueCount() < MOTION_QUEUE_SIZE && Random(4) == 0)
+        {
+            //short moves as well as long ones, some just a step or two
+            if(Random(4) == 0)
+            {
+                Target = Target + (signed long)Random(11) - 5;
+            }
+            else
+            {
+                Target = (signed long)Random(2 * PATH_RANGE + 1) - PATH_RANGE;
+            }
+            Interval = MOTION_MIN_DELAY + (unsigned int)Random(2000);
+            CHECK(MotionQueueAdd(Target, Interval, Acceleration) == MOTION_OK);
+            Moves++;
+        }
+        RunService(1, 1 + (unsigned int)Random(SERVICE_MAX));
+    }
+    CHECK(RunToEnd(1 + (unsigned int)Random(SERVICE_MAX)));
+
+    printf("a %5u: %lu steps, largest speed change %.2f of the limit\n",
+           Acceleration, StepCount, MaxSpeedChange);
+    CHECK_EQUAL(Target, MotionGetPosition());
+    CHECK(MotionIsComplete());
+    CHECK(MotionBlocksActive() == 0);
+    CHECK(TIMER_3_ENABLE == 0);
+    CHECK_EQUAL(0, MotionGetUnderrunCount() - Underruns);
+    CHECK_EQUAL(0, BadSteps);
+    CHECK_EQUAL(0, FastSpeedChanges);
+    CHECK_EQUAL(0, FastReversals);
+}
+
+
+
+//***************************************************************
+//A stop runs on for no more than the block being made and the steps
+//to slow down from its speed, the blocks waiting in the ring and the
+//moves still queued are dropped
+
+static void    TestStop(unsigned int StopTime)
+{
+    signed long Position;
+    signed long Overtravel;
+    double Speed;
+    double Limit;
+
+    Reset(DEFAULT_ACCELERATION);
+    CHECK(MotionQueueAdd(20000, 200, Acceleration) == MOTION_OK);
+    CHECK(MotionQueueAdd(25000, 400, Acceleration) == MOTION_OK);
+    CHECK(MotionQueueAdd(-5000, 200, Acceleration) == MOTION_OK);
+    RunService(StopTime, 1);
+
+    Position = MotionGetPosition();
+    Speed = (double)MOTION_TIMER_FREQUENCY / LastGap;
+    MotionStop();
+    MotionQueueService();
+    CHECK(RunToEnd(1));
+
+    //one block is at most 8 ms of steps at the speed reached
+    Overtravel = MotionGetPosition() - Position;
+    Limit = Speed / MOTION_BLOCK_RATE + 1.0 + Speed * Speed / (2.0 * Acceleration) + 1.0;
+    printf("stop at %4u ms, %5.0f steps/s: %ld steps on, limit %.0f\n",
+           StopTime, Speed, Overtravel, Limit);
+    CHECK(Overtravel >= 0);
+    CHECK(Overtravel <= Limit);
+    CHECK_EQUAL(0, BadSteps);
+    CHECK_EQUAL(0, FastSpeedChanges);
+
+    //the queue starts again from where the motor stopped
+    CHECK(MotionQueueAdd(0, 200, Acceleration) == MOTION_OK);
+    CHECK(RunToEnd(5));
+    CHECK_EQUAL(0, MotionGetPosition());
+}
+
+int main(void)
+{
+    TestPath(DEFAULT_ACCELERATION, 1);
+    TestPath(MIN_ACCELERATION, 2);
+    TestPath(20000, 3);
+    TestPath(MAX_ACCELERATION, 4);
+    TestStop(50);
+    TestStop(500);
+    TestStop(2000);
+    TestStop(3000);
+    return TestSummary("TestMotionQueue");
+}
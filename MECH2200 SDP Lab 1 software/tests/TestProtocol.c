@@ -0,0 +1,372 @@
+/*
+ * File: TestProtocol.c
+ * Author: Roger Berry
+ * Comments: The binary frame encoder, parser and command replies.
+ *           ProtocolEncodeFrame and ProtocolParseByte build on the host
+ *           unchanged and are the host encoder and decoder. The parser is
+ *           fuzzed with random bytes and damaged frames, it must keep its
+ *           state in range and always find the next good frame.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Test.h"
+#include "Init.h"
+#include "Comms.h"
+#include "Protocol.h"
+#include "SPI.h"
+#include "Motion.h"
+#include "Host.h"
+
+#define ROUND_TRIPS                 20000   //random frames encoded and decoded
+#define FUZZ_BYTES                  2000000 //random bytes passed to the parser
+#define REPLY_NONE                  0xFFFF  //no reply frame found
+
+//define external global variables
+extern volatile unsigned int GLOBAL_StepperMotorSpeed;
+
+//define variables used in this file
+static unsigned long RandomSeed = 1;
+static FRAME_PARSER ReplyParser;
+
+
+
+//***************************************************************
+//Repeatable pseudo random number from 0 to Range - 1
+
+static unsigned long    Random(unsigned long Range)
+{
+    RandomSeed = RandomSeed * 1103515245UL + 12345UL;
+    return ((RandomSeed >> 8) & 0xFFFFFFUL) % Range;
+}
+
+//pass a whole frame to the parser, returns the last result
+static unsigned int    ParseFrame(FRAME_PARSER *Parser, const unsigned char *Frame, unsigned int Length)
+{
+    unsigned int Index;
+    unsigned int Result = FRAME_PENDING;
+
+    for(Index = 0; Index < Length; Index++)
+    {
+        Result = ProtocolParseByte(Parser, Frame[Index]);
+    }
+    return Result;
+}
+
+//the parser state and counts must always be in range
+static unsigned int    ParserValid(const FRAME_PARSER *Parser)
+{
+    if(Parser->State > FRAME_WAIT_CRC)
+    {
+        return 0;
+    }
+    if(Parser->State >= FRAME_WAIT_OPCODE && Parser->Length > PROTOCOL_MAX_PAYLOAD)
+    {
+        return 0;
+    }
+    if(Parser->State == FRAME_WAIT_PAYLOAD && Parser->Count >= Parser->Length)
+    {
+        return 0;
+    }
+    return 1;
+}
+
+
+
+//***************************************************************
+//Send a command frame through the UART receive path and decode the
+//reply the firmware sends, returns the reply opcode
+
+static unsigned int    Command(unsigned char Opcode, const unsigned char *Payload, unsigned int Length)
+{
+    unsigned char Frame[PROTOCOL_MAX_FRAME];
+    unsigned int FrameLength;
+    unsigned int Index;
+    unsigned int Count;
+    const char *Sent;
+
+    FrameLength = ProtocolEncodeFrame(Opcode, Payload, Length, Frame);
+    HostClearTransmitted();
+    for(Index = 0; Index < FrameLength; Index++)
+    {
+        CHECK_EQUAL(1, ProtocolReceiveByte(Frame[Index]));
+    }
+    Count = HostTransmit();
+    Sent = HostTransmitted();
+    ProtocolResetParser(&ReplyParser);
+    for(Index = 0; Index < Count; Index++)
+    {
+        if(ProtocolParseByte(&ReplyParser, (unsigned char)Sent[Index]) == FRAME_COMPLETE)
+        {
+            //the reply is the whole of the output
+            CHECK_EQUAL(Count, Index + 1);
+            return ReplyParser.Opcode;
+        }
+    }
+    return REPLY_NONE;
+}
+
+
+
+//***************************************************************
+//CRC-8 with polynomial 0x07 and initial value 0 gives 0xF4 for the
+//standard check string, frames carry it over length, opcode and payload
+
+static void    TestCrc(void)
+{
+    const unsigned char Check[] = "123456789";
+    unsigned char Frame[PROTOCOL_MAX_FRAME];
+    unsigned char Payload[PROTOCOL_MAX_PAYLOAD + 1] = {0x12, 0x34};
+    unsigned char Crc = 0;
+    unsigned int Index;
+
+    for(Index = 0; Check[Index] != 0; Index++)
+    {
+        Crc = ProtocolCrc8(Crc, Check[Index]);
+    }
+    CHECK_EQUAL(0xF4, Crc);
+
+    CHECK_EQUAL(6, ProtocolEncodeFrame(PROTOCOL_SET_SPEED, Payload, 2, Frame));
+    CHECK_EQUAL(PROTOCOL_SYNC, Frame[0]);
+    CHECK_EQUAL(2, Frame[1]);
+    CHECK_EQUAL(PROTOCOL_SET_SPEED, Frame[2]);
+    CHECK_EQUAL(0x12, Frame[3]);
+    CHECK_EQUAL(0x34, Frame[4]);
+    Crc = ProtocolCrc8(ProtocolCrc8(ProtocolCrc8(ProtocolCrc8(0, 2), PROTOCOL_SET_SPEED), 0x12), 0x34);
+    CHECK_EQUAL(Crc, Frame[5]);
+
+    CHECK_EQUAL(4, ProtocolEncodeFrame(PROTOCOL_QUERY_STATUS, NULL, 0, Frame));
+    CHECK_EQUAL(0, ProtocolEncodeFrame(PROTOCOL_SET_SPEED, Payload, PROTOCOL_MAX_PAYLOAD + 1, Frame));
+}
+
+
+
+//***************************************************************
+//Every frame encoded decodes to the same opcode and payload, any one
+//bit changed in the opcode, payload or CRC is caught
+
+static void    TestRoundTrip(void)
+{
+    FRAME_PARSER Parser;
+    unsigned char Frame[PROTOCOL_MAX_FRAME];
+    unsigned char Payload[PROTOCOL_MAX_PAYLOAD];
+    unsigned int Trip;
+    unsigned int Length;
+    unsigned int FrameLength;
+    unsigned int Index;
+    unsigned int Bit;
+    unsigned char Opcode;
+    unsigned int Wrong = 0;
+    unsigned int Missed = 0;
+
+    ProtocolResetParser(&Parser);
+    for(Trip = 0; Trip < ROUND_TRIPS; Trip++)
+    {
+        Length = (unsigned int)Random(PROTOCOL_MAX_PAYLOAD + 1);
+        Opcode = (unsigned char)Random(256);
+        for(Index = 0; Index < Length; Index++)
+        {
+            Payload[Index] = (unsigned char)Random(256);
+        }
+        FrameLength = ProtocolEncodeFrame(Opcode, Payload, Length, Frame);
+        if(FrameLength != Length + 4 || ParseFrame(&Parser, Frame, FrameLength) != FRAME_COMPLETE ||
+           Parser.Opcode != Opcode || Parser.Length != Length || memcmp(Parser.Payload, Payload, Length) != 0)
+        {
+            Wrong++;
+        }
+
+        //a single bit error after the length, a changed length may end
+        //the frame early on a byte that happens to match the CRC
+        Bit = 16 + (unsigned int)Random((FrameLength - 2) * 8);
+        Frame[Bit / 8] ^= (unsigned char)(1 << (Bit % 8));
+        ProtocolResetParser(&Parser);
+        if(ParseFrame(&Parser, Frame, FrameLength) == FRAME_COMPLETE)
+        {
+            Missed++;
+        }
+        ProtocolResetParser(&Parser);
+    }
+    CHECK_EQUAL(0, Wrong);
+    CHECK_EQUAL(0, Missed);
+}
+
+
+
+//***************************************************************
+//Random bytes with good and damaged frames mixed in. The parser state
+//stays in range, a frame's worth of filler always brings it back to
+//waiting for sync and the good frame after it is always decoded
+
+static void    TestFuzz(void)
+{
+    FRAME_PARSER Parser;
+    unsigned char Frame[PROTOCOL_MAX_FRAME];
+    unsigned char Payload[PROTOCOL_MAX_PAYLOAD];
+    unsigned long Step;
+    unsigned int Length;
+    unsigned int FrameLength;
+    unsigned int Index;
+    unsigned int Result;
+    unsigned int Invalid = 0;
+    unsigned int Stuck = 0;
+    unsigned int Lost = 0;
+    unsigned long Complete = 0;
+    unsigned long CrcErrors = 0;
+    unsigned long LengthErrors = 0;
+
+    ProtocolResetParser(&Parser);
+    for(Step = 0; Step < FUZZ_BYTES; Step++)
+    {
+        //sync bytes and short lengths are common so frames are often started
+        switch(Random(4))
+        {
+            case 0:
+                Result = ProtocolParseByte(&Parser, PROTOCOL_SYNC);
+                break;
+            case 1:
+                Result = ProtocolParseByte(&Parser, (unsigned char)Random(PROTOCOL_MAX_PAYLOAD + 2));
+                break;
+            default:
+                Result = ProtocolParseByte(&Parser, (unsigned char)Random(256));
+                break;
+        }
+        if(Result == FRAME_COMPLETE)
+        {
+            Complete++;
+        }
+        else if(Result == FRAME_CRC_ERROR)
+        {
+            CrcErrors++;
+        }
+        else if(Result == FRAME_LENGTH_ERROR)
+        {
+            LengthErrors++;
+        }
+        if(ParserValid(&Parser) == 0)
+        {
+            Invalid++;
+        }
+
+        //every so often, filler then a good frame
+        if(Random(64) == 0)
+        {
+            for(Index = 0; Index < PROTOCOL_MAX_FRAME; Index++)
+            {
+                ProtocolParseByte(&Parser, 0);
+            }
+            if(Parser.State != FRAME_WAIT_SYNC)
+            {
+                Stuck++;
+            }
+            Length = (unsigned int)Random(PROTOCOL_MAX_PAYLOAD + 1);
+            for(Index = 0; Index < Length; Index++)
+            {
+                Payload[Index] = (unsigned char)Random(256);
+            }
+            FrameLength = ProtocolEncodeFrame(PROTOCOL_MOVE_TO, Payload, Length, Frame);
+            if(ParseFrame(&Parser, Frame, FrameLength) != FRAME_COMPLETE || memcmp(Parser.Payload, Payload, Length) != 0)
+            {
+                Lost++;
+            }
+        }
+    }
+    printf("%lu random frames accepted, %lu CRC errors, %lu length errors\n", Complete, CrcErrors, LengthErrors);
+    CHECK_EQUAL(0, Invalid);
+    CHECK_EQUAL(0, Stuck);
+    CHECK_EQUAL(0, Lost);
+    //an 8 bit CRC passes about 1 in 256 random frames
+    CHECK(CrcErrors > 10000);
+    CHECK(Complete * 128 < CrcErrors && Complete * 512 > CrcErrors);
+}
+
+
+
+//***************************************************************
+//Commands through the UART receive path get a reply or a NAK with
+//the reason, menu characters are not taken by the protocol
+
+static void    TestCommands(void)
+{
+    unsigned char Payload[PROTOCOL_MAX_PAYLOAD];
+    unsigned char Frame[PROTOCOL_MAX_FRAME];
+    unsigned int Length;
+    unsigned int Index;
+
+    InitialiseComms();
+    InitialiseSPI();
+    InitialiseDRV8711();
+    InitialiseMotion();
+    HostTransmit();
+
+    //menu characters are left for the menu
+    CHECK_EQUAL(0, ProtocolReceiveByte('1'));
+    CHECK_EQUAL(0, ProtocolReceiveByte('\r'));
+    CHECK_EQUAL(0, ProtocolFrameActive());
+
+    MotionSetPosition(-123456);
+    CHECK_EQUAL(PROTOCOL_GET_POSITION | PROTOCOL_REPLY, Command(PROTOCOL_GET_POSITION, NULL, 0));
+    CHECK_EQUAL(5, ReplyParser.Length);
+    //long is 64 bits on the host, int gives the sign of the 32 bit value
+    CHECK_EQUAL(-123456, (signed int)(((unsigned long)ReplyParser.Payload[0] << 24) | ((unsigned long)ReplyParser.Payload[1] << 16) |
+                                                    ((unsigned long)ReplyParser.Payload[2] << 8) | ReplyParser.Payload[3]));
+    CHECK_EQUAL(1, ReplyParser.Payload[4]);
+
+    //the step interval, high byte first, with the menu's 500 us limit
+    Payload[0] = 0x03;
+    Payload[1] = 0xE8;
+    CHECK_EQUAL(PROTOCOL_SET_SPEED | PROTOCOL_REPLY, Command(PROTOCOL_SET_SPEED, Payload, 2));
+    CHECK_EQUAL(0, ReplyParser.Length);
+    CHECK_EQUAL(1000, GLOBAL_StepperMotorSpeed);
+    Payload[0] = 0x01;
+    CHECK_EQUAL(PROTOCOL_NAK, Command(PROTOCOL_SET_SPEED, Payload, 2));
+    CHECK_EQUAL(PROTOCOL_SET_SPEED, ReplyParser.Payload[0]);
+    CHECK_EQUAL(PROTOCOL_ERROR_VALUE, ReplyParser.Payload[1]);
+    CHECK_EQUAL(1000, GLOBAL_StepperMotorSpeed);
+    CHECK_EQUAL(PROTOCOL_NAK, Command(PROTOCOL_SET_SPEED, Payload, 1));
+    CHECK_EQUAL(PROTOCOL_ERROR_LENGTH, ReplyParser.Payload[1]);
+
+    //registers are 12 bits and channels 0 to 2
+    Payload[0] = DRV_TORQUE_REG;
+    Payload[1] = 0x10;
+    Payload[2] = 0x00;
+    CHECK_EQUAL(PROTOCOL_NAK, Command(PROTOCOL_WRITE_REGISTER, Payload, 3));
+    CHECK_EQUAL(PROTOCOL_ERROR_VALUE, ReplyParser.Payload[1]);
+    Payload[0] = 3;
+    CHECK_EQUAL(PROTOCOL_NAK, Command(PROTOCOL_READ_ADC, Payload, 1));
+    CHECK_EQUAL(PROTOCOL_READ_ADC, ReplyParser.Payload[0]);
+    CHECK_EQUAL(PROTOCOL_ERROR_VALUE, ReplyParser.Payload[1]);
+
+    CHECK_EQUAL(PROTOCOL_NAK, Command(PROTOCOL_MOVE_TO, Payload, 2));
+    CHECK_EQUAL(PROTOCOL_ERROR_LENGTH, ReplyParser.Payload[1]);
+    CHECK_EQUAL(PROTOCOL_NAK, Command(0x40, NULL, 0));
+    CHECK_EQUAL(0x40, ReplyParser.Payload[0]);
+    CHECK_EQUAL(PROTOCOL_ERROR_OPCODE, ReplyParser.Payload[1]);
+
+    //a damaged frame is answered with a CRC NAK and not acted on
+    Payload[0] = 0x07;
+    Payload[1] = 0xD0;
+    Length = ProtocolEncodeFrame(PROTOCOL_SET_SPEED, Payload, 2, Frame);
+    Frame[Length - 1] ^= 0x01;
+    HostClearTransmitted();
+    for(Index = 0; Index < Length; Index++)
+    {
+        CHECK_EQUAL(1, ProtocolReceiveByte(Frame[Index]));
+    }
+    CHECK_EQUAL(1000, GLOBAL_StepperMotorSpeed);
+    Length = HostTransmit();
+    CHECK_EQUAL(FRAME_COMPLETE, ParseFrame(&ReplyParser, (const unsigned char *)HostTransmitted(), Length));
+    CHECK_EQUAL(PROTOCOL_NAK, ReplyParser.Opcode);
+    CHECK_EQUAL(PROTOCOL_SET_SPEED, ReplyParser.Payload[0]);
+    CHECK_EQUAL(PROTOCOL_ERROR_CRC, ReplyParser.Payload[1]);
+    CHECK_EQUAL(0, ProtocolFrameActive());
+}
+
+int main(void)
+{
+    TestCrc();
+    TestRoundTrip();
+    TestFuzz();
+    TestCommands();
+    return TestSummary("TestProtocol");
+}
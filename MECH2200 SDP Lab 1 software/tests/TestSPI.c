@@ -0,0 +1,382 @@
+/*
+ * File: TestSPI.c
+ * Author: Roger Berry
+ * Comments: The SPI transaction queue driven through the MSSP model.
+ *           The DRV8711 and the LED display share the bus, so every byte
+ *           must go out with only its own chip select active and its own
+ *           clock setting loaded. A model of the DRV8711 registers checks
+ *           the shadow copy, write verify and the reload after a reset.
+ *           The transfer time of a DRV8711 frame at its own clock profile
+ *           is compared with the single 125 kHz clock used before.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Test.h"
+#include "Init.h"
+#include "Comms.h"
+#include "SPI.h"
+#include "Host.h"
+
+#define DRV_MODEL_REGISTERS         8       //registers in the DRV8711 model, status included
+#define OLD_CLOCK_DIVIDER           63      //SSP1ADD for the 125 kHz clock every device used
+#define BYTE_TIME(Divider)          ((Divider) + 1)     //us to send a byte at 32 MHz
+
+//define variables used in this file
+static unsigned int DrvRegisters[DRV_MODEL_REGISTERS];
+static unsigned char DrvByte = 0;           //byte of the 16 bit DRV8711 frame, 0 or 1
+static unsigned char DrvCommand;            //first byte of the frame
+static unsigned int BadClock;               //bytes sent with the other device's clock
+static unsigned int BothSelected;           //bytes sent with both chip selects active
+static unsigned int CallbackCount;
+static SPI_TRANSACTION *CallbackOrder[SPI_QUEUE_SIZE + 1];
+static unsigned char LastDrvData;           //data byte of the last DRV8711 write, compared after the frame
+
+
+
+//***************************************************************
+//DRV8711 model, each frame is 16 bits, read flag, 3 address bits then
+//12 data bits. A read returns the register in the data bits, a write
+//takes the data bits at the end of the frame.
+//Every byte is also checked for the chip selects and clock setting.
+
+static unsigned char    Reply(unsigned char Device, unsigned char Sent)
+{
+    unsigned int Address;
+    unsigned char Received = 0;
+
+    if(SPI_ENABLE_WRITE != 0 && GPIO_8_WRITE == 0)
+    {
+        BothSelected++;
+    }
+    if((Device == SPI_DEVICE_DRV8711 && SSP1ADD != DRV8711_CLOCK_DIVIDER) ||
+       (Device == SPI_DEVICE_LED && SSP1ADD != LED_CLOCK_DIVIDER) || SSP1CON1bits.SSPEN == 0)
+    {
+        BadClock++;
+    }
+    if(Device != SPI_DEVICE_DRV8711)
+    {
+        return 0;
+    }
+
+    if(DrvByte == 0)
+    {
+        DrvCommand = Sent;
+        Address = (Sent >> 4) & 0x07;
+        Received = (unsigned char)((DrvRegisters[Address] >> 8) & 0x0F);
+        DrvByte = 1;
+    }
+    else
+    {
+        Address = (DrvCommand >> 4) & 0x07;
+        Received = (unsigned char)DrvRegisters[Address];
+        if((DrvCommand & 0x80) == 0 && Address != DRV_STATUS_REG)
+        {
+            DrvRegisters[Address] = ((unsigned int)(DrvCommand & 0x0F) << 8) | Sent;
+            //RSTEP clears itself
+            if(Address == DRV_CTRL_REG)
+            {
+                DrvRegisters[Address] &= ~RSTEP_MASK;
+            }
+        }
+        LastDrvData = Sent;
+        DrvByte = 0;
+    }
+    return Received;
+}
+
+//the DRV8711 power on values, as after a reset
+static void    ResetDrvModel(void)
+{
+    DrvRegisters[DRV_CTRL_REG] = 0xC10;
+    DrvRegisters[DRV_TORQUE_REG] = 0x1FF;
+    DrvRegisters[DRV_OFF_REG] = 0x030;
+    DrvRegisters[DRV_BLANK_REG] = 0x080;
+    DrvRegisters[DRV_DECAY_REG] = 0x110;
+    DrvRegisters[DRV_STALL_REG] = 0x040;
+    DrvRegisters[DRV_DRIVE_REG] = 0xA59;
+    DrvRegisters[DRV_STATUS_REG] = 0x000;
+}
+
+static void    Callback(SPI_TRANSACTION *Transaction)
+{
+    if(CallbackCount <= SPI_QUEUE_SIZE)
+    {
+        CallbackOrder[CallbackCount] = Transaction;
+    }
+    CallbackCount++;
+}
+
+//run the SPI interrupt until the queue is empty, returns the number of
+//interrupts taken
+static unsigned int    RunInterrupt(void)
+{
+    unsigned int Count = 0;
+
+    while(SPI_INTERRUPT_ENABLE != 0 && SPI_INTERRUPT_FLAG != 0 && Count < 1000)
+    {
+        SPI_InterruptService();
+        Count++;
+    }
+    return Count;
+}
+
+static void    Reset(void)
+{
+    INTCONbits.GIE = 0;
+    HostSPIReply(Reply);
+    ResetDrvModel();
+    DrvByte = 0;
+    InitialiseSPI();
+    HostClearSPI();
+    BadClock = 0;
+    BothSelected = 0;
+    CallbackCount = 0;
+}
+
+
+
+//***************************************************************
+//A write and a read of a DRV8711 register, the frame bits and the chip
+//select around the two bytes
+
+static void    TestDRV8711Frames(void)
+{
+    SPI_TRANSACTION Transaction;
+
+    Reset();
+    QueueDRV8711Write(&Transaction, DRV_TORQUE_REG, 0xF123);
+    CHECK_EQUAL(2, Transaction.Length);
+    CHECK_EQUAL(0x11, Transaction.TxData[0]);
+    CHECK_EQUAL(0x23, Transaction.TxData[1]);
+    CHECK_EQUAL(SPI_QUEUE_OK, QueueSPI(&Transaction));
+    CHECK_EQUAL(SPI_QUEUED, Transaction.Status);
+    CHECK_EQUAL(0, SPI_Idle());
+    //nothing goes out until the interrupt runs
+    CHECK_EQUAL(0, HostSPICount());
+    RunInterrupt();
+    CHECK_EQUAL(SPI_DONE, Transaction.Status);
+    CHECK_EQUAL(1, SPI_Idle());
+    CHECK_EQUAL(0, SPI_INTERRUPT_ENABLE);
+    CHECK_EQUAL(2, HostSPICount());
+    CHECK_EQUAL(SPI_DEVICE_DRV8711, HostSPIByte(0)->Device);
+    CHECK_EQUAL(SPI_DEVICE_DRV8711, HostSPIByte(1)->Device);
+    CHECK_EQUAL(0, SPI_ENABLE_WRITE);
+    CHECK_EQUAL(1, GPIO_8_WRITE);
+    CHECK_EQUAL(0x123, DrvRegisters[DRV_TORQUE_REG]);
+
+    QueueDRV8711Read(&Transaction, DRV_TORQUE_REG);
+    CHECK_EQUAL(0x90, Transaction.TxData[0]);
+    QueueSPI(&Transaction);
+    RunInterrupt();
+    CHECK_EQUAL(0x123, GetDRV8711Result(&Transaction));
+    CHECK_EQUAL(0x123, DrvRegisters[DRV_TORQUE_REG]);
+
+    //the waiting calls run the interrupt themselves while interrupts are off
+    WriteSPI(DRV_DECAY_REG, 0x0ABC);
+    CHECK_EQUAL(0xABC, DrvRegisters[DRV_DECAY_REG]);
+    CHECK_EQUAL(0xABC, ReadSPI(DRV_DECAY_REG));
+    CHECK_EQUAL(0, BadClock);
+}
+
+
+
+//***************************************************************
+//A 16 bit DRV8711 frame at the 4 MHz profile against the 125 kHz clock
+//all devices shared before. The time runs from chip select to the end
+//of the last byte, so it includes the interrupt and Timer1 reads.
+
+static void    TestTransferTime(void)
+{
+    SPI_TRANSACTION Transaction;
+    unsigned int DrvTime;
+    unsigned int LedTime;
+    unsigned int OldTime;
+    volatile unsigned char Text[] = "1234567";
+
+    Reset();
+    QueueDRV8711Write(&Transaction, DRV_TORQUE_REG, 0x123);
+    QueueSPI(&Transaction);
+    RunInterrupt();
+    DrvTime = GetSPI_TransferTime(SPI_DEVICE_DRV8711);
+    QueueLED_Display(&Transaction, LED_DISPLAY_CURSOR_CONTROL, Text, 0);
+    QueueSPI(&Transaction);
+    RunInterrupt();
+    LedTime = GetSPI_TransferTime(SPI_DEVICE_LED);
+    OldTime = 2 * BYTE_TIME(OLD_CLOCK_DIVIDER);
+    printf("DRV8711 frame: %u us at 4 MHz, at least %u us at 125 kHz\n", DrvTime, OldTime);
+    printf("LED display frame: %u us at 250 kHz, at least %u us at 125 kHz\n", LedTime, SPI_MAX_TRANSFER * BYTE_TIME(OLD_CLOCK_DIVIDER));
+
+    CHECK(DrvTime >= 2 * BYTE_TIME(DRV8711_CLOCK_DIVIDER));
+    CHECK(DrvTime < OldTime / 8);
+    CHECK(LedTime >= SPI_MAX_TRANSFER * BYTE_TIME(LED_CLOCK_DIVIDER));
+    CHECK(LedTime < SPI_MAX_TRANSFER * BYTE_TIME(OLD_CLOCK_DIVIDER));
+}
+
+
+
+//***************************************************************
+//DRV8711 and LED display transactions queued together go out in order,
+//each with only its own chip select and clock, and each callback is
+//called once as its transaction finishes
+
+static void    TestSharedBus(void)
+{
+    SPI_TRANSACTION Status;
+    SPI_TRANSACTION Display;
+    SPI_TRANSACTION Torque;
+    SPI_TRANSACTION Brightness;
+    SPI_TRANSACTION Extra[SPI_QUEUE_SIZE];
+    volatile unsigned char Text[] = "1234567";
+    volatile unsigned char Level[] = {0x40, 0};
+    unsigned int Index;
+    unsigned int Ledbytes = 0;
+
+    Reset();
+    DrvRegisters[DRV_STATUS_REG] = 0x0A5;
+    QueueDRV8711Read(&Status, DRV_STATUS_REG);
+    Status.Callback = Callback;
+    QueueLED_Display(&Display, LED_DISPLAY_CURSOR_CONTROL, Text, 0);
+    Display.Callback = Callback;
+    QueueDRV8711Write(&Torque, DRV_TORQUE_REG, 0x155);
+    Torque.Callback = Callback;
+    QueueLED_Display(&Brightness, LED_DISPLAY_BRIGHTNESS, Level, 0);
+    Brightness.Callback = Callback;
+
+    //the cursor command, position and as much of the text as fits
+    CHECK_EQUAL(SPI_MAX_TRANSFER, Display.Length);
+    CHECK_EQUAL(LED_DISPLAY_CURSOR_CONTROL, Display.TxData[0]);
+    CHECK_EQUAL(0, Display.TxData[1]);
+    CHECK(memcmp(&Display.TxData[2], "123456", 6) == 0);
+    CHECK_EQUAL(2, Brightness.Length);
+
+    CHECK_EQUAL(SPI_QUEUE_OK, QueueSPI(&Status));
+    CHECK_EQUAL(SPI_QUEUE_OK, QueueSPI(&Display));
+    CHECK_EQUAL(SPI_QUEUE_OK, QueueSPI(&Torque));
+    CHECK_EQUAL(SPI_QUEUE_OK, QueueSPI(&Brightness));
+    RunInterrupt();
+
+    CHECK_EQUAL(4, CallbackCount);
+    CHECK(CallbackOrder[0] == &Status);
+    CHECK(CallbackOrder[1] == &Display);
+    CHECK(CallbackOrder[2] == &Torque);
+    CHECK(CallbackOrder[3] == &Brightness);
+    CHECK_EQUAL(0x0A5, GetDRV8711Result(&Status));
+    CHECK_EQUAL(0x155, DrvRegisters[DRV_TORQUE_REG]);
+    CHECK_EQUAL(2 + SPI_MAX_TRANSFER + 2 + 2, HostSPICount());
+    for(Index = 0; Index < HostSPICount(); Index++)
+    {
+        if(HostSPIByte(Index)->Device == SPI_DEVICE_LED)
+        {
+            Ledbytes++;
+        }
+    }
+    CHECK_EQUAL(SPI_MAX_TRANSFER + 2, Ledbytes);
+    CHECK_EQUAL(SPI_DEVICE_LED, HostSPIByte(2)->Device);
+    CHECK_EQUAL(LED_DISPLAY_CURSOR_CONTROL, HostSPIByte(2)->Sent);
+    CHECK_EQUAL(SPI_DEVICE_DRV8711, HostSPIByte(2 + SPI_MAX_TRANSFER)->Device);
+    CHECK_EQUAL(0x40, HostSPIByte(HostSPICount() - 1)->Sent);
+    CHECK_EQUAL(0, BadClock);
+    CHECK_EQUAL(0, BothSelected);
+    CHECK_EQUAL(1, SPI_Idle());
+
+    //a full queue is reported instead of waited on
+    for(Index = 0; Index < SPI_QUEUE_SIZE; Index++)
+    {
+        QueueDRV8711Read(&Extra[Index], DRV_STATUS_REG);
+        CHECK_EQUAL(SPI_QUEUE_OK, QueueSPI(&Extra[Index]));
+    }
+    CHECK_EQUAL(SPI_QUEUE_FULL, QueueSPI(&Status));
+    CHECK_EQUAL(SPI_DONE, Status.Status);
+    RunInterrupt();
+    for(Index = 0; Index < SPI_QUEUE_SIZE; Index++)
+    {
+        CHECK_EQUAL(SPI_DONE, Extra[Index].Status);
+    }
+    CHECK_EQUAL(SPI_QUEUE_OK, QueueSPI(&Status));
+    RunInterrupt();
+    CHECK_EQUAL(0, BothSelected);
+}
+
+
+
+//***************************************************************
+//The shadow copy follows every write, verify reads each write back and
+//the register check reloads the settings after the driver resets
+
+static void    TestShadow(void)
+{
+    unsigned int Address;
+    unsigned int Call;
+    unsigned int Index;
+    unsigned int Restored = 0;
+
+    Reset();
+    InitialiseDRV8711();
+    for(Address = 0; Address < DRV_REGISTER_COUNT; Address++)
+    {
+        CHECK_EQUAL(GetDRV8711Shadow(Address), DrvRegisters[Address]);
+    }
+    CHECK_EQUAL(DRV_CTRL_REG_VALUE, DrvRegisters[DRV_CTRL_REG]);
+    CHECK_EQUAL(DRV_TORQUE_REG_VALUE, DrvRegisters[DRV_TORQUE_REG]);
+
+    MotorOn();
+    CHECK_EQUAL(DRV_CTRL_REG_VALUE | ENABLE_DRIVE, DrvRegisters[DRV_CTRL_REG]);
+    LoadTorque(0x42);
+    CHECK_EQUAL((DRV_TORQUE_REG_VALUE & ~TORQUE_MASK) | 0x42, DrvRegisters[DRV_TORQUE_REG]);
+    SetDRV8711_Mode(PWM_MODE);
+    CHECK_EQUAL(DRV_OFF_REG_VALUE | SET_PWM_MODE, DrvRegisters[DRV_OFF_REG]);
+    SetDRV8711_Mode(STEPPER_MODE);
+    CHECK_EQUAL(DRV_OFF_REG_VALUE, DrvRegisters[DRV_OFF_REG]);
+
+    //verify, RSTEP reads back as 0 and is not a failure
+    SetDRV8711Verify(1);
+    CHECK_EQUAL(DRV_SETTINGS_OK, WriteDRV8711(DRV_CTRL_REG, GetDRV8711Shadow(DRV_CTRL_REG) | RSTEP_MASK));
+    CHECK_EQUAL(DRV_SETTINGS_OK, UpdateDRV8711(DRV_STALL_REG, 0x0FF, 0x020));
+    //the status register does not keep what is written
+    CHECK_EQUAL(DRV_SETTINGS_OK, WriteDRV8711(DRV_STATUS_REG, 0x0FF));
+    SetDRV8711Verify(0);
+
+    //no change, a full pass of the registers finds nothing
+    for(Call = 0; Call < 2 * DRV_REGISTER_COUNT + 2; Call++)
+    {
+        CHECK_EQUAL(DRV_SETTINGS_OK, CheckDRV8711());
+        RunInterrupt();
+    }
+
+    //the driver resets, one pass of the check reloads everything
+    MotorOff();
+    LoadTorque(0x20);
+    ResetDrvModel();
+    for(Call = 0; Call < DRV_REGISTER_COUNT + 2; Call++)
+    {
+        if(CheckDRV8711() == DRV_SETTINGS_RESTORED)
+        {
+            Restored++;
+        }
+        RunInterrupt();
+    }
+    CHECK_EQUAL(1, Restored);
+    CHECK(GetDRV8711RestoreCount() >= 1);
+    for(Address = 0; Address < DRV_REGISTER_COUNT; Address++)
+    {
+        CHECK_EQUAL(GetDRV8711Shadow(Address) & ~(Address == DRV_CTRL_REG ? RSTEP_MASK : 0), DrvRegisters[Address]);
+    }
+    //the drive enable is written last, only the check reads follow it
+    for(Index = HostSPICount() - 2; (HostSPIByte(Index)->Sent & 0x80) != 0 && Index > 0; Index = Index - 2)
+    {
+    }
+    CHECK_EQUAL(DRV_CTRL_REG << 4, HostSPIByte(Index)->Sent & 0xF0);
+    CHECK_EQUAL(0, BadClock);
+    CHECK_EQUAL(0, BothSelected);
+}
+
+int main(void)
+{
+    TestDRV8711Frames();
+    TestSharedBus();
+    TestShadow();
+    TestTransferTime();
+    return TestSummary("TestSPI");
+}
@@ -0,0 +1,231 @@
+/*
+ * File: TestScheduler.c
+ * Author: Roger Berry
+ * Comments: Task order, event passing and run time statistics of the
+ *           cooperative scheduler
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Test.h"
+#include "Init.h"
+#include "SoftTimer.h"
+#include "Scheduler.h"
+
+#define LOG_LENGTH                  64
+
+//define external global variables
+extern volatile unsigned int GLOBAL_TimerEventCounter;
+
+//define variables used in this file
+static char RunLog[LOG_LENGTH + 1];
+static unsigned int RunCount = 0;
+static unsigned char RaiseEvents = 0;       //raised by TaskE while it runs
+static unsigned int RunTime = 0;            //us TaskF takes
+static unsigned int RunTicks = 0;           //ms ticks counted while TaskF runs
+
+const unsigned char NameA[] = "A";
+const unsigned char NameB[] = "B";
+const unsigned char NameC[] = "C";
+const unsigned char NameD[] = "D";
+const unsigned char NameE[] = "E";
+const unsigned char NameF[] = "F";
+
+
+
+//***************************************************************
+//Each task adds its letter to the run log
+
+static void    Log(char Letter)
+{
+    if(RunCount < LOG_LENGTH)
+    {
+        RunLog[RunCount] = Letter;
+        RunCount++;
+        RunLog[RunCount] = 0;
+    }
+}
+
+static void    TaskA(void)
+{
+    Log('A');
+}
+
+static void    TaskB(void)
+{
+    Log('B');
+}
+
+static void    TaskC(void)
+{
+    Log('C');
+}
+
+static void    TaskD(void)
+{
+    Log('D');
+}
+
+//raises events as an interrupt would while it runs
+static void    TaskE(void)
+{
+    Log('E');
+    SchedulerInterruptSignal(RaiseEvents);
+    RaiseEvents = 0;
+}
+
+//takes RunTime us on Timer1 and RunTicks ms ticks
+static void    TaskF(void)
+{
+    Log('F');
+    TMR1 = (unsigned short)(TMR1 + RunTime);
+    GLOBAL_TimerEventCounter = GLOBAL_TimerEventCounter + RunTicks;
+}
+
+//highest priority first
+const TASK TestTasks[] =
+{
+    {NameA, TaskA, EVENT_TICK},
+    {NameB, TaskB, EVENT_BUTTON},
+    {NameC, TaskC, EVENT_TICK | EVENT_RX},
+    {NameD, TaskD, TASK_POLL},
+    {NameE, TaskE, TASK_POLL},
+    {NameF, TaskF, EVENT_ENDSTOP}
+};
+const SCHEDULE TestSchedule = {TestTasks, SCHEDULE_TASK_COUNT(TestTasks)};
+
+
+
+//***************************************************************
+//Run tasks until the end of a pass, the log shows the order
+
+static const char  *RunPass(void)
+{
+    unsigned int Runs;
+
+    RunCount = 0;
+    RunLog[0] = 0;
+    for(Runs = 0; Runs < LOG_LENGTH; Runs++)
+    {
+        if(SchedulerRun(&TestSchedule) == SCHEDULER_NO_TASK)
+        {
+            break;
+        }
+    }
+    return RunLog;
+}
+
+
+
+//***************************************************************
+//The polled tasks run once on each pass, event tasks only when their
+//event is raised, and always in table order
+
+static void    TestOrder(void)
+{
+    SchedulerInitialise(&TestSchedule);
+    CHECK(strcmp(RunPass(), "DE") == 0);
+    CHECK(strcmp(RunPass(), "DE") == 0);
+
+    //one tick wakes every task waiting for it
+    SchedulerInterruptSignal(EVENT_TICK);
+    CHECK(strcmp(RunPass(), "ACDE") == 0);
+
+    //events raised twice before the tasks run are served once
+    SchedulerInterruptSignal(EVENT_RX);
+    SchedulerInterruptSignal(EVENT_RX | EVENT_BUTTON);
+    CHECK(strcmp(RunPass(), "BCDE") == 0);
+
+    //the main loop cannot raise TASK_POLL as an event
+    SchedulerSignal(TASK_POLL | EVENT_ENDSTOP);
+    CHECK(strcmp(RunPass(), "DEF") == 0);
+    CHECK(strcmp(RunPass(), "DE") == 0);
+}
+
+
+
+//***************************************************************
+//An event raised while a low priority task runs is served before the
+//rest of the pass, the polled tasks are not run again until the next pass
+
+static void    TestPreference(void)
+{
+    SchedulerInitialise(&TestSchedule);
+    RaiseEvents = EVENT_BUTTON | EVENT_ENDSTOP;
+    CHECK(strcmp(RunPass(), "DEBF") == 0);
+
+    RaiseEvents = EVENT_TICK;
+    SchedulerInterruptSignal(EVENT_ENDSTOP);
+    CHECK(strcmp(RunPass(), "DEACF") == 0);
+    CHECK(strcmp(RunPass(), "DE") == 0);
+}
+
+
+
+//***************************************************************
+//Run counts and times are kept per task, a run of 65 ms or more is
+//marked as too long for Timer1 to measure
+
+static void    TestStatistics(void)
+{
+    const TASK_STATISTICS *Statistics;
+    unsigned int Runs;
+
+    InitialiseSoftTimers();
+    SchedulerClearStatistics();
+    SchedulerInitialise(&TestSchedule);
+    Statistics = SchedulerGetStatistics(5);
+    CHECK_EQUAL(0, Statistics->Runs);
+
+    RunTime = 500;
+    SchedulerSignal(EVENT_ENDSTOP);
+    RunPass();
+    CHECK_EQUAL(1, Statistics->Runs);
+    //each Timer1 read moves the model on by 1 us
+    CHECK(Statistics->LastTime >= 500 && Statistics->LastTime <= 505);
+    CHECK_EQUAL(Statistics->LastTime, Statistics->MaxTime);
+
+    RunTime = 100;
+    SchedulerSignal(EVENT_ENDSTOP);
+    RunPass();
+    CHECK_EQUAL(2, Statistics->Runs);
+    CHECK(Statistics->LastTime >= 100 && Statistics->LastTime <= 105);
+    CHECK(Statistics->MaxTime >= 500 && Statistics->MaxTime <= 505);
+
+    //Timer1 has rolled over back to the same count 65.536 ms later
+    RunTime = 0;
+    RunTicks = 65;
+    SchedulerSignal(EVENT_ENDSTOP);
+    RunPass();
+    RunTicks = 0;
+    CHECK_EQUAL(TASK_TIME_OVERFLOW, Statistics->LastTime);
+    CHECK_EQUAL(TASK_TIME_OVERFLOW, Statistics->MaxTime);
+    RunTime = 200;
+    RunTicks = 64;
+    SchedulerSignal(EVENT_ENDSTOP);
+    RunPass();
+    RunTicks = 0;
+    CHECK(Statistics->LastTime >= 200 && Statistics->LastTime <= 205);
+
+    //the count stops at its largest value, a pass runs D and E then ends
+    SchedulerInitialise(&TestSchedule);
+    for(Runs = 0; Runs < 3UL * 70000; Runs++)
+    {
+        SchedulerRun(&TestSchedule);
+    }
+    CHECK_EQUAL(0xFFFF, SchedulerGetStatistics(3)->Runs);
+
+    SchedulerClearStatistics();
+    CHECK_EQUAL(0, Statistics->Runs);
+    CHECK_EQUAL(0, Statistics->MaxTime);
+    CHECK(SchedulerGetStatistics(SCHEDULER_MAX_TASKS) == SchedulerGetStatistics(0));
+}
+
+int main(void)
+{
+    TestOrder();
+    TestPreference();
+    TestStatistics();
+    return TestSummary("TestScheduler");
+}
@@ -0,0 +1,328 @@
+/*
+ * File: TestSoftTimer.c
+ * Author: Roger Berry
+ * Comments: The 1 ms tick, the master time out and the software timers.
+ *           The timing wheel is checked against a plain list of due ticks
+ *           through random starts, stops and late services.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include "Test.h"
+#include "Init.h"
+#include "SoftTimer.h"
+#include "Host.h"
+
+#define RANDOM_STEPS                200000  //random operations in the wheel test
+
+//define external global variables
+extern volatile unsigned int GLOBAL_TimerEventCounter;
+extern volatile unsigned int GLOBAL_MasterTimeOutFlag;
+
+//the expected state of one timer
+typedef struct
+{
+    unsigned int Running;
+    unsigned long Due;                      //tick it expires on
+    unsigned int Period;
+    unsigned int Expired;
+    unsigned long Calls;                    //handler calls
+} MODEL_TIMER;
+
+//define variables used in this file
+static unsigned long RandomSeed = 1;
+static MODEL_TIMER Model[SOFT_TIMER_COUNT];
+static unsigned long ModelTick;             //ticks counted by the interrupt
+static unsigned long ModelServiced;         //ticks dealt with by the service
+static unsigned long HandlerCalls[SOFT_TIMER_COUNT];
+static unsigned long Mismatches;
+static unsigned long Expiries;
+
+
+
+//***************************************************************
+//Repeatable pseudo random number from 0 to Range - 1
+
+static unsigned long    Random(unsigned long Range)
+{
+    RandomSeed = RandomSeed * 1103515245UL + 12345UL;
+    return ((RandomSeed >> 8) & 0xFFFFFFUL) % Range;
+}
+
+
+
+//***************************************************************
+//Count the ticks without running the service, as a slow main loop would
+
+static void    Ticks(unsigned int Count)
+{
+    unsigned int Sample;
+
+    while(Count != 0)
+    {
+        for(Sample = 0; Sample < TICK_SAMPLES; Sample++)
+        {
+            SoftTimerInterrupt();
+        }
+        Count--;
+    }
+}
+
+static void    Handler0(void)
+{
+    HandlerCalls[0]++;
+}
+
+static void    Handler1(void)
+{
+    HandlerCalls[1]++;
+}
+
+static void    Handler2(void)
+{
+    HandlerCalls[2]++;
+}
+
+static void    Handler3(void)
+{
+    HandlerCalls[3]++;
+}
+
+static void (* const Handlers[SOFT_TIMER_COUNT])(void) = {Handler0, Handler1, Handler2, Handler3};
+
+
+
+//***************************************************************
+//The tick is every 4th input sample and the master time out is counted
+//down on each tick
+
+static void    TestTick(void)
+{
+    unsigned int Tick;
+
+    InitialiseSoftTimers();
+    CHECK_EQUAL(0, GetTickCount());
+    SoftTimerInterrupt();
+    SoftTimerInterrupt();
+    SoftTimerInterrupt();
+    CHECK_EQUAL(0, GetTickCount());
+    SoftTimerInterrupt();
+    CHECK_EQUAL(1, GetTickCount());
+    Ticks(99);
+    CHECK_EQUAL(100, GetTickCount());
+
+    SetMasterTimeOut(5);
+    for(Tick = 1; Tick < 5; Tick++)
+    {
+        Ticks(1);
+        CHECK_EQUAL(0, GLOBAL_MasterTimeOutFlag);
+    }
+    Ticks(1);
+    CHECK_EQUAL(1, GLOBAL_MasterTimeOutFlag);
+    SetMasterTimeOut(5);
+    CHECK_EQUAL(0, GLOBAL_MasterTimeOutFlag);
+    SetMasterTimeOut(0);
+    Ticks(10);
+    CHECK_EQUAL(0, GLOBAL_MasterTimeOutFlag);
+}
+
+
+
+//***************************************************************
+//One shot, periodic and long timers expire on the tick they are due
+
+static void    TestTimers(void)
+{
+    unsigned int Tick;
+
+    InitialiseSoftTimers();
+    CHECK_EQUAL(SOFT_TIMER_INVALID, SoftTimerStart(SOFT_TIMER_COUNT, 1, 0, NULL));
+    CHECK_EQUAL(0, SoftTimerRunning(SOFT_TIMER_COUNT));
+    CHECK_EQUAL(0, SoftTimerExpired(SOFT_TIMER_COUNT));
+
+    //a delay longer than one turn of the wheel
+    CHECK_EQUAL(SOFT_TIMER_OK, SoftTimerStart(0, 1000, 0, NULL));
+    HostTick(999);
+    CHECK_EQUAL(1, SoftTimerRunning(0));
+    CHECK_EQUAL(0, SoftTimerExpired(0));
+    HostTick(1);
+    CHECK_EQUAL(0, SoftTimerRunning(0));
+    CHECK_EQUAL(1, SoftTimerExpired(0));
+    CHECK_EQUAL(0, SoftTimerExpired(0));
+
+    //periodic, every expiry is seen and handled
+    HandlerCalls[1] = 0;
+    SoftTimerStart(1, 3, 8, Handler1);
+    HostTick(2);
+    CHECK_EQUAL(0, HandlerCalls[1]);
+    HostTick(1);
+    CHECK_EQUAL(1, HandlerCalls[1]);
+    CHECK_EQUAL(1, SoftTimerExpired(1));
+    for(Tick = 0; Tick < 80; Tick++)
+    {
+        HostTick(1);
+    }
+    CHECK_EQUAL(11, HandlerCalls[1]);
+    CHECK_EQUAL(1, SoftTimerRunning(1));
+
+    //a slow main loop makes the timer late but no expiry is lost
+    Ticks(40);
+    SoftTimerService();
+    CHECK_EQUAL(16, HandlerCalls[1]);
+
+    //starting again clears the flag and the old delay
+    SoftTimerStart(1, 5, 0, NULL);
+    CHECK_EQUAL(0, SoftTimerExpired(1));
+    HostTick(4);
+    SoftTimerStart(1, 5, 0, NULL);
+    HostTick(4);
+    CHECK_EQUAL(0, SoftTimerExpired(1));
+    HostTick(1);
+    CHECK_EQUAL(1, SoftTimerExpired(1));
+
+    //a delay of 0 expires on the next tick
+    SoftTimerStart(2, 0, 0, NULL);
+    HostTick(1);
+    CHECK_EQUAL(1, SoftTimerExpired(2));
+
+    SoftTimerStart(3, 10, 0, NULL);
+    SoftTimerStop(3);
+    HostTick(20);
+    CHECK_EQUAL(0, SoftTimerRunning(3));
+    CHECK_EQUAL(0, SoftTimerExpired(3));
+}
+
+
+
+//***************************************************************
+//Check every timer against the model
+
+static void    Compare(void)
+{
+    unsigned int Timer;
+
+    for(Timer = 0; Timer < SOFT_TIMER_COUNT; Timer++)
+    {
+        if(SoftTimerRunning(Timer) != Model[Timer].Running || HandlerCalls[Timer] != Model[Timer].Calls)
+        {
+            Mismatches++;
+        }
+    }
+}
+
+//run the model service up to the ticks counted
+static void    ModelService(void)
+{
+    unsigned int Timer;
+
+    while(ModelServiced != ModelTick)
+    {
+        ModelServiced++;
+        for(Timer = 0; Timer < SOFT_TIMER_COUNT; Timer++)
+        {
+            if(Model[Timer].Running != 0 && Model[Timer].Due == ModelServiced)
+            {
+                Model[Timer].Expired = 1;
+                Model[Timer].Calls++;
+                Expiries++;
+                Model[Timer].Running = 0;
+                if(Model[Timer].Period != 0)
+                {
+                    Model[Timer].Running = 1;
+                    Model[Timer].Due = ModelServiced + Model[Timer].Period;
+                }
+            }
+        }
+    }
+}
+
+
+
+//***************************************************************
+//Random starts, stops, flag tests and ticks with the service sometimes
+//run late, several timers often share a slot of the wheel
+
+static void    TestRandom(void)
+{
+    unsigned long Step;
+    unsigned int Timer;
+    unsigned int Delay;
+    unsigned int Period;
+    unsigned int Count;
+
+    InitialiseSoftTimers();
+    for(Timer = 0; Timer < SOFT_TIMER_COUNT; Timer++)
+    {
+        Model[Timer].Running = 0;
+        Model[Timer].Expired = 0;
+        Model[Timer].Calls = 0;
+        HandlerCalls[Timer] = 0;
+    }
+    ModelTick = 0;
+    ModelServiced = 0;
+    Mismatches = 0;
+    Expiries = 0;
+
+    for(Step = 0; Step < RANDOM_STEPS; Step++)
+    {
+        Timer = (unsigned int)Random(SOFT_TIMER_COUNT);
+        switch(Random(6))
+        {
+            case 0:
+                //short delays land in the same slots, long ones go round
+                Delay = (unsigned int)Random(4) == 0 ? (unsigned int)Random(3000) : (unsigned int)Random(24);
+                Period = (unsigned int)Random(3) == 0 ? 1 + (unsigned int)Random(40) : 0;
+                SoftTimerStart(Timer, Delay, Period, Handlers[Timer]);
+                Model[Timer].Running = 1;
+                Model[Timer].Due = ModelServiced + (Delay == 0 ? 1 : Delay);
+                Model[Timer].Period = Period;
+                Model[Timer].Expired = 0;
+                break;
+
+            case 1:
+                SoftTimerStop(Timer);
+                Model[Timer].Running = 0;
+                Model[Timer].Expired = 0;
+                break;
+
+            case 2:
+                if(SoftTimerExpired(Timer) != Model[Timer].Expired)
+                {
+                    Mismatches++;
+                }
+                Model[Timer].Expired = 0;
+                break;
+
+            case 3:
+                //a late service, up to 100 ticks
+                Count = 1 + (unsigned int)Random(100);
+                Ticks(Count);
+                ModelTick = ModelTick + Count;
+                break;
+
+            default:
+                Count = 1 + (unsigned int)Random(3);
+                Ticks(Count);
+                ModelTick = ModelTick + Count;
+                SoftTimerService();
+                ModelService();
+                Compare();
+                break;
+        }
+    }
+    SoftTimerService();
+    ModelService();
+    Compare();
+
+    printf("%lu ticks, %lu expiries\n", ModelTick, Expiries);
+    CHECK(Expiries > 10000);
+    CHECK_EQUAL(0, Mismatches);
+}
+
+int main(void)
+{
+    TestTick();
+    TestTimers();
+    TestRandom();
+    return TestSummary("TestSoftTimer");
+}
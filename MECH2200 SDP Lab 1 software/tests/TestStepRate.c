@@ -0,0 +1,682 @@
+/*
+ * File: TestStepRate.c
+ * Author: Roger Berry
+ * Comments: Step rate of the Timer3 step interrupt.
+ *           Moves are run through the Timer3 model with the interrupt
+ *           entered late and taking time to run, as on the PIC. The step
+ *           interrupt is compared with a model of the handler it replaced,
+ *           which took two interrupts per step, one to set the step output
+ *           and one to clear it, and loaded the timer instead of adding to it.
+ *           The highest step rate each holds is measured for a range of
+ *           interrupt run times. The run times are estimates at 8 MIPS, the
+ *           host cannot time PIC code, so the table shows where each
+ *           handler runs out of time rather than the exact rate on target.
+ *           Moves with coarse steps are checked to change step mode without
+ *           the step interrupt waiting for the SPI.
+ *           The time of every step of trapezoid moves is printed in part
+ *           and checked against the ideal profile, t = sqrt(2n / a) while
+ *           the speed changes and n / v while cruising.
+ *           S curve moves are checked for the step count, a speed that
+ *           only rises to the peak and only falls after it, the peak rate
+ *           and the acceleration time.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "Test.h"
+#include "Init.h"
+#include "SPI.h"
+#include "Timer.h"
+#include "Motion.h"
+#include "Host.h"
+
+#define MOVE_STEPS                  3000    //steps in each measured move
+#define SWEEP_SLOWEST               400     //longest cruise interval tried in us
+#define ENTRY_LATENCY               3       //us from the overflow to the handler, HIGH_ISR flag tests included
+#define OLD_MIN_DELAY               200     //shortest interval of the two interrupt handler
+#define OLD_CLEAR_TIME              3       //us the old handler took to clear the step output
+#define RUN_TIME_COUNT              5
+#define COARSE_INTERVAL             70      //fine step interval in us that needs coarse steps
+#define COARSE_MOVES                6
+#define RECORD_STEPS                10000   //step times kept by RecordSteps
+#define TRAPEZOID_MOVES             6
+#define TRAPEZOID_END               1.5     //largest error of any step, in ideal first step times
+#define TRAPEZOID_MID               0.75    //largest error before the last steps
+#define TRAPEZOID_LAST              10      //steps at the end of the stop allowed the larger error
+#define SCURVE_MOVES                8
+#define SCURVE_PEAK                 0.01    //largest error of the peak rate, as a fraction
+#define SCURVE_RAMP_TIME            0.9     //shortest acceleration time, as a fraction of 2v / a
+
+//define external global variables
+extern volatile unsigned int GLOBAL_StepperMotorSpeed;
+
+//define variables used in this file
+static const unsigned int RunTimes[RUN_TIME_COUNT] = {20, 45, 90, 120, 150};   //us to make a step
+static unsigned int OldDelay;
+static unsigned char OldStepHigh;
+static unsigned long StepTimes[RECORD_STEPS];   //us from the first step
+
+//result of one measured move
+typedef struct
+{
+    unsigned long Steps;
+    unsigned long Interrupts;
+    unsigned long CruiseSteps;              //steps made at the cruise interval
+    unsigned long CruiseTime;               //us taken by those steps
+    unsigned long WrongIntervals;           //cruise steps not at the requested interval
+} STEP_RUN;
+
+//trapezoid move compared with the ideal profile
+typedef struct
+{
+    unsigned int Acceleration;              //steps/s/s
+    unsigned int Deceleration;
+    unsigned int Interval;                  //cruise interval in us
+    unsigned long Steps;
+} TRAPEZOID_MOVE;
+
+//ideal profile of a trapezoid move, distances in steps from the first
+typedef struct
+{
+    double AccelEnd;
+    double DecelStart;
+    double Speed;                           //steps/s reached
+    double Total;                           //s from the first to the last step
+} IDEAL_PROFILE;
+
+
+
+//***************************************************************
+//Model of the replaced handler at cruise speed, the first interrupt set
+//the step output, the second cleared it, each loaded the timer with half
+//the interval so the time taken to reach the interrupt was lost twice
+//returns the us from entering the interrupt to the next overflow
+
+static unsigned int    OldStepInterrupt(unsigned int Late)
+{
+    unsigned short Timer;
+
+    Timer = (unsigned short)Late;
+    OldStepHigh = !OldStepHigh;
+    Timer = (unsigned short)(0x10000UL - (OldDelay >> 1));
+    return (unsigned int)(0x10000UL - Timer);
+}
+
+
+
+//***************************************************************
+//Run the present move to its end. Each interrupt is entered
+//ENTRY_LATENCY us after the overflow or when the one before has
+//finished, whichever is later, and runs for RunTime us.
+
+static void    RunFirmware(unsigned int Interval, unsigned int Latency, unsigned int RunTime, STEP_RUN *Run)
+{
+    unsigned long Overflow;
+    unsigned long Entry;
+    unsigned long Exit = 0;
+    unsigned long LastStep = 0;
+    unsigned int Next;
+    unsigned int LastState = MOTION_STOPPED;
+    unsigned int State = MOTION_STOPPED;
+    signed long Position;
+
+    Run->Steps = 0;
+    Run->Interrupts = 0;
+    Run->CruiseSteps = 0;
+    Run->CruiseTime = 0;
+    Run->WrongIntervals = 0;
+    Position = MotionGetPosition();
+    Overflow = 0x10000UL - TIMER_3_TIME;
+    while(TIMER_3_ENABLE != 0 && Run->Interrupts < 4 * MOVE_STEPS)
+    {
+        Entry = Overflow + Latency;
+        if(Exit > Entry)
+        {
+            Entry = Exit;
+        }
+        Next = HostStepInterruptLate((unsigned int)(Entry - Overflow));
+        Run->Interrupts++;
+        if(MotionGetPosition() != Position)
+        {
+            Position = MotionGetPosition();
+            Run->Steps++;
+            //each interrupt loads the interval worked out by the one before,
+            //so a step is at the cruise interval if the interrupt two back
+            //was cruising
+            if(LastState == MOTION_CRUISE)
+            {
+                Run->CruiseSteps++;
+                Run->CruiseTime = Run->CruiseTime + (Entry - LastStep);
+                if(Entry - LastStep != Interval)
+                {
+                    Run->WrongIntervals++;
+                }
+            }
+            LastStep = Entry;
+        }
+        LastState = State;
+        State = MotionState();
+        if(Next == 0)
+        {
+            break;
+        }
+        Overflow = Entry + Next;
+        Exit = Entry + RunTime;
+    }
+}
+
+//move MOVE_STEPS at the passed cruise interval
+static void    MeasureFirmware(unsigned int Interval, unsigned int Latency, unsigned int RunTime, STEP_RUN *Run)
+{
+    InitialiseMotion();
+    MotionSetShape(MOTION_SHAPE_TRAPEZOID);
+    MotionSetModeSwitch(0);
+    MotionSetHardwareCruise(0);
+    MotionSetProfile(MAX_ACCELERATION, MAX_ACCELERATION);
+    MotionSetPosition(0);
+    GLOBAL_StepperMotorSpeed = Interval;
+    MotionMoveBy(MOVE_STEPS);
+    RunFirmware(Interval, Latency, RunTime, Run);
+}
+
+//the old handler cruising for MOVE_STEPS, the step is made by the
+//interrupt that sets the output, the other only clears it
+static void    MeasureOld(unsigned int Interval, unsigned int Latency, unsigned int RunTime, STEP_RUN *Run)
+{
+    unsigned long Overflow = 0;
+    unsigned long Entry;
+    unsigned long Exit = 0;
+    unsigned long LastStep = 0;
+
+    OldDelay = Interval;
+    OldStepHigh = 0;
+    Run->Steps = 0;
+    Run->Interrupts = 0;
+    Run->CruiseSteps = 0;
+    Run->CruiseTime = 0;
+    Run->WrongIntervals = 0;
+    while(Run->Steps < MOVE_STEPS || OldStepHigh != 0)
+    {
+        Entry = Overflow + Latency;
+        if(Exit > Entry)
+        {
+            Entry = Exit;
+        }
+        Overflow = Entry + OldStepInterrupt((unsigned int)(Entry - Overflow));
+        Run->Interrupts++;
+        if(OldStepHigh != 0)
+        {
+            if(Run->Steps != 0)
+            {
+                Run->CruiseSteps++;
+                Run->CruiseTime = Run->CruiseTime + (Entry - LastStep);
+                if(Entry - LastStep != Interval)
+                {
+                    Run->WrongIntervals++;
+                }
+            }
+            Run->Steps++;
+            LastStep = Entry;
+            Exit = Entry + RunTime;
+        }
+        else
+        {
+            Exit = Entry + OLD_CLEAR_TIME;
+        }
+    }
+}
+
+static unsigned long    CruiseRate(const STEP_RUN *Run)
+{
+    if(Run->CruiseTime == 0)
+    {
+        return 0;
+    }
+    return (Run->CruiseSteps * MOTION_TIMER_FREQUENCY + Run->CruiseTime / 2) / Run->CruiseTime;
+}
+
+
+
+//***************************************************************
+//Every step takes one interrupt and the cruise interval is held exactly
+//however late the interrupt is entered, as the interval is added to the
+//timer
+
+static void    TestInterval(void)
+{
+    STEP_RUN Run;
+    unsigned int Latency;
+
+    for(Latency = 0; Latency <= 30; Latency = Latency + 10)
+    {
+        MeasureFirmware(MOTION_MIN_DELAY, Latency, 20, &Run);
+        CHECK_EQUAL(MOVE_STEPS, Run.Steps);
+        CHECK_EQUAL(Run.Steps, Run.Interrupts);
+        CHECK(Run.CruiseSteps > MOVE_STEPS / 2);
+        CHECK_EQUAL(0, Run.WrongIntervals);
+        CHECK_EQUAL(MOTION_TIMER_FREQUENCY / MOTION_MIN_DELAY, CruiseRate(&Run));
+        CHECK_EQUAL(0, TIMER_3_ENABLE);
+
+        //the old handler lost the latency on both interrupts
+        MeasureOld(OLD_MIN_DELAY, Latency, 20, &Run);
+        CHECK_EQUAL(2 * Run.Steps, Run.Interrupts);
+        CHECK_EQUAL((MOTION_TIMER_FREQUENCY + (OLD_MIN_DELAY + 2 * Latency) / 2) / (OLD_MIN_DELAY + 2 * Latency), CruiseRate(&Run));
+    }
+}
+
+
+
+//***************************************************************
+//Highest cruise rate held with every step at the requested interval,
+//for each interrupt run time, from the slowest interval down to the
+//shortest each handler allows
+
+static void    TestHighestRate(void)
+{
+    STEP_RUN Run;
+    unsigned int Index;
+    unsigned int Interval;
+    unsigned int RunTime;
+    unsigned long Rate;
+    unsigned long OldBest;
+    unsigned long NewBest;
+    unsigned long NewInterrupts;
+
+    printf("step time  before steps/s  interrupts/s  after steps/s  interrupts/s\n");
+    for(Index = 0; Index < RUN_TIME_COUNT; Index++)
+    {
+        RunTime = RunTimes[Index];
+        OldBest = 0;
+        NewBest = 0;
+        NewInterrupts = 0;
+        for(Interval = SWEEP_SLOWEST; Interval >= MOTION_MIN_DELAY; Interval--)
+        {
+            if(Interval >= OLD_MIN_DELAY)
+            {
+                //the old handler slows down instead of losing steps
+                MeasureOld(Interval, ENTRY_LATENCY, RunTime, &Run);
+                Rate = CruiseRate(&Run);
+                if(Rate > OldBest)
+                {
+                    OldBest = Rate;
+                }
+            }
+            MeasureFirmware(Interval, ENTRY_LATENCY, RunTime, &Run);
+            Rate = CruiseRate(&Run);
+            if(Run.Steps == MOVE_STEPS && Run.WrongIntervals == 0 && Rate > NewBest)
+            {
+                NewBest = Rate;
+                NewInterrupts = Rate * Run.Interrupts / Run.Steps;
+            }
+        }
+        printf("%6u us  %14lu  %12lu  %13lu  %12lu\n", RunTime, OldBest, 2 * OldBest, NewBest, NewInterrupts);
+
+        //one interrupt per step, the rate is limited by MOTION_MIN_DELAY
+        //until the step takes longer than that, the entry latency only
+        //delays every step by the same time
+        CHECK_EQUAL(NewBest, NewInterrupts);
+        CHECK(NewBest > OldBest);
+        if(RunTime <= MOTION_MIN_DELAY)
+        {
+            CHECK_EQUAL(MOTION_TIMER_FREQUENCY / MOTION_MIN_DELAY, NewBest);
+        }
+        else
+        {
+            CHECK_EQUAL((MOTION_TIMER_FREQUENCY + RunTime / 2) / RunTime, NewBest);
+        }
+    }
+}
+
+//***************************************************************
+//Moves fast enough for coarse steps end at the exact position with the
+//driver back on fine steps. The step mode writes are only queued by the
+//step interrupt, no SPI byte is exchanged inside it, and a pulse is only
+//held back while a write is on the bus.
+
+static void    TestModeSwitch(void)
+{
+    static const signed long Moves[COARSE_MOVES] = {3001, -2999, 40, 5000, -1, -5041};
+    STEP_RUN Run;
+    unsigned int Index;
+    unsigned long SPIBytes;
+    signed long Target = 0;
+    
+    InitialiseMotion();
+    MotionSetShape(MOTION_SHAPE_TRAPEZOID);
+    MotionSetModeSwitch(1);
+    MotionSetHardwareCruise(0);
+    MotionSetProfile(MAX_ACCELERATION, MAX_ACCELERATION);
+    MotionSetPosition(0);
+    GLOBAL_StepperMotorSpeed = COARSE_INTERVAL;
+    SPIBytes = HostStepSPIBytes();
+    for(Index = 0; Index < COARSE_MOVES; Index++)
+    {
+        Target = Target + Moves[Index];
+        MotionMoveBy(Moves[Index]);
+        RunFirmware(COARSE_INTERVAL << MOTION_COARSE_SHIFT, 0, 20, &Run);
+        CHECK_EQUAL(0, TIMER_3_ENABLE);
+        CHECK_EQUAL(Target, MotionGetPosition());
+        CHECK_EQUAL(MOTION_FINE_MODE, GetDRV8711Shadow(DRV_CTRL_REG) & STEP_MASK);
+        //each change of mode holds back at most one pulse
+        CHECK(Run.Interrupts <= Run.Steps + 2);
+        if(Moves[Index] > 1000 || Moves[Index] < -1000)
+        {
+            //coarse steps were used
+            CHECK(Run.Steps < (unsigned long)(Moves[Index] > 0 ? Moves[Index] : -Moves[Index]));
+        }
+    }
+    CHECK_EQUAL(SPIBytes, HostStepSPIBytes());
+    MotionSetModeSwitch(0);
+}
+
+//***************************************************************
+//Run the present move with no interrupt latency and keep the time of
+//every step in us from the first, returns the number of steps
+
+static unsigned long    RecordSteps(void)
+{
+    unsigned long Time;
+    unsigned long Count = 0;
+    unsigned int Next;
+    signed long Position;
+
+    Position = MotionGetPosition();
+    Time = 0x10000UL - TIMER_3_TIME;
+    while(TIMER_3_ENABLE != 0)
+    {
+        Next = HostStepInterrupt();
+        if(MotionGetPosition() != Position)
+        {
+            Position = MotionGetPosition();
+            if(Count < RECORD_STEPS)
+            {
+                StepTimes[Count] = Time;
+            }
+            Count++;
+        }
+        if(Next == 0)
+        {
+            break;
+        }
+        Time = Time + Next;
+    }
+    for(Next = 1; Next < Count && Next < RECORD_STEPS; Next++)
+    {
+        StepTimes[Next] = StepTimes[Next] - StepTimes[0];
+    }
+    StepTimes[0] = 0;
+    return Count;
+}
+
+//start the passed trapezoid move from position 0
+static void    StartTrapezoid(const TRAPEZOID_MOVE *Move)
+{
+    InitialiseMotion();
+    MotionSetShape(MOTION_SHAPE_TRAPEZOID);
+    MotionSetModeSwitch(0);
+    MotionSetHardwareCruise(0);
+    MotionSetProfile(Move->Acceleration, Move->Deceleration);
+    MotionSetPosition(0);
+    GLOBAL_StepperMotorSpeed = Move->Interval;
+    MotionMoveBy((signed long)Move->Steps);
+}
+
+//work out the ideal trapezoid, the steps from the first to the end of
+//the acceleration and to the start of the deceleration, the cruise
+//speed reached and the time of the last step
+static void    IdealTrapezoid(const TRAPEZOID_MOVE *Move, IDEAL_PROFILE *Ideal)
+{
+    double Distance;
+    double DecelSteps;
+
+    Distance = (double)(Move->Steps - 1);
+    Ideal->Speed = (double)MOTION_TIMER_FREQUENCY / Move->Interval;
+    Ideal->AccelEnd = Ideal->Speed * Ideal->Speed / (2.0 * Move->Acceleration);
+    DecelSteps = Ideal->Speed * Ideal->Speed / (2.0 * Move->Deceleration);
+    if(Ideal->AccelEnd + DecelSteps > Distance)
+    {
+        //the cruise speed is not reached
+        Ideal->AccelEnd = Distance * Move->Deceleration / (Move->Acceleration + Move->Deceleration);
+        DecelSteps = Distance - Ideal->AccelEnd;
+        Ideal->Speed = sqrt(2.0 * Move->Acceleration * Ideal->AccelEnd);
+    }
+    Ideal->DecelStart = Distance - DecelSteps;
+    Ideal->Total = Ideal->Speed / Move->Acceleration + (Ideal->DecelStart - Ideal->AccelEnd) / Ideal->Speed
+                   + Ideal->Speed / Move->Deceleration;
+}
+
+//time of the passed step in us from the first, t = sqrt(2n / a) up to
+//the cruise speed, n / v at it and the same backwards from the last step
+static double   IdealStepTime(const TRAPEZOID_MOVE *Move, const IDEAL_PROFILE *Ideal, unsigned long Step)
+{
+    if(Step <= Ideal->AccelEnd)
+    {
+        return 1e6 * sqrt(2.0 * Step / Move->Acceleration);
+    }
+    if(Step >= Ideal->DecelStart)
+    {
+        return 1e6 * (Ideal->Total - sqrt(2.0 * ((double)(Move->Steps - 1) - Step) / Move->Deceleration));
+    }
+    return 1e6 * (Ideal->Speed / Move->Acceleration + (Step - Ideal->AccelEnd) / Ideal->Speed);
+}
+
+
+
+//***************************************************************
+//Every step of a trapezoid move is compared with the ideal profile.
+//The first interval is 0.676 of the ideal sqrt(2 / a), AVR446 equation
+//15, so the recurrence follows the ideal intervals from the second step
+//on, and the stop mirrors the start. With FirstStep the ideal time of
+//the first step, sqrt(2 / a) at the lower rate, every step is within
+//TRAPEZOID_END * FirstStep of the ideal and all but the last
+//TRAPEZOID_LAST within TRAPEZOID_MID * FirstStep. Every interval of the
+//ideal cruise is within 1 us of the requested interval, the recurrence
+//comes down to it over a few steps and TestInterval checks the steps the
+//interrupt makes in its cruise state are exact.
+
+static void    TestTrapezoid(void)
+{
+    static const TRAPEZOID_MOVE Moves[TRAPEZOID_MOVES] =
+    {
+        {20000, 20000, 250, 4000},
+        {2000, 2000, 500, 3000},
+        {20000, 10000, 125, 6000},
+        {10000, 40000, 200, 3000},
+        {60000, 60000, 125, 5000},
+        {20000, 20000, 250, 300}        //no cruise
+    };
+    const TRAPEZOID_MOVE *Move;
+    IDEAL_PROFILE Ideal;
+    unsigned int Index;
+    unsigned long Step;
+    unsigned long Count;
+    unsigned long Wrong;
+    unsigned long Interval;
+    double Time;
+    double Error;
+    double WorstEnd;
+    double WorstMid;
+    double FirstStep;
+
+    for(Index = 0; Index < TRAPEZOID_MOVES; Index++)
+    {
+        Move = &Moves[Index];
+        StartTrapezoid(Move);
+        Count = RecordSteps();
+        CHECK_EQUAL(Move->Steps, Count);
+        CHECK_EQUAL((signed long)Move->Steps, MotionGetPosition());
+        if(Count > RECORD_STEPS)
+        {
+            Count = RECORD_STEPS;
+        }
+
+        IdealTrapezoid(Move, &Ideal);
+        FirstStep = 1e6 * sqrt(2.0 / (Move->Acceleration < Move->Deceleration ? Move->Acceleration : Move->Deceleration));
+        WorstEnd = 0;
+        WorstMid = 0;
+        Wrong = 0;
+        printf("a %u d %u steps/s/s, cruise %u us, %lu steps\n", Move->Acceleration, Move->Deceleration, Move->Interval, Move->Steps);
+        for(Step = 0; Step < Count; Step++)
+        {
+            Time = IdealStepTime(Move, &Ideal, Step);
+            Error = (double)StepTimes[Step] - Time;
+            if(fabs(Error) > WorstEnd)
+            {
+                WorstEnd = fabs(Error);
+            }
+            if(Step + TRAPEZOID_LAST < Count && fabs(Error) > WorstMid)
+            {
+                WorstMid = fabs(Error);
+            }
+            if(Step < 3 || Step % 1000 == 0 || Step + 3 > Count)
+            {
+                printf("  step %5lu  %8lu us  ideal %8.0f us  error %6.0f us\n", Step, StepTimes[Step], Time, Error);
+            }
+            if(Step > Ideal.AccelEnd + 1 && Step + 1 < Ideal.DecelStart)
+            {
+                Interval = StepTimes[Step] - StepTimes[Step - 1];
+                if(Interval < Move->Interval || Interval > Move->Interval + 1)
+                {
+                    Wrong++;
+                }
+            }
+        }
+        printf("  largest error %.0f us, %.0f us before the last %u steps, ideal first step %.0f us\n", WorstEnd, WorstMid, TRAPEZOID_LAST, FirstStep);
+        CHECK(WorstEnd <= TRAPEZOID_END * FirstStep);
+        CHECK(WorstMid <= TRAPEZOID_MID * FirstStep);
+        CHECK_EQUAL(0, Wrong);
+    }
+}
+
+
+
+//***************************************************************
+//S curve moves, the step count, the speed only rising up to the peak
+//and only falling after it, the peak rate and the ramp time, which is
+//2v / a when the acceleration set is the peak
+
+static void    TestSCurve(void)
+{
+    static const TRAPEZOID_MOVE Moves[SCURVE_MOVES] =
+    {
+        {20000, 20000, 250, 4000},
+        {2000, 2000, 500, 3000},       //cruise speed not reached
+        {20000, 10000, 125, 6000},     //cruise speed not reached
+        {10000, 40000, 200, 3000},     //cruise speed not reached
+        {60000, 60000, 125, 5000},
+        {20000, 20000, 250, 300},      //cruise speed not reached
+        {20000, 20000, 250, 20},
+        {20000, 20000, 250, 2}
+    };
+    const TRAPEZOID_MOVE *Move;
+    unsigned int Index;
+    unsigned long Count;
+    unsigned long Step;
+    unsigned long Interval;
+    unsigned long Last;
+    unsigned long Peak;
+    unsigned long PeakFirst;
+    unsigned long PeakLast;
+    unsigned long Wrong;
+    double Harmonic;
+    double Speed;
+    double RampTime;
+
+    for(Index = 0; Index < SCURVE_MOVES; Index++)
+    {
+        Move = &Moves[Index];
+        InitialiseMotion();
+        MotionSetShape(MOTION_SHAPE_SCURVE);
+        MotionSetModeSwitch(0);
+        MotionSetHardwareCruise(0);
+        MotionSetProfile(Move->Acceleration, Move->Deceleration);
+        MotionSetPosition(0);
+        GLOBAL_StepperMotorSpeed = Move->Interval;
+        MotionMoveBy((signed long)Move->Steps);
+        Count = RecordSteps();
+        CHECK_EQUAL(Move->Steps, Count);
+        CHECK_EQUAL((signed long)Move->Steps, MotionGetPosition());
+        if(Count > RECORD_STEPS)
+        {
+            Count = RECORD_STEPS;
+        }
+
+        //shortest interval and the first and last step made at it
+        Peak = 0xFFFFFFFFUL;
+        PeakFirst = 0;
+        PeakLast = 0;
+        for(Step = 1; Step < Count; Step++)
+        {
+            Interval = StepTimes[Step] - StepTimes[Step - 1];
+            if(Interval < Peak)
+            {
+                Peak = Interval;
+                PeakFirst = Step;
+            }
+            if(Interval == Peak)
+            {
+                PeakLast = Step;
+            }
+        }
+
+        //intervals only fall to the peak, are within 1 us of it between
+        //the ramps and only rise after it
+        Wrong = 0;
+        Last = 0xFFFFFFFFUL;
+        for(Step = 1; Step < Count; Step++)
+        {
+            Interval = StepTimes[Step] - StepTimes[Step - 1];
+            if(Step <= PeakFirst && Interval > Last)
+            {
+                Wrong++;
+            }
+            if(Step > PeakFirst && Step <= PeakLast && Interval > Peak + 1)
+            {
+                Wrong++;
+            }
+            if(Step > PeakLast && Interval < Last)
+            {
+                Wrong++;
+            }
+            Last = Interval;
+        }
+
+        //the peak is the cruise speed or the speed both ramps reach in
+        //the move, v * v / a + v * v / d = steps
+        Harmonic = (double)Move->Acceleration * Move->Deceleration / (Move->Acceleration + Move->Deceleration);
+        Speed = (double)MOTION_TIMER_FREQUENCY / Move->Interval;
+        if(Speed * Speed / Harmonic > Move->Steps - 1)
+        {
+            Speed = sqrt((Move->Steps - 1) * Harmonic);
+        }
+        RampTime = 2.0 * MOTION_TIMER_FREQUENCY * Speed / Move->Acceleration;
+        printf("S curve a %u d %u steps/s/s, cruise %u us, %lu steps: peak %lu us, ideal %.0f us, ramp %lu us, ideal %.0f us\n",
+               Move->Acceleration, Move->Deceleration, Move->Interval, Move->Steps, Peak, MOTION_TIMER_FREQUENCY / Speed,
+               StepTimes[PeakFirst], RampTime);
+        CHECK_EQUAL(0, Wrong);
+        CHECK(Peak >= Move->Interval);
+        CHECK(fabs((double)MOTION_TIMER_FREQUENCY / Peak - Speed) <= SCURVE_PEAK * Speed);
+        //too few steps for every segment to have one
+        if(PeakFirst >= MOTION_SEGMENTS)
+        {
+            CHECK(StepTimes[PeakFirst] >= SCURVE_RAMP_TIME * RampTime);
+            CHECK(StepTimes[PeakFirst] <= RampTime);
+        }
+    }
+}
+
+
+
+int main(void)
+{
+    INTCONbits.GIE = 0;
+    InitialiseSPI();
+    InitialiseDRV8711();
+    TestInterval();
+    TestHighestRate();
+    TestModeSwitch();
+    TestTrapezoid();
+    TestSCurve();
+    return TestSummary("TestStepRate");
+}
@@ -0,0 +1,329 @@
+/*
+ * File: TestStrings.c
+ * Author: Roger Berry
+ * Comments: The overflow checked number parsers and the line reader.
+ *           StringToUnsigned is checked for every value up to 6 digits,
+ *           StringToFixed for every string of up to 7 characters from
+ *           "0", "1", "9", "." and "-" against a plain reference parser,
+ *           and both at the edges of their range.
+ * Revision history: 1.0 15/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Test.h"
+#include "Init.h"
+#include "Comms.h"
+#include "Host.h"
+
+#define ALPHABET_LENGTH             5       //characters the fixed point strings are built from
+#define STRING_MAX                  7       //longest string built
+
+//define external global variables
+extern volatile unsigned int GLOBAL_MasterTimeOutFlag;
+
+//define variables used in this file
+static const char Alphabet[ALPHABET_LENGTH] = {'0', '1', '9', '.', '-'};
+static volatile unsigned char String[RX_STRING_LENGTH];
+static unsigned long Mismatches;
+
+
+
+//***************************************************************
+//Copy a C string into the firmware's string type
+
+static volatile unsigned char  *Load(const char *Text)
+{
+    unsigned int Index;
+
+    for(Index = 0; Text[Index] != 0 && Index < RX_STRING_LENGTH - 1; Index++)
+    {
+        String[Index] = (unsigned char)Text[Index];
+    }
+    String[Index] = 0;
+    return String;
+}
+
+//the fixed point result of a string with an optional minus sign, digits
+//and one decimal point, worked out in 64 bits
+static unsigned int    ReferenceFixed(const char *Text, unsigned int Decimals, long long *Result)
+{
+    long long Value = 0;
+    unsigned int Negative = 0;
+    unsigned int Point = 0;
+    unsigned int Digits = 0;
+    unsigned int Fraction = 0;
+
+    if(*Text == '-')
+    {
+        Negative = 1;
+        Text++;
+    }
+    for(; *Text != 0; Text++)
+    {
+        if(*Text == '.')
+        {
+            if(Point != 0)
+            {
+                return INVALID_STRING;
+            }
+            Point = 1;
+            continue;
+        }
+        if(*Text < '0' || *Text > '9')
+        {
+            return INVALID_STRING;
+        }
+        if(Point != 0)
+        {
+            Fraction++;
+            if(Fraction > Decimals)
+            {
+                return INVALID_STRING;
+            }
+        }
+        Digits++;
+        Value = Value * 10 + (*Text - '0');
+    }
+    if(Digits == 0)
+    {
+        return NO_DATA;
+    }
+    for(; Fraction < Decimals; Fraction++)
+    {
+        Value = Value * 10;
+    }
+    if(Value > 0x7FFFFFFFLL + Negative)
+    {
+        return VALUE_TOO_LARGE;
+    }
+    *Result = Negative != 0 ? -Value : Value;
+    return STRING_OK;
+}
+
+
+
+//***************************************************************
+//Every value of up to 6 digits, with and without a leading zero, is
+//read or rejected as too large, the result is left alone on an error
+
+static void    TestUnsigned(void)
+{
+    unsigned long Value;
+    unsigned int Result;
+    unsigned int Status;
+    char Text[16];
+
+    Mismatches = 0;
+    for(Value = 0; Value <= 999999; Value++)
+    {
+        sprintf(Text, "%lu", Value);
+        Result = 0xABCD;
+        Status = StringToUnsigned(Load(Text), &Result);
+        if(Value <= 0xFFFF ? (Status != STRING_OK || Result != Value) : (Status != VALUE_TOO_LARGE || Result != 0xABCD))
+        {
+            Mismatches++;
+        }
+        sprintf(Text, "0%lu", Value);
+        Status = StringToUnsigned(Load(Text), &Result);
+        if(Value <= 0xFFFF ? (Status != STRING_OK || Result != Value) : Status != VALUE_TOO_LARGE)
+        {
+            Mismatches++;
+        }
+    }
+    CHECK_EQUAL(0, Mismatches);
+
+    Result = 0xABCD;
+    CHECK_EQUAL(NO_DATA, StringToUnsigned(Load(""), &Result));
+    CHECK_EQUAL(INVALID_STRING, StringToUnsigned(Load("12a"), &Result));
+    CHECK_EQUAL(INVALID_STRING, StringToUnsigned(Load("-1"), &Result));
+    CHECK_EQUAL(INVALID_STRING, StringToUnsigned(Load("1.0"), &Result));
+    CHECK_EQUAL(INVALID_STRING, StringToUnsigned(Load(" 1"), &Result));
+    CHECK_EQUAL(0xABCD, Result);
+    CHECK_EQUAL(STRING_OK, StringToUnsigned(Load("0000000000065535"), &Result));
+    CHECK_EQUAL(65535, Result);
+    CHECK_EQUAL(VALUE_TOO_LARGE, StringToUnsigned(Load("99999999999999999999"), &Result));
+
+    //the old call saturates so range checks still reject large entries
+    CHECK_EQUAL(65535, StringToInteger(Load("65536")));
+    CHECK_EQUAL(65535, StringToInteger(Load("4294967296")));
+    CHECK_EQUAL(1234, StringToInteger(Load("1234")));
+    //empty and invalid strings give 0, as the old call did for an empty one
+    CHECK_EQUAL(0, StringToInteger(Load("")));
+    CHECK_EQUAL(0, StringToInteger(Load(".")));
+    CHECK_EQUAL(0, StringToInteger(Load("12a")));
+}
+
+
+
+//***************************************************************
+//Every string of up to 7 characters from the alphabet with 0 to 3
+//decimals matches the reference
+
+static void    TestFixedStrings(void)
+{
+    unsigned int Digit[STRING_MAX];
+    unsigned int Length;
+    unsigned int Index;
+    unsigned int Decimals;
+    unsigned int Status;
+    unsigned int Expected;
+    unsigned long Count = 0;
+    signed long Result;
+    long long Reference = 0;
+    char Text[STRING_MAX + 1];
+
+    Mismatches = 0;
+    for(Length = 0; Length <= STRING_MAX; Length++)
+    {
+        memset(Digit, 0, sizeof(Digit));
+        do
+        {
+            for(Index = 0; Index < Length; Index++)
+            {
+                Text[Index] = Alphabet[Digit[Index]];
+            }
+            Text[Length] = 0;
+            for(Decimals = 0; Decimals <= 3; Decimals++)
+            {
+                Result = 0x5A5A;
+                Status = StringToFixed(Load(Text), Decimals, &Result);
+                Expected = ReferenceFixed(Text, Decimals, &Reference);
+                if(Status != Expected || (Status == STRING_OK && Result != Reference) || (Status != STRING_OK && Result != 0x5A5A))
+                {
+                    if(Mismatches < 10)
+                    {
+                        printf("\"%s\" %u decimals: status %X result %ld, expected %X %lld\n", Text, Decimals, Status, Result, Expected, Reference);
+                    }
+                    Mismatches++;
+                }
+                Count++;
+            }
+
+            //next string, counting in base 5
+            for(Index = 0; Index < Length; Index++)
+            {
+                Digit[Index]++;
+                if(Digit[Index] < ALPHABET_LENGTH)
+                {
+                    break;
+                }
+                Digit[Index] = 0;
+            }
+        }
+        while(Index < Length);
+    }
+    printf("%lu fixed point strings checked\n", Count);
+    CHECK_EQUAL(0, Mismatches);
+}
+
+
+
+//***************************************************************
+//The signed 32 bit limits with and without decimals
+
+static void    TestFixedLimits(void)
+{
+    signed long Result;
+
+    CHECK_EQUAL(STRING_OK, StringToFixed(Load("2147483647"), 0, &Result));
+    CHECK_EQUAL(2147483647L, Result);
+    CHECK_EQUAL(VALUE_TOO_LARGE, StringToFixed(Load("2147483648"), 0, &Result));
+    CHECK_EQUAL(STRING_OK, StringToFixed(Load("-2147483648"), 0, &Result));
+    CHECK_EQUAL(-2147483647L - 1, Result);
+    CHECK_EQUAL(VALUE_TOO_LARGE, StringToFixed(Load("-2147483649"), 0, &Result));
+    CHECK_EQUAL(STRING_OK, StringToFixed(Load("21474836.47"), 2, &Result));
+    CHECK_EQUAL(2147483647L, Result);
+    CHECK_EQUAL(VALUE_TOO_LARGE, StringToFixed(Load("21474836.48"), 2, &Result));
+    //the padding zeros count towards the limit
+    CHECK_EQUAL(VALUE_TOO_LARGE, StringToFixed(Load("21474837"), 2, &Result));
+    CHECK_EQUAL(STRING_OK, StringToFixed(Load("-21474836.48"), 2, &Result));
+    CHECK_EQUAL(-2147483647L - 1, Result);
+    CHECK_EQUAL(STRING_OK, StringToFixed(Load("000000000000012.5"), 2, &Result));
+    CHECK_EQUAL(1250, Result);
+    CHECK_EQUAL(STRING_OK, StringToFixed(Load("-.05"), 2, &Result));
+    CHECK_EQUAL(-5, Result);
+    CHECK_EQUAL(STRING_OK, StringToFixed(Load("7."), 2, &Result));
+    CHECK_EQUAL(700, Result);
+}
+
+
+
+//***************************************************************
+//ReadLine echoes what it keeps, marks characters past the length with
+//X, handles backspace and reports the string status on CR
+
+static unsigned int    Line(LINE_READER *Reader, const char *Typed, unsigned int Length, unsigned int Mode)
+{
+    unsigned int Status;
+
+    StartLine(Reader, String, Length, Mode);
+    HostClearTransmitted();
+    HostReceive(Typed);
+    Status = ReadLine(Reader);
+    HostTransmit();
+    return Status;
+}
+
+static void    TestReadLine(void)
+{
+    LINE_READER Reader;
+
+    InitialiseComms();
+    HostTransmit();
+    while(GetChar() != 0xFFFF)
+    {
+    }
+    GLOBAL_MasterTimeOutFlag = 0;
+
+    //nothing yet, then the rest of the line
+    StartLine(&Reader, String, 5, LINE_INTEGER);
+    HostReceive("12");
+    CHECK_EQUAL(LINE_PENDING, ReadLine(&Reader));
+    HostReceive("3\r");
+    CHECK_EQUAL(STRING_OK, ReadLine(&Reader));
+    CHECK(strcmp((const char *)String, "123") == 0);
+    HostTransmit();
+
+    CHECK_EQUAL(STRING_OK, Line(&Reader, "1a2 b3\r", 5, LINE_INTEGER));
+    CHECK(strcmp((const char *)String, "123") == 0);
+    CHECK(strcmp(HostTransmitted(), "123") == 0);
+
+    CHECK_EQUAL(TOO_LONG, Line(&Reader, "12345\r", 3, LINE_INTEGER));
+    CHECK(strcmp(HostTransmitted(), "123XX") == 0);
+    //backspace takes off the rejected characters first
+    CHECK_EQUAL(STRING_OK, Line(&Reader, "12345\b\b\b\r", 3, LINE_INTEGER));
+    CHECK(strcmp((const char *)String, "12") == 0);
+    CHECK(strcmp(HostTransmitted(), "123XX\b \b\b \b\b \b") == 0);
+    CHECK_EQUAL(NO_DATA, Line(&Reader, "1\x7F\r", 3, LINE_INTEGER));
+    CHECK_EQUAL(NO_DATA, Line(&Reader, "\b\r", 3, LINE_INTEGER));
+
+    //decimal lines take one leading minus sign and decimal points
+    CHECK_EQUAL(STRING_OK, Line(&Reader, "-1-2.5\r", 7, LINE_DECIMAL));
+    CHECK(strcmp((const char *)String, "-12.5") == 0);
+    CHECK_EQUAL(STRING_OK, Line(&Reader, "-1.5\r", 7, LINE_INTEGER));
+    CHECK(strcmp((const char *)String, "15") == 0);
+    CHECK_EQUAL(INVALID_STRING, Line(&Reader, "1.2.3\r", 7, LINE_DECIMAL));
+    //a decimal point taken off is no longer counted
+    CHECK_EQUAL(STRING_OK, Line(&Reader, "1.\b2.3\r", 7, LINE_DECIMAL));
+    CHECK(strcmp((const char *)String, "12.3") == 0);
+
+    //the master time out ends the line
+    StartLine(&Reader, String, 5, LINE_INTEGER);
+    HostReceive("12");
+    GLOBAL_MasterTimeOutFlag = 1;
+    CHECK_EQUAL(TIME_OUT, ReadLine(&Reader));
+    GLOBAL_MasterTimeOutFlag = 0;
+    while(GetChar() != 0xFFFF)
+    {
+    }
+}
+
+int main(void)
+{
+    TestUnsigned();
+    TestFixedStrings();
+    TestFixedLimits();
+    TestReadLine();
+    return TestSummary("TestStrings");
+}
@@ -0,0 +1,278 @@
+/*
+ * File: xc.h
+ * Author: Roger Berry
+ * Comments: Host stand in for the XC8 processor header so the firmware
+ *           modules can be built and tested on a PC. Each special function
+ *           register is an ordinary variable, only the registers and bits
+ *           the firmware uses are declared. Bit widths are as the PIC16F1779.
+ * Revision history: 1.0 15/10/2026
+ */
+
+// This is a guard condition so that contents of this file are not included
+// more than once.
+#ifndef XC_H
+#define	XC_H
+
+#include <stddef.h>
+
+//the firmware uses NULL as 0, as Comms.h defines it
+#undef NULL
+#define NULL 0
+
+//compiler keywords and built in functions with no host meaning
+#define __interrupt(...)
+#define NOP()
+
+//registers are declared here and defined once in Registers.c
+#ifndef SFR_STORAGE
+#define SFR_STORAGE extern
+#endif
+#define SFR(Type, Name)     SFR_STORAGE volatile Type Name
+
+//bit addressable registers
+typedef struct {unsigned ADON:1; unsigned CHS:6; unsigned GO:1;} ADCON0bits_t;
+SFR(ADCON0bits_t, ADCON0bits);
+typedef struct {unsigned ADCS:3; unsigned ADFM:1; unsigned ADNREF:1; unsigned ADPREF:2;} ADCON1bits_t;
+SFR(ADCON1bits_t, ADCON1bits);
+typedef struct {unsigned TRIGSEL:6;} ADCON2bits_t;
+SFR(ADCON2bits_t, ADCON2bits);
+typedef struct {unsigned ANSA0:1; unsigned ANSA1:1;} ANSELAbits_t;
+SFR(ANSELAbits_t, ANSELAbits);
+typedef struct {unsigned ANSB0:1; unsigned ANSB1:1; unsigned ANSB2:1; unsigned ANSB3:1; unsigned ANSB4:1; unsigned ANSB5:1;} ANSELBbits_t;
+SFR(ANSELBbits_t, ANSELBbits);
+typedef struct {unsigned ANSC4:1; unsigned ANSC5:1; unsigned ANSC7:1;} ANSELCbits_t;
+SFR(ANSELCbits_t, ANSELCbits);
+typedef struct {unsigned ANSD2:1; unsigned ANSD4:1; unsigned ANSD5:1; unsigned ANSD6:1; unsigned ANSD7:1;} ANSELDbits_t;
+SFR(ANSELDbits_t, ANSELDbits);
+typedef struct {unsigned BRG16:1;} BAUD1CONbits_t;
+SFR(BAUD1CONbits_t, BAUD1CONbits);
+typedef struct {unsigned DACEN:1; unsigned DACFM:1; unsigned DACNSS:2; unsigned DACPSS:2;} DAC1CON0bits_t;
+SFR(DAC1CON0bits_t, DAC1CON0bits);
+typedef struct {unsigned DACEN:1; unsigned DACFM:1; unsigned DACNSS:2; unsigned DACPSS:2;} DAC2CON0bits_t;
+SFR(DAC2CON0bits_t, DAC2CON0bits);
+typedef struct {unsigned DAC1LD:1; unsigned DAC2LD:1;} DACLDbits_t;
+SFR(DACLDbits_t, DACLDbits);
+typedef struct {unsigned INLVB0:1; unsigned INLVB2:1; unsigned INLVB3:1; unsigned INLVLB4:1; unsigned INLVLB5:1;} INLVLBbits_t;
+SFR(INLVLBbits_t, INLVLBbits);
+typedef struct {unsigned INLVLC0:1; unsigned INLVLC1:1; unsigned INLVLC4:1; unsigned INLVLC5:1; unsigned INLVLC7:1;} INLVLCbits_t;
+SFR(INLVLCbits_t, INLVLCbits);
+typedef struct {unsigned INLVLD4:1; unsigned INLVLD5:1;} INLVLDbits_t;
+SFR(INLVLDbits_t, INLVLDbits);
+typedef struct {unsigned GIE:1; unsigned IOCIE:1; unsigned IOCIF:1; unsigned PEIE:1;} INTCONbits_t;
+SFR(INTCONbits_t, INTCONbits);
+typedef struct {unsigned IOCBF5:1;} IOCBFbits_t;
+SFR(IOCBFbits_t, IOCBFbits);
+typedef struct {unsigned IOCBN5:1;} IOCBNbits_t;
+SFR(IOCBNbits_t, IOCBNbits);
+typedef struct {unsigned IOCCF5:1;} IOCCFbits_t;
+SFR(IOCCFbits_t, IOCCFbits);
+typedef struct {unsigned IOCCN5:1;} IOCCNbits_t;
+SFR(IOCCNbits_t, IOCCNbits);
+typedef struct {unsigned LATB0:1; unsigned LATB2:1; unsigned LATB3:1; unsigned LATB4:1; unsigned LATB5:1;} LATBbits_t;
+SFR(LATBbits_t, LATBbits);
+typedef struct {unsigned LATC4:1; unsigned LATC5:1;} LATCbits_t;
+SFR(LATCbits_t, LATCbits);
+typedef struct {unsigned LATD0:1; unsigned LATD1:1; unsigned LATD2:1; unsigned LATD3:1; unsigned LATD4:1; unsigned LATD5:1;} LATDbits_t;
+SFR(LATDbits_t, LATDbits);
+typedef struct {unsigned LATE0:1; unsigned LATE1:1; unsigned LATE2:1;} LATEbits_t;
+SFR(LATEbits_t, LATEbits);
+typedef struct {unsigned EN:1; unsigned ORM:2; unsigned UG:1;} OPA1CONbits_t;
+SFR(OPA1CONbits_t, OPA1CONbits);
+typedef struct {unsigned PCH:8;} OPA1PCHSbits_t;
+SFR(OPA1PCHSbits_t, OPA1PCHSbits);
+typedef struct {unsigned EN:1; unsigned ORM:2; unsigned UG:1;} OPA2CONbits_t;
+SFR(OPA2CONbits_t, OPA2CONbits);
+typedef struct {unsigned PCH:8;} OPA2PCHSbits_t;
+SFR(OPA2PCHSbits_t, OPA2PCHSbits);
+typedef struct {unsigned nWPUEN:1;} OPTION_REGbits_t;
+SFR(OPTION_REGbits_t, OPTION_REGbits);
+typedef struct {unsigned PLLR:1;} OSCSTATbits_t;
+SFR(OSCSTATbits_t, OSCSTATbits);
+typedef struct {unsigned RCIE:1; unsigned SSP1IE:1; unsigned TMR2IE:1; unsigned TXIE:1;} PIE1bits_t;
+SFR(PIE1bits_t, PIE1bits);
+typedef struct {unsigned TMR3IE:1; unsigned TMR4IE:1; unsigned TMR5IE:1; unsigned TMR6IE:1;} PIE4bits_t;
+SFR(PIE4bits_t, PIE4bits);
+typedef struct {unsigned PWM11IE:1; unsigned PWM5IE:1; unsigned PWM6IE:1;} PIE6bits_t;
+SFR(PIE6bits_t, PIE6bits);
+typedef struct {unsigned RCIF:1; unsigned SSP1IF:1; unsigned TMR1IF:1; unsigned TMR2IF:1; unsigned TXIF:1;} PIR1bits_t;
+SFR(PIR1bits_t, PIR1bits);
+typedef struct {unsigned TMR3IF:1; unsigned TMR4IF:1; unsigned TMR5IF:1; unsigned TMR6IF:1;} PIR4bits_t;
+SFR(PIR4bits_t, PIR4bits);
+typedef struct {unsigned PWM11IF:1; unsigned PWM5IF:1; unsigned PWM6IF:1;} PIR6bits_t;
+SFR(PIR6bits_t, PIR6bits);
+typedef struct {unsigned CFGS:1; unsigned FREE:1; unsigned LWLO:1; unsigned RD:1; unsigned WR:1; unsigned WREN:1; unsigned WRERR:1;} PMCON1bits_t;
+SFR(PMCON1bits_t, PMCON1bits);
+typedef struct {unsigned RA2:1; unsigned RA3:1;} PORTAbits_t;
+SFR(PORTAbits_t, PORTAbits);
+typedef struct {unsigned RB0:1; unsigned RB2:1; unsigned RB3:1; unsigned RB4:1; unsigned RB5:1;} PORTBbits_t;
+SFR(PORTBbits_t, PORTBbits);
+typedef struct {unsigned RC0:1; unsigned RC1:1; unsigned RC2:1; unsigned RC3:1; unsigned RC5:1;} PORTCbits_t;
+SFR(PORTCbits_t, PORTCbits);
+typedef struct {unsigned RD4:1; unsigned RD5:1;} PORTDbits_t;
+SFR(PORTDbits_t, PORTDbits);
+typedef struct {unsigned RE0:1; unsigned RE1:1; unsigned RE2:1;} PORTEbits_t;
+SFR(PORTEbits_t, PORTEbits);
+typedef struct {unsigned CS:2; unsigned PS:3;} PWM11CLKCONbits_t;
+SFR(PWM11CLKCONbits_t, PWM11CLKCONbits);
+typedef struct {unsigned EN:1;} PWM11CONbits_t;
+SFR(PWM11CONbits_t, PWM11CONbits);
+typedef struct {unsigned PHIE:1;} PWM11INTEbits_t;
+SFR(PWM11INTEbits_t, PWM11INTEbits);
+typedef struct {unsigned PHIF:1;} PWM11INTFbits_t;
+SFR(PWM11INTFbits_t, PWM11INTFbits);
+typedef struct {unsigned LDA:1;} PWM11LDCONbits_t;
+SFR(PWM11LDCONbits_t, PWM11LDCONbits);
+typedef struct {unsigned OFM:2;} PWM11OFCONbits_t;
+SFR(PWM11OFCONbits_t, PWM11OFCONbits);
+typedef struct {unsigned EN:1;} PWM3CONbits_t;
+SFR(PWM3CONbits_t, PWM3CONbits);
+typedef struct {unsigned EN:1;} PWM4CONbits_t;
+SFR(PWM4CONbits_t, PWM4CONbits);
+typedef struct {unsigned CS:2; unsigned PS:3;} PWM5CLKCONbits_t;
+SFR(PWM5CLKCONbits_t, PWM5CLKCONbits);
+typedef struct {unsigned EN:1; unsigned POL:1;} PWM5CONbits_t;
+SFR(PWM5CONbits_t, PWM5CONbits);
+typedef struct {unsigned PRIE:1;} PWM5INTEbits_t;
+SFR(PWM5INTEbits_t, PWM5INTEbits);
+typedef struct {unsigned PRIF:1;} PWM5INTFbits_t;
+SFR(PWM5INTFbits_t, PWM5INTFbits);
+typedef struct {unsigned LDA:1;} PWM5LDCONbits_t;
+SFR(PWM5LDCONbits_t, PWM5LDCONbits);
+typedef struct {unsigned OFM:2;} PWM5OFCONbits_t;
+SFR(PWM5OFCONbits_t, PWM5OFCONbits);
+typedef struct {unsigned CS:2; unsigned PS:3;} PWM6CLKCONbits_t;
+SFR(PWM6CLKCONbits_t, PWM6CLKCONbits);
+typedef struct {unsigned EN:1; unsigned POL:1;} PWM6CONbits_t;
+SFR(PWM6CONbits_t, PWM6CONbits);
+typedef struct {unsigned PRIE:1;} PWM6INTEbits_t;
+SFR(PWM6INTEbits_t, PWM6INTEbits);
+typedef struct {unsigned PRIF:1;} PWM6INTFbits_t;
+SFR(PWM6INTFbits_t, PWM6INTFbits);
+typedef struct {unsigned LDA:1;} PWM6LDCONbits_t;
+SFR(PWM6LDCONbits_t, PWM6LDCONbits);
+typedef struct {unsigned OFM:2;} PWM6OFCONbits_t;
+SFR(PWM6OFCONbits_t, PWM6OFCONbits);
+typedef struct {unsigned CREN:1; unsigned SPEN:1;} RC1STAbits_t;
+SFR(RC1STAbits_t, RC1STAbits);
+typedef struct {unsigned FERR:1; unsigned OERR:1;} RCSTAbits_t;
+SFR(RCSTAbits_t, RCSTAbits);
+typedef struct {unsigned CKP:1; unsigned SSPEN:1; unsigned SSPM:4; unsigned SSPOV:1;} SSP1CON1bits_t;
+SFR(SSP1CON1bits_t, SSP1CON1bits);
+typedef struct {unsigned BOEN:1;} SSP1CON3bits_t;
+SFR(SSP1CON3bits_t, SSP1CON3bits);
+typedef struct {unsigned BF:1; unsigned CKE:1; unsigned SMP:1;} SSP1STATbits_t;
+SFR(SSP1STATbits_t, SSP1STATbits);
+typedef struct {unsigned CKPS:2; unsigned CS:2; unsigned T1ON:1;} T1CONbits_t;
+SFR(T1CONbits_t, T1CONbits);
+typedef struct {unsigned T2CS:4;} T2CLKCONbits_t;
+SFR(T2CLKCONbits_t, T2CLKCONbits);
+typedef struct {unsigned T2CKPS:3; unsigned T2ON:1;} T2CONbits_t;
+SFR(T2CONbits_t, T2CONbits);
+typedef struct {unsigned CKSYNC:1; unsigned MODE:5;} T2HLTbits_t;
+SFR(T2HLTbits_t, T2HLTbits);
+typedef struct {unsigned CKPS:2; unsigned CS:2; unsigned T3ON:1;} T3CONbits_t;
+SFR(T3CONbits_t, T3CONbits);
+typedef struct {unsigned CKPS:2; unsigned CS:2; unsigned T5ON:1;} T5CONbits_t;
+SFR(T5CONbits_t, T5CONbits);
+typedef struct {unsigned T6CS:4;} T6CLKCONbits_t;
+SFR(T6CLKCONbits_t, T6CLKCONbits);
+typedef struct {unsigned T6CKPS:3; unsigned T6ON:1;} T6CONbits_t;
+SFR(T6CONbits_t, T6CONbits);
+typedef struct {unsigned CKSYNC:1; unsigned MODE:5;} T6HLTbits_t;
+SFR(T6HLTbits_t, T6HLTbits);
+typedef struct {unsigned TRISA1:1; unsigned TRISA2:1; unsigned TRISA3:1; unsigned TRISA4:1; unsigned TRISA5:1;} TRISAbits_t;
+SFR(TRISAbits_t, TRISAbits);
+typedef struct {unsigned TRISB0:1; unsigned TRISB1:1; unsigned TRISB2:1; unsigned TRISB3:1; unsigned TRISB4:1; unsigned TRISB5:1;} TRISBbits_t;
+SFR(TRISBbits_t, TRISBbits);
+typedef struct {unsigned TRISC0:1; unsigned TRISC1:1; unsigned TRISC2:1; unsigned TRISC3:1; unsigned TRISC4:1; unsigned TRISC5:1;} TRISCbits_t;
+SFR(TRISCbits_t, TRISCbits);
+typedef struct {unsigned TRISD0:1; unsigned TRISD1:1; unsigned TRISD2:1; unsigned TRISD3:1; unsigned TRISD4:1; unsigned TRISD5:1;} TRISDbits_t;
+SFR(TRISDbits_t, TRISDbits);
+typedef struct {unsigned TRISE0:1; unsigned TRISE1:1; unsigned TRISE2:1;} TRISEbits_t;
+SFR(TRISEbits_t, TRISEbits);
+typedef struct {unsigned BRGH:1; unsigned SYNC:1; unsigned TXEN:1;} TX1STAbits_t;
+SFR(TX1STAbits_t, TX1STAbits);
+typedef struct {unsigned TRMT:1;} TXSTAbits_t;
+SFR(TXSTAbits_t, TXSTAbits);
+typedef struct {unsigned WPUA0:1;} WPUAbits_t;
+SFR(WPUAbits_t, WPUAbits);
+typedef struct {unsigned WPUB0:1; unsigned WPUB2:1; unsigned WPUB3:1; unsigned WPUB4:1; unsigned WPUB5:1;} WPUBbits_t;
+SFR(WPUBbits_t, WPUBbits);
+typedef struct {unsigned WPUC0:1; unsigned WPUC1:1; unsigned WPUC4:1; unsigned WPUC5:1;} WPUCbits_t;
+SFR(WPUCbits_t, WPUCbits);
+typedef struct {unsigned WPUD4:1; unsigned WPUD5:1; unsigned WPUD6:1; unsigned WPUD7:1;} WPUDbits_t;
+SFR(WPUDbits_t, WPUDbits);
+
+//byte and word registers
+SFR(unsigned short, ADRES);
+SFR(unsigned short, DAC1REF);
+SFR(unsigned short, DAC2REF);
+SFR(unsigned char, PMADRH);
+SFR(unsigned char, PMADRL);
+SFR(unsigned char, PMCON2);
+SFR(unsigned char, PMDATH);
+SFR(unsigned char, PMDATL);
+SFR(unsigned char, PWM11CON);
+SFR(unsigned short, PWM11DC);
+SFR(unsigned short, PWM11OF);
+SFR(unsigned short, PWM11PH);
+SFR(unsigned short, PWM11PR);
+SFR(unsigned short, PWM11TMR);
+SFR(unsigned char, PWM3CON);
+SFR(unsigned char, PWM3DCH);
+SFR(unsigned char, PWM3DCL);
+SFR(unsigned char, PWM4CON);
+SFR(unsigned char, PWM4DCH);
+SFR(unsigned char, PWM4DCL);
+SFR(unsigned char, PWM5CON);
+SFR(unsigned short, PWM5DC);
+SFR(unsigned short, PWM5OF);
+SFR(unsigned short, PWM5PH);
+SFR(unsigned short, PWM5PR);
+SFR(unsigned short, PWM5TMR);
+SFR(unsigned char, PWM6CON);
+SFR(unsigned short, PWM6DC);
+SFR(unsigned short, PWM6OF);
+SFR(unsigned short, PWM6PH);
+SFR(unsigned short, PWM6PR);
+SFR(unsigned short, PWM6TMR);
+SFR(unsigned char, RA2PPS);
+SFR(unsigned char, RA3PPS);
+SFR(unsigned char, RA4PPS);
+SFR(unsigned char, RA5PPS);
+SFR(unsigned char, RC2PPS);
+SFR(unsigned char, RC3PPS);
+SFR(unsigned char, RC6PPS);
+SFR(unsigned char, RD2PPS);
+SFR(unsigned char, RXPPS);
+SFR(unsigned char, SPBRGH);
+SFR(unsigned char, SPBRGL);
+SFR(unsigned char, SSP1ADD);
+SFR(unsigned char, SSPDATPPS);
+SFR(unsigned char, T2PR);
+SFR(unsigned char, T5CKIPPS);
+SFR(unsigned char, T6PR);
+SFR(unsigned short, TMR1);
+SFR(unsigned char, TMR2);
+SFR(unsigned short, TMR3);
+SFR(unsigned short, TMR5);
+SFR(unsigned char, TMR5H);
+SFR(unsigned char, TMR5L);
+SFR(unsigned char, TXREG);
+
+//reading RCREG takes the character from the receiver model in Host.c
+unsigned char   HostReadRCREG(void);
+#define RCREG   HostReadRCREG()
+
+//each access to SSP1BUF is passed to the MSSP model in Host.c
+unsigned char   *HostSSP1BUF(void);
+#define SSP1BUF (*HostSSP1BUF())
+
+//Timer1 counts 1 us for each read of the low byte so waits on GetTime end
+unsigned char   HostReadTMR1L(void);
+#define TMR1L   HostReadTMR1L()
+#define TMR1H   ((unsigned char)(TMR1 >> 8))
+
+
+
+#endif	/* XC_H */
@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED="../MECH2200 SDP Lab 1 software/ADC.c" "../MECH2200 SDP Lab 1 software/Comms.c" "../MECH2200 SDP Lab 1 software/DAC.c" "../MECH2200 SDP Lab 1 software/Init.c" "../MECH2200 SDP Lab 1 software/PWM.c" "../MECH2200 SDP Lab 1 software/SPI.c" "../MECH2200 SDP Lab 1 software/Timer.c" "../MECH2200 SDP Lab 1 software/main.c"
+SOURCEFILES_QUOTED_IF_SPACED="../MECH2200 SDP Lab 1 software/ADC.c" "../MECH2200 SDP Lab 1 software/Button.c" "../MECH2200 SDP Lab 1 software/Calibration.c" "../MECH2200 SDP Lab 1 software/Comms.c" "../MECH2200 SDP Lab 1 software/DAC.c" "../MECH2200 SDP Lab 1 software/Display.c" "../MECH2200 SDP Lab 1 software/Door.c" "../MECH2200 SDP Lab 1 software/Flash.c" "../MECH2200 SDP Lab 1 software/Format.c" "../MECH2200 SDP Lab 1 software/Home.c" "../MECH2200 SDP Lab 1 software/Init.c" "../MECH2200 SDP Lab 1 software/Lift.c" "../MECH2200 SDP Lab 1 software/Menu.c" "../MECH2200 SDP Lab 1 software/Motion.c" "../MECH2200 SDP Lab 1 software/MotionQueue.c" "../MECH2200 SDP Lab 1 software/Protocol.c" "../MECH2200 SDP Lab 1 software/PWM.c" "../MECH2200 SDP Lab 1 software/Scheduler.c" "../MECH2200 SDP Lab 1 software/SoftTimer.c" "../MECH2200 SDP Lab 1 software/SPI.c" "../MECH2200 SDP Lab 1 software/Timer.c" "../MECH2200 SDP Lab 1 software/main.c"
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/1297112354/ADC.p1 ${OBJECTDIR}/_ext/1297112354/Comms.p1 ${OBJECTDIR}/_ext/1297112354/DAC.p1 ${OBJECTDIR}/_ext/1297112354/Init.p1 ${OBJECTDIR}/_ext/1297112354/PWM.p1 ${OBJECTDIR}/_ext/1297112354/SPI.p1 ${OBJECTDIR}/_ext/1297112354/Timer.p1 ${OBJECTDIR}/_ext/1297112354/main.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/1297112354/ADC.p1.d ${OBJECTDIR}/_ext/1297112354/Comms.p1.d ${OBJECTDIR}/_ext/1297112354/DAC.p1.d ${OBJECTDIR}/_ext/1297112354/Init.p1.d ${OBJECTDIR}/_ext/1297112354/PWM.p1.d ${OBJECTDIR}/_ext/1297112354/SPI.p1.d ${OBJECTDIR}/_ext/1297112354/Timer.p1.d ${OBJECTDIR}/_ext/1297112354/main.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/1297112354/ADC.p1 ${OBJECTDIR}/_ext/1297112354/Button.p1 ${OBJECTDIR}/_ext/1297112354/Calibration.p1 ${OBJECTDIR}/_ext/1297112354/Comms.p1 ${OBJECTDIR}/_ext/1297112354/DAC.p1 ${OBJECTDIR}/_ext/1297112354/Display.p1 ${OBJECTDIR}/_ext/1297112354/Door.p1 ${OBJECTDIR}/_ext/1297112354/Flash.p1 ${OBJECTDIR}/_ext/1297112354/Format.p1 ${OBJECTDIR}/_ext/1297112354/Home.p1 ${OBJECTDIR}/_ext/1297112354/Init.p1 ${OBJECTDIR}/_ext/1297112354/Lift.p1 ${OBJECTDIR}/_ext/1297112354/Menu.p1 ${OBJECTDIR}/_ext/1297112354/Motion.p1 ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1 ${OBJECTDIR}/_ext/1297112354/Protocol.p1 ${OBJECTDIR}/_ext/1297112354/PWM.p1 ${OBJECTDIR}/_ext/1297112354/Scheduler.p1 ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1 ${OBJECTDIR}/_ext/1297112354/SPI.p1 ${OBJECTDIR}/_ext/1297112354/Timer.p1 ${OBJECTDIR}/_ext/1297112354/main.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/1297112354/ADC.p1.d ${OBJECTDIR}/_ext/1297112354/Button.p1.d ${OBJECTDIR}/_ext/1297112354/Calibration.p1.d ${OBJECTDIR}/_ext/1297112354/Comms.p1.d ${OBJECTDIR}/_ext/1297112354/DAC.p1.d ${OBJECTDIR}/_ext/1297112354/Display.p1.d ${OBJECTDIR}/_ext/1297112354/Door.p1.d ${OBJECTDIR}/_ext/1297112354/Flash.p1.d ${OBJECTDIR}/_ext/1297112354/Format.p1.d ${OBJECTDIR}/_ext/1297112354/Home.p1.d ${OBJECTDIR}/_ext/1297112354/Init.p1.d ${OBJECTDIR}/_ext/1297112354/Lift.p1.d ${OBJECTDIR}/_ext/1297112354/Menu.p1.d ${OBJECTDIR}/_ext/1297112354/Motion.p1.d ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1.d ${OBJECTDIR}/_ext/1297112354/Protocol.p1.d ${OBJECTDIR}/_ext/1297112354/PWM.p1.d ${OBJECTDIR}/_ext/1297112354/Scheduler.p1.d ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1.d ${OBJECTDIR}/_ext/1297112354/SPI.p1.d ${OBJECTDIR}/_ext/1297112354/Timer.p1.d ${OBJECTDIR}/_ext/1297112354/main.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/_ext/1297112354/ADC.p1 ${OBJECTDIR}/_ext/1297112354/Comms.p1 ${OBJECTDIR}/_ext/1297112354/DAC.p1 ${OBJECTDIR}/_ext/1297112354/Init.p1 ${OBJECTDIR}/_ext/1297112354/PWM.p1 ${OBJECTDIR}/_ext/1297112354/SPI.p1 ${OBJECTDIR}/_ext/1297112354/Timer.p1 ${OBJECTDIR}/_ext/1297112354/main.p1
+OBJECTFILES=${OBJECTDIR}/_ext/1297112354/ADC.p1 ${OBJECTDIR}/_ext/1297112354/Button.p1 ${OBJECTDIR}/_ext/1297112354/Calibration.p1 ${OBJECTDIR}/_ext/1297112354/Comms.p1 ${OBJECTDIR}/_ext/1297112354/DAC.p1 ${OBJECTDIR}/_ext/1297112354/Display.p1 ${OBJECTDIR}/_ext/1297112354/Door.p1 ${OBJECTDIR}/_ext/1297112354/Flash.p1 ${OBJECTDIR}/_ext/1297112354/Format.p1 ${OBJECTDIR}/_ext/1297112354/Home.p1 ${OBJECTDIR}/_ext/1297112354/Init.p1 ${OBJECTDIR}/_ext/1297112354/Lift.p1 ${OBJECTDIR}/_ext/1297112354/Menu.p1 ${OBJECTDIR}/_ext/1297112354/Motion.p1 ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1 ${OBJECTDIR}/_ext/1297112354/Protocol.p1 ${OBJECTDIR}/_ext/1297112354/PWM.p1 ${OBJECTDIR}/_ext/1297112354/Scheduler.p1 ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1 ${OBJECTDIR}/_ext/1297112354/SPI.p1 ${OBJECTDIR}/_ext/1297112354/Timer.p1 ${OBJECTDIR}/_ext/1297112354/main.p1
 
 # Source Files
-SOURCEFILES=../MECH2200 SDP Lab 1 software/ADC.c ../MECH2200 SDP Lab 1 software/Comms.c ../MECH2200 SDP Lab 1 software/DAC.c ../MECH2200 SDP Lab 1 software/Init.c ../MECH2200 SDP Lab 1 software/PWM.c ../MECH2200 SDP Lab 1 software/SPI.c ../MECH2200 SDP Lab 1 software/Timer.c ../MECH2200 SDP Lab 1 software/main.c
+SOURCEFILES=../MECH2200 SDP Lab 1 software/ADC.c ../MECH2200 SDP Lab 1 software/Button.c ../MECH2200 SDP Lab 1 software/Calibration.c ../MECH2200 SDP Lab 1 software/Comms.c ../MECH2200 SDP Lab 1 software/DAC.c ../MECH2200 SDP Lab 1 software/Display.c ../MECH2200 SDP Lab 1 software/Door.c ../MECH2200 SDP Lab 1 software/Flash.c ../MECH2200 SDP Lab 1 software/Format.c ../MECH2200 SDP Lab 1 software/Home.c ../MECH2200 SDP Lab 1 software/Init.c ../MECH2200 SDP Lab 1 software/Lift.c ../MECH2200 SDP Lab 1 software/Menu.c ../MECH2200 SDP Lab 1 software/Motion.c ../MECH2200 SDP Lab 1 software/MotionQueue.c ../MECH2200 SDP Lab 1 software/Protocol.c ../MECH2200 SDP Lab 1 software/PWM.c ../MECH2200 SDP Lab 1 software/Scheduler.c ../MECH2200 SDP Lab 1 software/SoftTimer.c ../MECH2200 SDP Lab 1 software/SPI.c ../MECH2200 SDP Lab 1 software/Timer.c ../MECH2200 SDP Lab 1 software/main.c
 
 
 
@@ -102,6 +102,22 @@ ${OBJECTDIR}/_ext/1297112354/ADC.p1: ../MECH2200\ SDP\ Lab\ 1\ software/ADC.c  n
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/ADC.d ${OBJECTDIR}/_ext/1297112354/ADC.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/ADC.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Button.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Button.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Button.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Button.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Button.p1 "../MECH2200 SDP Lab 1 software/Button.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Button.d ${OBJECTDIR}/_ext/1297112354/Button.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Button.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Calibration.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Calibration.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Calibration.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Calibration.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Calibration.p1 "../MECH2200 SDP Lab 1 software/Calibration.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Calibration.d ${OBJECTDIR}/_ext/1297112354/Calibration.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Calibration.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/Comms.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Comms.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/Comms.p1.d 
@@ -118,6 +134,46 @@ ${OBJECTDIR}/_ext/1297112354/DAC.p1: ../MECH2200\ SDP\ Lab\ 1\ software/DAC.c  n
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/DAC.d ${OBJECTDIR}/_ext/1297112354/DAC.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/DAC.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Display.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Display.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Display.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Display.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Display.p1 "../MECH2200 SDP Lab 1 software/Display.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Display.d ${OBJECTDIR}/_ext/1297112354/Display.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Display.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Door.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Door.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Door.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Door.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Door.p1 "../MECH2200 SDP Lab 1 software/Door.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Door.d ${OBJECTDIR}/_ext/1297112354/Door.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Door.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Flash.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Flash.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Flash.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Flash.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Flash.p1 "../MECH2200 SDP Lab 1 software/Flash.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Flash.d ${OBJECTDIR}/_ext/1297112354/Flash.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Flash.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Format.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Format.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Format.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Format.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Format.p1 "../MECH2200 SDP Lab 1 software/Format.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Format.d ${OBJECTDIR}/_ext/1297112354/Format.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Format.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Home.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Home.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Home.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Home.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Home.p1 "../MECH2200 SDP Lab 1 software/Home.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Home.d ${OBJECTDIR}/_ext/1297112354/Home.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Home.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/Init.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Init.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/Init.p1.d 
@@ -126,6 +182,46 @@ ${OBJECTDIR}/_ext/1297112354/Init.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Init.c
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/Init.d ${OBJECTDIR}/_ext/1297112354/Init.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Init.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Lift.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Lift.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Lift.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Lift.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Lift.p1 "../MECH2200 SDP Lab 1 software/Lift.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Lift.d ${OBJECTDIR}/_ext/1297112354/Lift.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Lift.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Menu.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Menu.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Menu.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Menu.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Menu.p1 "../MECH2200 SDP Lab 1 software/Menu.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Menu.d ${OBJECTDIR}/_ext/1297112354/Menu.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Menu.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Motion.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Motion.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Motion.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Motion.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Motion.p1 "../MECH2200 SDP Lab 1 software/Motion.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Motion.d ${OBJECTDIR}/_ext/1297112354/Motion.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Motion.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/MotionQueue.p1: ../MECH2200\ SDP\ Lab\ 1\ software/MotionQueue.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1 "../MECH2200 SDP Lab 1 software/MotionQueue.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/MotionQueue.d ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Protocol.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Protocol.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Protocol.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Protocol.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Protocol.p1 "../MECH2200 SDP Lab 1 software/Protocol.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Protocol.d ${OBJECTDIR}/_ext/1297112354/Protocol.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Protocol.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/PWM.p1: ../MECH2200\ SDP\ Lab\ 1\ software/PWM.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/PWM.p1.d 
@@ -134,6 +230,22 @@ ${OBJECTDIR}/_ext/1297112354/PWM.p1: ../MECH2200\ SDP\ Lab\ 1\ software/PWM.c  n
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/PWM.d ${OBJECTDIR}/_ext/1297112354/PWM.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/PWM.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Scheduler.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Scheduler.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Scheduler.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Scheduler.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Scheduler.p1 "../MECH2200 SDP Lab 1 software/Scheduler.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Scheduler.d ${OBJECTDIR}/_ext/1297112354/Scheduler.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Scheduler.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/SoftTimer.p1: ../MECH2200\ SDP\ Lab\ 1\ software/SoftTimer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1 "../MECH2200 SDP Lab 1 software/SoftTimer.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/SoftTimer.d ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/SPI.p1: ../MECH2200\ SDP\ Lab\ 1\ software/SPI.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/SPI.p1.d 
@@ -167,6 +279,22 @@ ${OBJECTDIR}/_ext/1297112354/ADC.p1: ../MECH2200\ SDP\ Lab\ 1\ software/ADC.c  n
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/ADC.d ${OBJECTDIR}/_ext/1297112354/ADC.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/ADC.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Button.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Button.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Button.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Button.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Button.p1 "../MECH2200 SDP Lab 1 software/Button.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Button.d ${OBJECTDIR}/_ext/1297112354/Button.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Button.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Calibration.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Calibration.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Calibration.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Calibration.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Calibration.p1 "../MECH2200 SDP Lab 1 software/Calibration.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Calibration.d ${OBJECTDIR}/_ext/1297112354/Calibration.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Calibration.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/Comms.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Comms.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/Comms.p1.d 
@@ -183,6 +311,46 @@ ${OBJECTDIR}/_ext/1297112354/DAC.p1: ../MECH2200\ SDP\ Lab\ 1\ software/DAC.c  n
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/DAC.d ${OBJECTDIR}/_ext/1297112354/DAC.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/DAC.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Display.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Display.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Display.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Display.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Display.p1 "../MECH2200 SDP Lab 1 software/Display.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Display.d ${OBJECTDIR}/_ext/1297112354/Display.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Display.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Door.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Door.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Door.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Door.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Door.p1 "../MECH2200 SDP Lab 1 software/Door.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Door.d ${OBJECTDIR}/_ext/1297112354/Door.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Door.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Flash.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Flash.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Flash.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Flash.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Flash.p1 "../MECH2200 SDP Lab 1 software/Flash.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Flash.d ${OBJECTDIR}/_ext/1297112354/Flash.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Flash.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Format.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Format.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Format.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Format.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Format.p1 "../MECH2200 SDP Lab 1 software/Format.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Format.d ${OBJECTDIR}/_ext/1297112354/Format.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Format.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Home.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Home.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Home.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Home.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Home.p1 "../MECH2200 SDP Lab 1 software/Home.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Home.d ${OBJECTDIR}/_ext/1297112354/Home.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Home.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/Init.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Init.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/Init.p1.d 
@@ -191,6 +359,46 @@ ${OBJECTDIR}/_ext/1297112354/Init.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Init.c
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/Init.d ${OBJECTDIR}/_ext/1297112354/Init.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Init.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Lift.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Lift.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Lift.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Lift.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Lift.p1 "../MECH2200 SDP Lab 1 software/Lift.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Lift.d ${OBJECTDIR}/_ext/1297112354/Lift.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Lift.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Menu.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Menu.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Menu.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Menu.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Menu.p1 "../MECH2200 SDP Lab 1 software/Menu.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Menu.d ${OBJECTDIR}/_ext/1297112354/Menu.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Menu.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Motion.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Motion.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Motion.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Motion.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Motion.p1 "../MECH2200 SDP Lab 1 software/Motion.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Motion.d ${OBJECTDIR}/_ext/1297112354/Motion.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Motion.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/MotionQueue.p1: ../MECH2200\ SDP\ Lab\ 1\ software/MotionQueue.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1 "../MECH2200 SDP Lab 1 software/MotionQueue.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/MotionQueue.d ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/MotionQueue.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/Protocol.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Protocol.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Protocol.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Protocol.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Protocol.p1 "../MECH2200 SDP Lab 1 software/Protocol.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Protocol.d ${OBJECTDIR}/_ext/1297112354/Protocol.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Protocol.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/PWM.p1: ../MECH2200\ SDP\ Lab\ 1\ software/PWM.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/PWM.p1.d 
@@ -199,6 +407,22 @@ ${OBJECTDIR}/_ext/1297112354/PWM.p1: ../MECH2200\ SDP\ Lab\ 1\ software/PWM.c  n
 	@-${MV} ${OBJECTDIR}/_ext/1297112354/PWM.d ${OBJECTDIR}/_ext/1297112354/PWM.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/PWM.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/_ext/1297112354/Scheduler.p1: ../MECH2200\ SDP\ Lab\ 1\ software/Scheduler.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Scheduler.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/Scheduler.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/Scheduler.p1 "../MECH2200 SDP Lab 1 software/Scheduler.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/Scheduler.d ${OBJECTDIR}/_ext/1297112354/Scheduler.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/Scheduler.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/_ext/1297112354/SoftTimer.p1: ../MECH2200\ SDP\ Lab\ 1\ software/SoftTimer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1.d 
+	@${RM} ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1 "../MECH2200 SDP Lab 1 software/SoftTimer.c" 
+	@-${MV} ${OBJECTDIR}/_ext/1297112354/SoftTimer.d ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/_ext/1297112354/SoftTimer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 ${OBJECTDIR}/_ext/1297112354/SPI.p1: ../MECH2200\ SDP\ Lab\ 1\ software/SPI.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/_ext/1297112354" 
 	@${RM} ${OBJECTDIR}/_ext/1297112354/SPI.p1.d 
@@ -242,13 +466,13 @@ endif
 ifeq ($(TYPE_IMAGE), DEBUG_RUN)
 dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.${OUTPUT_SUFFIX}: ${OBJECTFILES}  nbproject/Makefile-${CND_CONF}.mk    
 	@${MKDIR} dist/${CND_CONF}/${IMAGE_TYPE} 
-	${MP_CC} $(MP_EXTRA_LD_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -Wl,-Map=dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.map  -D__DEBUG=1  -DXPRJ_default=$(CND_CONF)  -Wl,--defsym=__MPLAB_BUILD=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall -std=c99 -gdwarf-3 -mstack=compiled:auto:auto        $(COMPARISON_BUILD) -Wl,--memorysummary,dist/${CND_CONF}/${IMAGE_TYPE}/memoryfile.xml -o dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.${DEBUGGABLE_SUFFIX}  ${OBJECTFILES_QUOTED_IF_SPACED}     
+	${MP_CC} $(MP_EXTRA_LD_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -Wl,-Map=dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.map  -D__DEBUG=1  -DXPRJ_default=$(CND_CONF)  -Wl,--defsym=__MPLAB_BUILD=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mrom=default,-3f80-3fff -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall -std=c99 -gdwarf-3 -mstack=compiled:auto:auto        $(COMPARISON_BUILD) -Wl,--memorysummary,dist/${CND_CONF}/${IMAGE_TYPE}/memoryfile.xml -o dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.${DEBUGGABLE_SUFFIX}  ${OBJECTFILES_QUOTED_IF_SPACED}     
 	@${RM} dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.hex 
 	
 else
 dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.${OUTPUT_SUFFIX}: ${OBJECTFILES}  nbproject/Makefile-${CND_CONF}.mk   
 	@${MKDIR} dist/${CND_CONF}/${IMAGE_TYPE} 
-	${MP_CC} $(MP_EXTRA_LD_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -Wl,-Map=dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.map  -DXPRJ_default=$(CND_CONF)  -Wl,--defsym=__MPLAB_BUILD=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     $(COMPARISON_BUILD) -Wl,--memorysummary,dist/${CND_CONF}/${IMAGE_TYPE}/memoryfile.xml -o dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.${DEBUGGABLE_SUFFIX}  ${OBJECTFILES_QUOTED_IF_SPACED}     
+	${MP_CC} $(MP_EXTRA_LD_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -Wl,-Map=dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.map  -DXPRJ_default=$(CND_CONF)  -Wl,--defsym=__MPLAB_BUILD=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mrom=default,-3f80-3fff -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     $(COMPARISON_BUILD) -Wl,--memorysummary,dist/${CND_CONF}/${IMAGE_TYPE}/memoryfile.xml -o dist/${CND_CONF}/${IMAGE_TYPE}/SDP1.X.${IMAGE_TYPE}.${DEBUGGABLE_SUFFIX}  ${OBJECTFILES_QUOTED_IF_SPACED}     
 	
 endif
 